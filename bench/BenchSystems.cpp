@@ -0,0 +1,311 @@
+#include "BenchSystems.h"
+
+#include <cmath>
+#include <random>
+
+#include "State.h"
+#include "Bounds.h"
+#include "includeFixes.h"
+#include "InitializeAtoms.h"
+
+namespace {
+
+    //! Fills a cube of lattice sites in boustrophedon order
+    /*!
+     * Consecutive sites are always lattice neighbors and never wrap through
+     * the periodic boundary, so chains can be laid along the returned order.
+     */
+    std::vector<Vector> latticeSites(int n, double spacing, int &perSide) {
+        perSide = (int) std::ceil(std::cbrt((double) n) - 1e-9);
+        std::vector<Vector> sites;
+        sites.reserve(n);
+        for (int z=0; z<perSide; z++) {
+            for (int j=0; j<perSide; j++) {
+                int y = z % 2 ? perSide-1-j : j;
+                int row = z*perSide + j;
+                for (int k=0; k<perSide; k++) {
+                    int x = row % 2 ? perSide-1-k : k;
+                    if (sites.size() < n) {
+                        sites.push_back(Vector(x+0.5, y+0.5, z+0.5) * spacing);
+                    }
+                }
+            }
+        }
+        return sites;
+    }
+
+    void setUp(boost::shared_ptr<State> state, bool real, Vector hi, double rCut, double padding, double dt) {
+        if (real) {
+            state->units.setReal();
+        }
+        state->bounds = Bounds(state, Vector(0, 0, 0), hi);
+        state->rCut = rCut;
+        state->padding = padding;
+        state->dt = dt;
+        state->verbose = false;
+    }
+
+    //! Uniformly distributed rotation, as a unit quaternion (w, x, y, z)
+    void randomRotation(std::mt19937 &rng, double q[4]) {
+        std::uniform_real_distribution<double> uniform(0, 1);
+        double u1 = uniform(rng);
+        double u2 = uniform(rng);
+        double u3 = uniform(rng);
+        q[0] = std::sqrt(1-u1) * std::sin(2*M_PI*u2);
+        q[1] = std::sqrt(1-u1) * std::cos(2*M_PI*u2);
+        q[2] = std::sqrt(u1) * std::sin(2*M_PI*u3);
+        q[3] = std::sqrt(u1) * std::cos(2*M_PI*u3);
+    }
+
+    Vector rotate(const double q[4], Vector v) {
+        Vector u(q[1], q[2], q[3]);
+        Vector t = u.cross(v) * 2.0;
+        return v + t * q[0] + u.cross(t);
+    }
+
+    //! Places a rigid or flexible 3- or 4-site water at each lattice site
+    /*!
+     * Sites are given in the molecule frame with the oxygen at the origin.
+     * Returns the atom ids of each molecule, oxygen first.
+     */
+    std::vector<std::vector<int> > placeWaters(boost::shared_ptr<State> state, int n, double spacing,
+                                               std::vector<std::string> handles, std::vector<Vector> offsets,
+                                               std::vector<double> charges) {
+        int perSide;
+        std::vector<Vector> sites = latticeSites(n, spacing, perSide);
+        std::mt19937 rng(2017);
+        std::vector<std::vector<int> > molecules;
+        for (Vector &center : sites) {
+            double q[4];
+            randomRotation(rng, q);
+            std::vector<int> ids;
+            for (int i=0; i<handles.size(); i++) {
+                ids.push_back(state->addAtom(handles[i], center + rotate(q, offsets[i]), charges[i]));
+            }
+            molecules.push_back(ids);
+        }
+        return molecules;
+    }
+
+    //! Water geometry in the molecule frame: H's in the xy plane, bisector along x
+    std::vector<Vector> waterOffsets(double rOH, double theta, double rOM) {
+        std::vector<Vector> offsets = {Vector(0, 0, 0),
+                                       Vector(std::cos(theta/2), std::sin(theta/2), 0) * rOH,
+                                       Vector(std::cos(theta/2), -std::sin(theta/2), 0) * rOH};
+        if (rOM > 0) {
+            offsets.push_back(Vector(rOM, 0, 0));
+        }
+        return offsets;
+    }
+
+    //! Lennard-Jones fluid at the usual benchmark state point, rho*=0.8442, T*=1.2
+    void buildLJ(boost::shared_ptr<State> state, int n) {
+        double spacing = std::cbrt(1.0 / 0.8442);
+        int perSide;
+        std::vector<Vector> sites = latticeSites(n, spacing, perSide);
+        setUp(state, false, Vector(1, 1, 1) * perSide * spacing, 2.5, 0.3, 0.005);
+        state->atomParams.addSpecies("A", 1);
+        for (Vector &site : sites) {
+            state->addAtom("A", site, 0);
+        }
+        boost::shared_ptr<FixLJCut> lj(new FixLJCut(state, "lj"));
+        lj->setParameter("sig", "A", "A", 1);
+        lj->setParameter("eps", "A", "A", 1);
+        state->activateFix(lj);
+        InitializeAtoms::initTemp(state, "all", 1.2);
+    }
+
+    //! Kremer-Grest bead-spring melt of n chains of 32 beads, rho*=0.85
+    void buildFENE(boost::shared_ptr<State> state, int n) {
+        const int chainLength = 32;
+        double spacing = std::cbrt(1.0 / 0.85);
+        int perSide;
+        std::vector<Vector> sites = latticeSites(n * chainLength, spacing, perSide);
+        setUp(state, false, Vector(1, 1, 1) * perSide * spacing,
+                                                  std::pow(2.0, 1.0/6.0), 0.4, 0.005);
+        state->setSpecialNeighborCoefs(1, 1, 1);
+        state->atomParams.addSpecies("bead", 1);
+        for (Vector &site : sites) {
+            state->addAtom("bead", site, 0);
+        }
+        boost::shared_ptr<FixLJCut> wca(new FixLJCut(state, "wca"));
+        wca->setParameter("sig", "bead", "bead", 1);
+        wca->setParameter("eps", "bead", "bead", 1);
+        boost::shared_ptr<FixBondFENE> fene(new FixBondFENE(state, "fene"));
+        fene->setBondTypeCoefs(0, 30, 1.5, 1, 1);
+        for (int c=0; c<n; c++) {
+            for (int i=0; i<chainLength-1; i++) {
+                int idx = c*chainLength + i;
+                fene->createBond(&state->atoms[idx], &state->atoms[idx+1], -1, -1, -1, -1, 0);
+            }
+        }
+        state->activateFix(wca);
+        state->activateFix(fene);
+        InitializeAtoms::initTemp(state, "all", 1.0);
+    }
+
+    //! SPC/E water with Ewald electrostatics
+    /*!
+     * FixRigid only knows the TIP3P and TIP4P/2005 geometries, so the SPC/E
+     * geometry is held by stiff harmonic bonds and angles (SPC/Fw force
+     * constants) and the step is 1 fs.
+     */
+    void buildSPCE(boost::shared_ptr<State> state, int n) {
+        double spacing = std::cbrt(1.0 / 0.03334);
+        int perSide = (int) std::ceil(std::cbrt((double) n) - 1e-9);
+        setUp(state, true, Vector(1, 1, 1) * perSide * spacing, 9.0, 2.0, 1.0);
+        state->setSpecialNeighborCoefs(0, 0, 0);
+        state->atomParams.addSpecies("OW", 15.9994, 8);
+        state->atomParams.addSpecies("HW", 1.008, 1);
+        double theta = 109.47 * M_PI / 180.0;
+        std::vector<std::vector<int> > molecules = placeWaters(state, n, spacing, {"OW", "HW", "HW"},
+                                                               waterOffsets(1.0, theta, 0),
+                                                               {-0.8476, 0.4238, 0.4238});
+        boost::shared_ptr<FixLJCut> lj(new FixLJCut(state, "lj"));
+        lj->setParameter("sig", "OW", "OW", 3.166);
+        lj->setParameter("eps", "OW", "OW", 0.1553);
+        lj->setParameter("sig", "HW", "HW", 0);
+        lj->setParameter("eps", "HW", "HW", 0);
+        lj->setParameter("sig", "OW", "HW", 0);
+        lj->setParameter("eps", "OW", "HW", 0);
+        boost::shared_ptr<FixBondHarmonic> bonds(new FixBondHarmonic(state, "bonds"));
+        boost::shared_ptr<FixAngleHarmonic> angles(new FixAngleHarmonic(state, "angles"));
+        bonds->setBondTypeCoefs(0, 1059.162, 1.0);
+        angles->setAngleTypeCoefs(0, 75.90, theta);
+        for (std::vector<int> &ids : molecules) {
+            Atom *o = &state->idToAtom(ids[0]);
+            Atom *h1 = &state->idToAtom(ids[1]);
+            Atom *h2 = &state->idToAtom(ids[2]);
+            bonds->createBond(o, h1, -1, -1, 0);
+            bonds->createBond(o, h2, -1, -1, 0);
+            angles->createAngle(h1, o, h2, COEF_DEFAULT, COEF_DEFAULT, 0);
+        }
+        boost::shared_ptr<FixChargeEwald> charge(new FixChargeEwald(state, "charge", "all"));
+        charge->setError(0.01, state->rCut, 3);
+        state->activateFix(lj);
+        state->activateFix(bonds);
+        state->activateFix(angles);
+        state->activateFix(charge);
+        InitializeAtoms::initTemp(state, "all", 300);
+    }
+
+    //! Rigid TIP4P/2005 water with Ewald electrostatics and the E3B3 three-body term
+    void buildTIP4P2005E3B3(boost::shared_ptr<State> state, int n) {
+        double spacing = std::cbrt(1.0 / 0.03334);
+        int perSide = (int) std::ceil(std::cbrt((double) n) - 1e-9);
+        setUp(state, true, Vector(1, 1, 1) * perSide * spacing, 9.0, 2.0, 2.0);
+        state->atomParams.addSpecies("OW", 15.9994, 8);
+        state->atomParams.addSpecies("HW", 1.008, 1);
+        state->atomParams.addSpecies("M", 0, 0);
+        std::vector<std::vector<int> > molecules = placeWaters(state, n, spacing, {"OW", "HW", "HW", "M"},
+                                                               waterOffsets(0.9572, 104.52 * M_PI / 180.0, 0.1546),
+                                                               {0, 0.5564, 0.5564, -1.1128});
+        boost::shared_ptr<FixLJCut> lj(new FixLJCut(state, "lj"));
+        for (std::string a : {"OW", "HW", "M"}) {
+            for (std::string b : {"OW", "HW", "M"}) {
+                bool oo = a == "OW" and b == "OW";
+                lj->setParameter("sig", a, b, oo ? 3.1589 : 0);
+                lj->setParameter("eps", a, b, oo ? 0.1852 : 0);
+            }
+        }
+        boost::shared_ptr<FixRigid> rigid(new FixRigid(state, "rigid", "all"));
+        rigid->setStyle("TIP4P/2005");
+        boost::shared_ptr<FixE3B3> e3b3(new FixE3B3(state, "e3b3", "all"));
+        for (std::vector<int> &ids : molecules) {
+            rigid->createRigid(ids[0], ids[1], ids[2], ids[3]);
+            e3b3->addMolecule(ids[0], ids[1], ids[2], ids[3]);
+        }
+        boost::shared_ptr<FixChargeEwald> charge(new FixChargeEwald(state, "charge", "all"));
+        charge->setError(0.01, state->rCut, 3);
+        state->activateFix(lj);
+        state->activateFix(charge);
+        state->activateFix(e3b3);
+        state->activateFix(rigid);
+        InitializeAtoms::initTemp(state, "all", 300);
+    }
+
+    //! n peptide-like backbones of 10 N-CA-C residues with the CHARMM bonded and nonbonded terms
+    /*!
+     * Chains are laid out as planar all-trans zigzags along x on a square
+     * grid in y and z, so every bond, angle and dihedral starts at its
+     * minimum.
+     */
+    void buildPeptide(boost::shared_ptr<State> state, int n) {
+        const int nRes = 10;
+        const int chainLength = 3*nRes;
+        const double bondLength = 1.53;
+        const double theta = 111.0 * M_PI / 180.0;
+        const double rise = bondLength * std::sin(theta/2);
+        const double zig = bondLength * std::cos(theta/2);
+        const double chainSpacing = 4.5;
+        int perSide = (int) std::ceil(std::sqrt((double) n) - 1e-9);
+        Vector hi(chainLength*rise + 5.0, perSide*chainSpacing, perSide*chainSpacing);
+        setUp(state, true, hi, 10.0, 2.0, 1.0);
+        state->setSpecialNeighborCoefs(0, 0, 0.5);
+        state->atomParams.addSpecies("N", 14.007, 7);
+        state->atomParams.addSpecies("CA", 12.011, 6);
+        state->atomParams.addSpecies("C", 12.011, 6);
+        const std::string handles[3] = {"N", "CA", "C"};
+        const double charges[3] = {-0.4, 0.1, 0.3};
+        for (int c=0; c<n; c++) {
+            double y = (c % perSide + 0.5) * chainSpacing;
+            double z = (c / perSide + 0.5) * chainSpacing;
+            for (int i=0; i<chainLength; i++) {
+                state->addAtom(handles[i%3], Vector(1.0 + i*rise, y + (i%2)*zig, z), charges[i%3]);
+            }
+        }
+        boost::shared_ptr<FixLJCHARMM> lj(new FixLJCHARMM(state, "lj"));
+        const double sig[3] = {3.296, 3.875, 3.564};
+        const double eps[3] = {0.2, 0.07, 0.11};
+        for (int i=0; i<3; i++) {
+            lj->setParameter("sig", handles[i], handles[i], sig[i]);
+            lj->setParameter("eps", handles[i], handles[i], eps[i]);
+            lj->setParameter("sig14", handles[i], handles[i], sig[i]);
+            lj->setParameter("eps14", handles[i], handles[i], eps[i] * 0.5);
+        }
+        boost::shared_ptr<FixBondHarmonic> bonds(new FixBondHarmonic(state, "bonds"));
+        boost::shared_ptr<FixAngleCHARMM> angles(new FixAngleCHARMM(state, "angles"));
+        boost::shared_ptr<FixDihedralCHARMM> dihedrals(new FixDihedralCHARMM(state, "dihedrals"));
+        bonds->setBondTypeCoefs(0, 300, bondLength);
+        angles->setAngleTypeCoefs(50, theta, 10, 2*rise, 0);
+        dihedrals->setDihedralTypeCoefs(0, 0.2, 3, 0);
+        for (int c=0; c<n; c++) {
+            Atom *a = &state->atoms[c*chainLength];
+            for (int i=0; i<chainLength-1; i++) {
+                bonds->createBond(a+i, a+i+1, -1, -1, 0);
+                if (i < chainLength-2) {
+                    angles->createAngle(a+i, a+i+1, a+i+2, COEF_DEFAULT, COEF_DEFAULT, COEF_DEFAULT, COEF_DEFAULT, 0);
+                }
+                if (i < chainLength-3) {
+                    dihedrals->createDihedral(a+i, a+i+1, a+i+2, a+i+3, COEF_DEFAULT, COEF_DEFAULT, COEF_DEFAULT, 0);
+                }
+            }
+        }
+        boost::shared_ptr<FixChargeEwald> charge(new FixChargeEwald(state, "charge", "all"));
+        charge->setError(0.01, state->rCut, 3);
+        state->activateFix(lj);
+        state->activateFix(bonds);
+        state->activateFix(angles);
+        state->activateFix(dihedrals);
+        state->activateFix(charge);
+        InitializeAtoms::initTemp(state, "all", 300);
+    }
+
+}
+
+const std::vector<std::string> &benchSizeNames() {
+    static const std::vector<std::string> names = {"small", "medium", "large"};
+    return names;
+}
+
+const std::vector<BenchSystem> &benchSystems() {
+    //LJ time is converted with argon's tau, 2.156 ps
+    static const std::vector<BenchSystem> systems = {
+        {"lj", "Lennard-Jones fluid, atoms", {4096, 32768, 262144}, 2000, 2156.0, buildLJ},
+        {"fene", "Kremer-Grest FENE melt, chains of 32", {128, 1024, 8192}, 2000, 2156.0, buildFENE},
+        {"spce", "SPC/E water with Ewald, molecules", {512, 4096, 32768}, 1000, 1.0, buildSPCE},
+        {"tip4p2005_e3b3", "rigid TIP4P/2005 with E3B3 and Ewald, molecules", {512, 4096, 32768}, 500, 1.0, buildTIP4P2005E3B3},
+        {"peptide", "CHARMM-style backbones of 30 atoms with Ewald, chains", {64, 512, 4096}, 1000, 1.0, buildPeptide},
+    };
+    return systems;
+}
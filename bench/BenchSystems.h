@@ -0,0 +1,36 @@
+#pragma once
+#ifndef BENCHSYSTEMS_H
+#define BENCHSYSTEMS_H
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+class State;
+
+//! A benchmark system which builds itself at a requested size
+/*!
+ * Systems are generated on lattices with fixed random seeds, so a given
+ * system and size is the same from one build of DASH to the next and timings
+ * can be compared between them.
+ */
+class BenchSystem {
+public:
+    std::string name;
+    std::string description;
+    //! Number of molecules (or chains) for the small, medium and large sizes
+    std::vector<int> sizes;
+    int defaultSteps; //!< Timed steps per run unless overridden
+    double fsPerTimeUnit; //!< Converts state->dt to femtoseconds
+    //! Fill a freshly constructed state with n molecules (or chains) and its fixes
+    void (*build)(boost::shared_ptr<State> state, int n);
+};
+
+//! Names of the sizes, matching BenchSystem::sizes
+const std::vector<std::string> &benchSizeNames();
+
+//! All benchmark systems, in the order they are run
+const std::vector<BenchSystem> &benchSystems();
+
+#endif
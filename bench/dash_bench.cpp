@@ -0,0 +1,236 @@
+/*
+ * dash_bench: throughput benchmarks on self-generated systems
+ *
+ * Usage: dash_bench [--systems lj,fene,...] [--sizes small,medium,large]
+ *                   [--steps N] [--warmup N] [--timing-interval N]
+ *                   [--device N] [--out results.json]
+ *                   [--compare baseline.json] [--tolerance 0.05]
+ *
+ * Every system and size is built, run for --warmup steps (which includes
+ * tuning) and then run for the timed steps.  Results are written to --out as
+ * JSON, one result object per line.  With --compare, throughput is checked
+ * against an earlier results file and the exit status is 1 if any case is
+ * more than --tolerance slower.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Python.h"
+
+#include "State.h"
+#include "IntegratorVerlet.h"
+
+#include "BenchSystems.h"
+
+namespace {
+
+    class Options {
+    public:
+        std::vector<std::string> systems;
+        std::vector<std::string> sizes = {"small", "medium"};
+        int steps = 0;
+        int warmup = 100;
+        int timingInterval = 50;
+        int device = -1;
+        std::string out = "dash_bench.json";
+        std::string compare;
+        double tolerance = 0.05;
+    };
+
+    class Result {
+    public:
+        std::string system;
+        std::string size;
+        int atoms;
+        int steps;
+        double particleStepsPerSecond;
+        double nsPerDay;
+        std::string timings;
+    };
+
+    std::vector<std::string> split(const std::string &s) {
+        std::vector<std::string> parts;
+        std::stringstream ss(s);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            if (part.size()) {
+                parts.push_back(part);
+            }
+        }
+        return parts;
+    }
+
+    void usage() {
+        std::cerr << "usage: dash_bench [--systems a,b] [--sizes small,medium,large] [--steps N] [--warmup N]\n"
+                  << "                  [--timing-interval N] [--device N] [--out file] [--compare file] [--tolerance f]\n"
+                  << "systems:";
+        for (const BenchSystem &sys : benchSystems()) {
+            std::cerr << "\n  " << sys.name << " (" << sys.description << ":";
+            for (int n : sys.sizes) {
+                std::cerr << " " << n;
+            }
+            std::cerr << ")";
+        }
+        std::cerr << std::endl;
+        exit(2);
+    }
+
+    Options parseArgs(int argc, char **argv) {
+        Options opts;
+        for (const BenchSystem &sys : benchSystems()) {
+            opts.systems.push_back(sys.name);
+        }
+        for (int i=1; i<argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--help" or arg == "-h" or i+1 == argc) {
+                usage();
+            }
+            std::string val = argv[++i];
+            if (arg == "--systems") {
+                opts.systems = split(val);
+            } else if (arg == "--sizes") {
+                opts.sizes = split(val);
+            } else if (arg == "--steps") {
+                opts.steps = atoi(val.c_str());
+            } else if (arg == "--warmup") {
+                opts.warmup = atoi(val.c_str());
+            } else if (arg == "--timing-interval") {
+                opts.timingInterval = atoi(val.c_str());
+            } else if (arg == "--device") {
+                opts.device = atoi(val.c_str());
+            } else if (arg == "--out") {
+                opts.out = val;
+            } else if (arg == "--compare") {
+                opts.compare = val;
+            } else if (arg == "--tolerance") {
+                opts.tolerance = atof(val.c_str());
+            } else {
+                usage();
+            }
+        }
+        return opts;
+    }
+
+    Result runCase(const BenchSystem &sys, int sizeIdx, const Options &opts, std::string &deviceName) {
+        boost::shared_ptr<State> state(new State());
+        if (opts.device >= 0) {
+            state->devManager.setDevice(opts.device);
+        }
+        sys.build(state, sys.sizes[sizeIdx]);
+        deviceName = state->devManager.prop.name;
+        IntegratorVerlet integrator(state.get());
+        if (opts.warmup) {
+            integrator.run(opts.warmup);
+        }
+        Result r;
+        r.system = sys.name;
+        r.size = benchSizeNames()[sizeIdx];
+        r.atoms = state->atoms.size();
+        r.steps = opts.steps ? opts.steps : sys.defaultSteps;
+        integrator.timingInterval = opts.timingInterval;
+        r.particleStepsPerSecond = integrator.run(r.steps);
+        double nsPerStep = state->dt * sys.fsPerTimeUnit * 1e-6;
+        r.nsPerDay = r.particleStepsPerSecond / r.atoms * nsPerStep * 86400;
+        r.timings = integrator.timingsJSON();
+        return r;
+    }
+
+    //! Reads throughput back out of a file written by writeResults
+    std::map<std::string, double> readBaseline(const std::string &fn) {
+        std::map<std::string, double> baseline;
+        std::ifstream f(fn.c_str());
+        if (not f) {
+            std::cerr << "Could not open baseline " << fn << std::endl;
+            exit(2);
+        }
+        std::regex pattern("\"system\": \"([^\"]+)\", \"size\": \"([^\"]+)\".*\"particleStepsPerSecond\": ([-+0-9.eE]+)");
+        std::string line;
+        std::smatch m;
+        while (std::getline(f, line)) {
+            if (std::regex_search(line, m, pattern)) {
+                baseline[m[1].str() + " " + m[2].str()] = atof(m[3].str().c_str());
+            }
+        }
+        return baseline;
+    }
+
+    void writeResults(const std::string &fn, const std::string &deviceName, const std::vector<Result> &results) {
+        std::ofstream f(fn.c_str());
+        if (not f) {
+            std::cerr << "Could not open " << fn << std::endl;
+            exit(2);
+        }
+        f << "{\"device\": \"" << deviceName << "\", \"results\": [\n";
+        for (int i=0; i<results.size(); i++) {
+            const Result &r = results[i];
+            f << "{\"system\": \"" << r.system << "\", \"size\": \"" << r.size << "\""
+              << ", \"atoms\": " << r.atoms << ", \"steps\": " << r.steps
+              << ", \"particleStepsPerSecond\": " << r.particleStepsPerSecond
+              << ", \"nsPerDay\": " << r.nsPerDay
+              << ", \"timings\": " << r.timings << "}"
+              << (i+1 < results.size() ? ",\n" : "\n");
+        }
+        f << "]}\n";
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options opts = parseArgs(argc, argv);
+    //State holds python objects, so the interpreter has to exist first
+    Py_Initialize();
+
+    std::vector<Result> results;
+    std::string deviceName;
+    for (std::string &name : opts.systems) {
+        const BenchSystem *sys = nullptr;
+        for (const BenchSystem &s : benchSystems()) {
+            if (s.name == name) {
+                sys = &s;
+            }
+        }
+        if (not sys) {
+            std::cerr << "Unknown system " << name << std::endl;
+            usage();
+        }
+        for (std::string &size : opts.sizes) {
+            int sizeIdx = std::find(benchSizeNames().begin(), benchSizeNames().end(), size) - benchSizeNames().begin();
+            if (sizeIdx == benchSizeNames().size()) {
+                std::cerr << "Unknown size " << size << std::endl;
+                usage();
+            }
+            Result r = runCase(*sys, sizeIdx, opts, deviceName);
+            std::cout << "BENCH " << r.system << " " << r.size << ": " << r.atoms << " atoms, "
+                      << r.particleStepsPerSecond << " particle-steps/s, " << r.nsPerDay << " ns/day" << std::endl;
+            results.push_back(r);
+        }
+    }
+    writeResults(opts.out, deviceName, results);
+
+    if (opts.compare.empty()) {
+        return 0;
+    }
+    std::map<std::string, double> baseline = readBaseline(opts.compare);
+    int regressions = 0;
+    for (Result &r : results) {
+        auto it = baseline.find(r.system + " " + r.size);
+        if (it == baseline.end()) {
+            std::cout << "COMPARE " << r.system << " " << r.size << ": not in baseline" << std::endl;
+            continue;
+        }
+        double ratio = r.particleStepsPerSecond / it->second;
+        bool regressed = ratio < 1 - opts.tolerance;
+        regressions += regressed;
+        std::cout << "COMPARE " << r.system << " " << r.size << ": " << ratio << "x baseline"
+                  << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * dash_microbench: timings of the host-side setup paths
+ *
+ * Usage: dash_microbench [--filter regex] [--min-time seconds] [--json file]
+ *
+ * Each benchmark is set up once per size and its body is then repeated until
+ * --min-time has passed (at least three times), in the manner of Google
+ * Benchmark.  Results are printed as a table and, with --json, written one
+ * object per line.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Python.h"
+
+#include "State.h"
+#include "GridGPU.h"
+#include "FixBondFENE.h"
+#include "FixLJCut.h"
+#include "ReadConfig.h"
+#include "WriteConfig.h"
+#include "base64.h"
+
+#include "BenchSystems.h"
+
+namespace {
+
+    //! A benchmark is a setup function, run once per size, returning the body to time
+    class MicroBenchmark {
+    public:
+        std::string name;
+        std::vector<int> sizes;
+        std::function<std::function<void ()> (int n)> setup;
+    };
+
+    boost::shared_ptr<State> buildSystem(std::string name, int n) {
+        boost::shared_ptr<State> state(new State());
+        for (const BenchSystem &sys : benchSystems()) {
+            if (sys.name == name) {
+                sys.build(state, n);
+            }
+        }
+        return state;
+    }
+
+    template <class T>
+    T *findFix(boost::shared_ptr<State> state) {
+        for (Fix *f : state->fixes) {
+            if (T *found = dynamic_cast<T *>(f)) {
+                return found;
+            }
+        }
+        return nullptr;
+    }
+
+    //! Owns what a benchmark body needs after its setup function returns
+    class Fixture {
+    public:
+        boost::shared_ptr<State> state;
+        GridGPU grid;
+        boost::shared_ptr<WriteConfig> writer;
+        std::string data;
+        int64_t turn = 0;
+        std::string tmpFile; //!< Removed once the benchmark is done with it
+        ~Fixture() {
+            if (tmpFile.size()) {
+                unlink(tmpFile.c_str());
+            }
+        }
+    };
+
+    const std::vector<int> atomSizes = {1024, 8192, 65536, 262144};
+    const int chainLength = 32; //!< Of the FENE benchmark system
+
+    std::vector<MicroBenchmark> microBenchmarks() {
+        std::vector<MicroBenchmark> benchmarks;
+
+        benchmarks.push_back({"generateExclusionList", atomSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->state = buildSystem("fene", n / chainLength);
+            fx->grid.state = fx->state.get();
+            return [fx] () {
+                fx->grid.generateExclusionList(3);
+            };
+        }});
+
+        benchmarks.push_back({"State::prepareForRun", atomSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->state = buildSystem("lj", n);
+            fx->state->incrementalPrepare = false;
+            return [fx] () {
+                fx->state->prepareForRun();
+            };
+        }});
+
+        benchmarks.push_back({"copyBondsToGPU", atomSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->state = buildSystem("fene", n / chainLength);
+            fx->state->prepareForRun();
+            FixBondFENE *fene = findFix<FixBondFENE>(fx->state);
+            return [fx, fene] () {
+                copyBondsToGPU<BondFENE, BondGPU, BondFENEType>(
+                        fx->state->atoms, fene->bonds, fx->state->idToIdx, &fene->bondsGPU,
+                        &fene->bondIdxs, &fene->parameters, 0, fene->bondTypes);
+            };
+        }});
+
+        //prepareParameters is protected, so it is timed through FixLJCut::prepareForRun
+        benchmarks.push_back({"FixPair::prepareParameters", {1, 8, 32, 128}, [] (int nTypes) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->state = boost::shared_ptr<State>(new State());
+            boost::shared_ptr<FixLJCut> lj(new FixLJCut(fx->state, "lj"));
+            for (int i=0; i<nTypes; i++) {
+                std::string handle = "t" + std::to_string(i);
+                fx->state->atomParams.addSpecies(handle, 1);
+                lj->setParameter("sig", handle, handle, 1);
+                lj->setParameter("eps", handle, handle, 1);
+            }
+            return [fx, lj] () {
+                lj->prepareForRun();
+            };
+        }});
+
+        benchmarks.push_back({"ReadConfig", atomSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->state = buildSystem("lj", n);
+            std::string fn = "dash_microbench_read_" + std::to_string(getpid());
+            {
+                WriteConfig writer(fx->state, fn, "bench", "xml", 1);
+                writer.write(0, fx->state->bounds);
+            }
+            fx->tmpFile = fn + ".xml";
+            return [fx] () {
+                fx->state->readConfig->loadFile(fx->tmpFile);
+                fx->state->readConfig->next();
+            };
+        }});
+
+        for (std::string format : {"xml", "base64", "xyz", "lammpstrj"}) {
+            benchmarks.push_back({"WriteConfig/" + format, atomSizes, [format] (int n) {
+                boost::shared_ptr<Fixture> fx(new Fixture());
+                fx->state = buildSystem("lj", n);
+                std::string fn = "dash_microbench_write_" + std::to_string(getpid()) + "_*";
+                fx->writer = boost::shared_ptr<WriteConfig>(new WriteConfig(fx->state, fn, "bench", format, 1));
+                return [fx] () {
+                    fx->writer->write(fx->turn, fx->state->bounds);
+                    unlink(fx->writer->getCurrentFn(fx->turn).c_str());
+                    fx->turn++;
+                };
+            }});
+        }
+
+        const std::vector<int> byteSizes = {1 << 10, 1 << 16, 1 << 20, 1 << 24};
+        benchmarks.push_back({"base64_encode", byteSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            fx->data = std::string(n, 0);
+            for (int i=0; i<n; i++) {
+                fx->data[i] = (char) (i * 2654435761u >> 24);
+            }
+            return [fx] () {
+                base64_encode((unsigned char const *) fx->data.data(), fx->data.size());
+            };
+        }});
+
+        benchmarks.push_back({"base64_decode", byteSizes, [] (int n) {
+            boost::shared_ptr<Fixture> fx(new Fixture());
+            std::string raw(n, 0);
+            for (int i=0; i<n; i++) {
+                raw[i] = (char) (i * 2654435761u >> 24);
+            }
+            fx->data = base64_encode((unsigned char const *) raw.data(), raw.size());
+            return [fx] () {
+                base64_decode(fx->data);
+            };
+        }});
+
+        return benchmarks;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    std::string filter = ".*";
+    double minTime = 0.5;
+    std::string jsonFn;
+    for (int i=1; i+1<argc; i+=2) {
+        std::string arg = argv[i];
+        if (arg == "--filter") {
+            filter = argv[i+1];
+        } else if (arg == "--min-time") {
+            minTime = atof(argv[i+1]);
+        } else if (arg == "--json") {
+            jsonFn = argv[i+1];
+        } else {
+            std::cerr << "usage: dash_microbench [--filter regex] [--min-time seconds] [--json file]" << std::endl;
+            return 2;
+        }
+    }
+    //State holds python objects, so the interpreter has to exist first
+    Py_Initialize();
+
+    std::ofstream json;
+    if (jsonFn.size()) {
+        json.open(jsonFn.c_str());
+    }
+    std::regex pattern(filter);
+    std::cout << std::left << std::setw(36) << "Benchmark" << std::right << std::setw(14) << "Time/iter (s)"
+              << std::setw(12) << "Iterations" << std::setw(16) << "Items/s" << std::endl;
+    for (MicroBenchmark &b : microBenchmarks()) {
+        if (not std::regex_search(b.name, pattern)) {
+            continue;
+        }
+        for (int n : b.sizes) {
+            std::function<void ()> body = b.setup(n);
+            body(); //warm up, and make any first-call allocations
+            cudaDeviceSynchronize();
+            int iterations = 0;
+            double elapsed = 0;
+            auto start = std::chrono::steady_clock::now();
+            while (iterations < 3 or elapsed < minTime) {
+                body();
+                cudaDeviceSynchronize();
+                iterations++;
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            double perIter = elapsed / iterations;
+            std::string name = b.name + "/" + std::to_string(n);
+            std::cout << std::left << std::setw(36) << name << std::right << std::setw(14) << perIter
+                      << std::setw(12) << iterations << std::setw(16) << n / perIter << std::endl;
+            if (json.is_open()) {
+                json << "{\"name\": \"" << b.name << "\", \"n\": " << n << ", \"iterations\": " << iterations
+                     << ", \"secondsPerIteration\": " << perIter << ", \"itemsPerSecond\": " << n / perIter << "}\n";
+            }
+        }
+    }
+    return 0;
+}
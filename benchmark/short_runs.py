@@ -0,0 +1,56 @@
+import sys
+import time
+sys.path = sys.path + ['../build/python/build/lib.linux-x86_64-2.7']
+from DASH import *
+
+# Per-call overhead of many short runs, as issued by advanced sampling
+# drivers.  Same LJ system as benchmark.py, run(10) called nCalls times with
+# incremental preparation on and then off.
+nCalls = 10000
+nTurns = 10
+
+def makeState():
+    state = State()
+    state.deviceManager.setDevice(0)
+    state.bounds = Bounds(state, lo = Vector(0, 0, 0), hi = Vector(55.12934875488, 55.12934875488, 55.12934875488))
+    state.rCut = 3.0
+    state.padding = 0.6
+    state.periodicInterval = 7
+    state.shoutEvery = 1000000
+
+    state.atomParams.addSpecies(handle='spc1', mass=1, atomicNum=1)
+    nonbond = FixLJCut(state, 'cut')
+    nonbond.setParameter('sig', 'spc1', 'spc1', 1)
+    nonbond.setParameter('eps', 'spc1', 'spc1', 1)
+    state.activateFix(nonbond)
+
+    f = open('init.xml').readlines()
+    for i in range(len(f)):
+        bits = [float(x) for x in f[i].split()]
+        state.addAtom('spc1', Vector(bits[0], bits[1], bits[2]))
+
+    InitializeAtoms.initTemp(state, 'all', 1.2)
+    fixNVT = FixNVTRescale(state, 'temp', 'all', 1.2)
+    state.activateFix(fixNVT)
+    return state
+
+def timeShortRuns(incremental):
+    state = makeState()
+    state.incrementalPrepare = incremental
+    integVerlet = IntegratorVerlet(state)
+    integVerlet.run(nTurns) #first run always does a full prepare
+    start = time.time()
+    for i in range(nCalls):
+        integVerlet.run(nTurns)
+    elapsed = time.time() - start
+
+    startLong = time.time()
+    integVerlet.run(nCalls * nTurns)
+    elapsedLong = time.time() - startLong
+
+    overhead = (elapsed - elapsedLong) / nCalls
+    print 'incremental %s: %d x run(%d) took %f s, one run(%d) took %f s' % (incremental, nCalls, nTurns, elapsed, nCalls * nTurns, elapsedLong)
+    print '    per-call overhead %f ms, full prepares %d' % (overhead * 1000, state.fullPrepareCount)
+
+timeShortRuns(True)
+timeShortRuns(False)
@@ -19,6 +19,10 @@ using namespace std;
 #include "Bounds.h"
 #include "Group.h"
 #include "includeFixes.h"
+#include "CVDistance.h"
+#include "CVAngle.h"
+#include "CVCoordination.h"
+#include "CVRMSD.h"
 #include "IntegratorVerlet.h"
 #include "IntegratorRelax.h"
 #include "IntegratorGradientDescent.h"
@@ -52,22 +56,27 @@ BOOST_PYTHON_MODULE(DASH) {
     export_FixBondHarmonic();
     export_FixBondQuartic();
     export_FixBondFENE();
+    export_FixBondTabulated();
     export_BondHarmonic();
     export_BondQuartic();
     export_BondFENE();
+    export_BondTabulated();
     
     export_FixAngleHarmonic();
     export_FixAngleCHARMM();
     export_FixAngleCosineDelta();
+    export_FixAngleTabulated();
     export_AngleHarmonic();
     export_AngleCHARMM();
     export_AngleCosineDelta();
+    export_AngleTabulated();
 
     export_FixImproperHarmonic();
     export_FixImproperCVFF();
     export_Impropers();
     export_FixDihedralOPLS();
     export_FixDihedralCHARMM();
+    export_FixDihedralTabulated();
     export_Dihedrals();
     export_FixWall();
     export_FixWallHarmonic();
@@ -88,7 +97,9 @@ BOOST_PYTHON_MODULE(DASH) {
     export_FixLJCut(); //make there be a pair base class in boost!
     export_FixLJCutFS();
     export_FixLJCHARMM();
+    export_FixLJCutSoftCore();
     export_FixTICG();
+    export_FixPairTabulated();
     export_FixWCA();
     
     export_FixCharge();
@@ -103,6 +114,13 @@ BOOST_PYTHON_MODULE(DASH) {
     export_FixPressureBerendsen();
 
     export_FixRingPolyPot();
+    export_CollectiveVariable();
+    export_CVDistance();
+    export_CVAngle();
+    export_CVCoordination();
+    export_CVRMSD();
+    export_FixCVHarmonic();
+    export_FixCVMetadynamics();
 
     export_AtomParams();
     export_DataManager();
@@ -117,6 +135,8 @@ BOOST_PYTHON_MODULE(DASH) {
     export_State(); 	
     //export_GridGPU(); 	
     export_DeviceManager();
+    export_NeighborListStats();
+    export_SkinController();
     export_DataSetUser();
 
 }
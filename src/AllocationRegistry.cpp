@@ -0,0 +1,183 @@
+#include "AllocationRegistry.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "Logging.h"
+
+namespace {
+    thread_local std::vector<std::string> scopeStack;
+    const std::string noOwner;
+}
+
+AllocationRegistry &AllocationRegistry::instance() {
+    //never destroyed, so arrays freed during static destruction can still report
+    static AllocationRegistry *registry = new AllocationRegistry();
+    return *registry;
+}
+
+int AllocationRegistry::ownerIdx(const std::string &name) {
+    const std::string &owner = name.size() ? name : std::string("unattributed");
+    for (int i=0; i<ownerNames.size(); i++) {
+        if (ownerNames[i] == owner) {
+            return i;
+        }
+    }
+    ownerNames.push_back(owner);
+    owners.push_back(Usage());
+    return owners.size() - 1;
+}
+
+void AllocationRegistry::charge(int owner, size_t bytes, bool isDevice) {
+    for (Usage *u : {&owners[owner], &total}) {
+        if (isDevice) {
+            u->deviceBytes += bytes;
+            u->peakDeviceBytes = std::max(u->peakDeviceBytes, u->deviceBytes);
+        } else {
+            u->hostBytes += bytes;
+            u->peakHostBytes = std::max(u->peakHostBytes, u->hostBytes);
+        }
+        u->allocations++;
+        u->allocatedBytes += bytes;
+    }
+}
+
+void AllocationRegistry::release(int owner, size_t bytes, bool isDevice) {
+    for (Usage *u : {&owners[owner], &total}) {
+        if (isDevice) {
+            u->deviceBytes -= bytes;
+        } else {
+            u->hostBytes -= bytes;
+        }
+        u->frees++;
+    }
+}
+
+void AllocationRegistry::deviceAllocated(const void *ptr, size_t bytes) {
+    if (ptr == nullptr or bytes == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Record r;
+    r.owner = ownerIdx(AllocationScope::current());
+    r.bytes = bytes;
+    device[ptr] = r;
+    charge(r.owner, bytes, true);
+}
+
+void AllocationRegistry::deviceFreed(const void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = device.find(ptr);
+    if (it != device.end()) {
+        release(it->second.owner, it->second.bytes, true);
+        device.erase(it);
+    }
+}
+
+void AllocationRegistry::hostResized(const void *key, size_t bytes) {
+    const std::string &scope = AllocationScope::current();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = host.find(key);
+    if (it == host.end()) {
+        if (bytes) {
+            Record r;
+            r.owner = ownerIdx(scope);
+            r.bytes = bytes;
+            host[key] = r;
+            charge(r.owner, bytes, false);
+        }
+        return;
+    }
+    Record &r = it->second;
+    int owner = scope.size() ? ownerIdx(scope) : r.owner;
+    if (r.bytes == bytes and r.owner == owner) {
+        return;
+    }
+    release(r.owner, r.bytes, false);
+    if (bytes) {
+        r.owner = owner;
+        r.bytes = bytes;
+        charge(r.owner, bytes, false);
+    } else {
+        host.erase(it);
+    }
+}
+
+void AllocationRegistry::beginRun() {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto reset = [] (Usage &u) {
+        u.peakHostBytes = u.hostBytes;
+        u.peakDeviceBytes = u.deviceBytes;
+        u.allocations = 0;
+        u.frees = 0;
+        u.allocatedBytes = 0;
+    };
+    reset(total);
+    for (Usage &u : owners) {
+        reset(u);
+    }
+}
+
+std::map<std::string, AllocationRegistry::Usage> AllocationRegistry::usage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, Usage> byOwner;
+    for (int i=0; i<owners.size(); i++) {
+        byOwner[ownerNames[i]] = owners[i];
+    }
+    byOwner["total"] = total;
+    return byOwner;
+}
+
+std::string AllocationRegistry::summary() {
+    std::map<std::string, Usage> byOwner = usage();
+    std::vector<std::pair<std::string, Usage> > sorted(byOwner.begin(), byOwner.end());
+    std::sort(sorted.begin(), sorted.end(), [] (const std::pair<std::string, Usage> &a,
+                                                const std::pair<std::string, Usage> &b) {
+        return a.second.deviceBytes > b.second.deviceBytes;
+    });
+    std::string out;
+    char line[256];
+    snprintf(line, sizeof(line), "%-32s %12s %12s %12s %12s\n", "owner", "device MB", "peak MB", "host MB", "peak MB");
+    out += line;
+    for (auto &entry : sorted) {
+        const Usage &u = entry.second;
+        snprintf(line, sizeof(line), "%-32s %12.2f %12.2f %12.2f %12.2f\n", entry.first.c_str(),
+                 u.deviceBytes / 1048576.0, u.peakDeviceBytes / 1048576.0,
+                 u.hostBytes / 1048576.0, u.peakHostBytes / 1048576.0);
+        out += line;
+    }
+    return out;
+}
+
+AllocationScope::AllocationScope(const std::string &owner) {
+    scopeStack.push_back(owner);
+}
+
+AllocationScope::~AllocationScope() {
+    scopeStack.pop_back();
+}
+
+const std::string &AllocationScope::current() {
+    return scopeStack.size() ? scopeStack.back() : noOwner;
+}
+
+cudaError_t trackedCudaMalloc(void **ptr, size_t bytes) {
+    cudaError_t err = cudaMalloc(ptr, bytes);
+    if (err == cudaSuccess) {
+        AllocationRegistry::instance().deviceAllocated(*ptr, bytes);
+    } else if (err == cudaErrorMemoryAllocation) {
+        const std::string &owner = AllocationScope::current();
+        mdMessage("Could not allocate %zu bytes of device memory for %s.  Memory in use:\n%s",
+                  bytes, owner.size() ? owner.c_str() : "unattributed",
+                  AllocationRegistry::instance().summary().c_str());
+    }
+    return err;
+}
+
+cudaError_t trackedCudaFree(void *ptr) {
+    AllocationRegistry::instance().deviceFreed(ptr);
+    return cudaFree(ptr);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef ALLOCATIONREGISTRY_H
+#define ALLOCATIONREGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+//! Accounts for host and device memory by owner
+/*!
+ * GPUArrays report their device allocations and the size of their host
+ * mirrors here, as do fixes which call cudaMalloc themselves (through
+ * trackedCudaMalloc).  Each allocation is charged to the owner named by the
+ * innermost AllocationScope on the allocating thread, or to "unattributed" if
+ * there is none; the integrator opens scopes for atom data, the grid, each
+ * fix and data recording while preparing a run.
+ *
+ * Host mirrors are std::vectors which the code resizes freely, so their size
+ * is re-read whenever the array changes size or copies to or from the
+ * device, rather than tracked through an allocator.
+ *
+ * There is one registry per process, since arrays do not know which State
+ * they belong to.
+ */
+class AllocationRegistry {
+public:
+    class Usage {
+    public:
+        size_t hostBytes;
+        size_t deviceBytes;
+        size_t peakHostBytes;   //!< Highest hostBytes since beginRun
+        size_t peakDeviceBytes; //!< Highest deviceBytes since beginRun
+        int64_t allocations;    //!< Allocations and resizes since beginRun
+        int64_t frees;          //!< Frees since beginRun
+        size_t allocatedBytes;  //!< Total bytes allocated since beginRun
+        Usage() : hostBytes(0), deviceBytes(0), peakHostBytes(0), peakDeviceBytes(0),
+                  allocations(0), frees(0), allocatedBytes(0) {}
+    };
+
+    static AllocationRegistry &instance();
+
+    void deviceAllocated(const void *ptr, size_t bytes);
+    void deviceFreed(const void *ptr);
+
+    //! Record the current size of the host storage identified by key
+    /*!
+     * A size of zero removes the entry.  The storage keeps its owner unless
+     * it changes size inside an AllocationScope.
+     */
+    void hostResized(const void *key, size_t bytes);
+    void hostFreed(const void *key) {
+        hostResized(key, 0);
+    }
+
+    //! Reset high-water marks to current usage and zero the churn counters
+    void beginRun();
+
+    //! Usage by owner, plus a "total" entry
+    std::map<std::string, Usage> usage();
+
+    //! Human-readable table of usage, largest device footprint first
+    std::string summary();
+
+private:
+    class Record {
+    public:
+        int owner;
+        size_t bytes;
+    };
+    std::mutex mutex;
+    std::vector<std::string> ownerNames;
+    std::vector<Usage> owners;
+    Usage total;
+    std::unordered_map<const void *, Record> device;
+    std::unordered_map<const void *, Record> host;
+
+    AllocationRegistry() {}
+    int ownerIdx(const std::string &name);
+    void charge(int owner, size_t bytes, bool isDevice);
+    void release(int owner, size_t bytes, bool isDevice);
+};
+
+//! Charges allocations made on this thread during its lifetime to owner
+class AllocationScope {
+public:
+    explicit AllocationScope(const std::string &owner);
+    ~AllocationScope();
+    //! Innermost owner on this thread, or an empty string if none
+    static const std::string &current();
+};
+
+//! cudaMalloc, recorded with the AllocationRegistry
+/*!
+ * If the allocation fails for lack of memory, the registry's summary is
+ * printed before the error is returned.
+ */
+cudaError_t trackedCudaMalloc(void **ptr, size_t bytes);
+
+//! cudaFree for memory from trackedCudaMalloc
+cudaError_t trackedCudaFree(void *ptr);
+
+#endif
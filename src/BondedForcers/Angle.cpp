@@ -186,3 +186,48 @@ void export_AngleCosineDelta() {
 
     ;
 }
+
+//angle tabulated
+AngleTabulated::AngleTabulated(Atom *a, Atom *b, Atom *c, int type_) {
+    ids[0] = a->id;
+    ids[1] = b->id;
+    ids[2] = c->id;
+    type = type_;
+    x0 = 0;
+    invDx = 0;
+    offset = 0;
+    nSegments = 0;
+    table = -1;
+}
+
+AngleTabulatedType::AngleTabulatedType(AngleTabulated *angle) {
+    x0 = angle->x0;
+    invDx = angle->invDx;
+    offset = angle->offset;
+    nSegments = angle->nSegments;
+    table = angle->table;
+}
+
+std::string AngleTabulatedType::getInfoString() {
+  std::stringstream ss;
+  ss << " nSegments='" << nSegments;
+  return ss.str();
+}
+
+std::string AngleTabulated::getInfoString() {
+  std::stringstream ss;
+  ss << "<member type='" << type << "' atomID_a='" << ids[0] << "' atomID_b='" << ids[1] << "' atomID_c='" << ids[2] << "'/>\n";
+  return ss.str();
+}
+
+bool AngleTabulatedType::operator==(const AngleTabulatedType &other) const {
+    return x0 == other.x0 and invDx == other.invDx and offset == other.offset and nSegments == other.nSegments
+           and table == other.table;
+}
+void export_AngleTabulated() {
+    boost::python::class_<AngleTabulated, SHARED(AngleTabulated)> ( "AngleTabulated", boost::python::init<>())
+        .def_readwrite("type", &AngleTabulated::type)
+        .def_readonly("ids", &AngleTabulated::ids)
+
+    ;
+}
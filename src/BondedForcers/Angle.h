@@ -10,9 +10,11 @@
 class AngleHarmonic;
 class AngleCHARMM;
 class AngleCosineDelta;
+class AngleTabulated;
 void export_AngleHarmonic();
 void export_AngleCHARMM();
 void export_AngleCosineDelta();
+void export_AngleTabulated();
 
 class Angle {
     public:
@@ -131,6 +133,41 @@ namespace std {
     };
 }
 
+//angle tabulated
+class AngleTabulatedType {
+public:
+    float x0;      //!< Angle of the first table point
+    float invDx;   //!< Inverse table spacing
+    int offset;    //!< Index of the first segment in the fix's spline coefficients
+    int nSegments; //!< Number of segments in the table
+    int table;     //!< Index of the type's table in the fix, see FixAngleTabulated
+    AngleTabulatedType(AngleTabulated *);
+    AngleTabulatedType(){};
+    bool operator==(const AngleTabulatedType &) const;
+	std::string getInfoString();
+};
+
+class AngleTabulated : public Angle, public AngleTabulatedType {
+public:
+    AngleTabulated(Atom *a, Atom *b, Atom *c, int type_);
+    AngleTabulated(){};
+	std::string getInfoString();
+};
+
+//for forcer maps
+namespace std {
+    template<> struct hash<AngleTabulatedType> {
+        size_t operator() (AngleTabulatedType const& ang) const {
+            size_t seed = 0;
+            boost::hash_combine(seed, ang.x0);
+            boost::hash_combine(seed, ang.invDx);
+            boost::hash_combine(seed, ang.offset);
+            boost::hash_combine(seed, ang.nSegments);
+            boost::hash_combine(seed, ang.table);
+            return seed;
+        }
+    };
+}
 
 
 // lets us store a list of vectors to any kind of angles we want
@@ -138,6 +175,7 @@ typedef boost::variant<
 	AngleHarmonic, 
 	AngleCHARMM, 
     AngleCosineDelta,
+    AngleTabulated,
     Angle	
 > AngleVariant;
 #endif
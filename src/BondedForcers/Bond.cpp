@@ -172,3 +172,40 @@ void export_BondFENE() {
         .def_readwrite("sig", &BondFENE::sig)
     ;
 }
+
+
+//bond tabulated
+bool BondTabulatedType::operator==(const BondTabulatedType &other) const {
+    return x0 == other.x0 and invDx == other.invDx and offset == other.offset and nSegments == other.nSegments
+           and table == other.table;
+}
+
+BondTabulated::BondTabulated(Atom *a, Atom *b, int type_) {
+    ids[0] = a->id;
+    ids[1] = b->id;
+    type = type_;
+    x0 = 0;
+    invDx = 0;
+    offset = 0;
+    nSegments = 0;
+    table = -1;
+}
+
+std::string BondTabulatedType::getInfoString() {
+  std::stringstream ss;
+  ss << " nSegments='" << nSegments;
+  return ss.str();
+}
+
+std::string BondTabulated::getInfoString() {
+  std::stringstream ss;
+  ss << "<member type='" << type << "' atomID_a='" << ids[0] <<  "' atomID_b='" << ids[1] << "'/>\n";
+  return ss.str();
+}
+
+void export_BondTabulated() {
+    py::class_<BondTabulated,SHARED(BondTabulated)> ( "BondTabulated", py::init<>())
+        .def_readonly("ids", &BondTabulated::ids)
+        .def_readwrite("type", &BondTabulated::type)
+    ;
+}
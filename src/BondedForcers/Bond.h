@@ -168,6 +168,52 @@ void export_BondFENE();
 //end bond fene classes
 
 
+//bond tabulated classes
+//
+class BondTabulatedType {
+public:
+    float x0;      //!< Bond length of the first table point
+    float invDx;   //!< Inverse table spacing
+    int offset;    //!< Index of the first segment in the fix's spline coefficients
+    int nSegments; //!< Number of segments in the table
+    int table;     //!< Index of the type's table in the fix, see FixBondTabulated
+    BondTabulatedType(){};
+    bool operator==(const BondTabulatedType &) const;
+    std::string getInfoString();
+};
+//
+//for forcer maps
+namespace std {
+    template<> struct hash<BondTabulatedType> {
+        size_t operator() (BondTabulatedType const& bond) const {
+            size_t seed = 0;
+            boost::hash_combine(seed, bond.x0);
+            boost::hash_combine(seed, bond.invDx);
+            boost::hash_combine(seed, bond.offset);
+            boost::hash_combine(seed, bond.nSegments);
+            boost::hash_combine(seed, bond.table);
+            return seed;
+        }
+    };
+}
+
+/*! \brief Bond with a tabulated potential
+ *
+ * Members only carry a type.  The type holders are set with the type's table
+ * and point at it, and FixBondTabulated fills in where its spline segments
+ * are when preparing for a run.
+ */
+class BondTabulated: public Bond, public BondTabulatedType {
+public:
+    BondTabulated(Atom *a, Atom *b, int type_);
+    BondTabulated(){};
+	std::string getInfoString();
+};
+
+void export_BondTabulated();
+//end bond tabulated classes
+
+
 
 class __align__(16) BondGPU {
     public:
@@ -184,6 +230,7 @@ typedef boost::variant<
 	BondHarmonic, 
 	BondQuartic, 
     BondFENE,
+    BondTabulated,
 	Bond
 > BondVariant;
 
@@ -46,6 +46,19 @@ DihedralCHARMM::DihedralCHARMM(double k_, int n_, double d_, int type_) {
     type = type_;
 }
 
+DihedralTabulated::DihedralTabulated(Atom *atomA, Atom *atomB, Atom *atomC, Atom *atomD, int type_) {
+    ids[0] = atomA->id;
+    ids[1] = atomB->id;
+    ids[2] = atomC->id;
+    ids[3] = atomD->id;
+    type = type_;
+    x0 = 0;
+    invDx = 0;
+    offset = 0;
+    nSegments = 0;
+    table = -1;
+}
+
 
 void Dihedral::takeIds(Dihedral *other) {
     for (int i=0; i<4; i++) {
@@ -70,6 +83,13 @@ DihedralCHARMMType::DihedralCHARMMType(DihedralCHARMM *dihedral) {
     n = dihedral->n;
     d = dihedral->d;
 }
+DihedralTabulatedType::DihedralTabulatedType(DihedralTabulated *dihedral) {
+    x0 = dihedral->x0;
+    invDx = dihedral->invDx;
+    offset = dihedral->offset;
+    nSegments = dihedral->nSegments;
+    table = dihedral->table;
+}
 
 
 std::string DihedralOPLS::getInfoString() {
@@ -97,6 +117,17 @@ std::string DihedralCHARMMType::getInfoString() {
   ss << " k='" << k << "' n='" << n << "' d='" << d;
   return ss.str();
 }
+std::string DihedralTabulated::getInfoString() {
+  std::stringstream ss;
+  ss << "<member type='" << type << "' atomID_a='" << ids[0] << "' atomID_b='" << ids[1] << "' atomID_c='" << ids[2] << "' atomID_d='" << ids[3] << "'/>\n";
+  return ss.str();
+}
+
+std::string DihedralTabulatedType::getInfoString() {
+  std::stringstream ss;
+  ss << " nSegments='" << nSegments;
+  return ss.str();
+}
 bool DihedralOPLSType::operator==(const DihedralOPLSType &other) const {
     for (int i=0; i<4; i++) {
         if (coefs[i] != other.coefs[i]) {
@@ -110,6 +141,11 @@ bool DihedralCHARMMType::operator==(const DihedralCHARMMType &other) const {
     return other.k == k and other.d == d and other.n == n;
 }
 
+bool DihedralTabulatedType::operator==(const DihedralTabulatedType &other) const {
+    return other.x0 == x0 and other.invDx == invDx and other.offset == offset and other.nSegments == nSegments
+           and other.table == table;
+}
+
 
 
 void export_Dihedrals() {
@@ -127,5 +163,10 @@ void export_Dihedrals() {
         .def_readonly("ids", &DihedralCHARMM::ids)
 
     ;
+    py::class_<DihedralTabulated, SHARED(DihedralTabulated)> ( "SimDihedralTabulated", py::init<>())
+        .def_readwrite("type", &DihedralTabulated::type)
+        .def_readonly("ids", &DihedralTabulated::ids)
+
+    ;
 
 }
@@ -10,6 +10,7 @@
 #include <array>
 class DihedralOPLS;
 class DihedralCHARMM;
+class DihedralTabulated;
 void export_Dihedrals();
 class Dihedral{
     public:
@@ -59,6 +60,26 @@ class DihedralCHARMM: public Dihedral, public DihedralCHARMMType {
 };
 
 
+class DihedralTabulatedType {
+    public:
+        float x0;      //!< Angle of the first table point
+        float invDx;   //!< Inverse table spacing
+        int offset;    //!< Index of the first segment in the fix's spline coefficients
+        int nSegments; //!< Number of segments in the table, covering one period
+        int table;     //!< Index of the type's table in the fix, see FixDihedralTabulated
+        DihedralTabulatedType(DihedralTabulated *);
+        DihedralTabulatedType(){};
+        bool operator==(const DihedralTabulatedType &) const;
+        std::string getInfoString();
+};
+
+class DihedralTabulated: public Dihedral, public DihedralTabulatedType {
+    public:
+        DihedralTabulated(Atom *atomA, Atom *atomB, Atom *atomC, Atom *atomD, int type_);
+        DihedralTabulated(){};
+        std::string getInfoString();
+};
+
 class DihedralGPU {
     public:
         int ids[4];
@@ -88,11 +109,23 @@ namespace std {
             return seed;
         }
     };
+    template<> struct hash<DihedralTabulatedType> {
+        size_t operator() (DihedralTabulatedType const& dih) const {
+            size_t seed = 0;
+            boost::hash_combine(seed, dih.x0);
+            boost::hash_combine(seed, dih.invDx);
+            boost::hash_combine(seed, dih.offset);
+            boost::hash_combine(seed, dih.nSegments);
+            boost::hash_combine(seed, dih.table);
+            return seed;
+        }
+    };
 }
 
 typedef boost::variant<
 	DihedralOPLS, 
     DihedralCHARMM,
+    DihedralTabulated,
     Dihedral	
 > DihedralVariant;
 #endif
@@ -0,0 +1,38 @@
+#include "CVAngle.h"
+#include "CollectiveVariableMath.h"
+#include "boost_for_export.h"
+#include "State.h"
+
+namespace py = boost::python;
+
+const std::string CVAngleType = "Angle";
+
+CVAngle::CVAngle(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, std::string groupC_)
+  : CVCenters(state_, CVAngleType, std::vector<std::string>({groupA_, groupB_, groupC_}))
+{
+}
+
+__global__ void compute_cv_angle(float4 *centers, BoundsGPU bounds, float *value, float4 *dValueDCenters) {
+    float3 vertex = make_float3(centers[1]);
+    float3 u = bounds.minImage(make_float3(centers[0]) - vertex);
+    float3 v = bounds.minImage(make_float3(centers[2]) - vertex);
+    float3 gradU, gradV;
+    value[0] = cvAngle(u, v, gradU, gradV);
+    dValueDCenters[0] = make_float4(gradU);
+    dValueDCenters[1] = make_float4((gradU + gradV) * -1.0f);
+    dValueDCenters[2] = make_float4(gradV);
+}
+
+void CVAngle::computeFromCenters() {
+    compute_cv_angle<<<1, 1>>>(centers.data(), state->boundsGPU, value.getDevData(), dValueDCenters.data());
+}
+
+void export_CVAngle() {
+    py::class_<CVAngle, boost::shared_ptr<CVAngle>, py::bases<CollectiveVariable>, boost::noncopyable> (
+        "CVAngle",
+        py::init<boost::shared_ptr<State>, std::string, std::string, std::string>(
+            py::args("state", "groupA", "groupB", "groupC")
+        )
+    )
+    ;
+}
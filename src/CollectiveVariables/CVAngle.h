@@ -0,0 +1,24 @@
+#pragma once
+#ifndef CVANGLE_H
+#define CVANGLE_H
+
+#include "CVCenters.h"
+
+void export_CVAngle();
+
+//! Angle A-B-C between the centers of mass of three groups, in radians
+class CVAngle : public CVCenters {
+protected:
+    void computeFromCenters();
+
+public:
+    //! Constructor
+    /*!
+     * \param groupA_ First end
+     * \param groupB_ Vertex
+     * \param groupC_ Second end
+     */
+    CVAngle(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, std::string groupC_);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "CVCenters.h"
+#include "cutils_func.h"
+#include "State.h"
+#include "helpers.h"
+
+CVCenters::CVCenters(boost::shared_ptr<State> state_, std::string type_, std::vector<std::string> groupHandles_)
+  : CollectiveVariable(state_, type_, groupHandles_)
+{
+}
+
+bool CVCenters::prepareForRun() {
+    std::vector<int> idsLoc;
+    std::vector<float> weightsLoc;
+    std::vector<int> centerIdxsLoc;
+    std::vector<int> centerStartsLoc;
+    for (int i=0; i<groupHandles.size(); i++) {
+        std::vector<int> groupIds;
+        std::vector<double> masses;
+        groupAtoms(groupHandles[i], groupIds, masses);
+        double massTotal = 0;
+        for (double mass : masses) {
+            massTotal += mass;
+        }
+        centerStartsLoc.push_back(idsLoc.size());
+        for (int j=0; j<groupIds.size(); j++) {
+            idsLoc.push_back(groupIds[j]);
+            weightsLoc.push_back(masses[j] / massTotal);
+            centerIdxsLoc.push_back(i);
+        }
+    }
+    centerStartsLoc.push_back(idsLoc.size());
+    ids = idsLoc;
+    weights = weightsLoc;
+    centerIdxs = centerIdxsLoc;
+    centerStarts = centerStartsLoc;
+    ids.dataToDevice();
+    weights.dataToDevice();
+    centerIdxs.dataToDevice();
+    centerStarts.dataToDevice();
+    centers = GPUArrayDeviceGlobal<float4>(groupHandles.size());
+    dValueDCenters = GPUArrayDeviceGlobal<float4>(groupHandles.size());
+    return CollectiveVariable::prepareForRun();
+}
+
+//one block per group
+__global__ void compute_cv_centers(int *ids, float *weights, int *centerStarts, float4 *xs, int *idToIdxs,
+                                   BoundsGPU bounds, float4 *centers, int warpSize) {
+    extern __shared__ float3 sums_shr[];
+    int center = blockIdx.x;
+    int start = centerStarts[center];
+    int end = centerStarts[center+1];
+    float3 origin = make_float3(xs[idToIdxs[ids[start]]]);
+    float3 sum = make_float3(0, 0, 0);
+    for (int i=start+threadIdx.x; i<end; i+=blockDim.x) {
+        float3 pos = make_float3(xs[idToIdxs[ids[i]]]);
+        sum += bounds.minImage(pos - origin) * weights[i];
+    }
+    sums_shr[threadIdx.x] = sum;
+    __syncthreads();
+    reduceByN<float3>(sums_shr, blockDim.x, warpSize);
+    if (threadIdx.x == 0) {
+        centers[center] = make_float4(origin + sums_shr[0]);
+    }
+}
+
+void CVCenters::compute() {
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    compute_cv_centers<<<groupHandles.size(), PERBLOCK, PERBLOCK*sizeof(float3)>>>(
+            ids.getDevData(), weights.getDevData(), centerStarts.getDevData(), gpd.xs(activeIdx),
+            gpd.idToIdxs.d_data.data(), state->boundsGPU, centers.data(), state->devManager.prop.warpSize);
+    computeFromCenters();
+}
+
+__global__ void apply_cv_center_forces(int nAtoms, int *ids, float *weights, int *centerIdxs, float4 *centers,
+                                       float4 *dValueDCenters, float *dUds, float4 *xs, float4 *fs, int *idToIdxs,
+                                       BoundsGPU bounds, Virial *virials) {
+    int idx = GETIDX();
+    if (idx < nAtoms) {
+        int center = centerIdxs[idx];
+        float3 force = make_float3(dValueDCenters[center]) * (-dUds[0] * weights[idx]);
+        int atomIdx = idToIdxs[ids[idx]];
+        //groups may share atoms
+        atomicAdd(&fs[atomIdx].x, force.x);
+        atomicAdd(&fs[atomIdx].y, force.y);
+        atomicAdd(&fs[atomIdx].z, force.z);
+        if (virials) {
+            float3 centerPos = make_float3(centers[center]);
+            float3 dr = bounds.minImage(centerPos - make_float3(centers[0]))
+                      + bounds.minImage(make_float3(xs[atomIdx]) - centerPos);
+            atomicAddVirial(virials[atomIdx], force, dr);
+        }
+    }
+}
+
+void CVCenters::applyForce(float *dUds, Virial *virials) {
+    int nAtoms = ids.size();
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    apply_cv_center_forces<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, ids.getDevData(), weights.getDevData(), centerIdxs.getDevData(),
+                                                         centers.data(), dValueDCenters.data(), dUds, gpd.xs(activeIdx),
+                                                         gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), state->boundsGPU, virials);
+}
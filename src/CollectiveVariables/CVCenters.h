@@ -0,0 +1,35 @@
+#pragma once
+#ifndef CVCENTERS_H
+#define CVCENTERS_H
+
+#include "CollectiveVariable.h"
+
+//! Base class for collective variables that are functions of the centers of mass of groups
+/*!
+ * compute() finds the center of mass of each group, each unwrapped around
+ * the group's first atom, then computeFromCenters() evaluates the variable
+ * and its gradient with respect to each center on a single thread.  The force
+ * on each atom is its share of the force on its center, m_i / M_group.  For
+ * the virial, each center is unwrapped around the first one and each atom
+ * around its center.
+ */
+class CVCenters : public CollectiveVariable {
+protected:
+    CVCenters(boost::shared_ptr<State> state_, std::string type_, std::vector<std::string> groupHandles_);
+
+    //! Set value and dValueDCenters from centers
+    virtual void computeFromCenters() = 0;
+
+public:
+    bool prepareForRun();
+    void compute();
+    void applyForce(float *dUds, Virial *virials);
+
+    GPUArrayGlobal<float> weights; //!< Mass of each atom over the mass of its group
+    GPUArrayGlobal<int> centerIdxs; //!< Group of each atom
+    GPUArrayGlobal<int> centerStarts; //!< Index in ids of the first atom of each group, and the total count
+    GPUArrayDeviceGlobal<float4> centers; //!< Center of mass of each group
+    GPUArrayDeviceGlobal<float4> dValueDCenters; //!< Gradient of the variable with respect to each center
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "CVCoordination.h"
+#include "CollectiveVariableMath.h"
+#include "boost_for_export.h"
+#include "cutils_func.h"
+#include "State.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+
+const std::string CVCoordinationType = "Coordination";
+
+CVCoordination::CVCoordination(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, double r0_, int n_, int m_)
+  : CollectiveVariable(state_, CVCoordinationType, std::vector<std::string>({groupA_, groupB_})), r0(r0_), n(n_), m(m_), nA(0), nB(0)
+{
+}
+
+bool CVCoordination::prepareForRun() {
+    mdAssert(r0 > 0, "Coordination number needs a positive r0, not %f", r0);
+    mdAssert(n > 0 and m > n, "Coordination number needs 0 < n < m, not n = %d and m = %d", n, m);
+    std::vector<int> idsA, idsB;
+    std::vector<double> masses;
+    groupAtoms(groupHandles[0], idsA, masses);
+    groupAtoms(groupHandles[1], idsB, masses);
+    nA = idsA.size();
+    nB = idsB.size();
+    std::vector<int> idsLoc = idsA;
+    idsLoc.insert(idsLoc.end(), idsB.begin(), idsB.end());
+    ids = idsLoc;
+    ids.dataToDevice();
+    gradients = GPUArrayDeviceGlobal<float4>(nA + nB);
+    return CollectiveVariable::prepareForRun();
+}
+
+//one thread per pair of an atom of A and an atom of B
+__global__ void compute_cv_coordination(int nA, int nB, bool sameGroup, int *ids, float4 *xs, int *idToIdxs, BoundsGPU bounds,
+                                        float r0, int n, int m, float *value, float4 *gradients, int warpSize) {
+    extern __shared__ float vals_shr[];
+    int idx = GETIDX();
+    float val = 0;
+    if (idx < nA * nB) {
+        int i = idx / nB;
+        int j = nA + idx % nB;
+        int idA = ids[i];
+        int idB = ids[j];
+        if (sameGroup ? idA < idB : idA != idB) {
+            float3 dr = bounds.minImage(make_float3(xs[idToIdxs[idB]]) - make_float3(xs[idToIdxs[idA]]));
+            float r = length(dr);
+            float dfdr;
+            val = cvSwitching(r, r0, n, m, dfdr);
+            float3 grad = dr * (dfdr / r);
+            atomicAdd(&gradients[j].x, grad.x);
+            atomicAdd(&gradients[j].y, grad.y);
+            atomicAdd(&gradients[j].z, grad.z);
+            atomicAdd(&gradients[i].x, -grad.x);
+            atomicAdd(&gradients[i].y, -grad.y);
+            atomicAdd(&gradients[i].z, -grad.z);
+        }
+    }
+    vals_shr[threadIdx.x] = val;
+    __syncthreads();
+    reduceByN<float>(vals_shr, blockDim.x, warpSize);
+    if (threadIdx.x == 0) {
+        atomicAdd(value, vals_shr[0]);
+    }
+}
+
+void CVCoordination::compute() {
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    value.d_data.memset(0);
+    gradients.memset(0);
+    compute_cv_coordination<<<NBLOCK(nA * nB), PERBLOCK, PERBLOCK*sizeof(float)>>>(
+            nA, nB, groupHandles[0] == groupHandles[1], ids.getDevData(), gpd.xs(activeIdx), gpd.idToIdxs.d_data.data(),
+            state->boundsGPU, r0, n, m, value.getDevData(), gradients.data(), state->devManager.prop.warpSize);
+}
+
+void CVCoordination::applyForce(float *dUds, Virial *virials) {
+    applyAtomGradients(dUds, virials);
+}
+
+void export_CVCoordination() {
+    py::class_<CVCoordination, boost::shared_ptr<CVCoordination>, py::bases<CollectiveVariable>, boost::noncopyable> (
+        "CVCoordination",
+        py::init<boost::shared_ptr<State>, std::string, std::string, double, py::optional<int, int> >(
+            py::args("state", "groupA", "groupB", "r0", "n", "m")
+        )
+    )
+    .def_readwrite("r0", &CVCoordination::r0)
+    .def_readwrite("n", &CVCoordination::n)
+    .def_readwrite("m", &CVCoordination::m)
+    ;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef CVCOORDINATION_H
+#define CVCOORDINATION_H
+
+#include "CollectiveVariable.h"
+
+void export_CVCoordination();
+
+//! Coordination number of group A by group B, a sum of switching functions over pairs of their atoms
+/*!
+ * \f[
+ * s = \sum_{i \in A} \sum_{j \in B} \frac{1 - (r_{ij}/r_0)^n}{1 - (r_{ij}/r_0)^m}
+ * \f]
+ * An atom is never paired with itself, and if A and B are the same group
+ * each pair is counted once.  Every pair is evaluated each turn, one thread
+ * per pair, so the cost grows with the product of the group sizes.
+ */
+class CVCoordination : public CollectiveVariable {
+public:
+    //! Constructor
+    /*!
+     * \param groupA_ First group
+     * \param groupB_ Second group
+     * \param r0_ Distance at which the switching function is n/m
+     * \param n_ Exponent of the numerator
+     * \param m_ Exponent of the denominator
+     */
+    CVCoordination(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, double r0_, int n_=6, int m_=12);
+
+    bool prepareForRun();
+    void compute();
+    void applyForce(float *dUds, Virial *virials);
+
+    double r0;
+    int n;
+    int m;
+    int nA; //!< Atoms of A, which come first in ids
+    int nB; //!< Atoms of B
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include "CVDistance.h"
+#include "boost_for_export.h"
+#include "State.h"
+
+namespace py = boost::python;
+
+const std::string CVDistanceType = "Distance";
+
+CVDistance::CVDistance(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, Vector dimensions_)
+  : CVCenters(state_, CVDistanceType, std::vector<std::string>({groupA_, groupB_})), dimensions(dimensions_)
+{
+}
+
+__global__ void compute_cv_distance(float4 *centers, float3 dims, BoundsGPU bounds, float *value, float4 *dValueDCenters) {
+    float3 dr = bounds.minImage(make_float3(centers[1]) - make_float3(centers[0])) * dims;
+    float len = length(dr);
+    float3 grad = len > 0 ? dr / len : make_float3(0, 0, 0);
+    value[0] = len;
+    dValueDCenters[0] = make_float4(grad * -1.0f);
+    dValueDCenters[1] = make_float4(grad);
+}
+
+void CVDistance::computeFromCenters() {
+    compute_cv_distance<<<1, 1>>>(centers.data(), dimensions.asFloat3(), state->boundsGPU, value.getDevData(), dValueDCenters.data());
+}
+
+void export_CVDistance() {
+    py::class_<CVDistance, boost::shared_ptr<CVDistance>, py::bases<CollectiveVariable>, boost::noncopyable> (
+        "CVDistance",
+        py::init<boost::shared_ptr<State>, std::string, std::string, py::optional<Vector> >(
+            py::args("state", "groupA", "groupB", "dimensions")
+        )
+    )
+    .def_readwrite("dimensions", &CVDistance::dimensions)
+    ;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef CVDISTANCE_H
+#define CVDISTANCE_H
+
+#include "CVCenters.h"
+#include "Vector.h"
+
+void export_CVDistance();
+
+//! Distance between the centers of mass of two groups
+/*!
+ * With single-atom groups this is the distance between two atoms.
+ * dimensions masks the separation vector, so Vector(0, 0, 1) gives the
+ * separation along z.
+ */
+class CVDistance : public CVCenters {
+protected:
+    void computeFromCenters();
+
+public:
+    //! Constructor
+    /*!
+     * \param groupA_ First group
+     * \param groupB_ Second group
+     * \param dimensions_ Components of the separation that count
+     */
+    CVDistance(boost::shared_ptr<State> state_, std::string groupA_, std::string groupB_, Vector dimensions_=Vector(1, 1, 1));
+
+    Vector dimensions;
+};
+
+#endif
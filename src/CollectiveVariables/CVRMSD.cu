@@ -0,0 +1,155 @@
+#include "CVRMSD.h"
+#include "CollectiveVariableMath.h"
+#include "boost_for_export.h"
+#include "cutils_func.h"
+#include "State.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+
+const std::string CVRMSDType = "RMSD";
+
+CVRMSD::CVRMSD(boost::shared_ptr<State> state_, std::string groupHandle_)
+  : CollectiveVariable(state_, CVRMSDType, std::vector<std::string>({groupHandle_}))
+{
+    updateReference();
+}
+
+void CVRMSD::updateReference() {
+    uint32_t tag = state->groupTagFromHandle(groupHandles[0]);
+    std::vector<int> groupIds;
+    std::vector<Vector> positions;
+    for (Atom &a : state->atoms) {
+        if (state->atomInGroup(a, tag)) {
+            //unwrapped around the group's first atom, as on the device
+            Vector origin = positions.size() ? positions[0] : a.pos;
+            groupIds.push_back(a.id);
+            positions.push_back(origin + state->bounds.minImage(a.pos - origin));
+        }
+    }
+    mdAssert(groupIds.size() >= 3, "RMSD of group %s needs at least three atoms", groupHandles[0].c_str());
+    Vector center(0, 0, 0);
+    for (Vector &pos : positions) {
+        center += pos / (double) positions.size();
+    }
+    std::vector<float4> refsLoc;
+    for (Vector &pos : positions) {
+        refsLoc.push_back(make_float4((pos - center).asFloat3()));
+    }
+    ids = groupIds;
+    refs = refsLoc;
+    ids.dataToDevice();
+    refs.dataToDevice();
+}
+
+bool CVRMSD::prepareForRun() {
+    gradients = GPUArrayDeviceGlobal<float4>(ids.size());
+    return CollectiveVariable::prepareForRun();
+}
+
+//single block.  Reduces the center, then the correlation matrix and the sum of squares, then writes each atom's gradient
+__global__ void compute_cv_rmsd(int nAtoms, int *ids, float4 *refs, float4 *xs, int *idToIdxs, BoundsGPU bounds,
+                                float *value, float4 *gradients, int warpSize) {
+    extern __shared__ float sums_shr[];
+    __shared__ float rot_shr[9];
+    __shared__ float rmsd_shr;
+    float3 origin = make_float3(xs[idToIdxs[ids[0]]]);
+    float3 sum = make_float3(0, 0, 0);
+    for (int i=threadIdx.x; i<nAtoms; i+=blockDim.x) {
+        float3 pos = make_float3(xs[idToIdxs[ids[i]]]);
+        sum += bounds.minImage(pos - origin);
+    }
+    sums_shr[threadIdx.x] = sum.x;
+    sums_shr[blockDim.x + threadIdx.x] = sum.y;
+    sums_shr[2*blockDim.x + threadIdx.x] = sum.z;
+    __syncthreads();
+    for (int k=0; k<3; k++) {
+        reduceByN<float>(sums_shr + k*blockDim.x, blockDim.x, warpSize);
+    }
+    __syncthreads();
+    float3 center = make_float3(sums_shr[0], sums_shr[blockDim.x], sums_shr[2*blockDim.x]) / (float) nAtoms;
+    __syncthreads();
+
+    float parts[10];
+    for (int k=0; k<10; k++) {
+        parts[k] = 0;
+    }
+    for (int i=threadIdx.x; i<nAtoms; i+=blockDim.x) {
+        float3 pos = make_float3(xs[idToIdxs[ids[i]]]);
+        float3 x = bounds.minImage(pos - origin) - center;
+        float3 y = make_float3(refs[i]);
+        float xs3[3] = {x.x, x.y, x.z};
+        float ys3[3] = {y.x, y.y, y.z};
+        for (int a=0; a<3; a++) {
+            for (int b=0; b<3; b++) {
+                parts[3*a + b] += ys3[a] * xs3[b];
+            }
+        }
+        parts[9] += dot(x, x) + dot(y, y);
+    }
+    for (int k=0; k<10; k++) {
+        sums_shr[k*blockDim.x + threadIdx.x] = parts[k];
+    }
+    __syncthreads();
+    for (int k=0; k<10; k++) {
+        reduceByN<float>(sums_shr + k*blockDim.x, blockDim.x, warpSize);
+    }
+    __syncthreads();
+    if (threadIdx.x == 0) {
+        double S[3][3];
+        for (int a=0; a<3; a++) {
+            for (int b=0; b<3; b++) {
+                S[a][b] = sums_shr[(3*a + b)*blockDim.x];
+            }
+        }
+        double rot[3][3];
+        double msd = cvRMSDFit(S, sums_shr[9*blockDim.x], nAtoms, rot);
+        for (int a=0; a<3; a++) {
+            for (int b=0; b<3; b++) {
+                rot_shr[3*a + b] = rot[a][b];
+            }
+        }
+        rmsd_shr = sqrt(msd);
+        value[0] = rmsd_shr;
+    }
+    __syncthreads();
+
+    //d rmsd / dx_i = (x_i - R y_i) / (N rmsd), as the fit is stationary in rotation and translation
+    float rmsd = rmsd_shr;
+    for (int i=threadIdx.x; i<nAtoms; i+=blockDim.x) {
+        float3 grad = make_float3(0, 0, 0);
+        if (rmsd > 1e-6f) {
+            float3 pos = make_float3(xs[idToIdxs[ids[i]]]);
+            float3 x = bounds.minImage(pos - origin) - center;
+            float3 y = make_float3(refs[i]);
+            float3 fitted = make_float3(rot_shr[0]*y.x + rot_shr[1]*y.y + rot_shr[2]*y.z,
+                                        rot_shr[3]*y.x + rot_shr[4]*y.y + rot_shr[5]*y.z,
+                                        rot_shr[6]*y.x + rot_shr[7]*y.y + rot_shr[8]*y.z);
+            grad = (x - fitted) / (nAtoms * rmsd);
+        }
+        gradients[i] = make_float4(grad);
+    }
+}
+
+void CVRMSD::compute() {
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    compute_cv_rmsd<<<1, PERBLOCK, 10*PERBLOCK*sizeof(float)>>>(
+            ids.size(), ids.getDevData(), refs.getDevData(), gpd.xs(activeIdx), gpd.idToIdxs.d_data.data(),
+            state->boundsGPU, value.getDevData(), gradients.data(), state->devManager.prop.warpSize);
+}
+
+void CVRMSD::applyForce(float *dUds, Virial *virials) {
+    applyAtomGradients(dUds, virials);
+}
+
+void export_CVRMSD() {
+    py::class_<CVRMSD, boost::shared_ptr<CVRMSD>, py::bases<CollectiveVariable>, boost::noncopyable> (
+        "CVRMSD",
+        py::init<boost::shared_ptr<State>, std::string>(
+            py::args("state", "groupHandle")
+        )
+    )
+    .def("updateReference", &CVRMSD::updateReference)
+    ;
+}
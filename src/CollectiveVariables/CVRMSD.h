@@ -0,0 +1,35 @@
+#pragma once
+#ifndef CVRMSD_H
+#define CVRMSD_H
+
+#include "CollectiveVariable.h"
+
+void export_CVRMSD();
+
+//! Root mean square deviation of a group from reference positions after optimal superposition
+/*!
+ * The reference is the group's positions when the variable is created or
+ * updateReference() is called.  Each turn a single block finds the
+ * correlation matrix of the centered positions with the centered reference,
+ * and the best rotation comes from the largest eigenvalue of a 4x4 quaternion
+ * matrix, so the cost is one pass over the group and no host work.
+ */
+class CVRMSD : public CollectiveVariable {
+public:
+    //! Constructor
+    /*!
+     * \param groupHandle_ Group whose deviation is measured
+     */
+    CVRMSD(boost::shared_ptr<State> state_, std::string groupHandle_);
+
+    //! Take the group's current positions as the reference
+    void updateReference();
+
+    bool prepareForRun();
+    void compute();
+    void applyForce(float *dUds, Virial *virials);
+
+    GPUArrayGlobal<float4> refs; //!< Centered reference positions, in the order of ids
+};
+
+#endif
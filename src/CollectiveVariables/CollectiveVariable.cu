@@ -0,0 +1,86 @@
+#include "CollectiveVariable.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Logging.h"
+#include "helpers.h"
+
+namespace py = boost::python;
+
+CollectiveVariable::CollectiveVariable(boost::shared_ptr<State> state_, std::string type_, std::vector<std::string> groupHandles_)
+  : state(state_.get()), type(type_), groupHandles(groupHandles_), value(GPUArrayGlobal<float>(1)), prepared(false)
+{
+    for (std::string &handle : groupHandles) {
+        mdAssert(state->groupTags.find(handle) != state->groupTags.end(), "Collective variable %s uses group %s, which does not exist", type.c_str(), handle.c_str());
+    }
+}
+
+void CollectiveVariable::groupAtoms(std::string groupHandle, std::vector<int> &groupIds, std::vector<double> &masses) {
+    uint32_t tag = state->groupTagFromHandle(groupHandle);
+    groupIds.clear();
+    masses.clear();
+    for (Atom &a : state->atoms) {
+        if (state->atomInGroup(a, tag)) {
+            groupIds.push_back(a.id);
+            masses.push_back(a.mass);
+        }
+    }
+    mdAssert(groupIds.size(), "Group %s of collective variable %s has no atoms", groupHandle.c_str(), type.c_str());
+}
+
+bool CollectiveVariable::prepareForRun() {
+    mdAssert(state->nPerRingPoly == 1, "Collective variables do not support path integral simulations");
+    prepared = true;
+    return prepared;
+}
+
+__global__ void apply_cv_gradients(int nAtoms, int *ids, float4 *gradients, float *dUds, float4 *xs, float4 *fs,
+                                   int *idToIdxs, BoundsGPU bounds, Virial *virials) {
+    int idx = GETIDX();
+    if (idx < nAtoms) {
+        float3 force = make_float3(gradients[idx]) * -dUds[0];
+        int atomIdx = idToIdxs[ids[idx]];
+        //an atom can appear more than once, as in a coordination number of a group with itself
+        atomicAdd(&fs[atomIdx].x, force.x);
+        atomicAdd(&fs[atomIdx].y, force.y);
+        atomicAdd(&fs[atomIdx].z, force.z);
+        if (virials) {
+            //unwrapped around the first atom, as the variables are
+            float3 origin = make_float3(xs[idToIdxs[ids[0]]]);
+            float3 dr = bounds.minImage(make_float3(xs[atomIdx]) - origin);
+            atomicAddVirial(virials[atomIdx], force, dr);
+        }
+    }
+}
+
+void CollectiveVariable::applyAtomGradients(float *dUds, Virial *virials) {
+    int nAtoms = ids.size();
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    apply_cv_gradients<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, ids.getDevData(), gradients.data(), dUds, gpd.xs(activeIdx),
+                                                     gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), state->boundsGPU, virials);
+}
+
+__global__ void add_cv_energy(float *perParticleEng, int *ids, int *idToIdxs, float *eng) {
+    perParticleEng[idToIdxs[ids[0]]] += eng[0];
+}
+
+void CollectiveVariable::addEnergy(float *perParticleEng, float *eng) {
+    add_cv_energy<<<1, 1>>>(perParticleEng, ids.getDevData(), state->gpd.idToIdxs.d_data.data(), eng);
+}
+
+double CollectiveVariable::getValue() {
+    mdAssert(prepared, "Collective variable %s has not been computed yet", type.c_str());
+    value.dataToHost();
+    cudaDeviceSynchronize();
+    return value.h_data[0];
+}
+
+void export_CollectiveVariable() {
+    py::class_<CollectiveVariable, boost::shared_ptr<CollectiveVariable>, boost::noncopyable> (
+        "CollectiveVariable",
+        py::no_init
+    )
+    .def("getValue", &CollectiveVariable::getValue)
+    .def_readonly("type", &CollectiveVariable::type)
+    ;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef COLLECTIVEVARIABLE_H
+#define COLLECTIVEVARIABLE_H
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+#include "Virial.h"
+
+class State;
+
+void export_CollectiveVariable();
+
+//! Base class for collective variables, scalar functions of atom positions that bias fixes act on
+/*!
+ * A collective variable is evaluated entirely on the device.  compute()
+ * leaves its value in value.d_data, and applyForce() adds -dU/ds ds/dx to the
+ * forces of its atoms, reading dU/ds from device memory, so a bias fix can
+ * apply forces every turn without waiting on the host or calling Python.
+ *
+ * Positions within a variable are unwrapped by the minimum image convention,
+ * so the atoms a variable depends on should span less than half the box.
+ * The virial of the bias forces is taken at the same unwrapped positions,
+ * which is exact because every variable is unchanged by translation.
+ */
+class CollectiveVariable {
+protected:
+    //! Constructor
+    /*!
+     * \param type_ Name of the variable type
+     * \param groupHandles_ Groups the variable depends on
+     */
+    CollectiveVariable(boost::shared_ptr<State> state_, std::string type_, std::vector<std::string> groupHandles_);
+
+    //! Ids and masses of the atoms in a group
+    void groupAtoms(std::string groupHandle, std::vector<int> &groupIds, std::vector<double> &masses);
+
+    //! Adds -dU/ds times gradients to the forces of the atoms in ids, and their virials if virials is set
+    void applyAtomGradients(float *dUds, Virial *virials);
+
+public:
+    virtual ~CollectiveVariable() {};
+
+    //! Builds the device arrays the variable needs
+    virtual bool prepareForRun();
+
+    //! Evaluate the variable at the current positions into value
+    virtual void compute() = 0;
+
+    //! Add the forces of a bias to the atoms of the variable
+    /*!
+     * \param dUds Device pointer to the derivative of the bias with respect to the variable
+     * \param virials Per-atom virials to add the virial of the forces to, or nullptr
+     *
+     * Must follow a compute() at the same positions.
+     */
+    virtual void applyForce(float *dUds, Virial *virials) = 0;
+
+    //! Add a bias energy on the device to the per-particle energy of the first atom of the variable
+    void addEnergy(float *perParticleEng, float *eng);
+
+    //! Value as of the last compute.  Synchronizes with the device
+    double getValue();
+
+    State *state;
+    const std::string type; //!< Name of the variable type
+    std::vector<std::string> groupHandles; //!< Groups the variable depends on
+    GPUArrayGlobal<int> ids; //!< Ids of the atoms the variable depends on
+    GPUArrayDeviceGlobal<float4> gradients; //!< ds/dx of each atom in ids, for variables not built from centers of mass
+    GPUArrayGlobal<float> value; //!< Value of the variable
+    bool prepared;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+#ifndef COLLECTIVEVARIABLEMATH_H
+#define COLLECTIVEVARIABLEMATH_H
+
+#include "cutils_math.h"
+
+//! Angle between u and v, and its gradient with respect to each
+inline __host__ __device__ float cvAngle(float3 u, float3 v, float3 &gradU, float3 &gradV) {
+    float lenU = length(u);
+    float lenV = length(v);
+    float c = dot(u, v) / (lenU * lenV);
+    c = fminf(1.0f, fmaxf(-1.0f, c));
+    //the gradient diverges at 0 and pi, where the angle is flat to first order anyway
+    float s = fmaxf(sqrtf(1.0f - c*c), 1e-6f);
+    gradU = (u * (c / (lenU * lenU)) - v / (lenU * lenV)) / s;
+    gradV = (v * (c / (lenV * lenV)) - u / (lenU * lenV)) / s;
+    return acosf(c);
+}
+
+//! Rational switching function (1 - (r/r0)^n) / (1 - (r/r0)^m) and its derivative in r
+inline __host__ __device__ float cvSwitching(float r, float r0, int n, int m, float &dfdr) {
+    float x = r / r0;
+    if (fabsf(x - 1.0f) < 1e-4f) {
+        //removable singularity at r0
+        dfdr = n * (n - m) / (2.0f * m * r0);
+        return n / (float) m;
+    }
+    float xn = powf(x, n);
+    float xm = powf(x, m);
+    float denom = 1.0f - xm;
+    dfdr = (-n * xn * denom + m * xm * (1.0f - xn)) / (x * denom * denom * r0);
+    return (1.0f - xn) / denom;
+}
+
+//! Largest eigenvalue and its eigenvector of a symmetric 4x4 matrix, by cyclic Jacobi rotations.  a is overwritten
+inline __host__ __device__ double cvLargestEigen4(double a[4][4], double vec[4]) {
+    double v[4][4];
+    for (int i=0; i<4; i++) {
+        for (int j=0; j<4; j++) {
+            v[i][j] = i == j;
+        }
+    }
+    for (int sweep=0; sweep<50; sweep++) {
+        double off = 0;
+        double diag = 0;
+        for (int p=0; p<4; p++) {
+            diag += a[p][p]*a[p][p];
+            for (int q=p+1; q<4; q++) {
+                off += a[p][q]*a[p][q];
+            }
+        }
+        if (off <= 1e-24 * diag or off == 0) {
+            break;
+        }
+        for (int p=0; p<4; p++) {
+            for (int q=p+1; q<4; q++) {
+                if (a[p][q] == 0) {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                double t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta*theta + 1));
+                double c = 1 / sqrt(t*t + 1);
+                double s = t * c;
+                for (int k=0; k<4; k++) {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c*akp - s*akq;
+                    a[k][q] = s*akp + c*akq;
+                }
+                for (int k=0; k<4; k++) {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c*apk - s*aqk;
+                    a[q][k] = s*apk + c*aqk;
+                }
+                for (int k=0; k<4; k++) {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c*vkp - s*vkq;
+                    v[k][q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+    int best = 0;
+    for (int i=1; i<4; i++) {
+        if (a[i][i] > a[best][best]) {
+            best = i;
+        }
+    }
+    for (int i=0; i<4; i++) {
+        vec[i] = v[i][best];
+    }
+    return a[best][best];
+}
+
+//! Optimal superposition of centered reference positions y onto centered positions x
+/*!
+ * \param S Correlation matrix, S[a][b] = sum over atoms of y_a x_b
+ * \param sumSq Sum over atoms of |x|^2 + |y|^2
+ * \param n Number of atoms
+ * \param rot Rotation that best maps each y onto its x
+ *
+ * \return Mean square deviation after the fit
+ *
+ * Uses the quaternion method of Horn (J. Opt. Soc. Am. A, 1987).
+ */
+inline __host__ __device__ double cvRMSDFit(double S[3][3], double sumSq, int n, double rot[3][3]) {
+    double N[4][4];
+    N[0][0] = S[0][0] + S[1][1] + S[2][2];
+    N[1][1] = S[0][0] - S[1][1] - S[2][2];
+    N[2][2] = -S[0][0] + S[1][1] - S[2][2];
+    N[3][3] = -S[0][0] - S[1][1] + S[2][2];
+    N[0][1] = N[1][0] = S[1][2] - S[2][1];
+    N[0][2] = N[2][0] = S[2][0] - S[0][2];
+    N[0][3] = N[3][0] = S[0][1] - S[1][0];
+    N[1][2] = N[2][1] = S[0][1] + S[1][0];
+    N[1][3] = N[3][1] = S[2][0] + S[0][2];
+    N[2][3] = N[3][2] = S[1][2] + S[2][1];
+    double q[4];
+    double lambda = cvLargestEigen4(N, q);
+    rot[0][0] = q[0]*q[0] + q[1]*q[1] - q[2]*q[2] - q[3]*q[3];
+    rot[1][1] = q[0]*q[0] - q[1]*q[1] + q[2]*q[2] - q[3]*q[3];
+    rot[2][2] = q[0]*q[0] - q[1]*q[1] - q[2]*q[2] + q[3]*q[3];
+    rot[0][1] = 2 * (q[1]*q[2] - q[0]*q[3]);
+    rot[1][0] = 2 * (q[1]*q[2] + q[0]*q[3]);
+    rot[0][2] = 2 * (q[1]*q[3] + q[0]*q[2]);
+    rot[2][0] = 2 * (q[1]*q[3] - q[0]*q[2]);
+    rot[1][2] = 2 * (q[2]*q[3] - q[0]*q[1]);
+    rot[2][1] = 2 * (q[2]*q[3] + q[0]*q[1]);
+    double msd = (sumSq - 2 * lambda) / n;
+    return msd > 0 ? msd : 0;
+}
+
+#endif
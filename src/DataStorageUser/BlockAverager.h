@@ -0,0 +1,135 @@
+#pragma once
+#ifndef BLOCKAVERAGER_H
+#define BLOCKAVERAGER_H
+
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace MD_ENGINE {
+
+    //! Running mean, variance and Flyvbjerg-Petersen block averages of a series
+    /*!
+     * Level 0 takes every sample.  Each pair of values taken by a level is
+     * averaged into one value of the next, so level l holds the means of
+     * blocks of 2^l samples and the levels grow with the log of the number
+     * of samples.  Each level keeps only its count, running mean and sum of
+     * squared deviations, and the value waiting for its partner.
+     *
+     * The standard error of the mean estimated from level l,
+     * sqrt(var_l / (n_l - 1)) with var_l the biased variance of its block
+     * means, grows with l until blocks are longer than the correlation time
+     * and then levels off.  The first level whose estimate agrees with the
+     * next to within its own uncertainty is taken as the plateau.
+     */
+    class BlockAverager {
+    public:
+        struct Level {
+            int64_t n;
+            double mean;
+            double m2; //!< Sum of squared deviations from the mean
+            bool hasPending;
+            double pending; //!< Value waiting to be averaged with the next one
+            Level() : n(0), mean(0), m2(0), hasPending(false), pending(0) {};
+        };
+        std::vector<Level> levels;
+
+        //! Fewest blocks a level may have to be considered for the plateau
+        int minBlocks;
+
+        BlockAverager(int minBlocks_=16) : minBlocks(minBlocks_) {};
+
+        void push(double x) {
+            for (int level=0; ; level++) {
+                if (levels.size() <= level) {
+                    levels.push_back(Level());
+                }
+                Level &lev = levels[level];
+                lev.n++;
+                double delta = x - lev.mean;
+                lev.mean += delta / lev.n;
+                lev.m2 += delta * (x - lev.mean);
+                if (not lev.hasPending) {
+                    lev.pending = x;
+                    lev.hasPending = true;
+                    return;
+                }
+                x = 0.5 * (lev.pending + x);
+                lev.hasPending = false;
+            }
+        }
+
+        int64_t count() const {
+            return levels.size() ? levels[0].n : 0;
+        }
+
+        double mean() const {
+            return levels.size() ? levels[0].mean : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        //! Unbiased variance of the samples
+        double variance() const {
+            if (count() < 2) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return levels[0].m2 / (levels[0].n - 1);
+        }
+
+        //! Standard error of the mean estimated from the blocks of a level
+        double blockError(int level) const {
+            const Level &lev = levels[level];
+            if (lev.n < 2) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return std::sqrt(lev.m2 / lev.n / (lev.n - 1));
+        }
+
+        //! Uncertainty of blockError(level)
+        double blockErrorError(int level) const {
+            return blockError(level) / std::sqrt(2.0 * (levels[level].n - 1));
+        }
+
+        //! Level at which the error estimates level off, or -1 if no level with enough blocks has
+        int plateauLevel() const {
+            for (int level=0; level+1<levels.size(); level++) {
+                if (levels[level+1].n < minBlocks) {
+                    break;
+                }
+                if (blockError(level+1) - blockError(level) < blockErrorError(level)) {
+                    return level;
+                }
+            }
+            return -1;
+        }
+
+        bool converged() const {
+            return plateauLevel() != -1;
+        }
+
+        //! Standard error of the mean at the plateau, or from the last level with enough blocks if none was reached
+        double error() const {
+            int level = plateauLevel();
+            if (level == -1) {
+                level = 0;
+                while (level+1 < levels.size() and levels[level+1].n >= minBlocks) {
+                    level++;
+                }
+            }
+            return levels.size() ? blockError(level) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        //! Integrated autocorrelation time in samples, 0.5 for uncorrelated samples
+        double correlationTime() const {
+            double err = error();
+            return 0.5 * count() * err * err / variance();
+        }
+
+        void reset() {
+            levels.clear();
+        }
+    };
+
+}
+
+#endif
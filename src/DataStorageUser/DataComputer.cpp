@@ -9,6 +9,7 @@ DataComputer::DataComputer(State *state_, std::string computeMode_, bool require
     lastGroupTag = 0;
 
     requiresPerAtomVirials = false; //though may be set to true by a derived class
+    requiresIds = computeMode == "vector";
 };
 
 
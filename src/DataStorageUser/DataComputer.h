@@ -47,6 +47,8 @@ namespace MD_ENGINE {
 
         bool requiresVirials;
         bool requiresPerAtomVirials;
+        //! Whether samples need gpd.ids on the host to put per-atom values back in atom order.  True by default in vector mode; computers whose vectors are not per atom turn it off
+        bool requiresIds;
 
         GPUArrayGlobal<float> gpuBuffer; //will be cast as virial if necessary
         GPUArrayGlobal<float> gpuBufferReduce; //target for reductions, also maybe cast as virial
@@ -54,11 +56,20 @@ namespace MD_ENGINE {
 
         std::string computeMode;
         virtual void prepareForRun();
+        //! Request the planner sums this computer will use for a group, so they are computed in one pass
+        virtual void requestReductions(uint32_t groupTag) {};
+        //! Result accumulated over all samples, for computers which do not append a value per sample
+        virtual boost::python::object getResult() { return boost::python::object(); };
+        //! Discard the samples accumulated so far
+        virtual void resetResult() {};
+        //! Value of the last scalar sample, for statistics kept in C++.  False if the computer has none
+        virtual bool scalarValue(double &) { return false; };
         int dataMultiple;
         void compute_GPU(bool transferToCPU, uint32_t groupTag);
         void compute_CPU();
         void appendData(boost::python::list &);
         DataComputer(){};
+        virtual ~DataComputer(){};
         DataComputer(State *, std::string computeMode_, bool requiresVirials_);
 
 
@@ -0,0 +1,102 @@
+#include "DataComputerAlchemical.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "DataSetUser.h"
+#include "FixLJCutSoftCore.h"
+#include "PairEvaluateAlchemical.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+DataComputerAlchemical::DataComputerAlchemical(State *state_, boost::shared_ptr<FixLJCutSoftCore> fix_, py::list lambdas_) : DataComputer(state_, "scalar", false), fix(fix_), preparedRun(-1), dEngDLambda(0) {
+    for (int i=0; i<py::len(lambdas_); i++) {
+        double lambda = py::extract<double>(lambdas_[i]);
+        mdAssert(lambda >= 0 and lambda <= 1, "Lambdas must be between 0 and 1, not %f", lambda);
+        lambdas.push_back(lambda);
+    }
+    mdAssert(lambdas.size() <= MAX_SAMPLE_LAMBDAS, "At most %d other lambdas can be sampled", MAX_SAMPLE_LAMBDAS);
+    //per-atom dU/dlambda, then per-atom energy differences for each lambda
+    dataMultiple = 1 + lambdas.size();
+    deltaEngs = std::vector<double>(lambdas.size(), 0);
+}
+
+DataComputerAlchemical *DataComputerAlchemical::sampling(State *state, Fix *fix) {
+    for (boost::shared_ptr<DataSetUser> ds : state->dataManager.dataSets) {
+        if (ds->nextCompute == state->turn) {
+            DataComputerAlchemical *comp = dynamic_cast<DataComputerAlchemical *>(ds->computer.get());
+            if (comp and comp->fix.get() == fix and comp->preparedRun == state->runInit) {
+                return comp;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void DataComputerAlchemical::prepareForRun() {
+    bool found = false;
+    for (Fix *f : state->fixes) {
+        found = found or f == fix.get();
+    }
+    mdAssert(found, "Trying to record lambda derivatives of inactive fix %s", fix->handle.c_str());
+    int nRecording = 0;
+    for (boost::shared_ptr<DataSetUser> ds : state->dataManager.dataSets) {
+        DataComputerAlchemical *comp = dynamic_cast<DataComputerAlchemical *>(ds->computer.get());
+        nRecording += comp and comp->fix == fix;
+    }
+    mdAssert(nRecording == 1, "Lambda derivatives of fix %s are recorded by %d data sets, only one is supported", fix->handle.c_str(), nRecording);
+    DataComputer::prepareForRun();
+    gpuBufferReduce = GPUArrayGlobal<float>(dataMultiple);
+    sampleLambdas = GPUArrayGlobal<float>(lambdas);
+    sampleLambdas.dataToDevice();
+    preparedRun = state->runInit;
+}
+
+void DataComputerAlchemical::computeScalar_GPU(bool transferToCPU, uint32_t) {
+    int nAtoms = state->atoms.size();
+    gpuBufferReduce.d_data.memset(0);
+    for (int i=0; i<dataMultiple; i++) {
+        accumulate_gpu<float, float, SumSingle, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
+            (gpuBufferReduce.getDevData() + i, gpuBuffer.getDevData() + i*nAtoms, nAtoms, state->devManager.prop.warpSize, SumSingle());
+    }
+    if (transferToCPU) {
+        //does NOT sync
+        gpuBufferReduce.dataToHost();
+    }
+}
+
+void DataComputerAlchemical::computeScalar_CPU() {
+    dEngDLambda = gpuBufferReduce.h_data[0];
+    for (int i=0; i<lambdas.size(); i++) {
+        deltaEngs[i] = gpuBufferReduce.h_data[i+1];
+    }
+    //kept whether or not the data set keeps vals, since they are the point of recording
+    deltaEngRows.insert(deltaEngRows.end(), deltaEngs.begin(), deltaEngs.end());
+}
+
+void DataComputerAlchemical::appendScalar(py::list &vals) {
+    vals.append(dEngDLambda);
+}
+
+py::object DataComputerAlchemical::getResult() {
+    py::object numpy = py::import("numpy");
+    py::dict res;
+    res["lambda"] = fix->lambda;
+    py::list lambdasPy;
+    py::list rows;
+    for (float lambda : lambdas) {
+        lambdasPy.append(lambda);
+    }
+    for (double eng : deltaEngRows) {
+        rows.append(eng);
+    }
+    res["lambdas"] = numpy.attr("array")(lambdasPy);
+    int nRows = lambdas.size() ? deltaEngRows.size() / lambdas.size() : 0;
+    res["deltaU"] = numpy.attr("array")(rows).attr("reshape")(nRows, (int) lambdas.size());
+    return res;
+}
+
+void DataComputerAlchemical::resetResult() {
+    deltaEngRows.clear();
+}
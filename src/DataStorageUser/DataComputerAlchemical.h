@@ -0,0 +1,64 @@
+#pragma once
+#ifndef DATACOMPUTERALCHEMICAL_H
+#define DATACOMPUTERALCHEMICAL_H
+
+#include <vector>
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+
+class Fix;
+class FixLJCutSoftCore;
+namespace MD_ENGINE {
+    //! dU/dlambda of a FixLJCutSoftCore and its energy at other lambdas, for thermodynamic integration and MBAR
+    /*!
+     * Nothing is computed here: on turns this computer samples, the fix's
+     * force sweep writes per-atom dU/dlambda and U(lambda_k) - U(lambda) into
+     * gpuBuffer, which are summed into gpuBufferReduce.  Sampling therefore
+     * only costs extra energy evaluations of the scaled pairs, and no extra
+     * pass over the neighbor list.
+     */
+    class DataComputerAlchemical : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t);
+            void computeVector_GPU(bool, uint32_t){};
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU();
+            void computeVector_CPU(){};
+            void computeTensor_CPU(){};
+
+            DataComputerAlchemical(State *, boost::shared_ptr<FixLJCutSoftCore> fix_, boost::python::list lambdas_);
+            void prepareForRun();
+
+            //! Appends dU/dlambda to vals
+            void appendScalar(boost::python::list &);
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Dict of lambda, the other lambdas and a samples x lambdas numpy array of U(lambda_k) - U(lambda)
+            boost::python::object getResult();
+            void resetResult();
+            bool scalarValue(double &val) { val = dEngDLambda; return true; };
+
+            //! The computer sampling fix on the current turn, or nullptr
+            /*!
+             * Forces of the first turn are computed before data sets are
+             * prepared, so a computer only samples once its buffers have
+             * been allocated for the current run.
+             */
+            static DataComputerAlchemical *sampling(State *, Fix *fix);
+
+            boost::shared_ptr<FixLJCutSoftCore> fix;
+            std::vector<float> lambdas; //!< Other lambdas the energy is evaluated at
+            GPUArrayGlobal<float> sampleLambdas;
+            int64_t preparedRun; //!< runInit of the run the buffers were allocated for, -1 before any
+
+            double dEngDLambda; //!< dU/dlambda of the last sample
+            std::vector<double> deltaEngs; //!< U(lambda_k) - U(lambda) of the last sample
+            std::vector<double> deltaEngRows; //!< deltaEngs of every sample, even with keepVals off
+    };
+};
+
+#endif
@@ -7,29 +7,13 @@ using namespace MD_ENGINE;
 
 // scalar, because we just need the one return - not a per-atom thing.
 DataComputerCOMV::DataComputerCOMV(State *state_) : DataComputer(state_, "scalar", false) {
-    sumMomentum = GPUArrayGlobal<float4>(2);
 }
 
 
 void DataComputerCOMV::computeScalar_GPU(bool transferToCPU, uint32_t groupTag) {
-    GPUData &gpd = state->gpd;
-    sumMomentum.d_data.memset(0);
     lastGroupTag = groupTag;
-    int nAtoms = state->atoms.size();
-
-    accumulate_gpu<float4, float4, SumVectorXYZOverW, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float4)>>>
-            (
-             sumMomentum.getDevData(),
-             gpd.vs.getDevData(),
-             nAtoms,
-             state->devManager.prop.warpSize,
-             SumVectorXYZOverW()
-            );
-    
-    if (transferToCPU) {
-        //does NOT sync
-        sumMomentum.dataToHost();
-    }
+    //the momentum is always summed over all atoms.  Copies to the host and does NOT sync
+    state->dataManager.reductions.reduce(1, REDUCE_MOMENTUM);
 }
 
 
@@ -38,9 +22,13 @@ void DataComputerCOMV::prepareForRun() {
     //then my own stuff
 }
 
+void DataComputerCOMV::requestReductions(uint32_t groupTag) {
+    state->dataManager.reductions.request(1, REDUCE_MOMENTUM);
+}
+
 
 void DataComputerCOMV::computeScalar_CPU() {
-    systemMomentum = sumMomentum.h_data[0];
+    systemMomentum = state->dataManager.reductions.result(1).momentum();
 
 }
 
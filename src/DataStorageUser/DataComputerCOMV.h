@@ -23,9 +23,9 @@ namespace MD_ENGINE {
             DataComputerCOMV(State *);
 
             void prepareForRun();
-            
-            // as from FixLinearMomentum
-            GPUArrayGlobal<float4> sumMomentum;
+            void requestReductions(uint32_t groupTag);
+
+            // summed momentum in xyz, total mass in w
             float4 systemMomentum;
 
             void appendScalar(boost::python::list &);
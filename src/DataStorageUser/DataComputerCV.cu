@@ -0,0 +1,29 @@
+#include "DataComputerCV.h"
+#include "boost_for_export.h"
+#include "State.h"
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+DataComputerCV::DataComputerCV(State *state_, boost::shared_ptr<CollectiveVariable> cv_) : DataComputer(state_, "scalar", false), cv(cv_), cvValue(0) {
+}
+
+void DataComputerCV::prepareForRun() {
+    DataComputer::prepareForRun();
+    cv->prepareForRun();
+}
+
+void DataComputerCV::computeScalar_GPU(bool transferToCPU, uint32_t groupTag) {
+    cv->compute();
+    if (transferToCPU) {
+        //does NOT sync
+        cv->value.dataToHost();
+    }
+}
+
+void DataComputerCV::computeScalar_CPU() {
+    cvValue = cv->value.h_data[0];
+}
+
+void DataComputerCV::appendScalar(py::list &vals) {
+    vals.append(cvValue);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef DATACOMPUTERCV_H
+#define DATACOMPUTERCV_H
+
+#include "DataComputer.h"
+#include "CollectiveVariable.h"
+
+namespace MD_ENGINE {
+    //! Value of a collective variable, as for the histograms of umbrella sampling windows
+    /*!
+     * The variable is evaluated again on each turn sampled, so it need not be
+     * biased by any fix.  Only one float is copied to the host per sample.
+     */
+    class DataComputerCV : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t);
+            void computeVector_GPU(bool, uint32_t){};
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU();
+            void computeVector_CPU(){};
+            void computeTensor_CPU(){};
+
+            DataComputerCV(State *, boost::shared_ptr<CollectiveVariable> cv_);
+            void prepareForRun();
+
+            void appendScalar(boost::python::list &);
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+            bool scalarValue(double &val) { val = cvValue; return true; };
+
+            boost::shared_ptr<CollectiveVariable> cv;
+            double cvValue;
+    };
+};
+
+#endif
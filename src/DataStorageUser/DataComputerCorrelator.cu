@@ -0,0 +1,201 @@
+#include "DataComputerCorrelator.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Group.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+//more levels than any run could fill, nPoints * 2^48 samples
+#define CORRELATOR_MAX_LEVELS 48
+#define CORRELATOR_MAX_POINTS 64
+
+//follows each member across periodic wraps from sample to sample
+__global__ void unwrapMembers_cu(float4 *unwrapped, float4 *lastWrapped, int nMembers, const float4 *xs,
+                                 const uint *ids, const int *idToIdxs, BoundsGPU bounds, bool first) {
+    int idx = GETIDX();
+    if (idx < nMembers) {
+        float4 pos = xs[idToIdxs[ids[idx]]];
+        if (first) {
+            unwrapped[idx] = pos;
+        } else {
+            float3 step = bounds.minImage(make_float3(pos - lastWrapped[idx]));
+            unwrapped[idx] += make_float4(step.x, step.y, step.z, 0);
+        }
+        lastWrapped[idx] = pos;
+    }
+}
+
+//pushes one value per member into a level and sums its correlations with the level's values, per block and lag
+template <bool MSD>
+__global__ void correlatorLevel_cu(double *partials, int nMembers, const float4 *source, const uint *ids, const int *idToIdxs,
+                                   float4 *sourceWaiting, float sourceScale, float4 *history, float4 *waiting,
+                                   int nPoints, int slot, int firstLag, int nLags) {
+    __shared__ double tmp[PERBLOCK];
+    int idx = GETIDX();
+    float3 v = make_float3(0, 0, 0);
+    bool valid = idx < nMembers;
+    if (valid) {
+        //level 0 gathers from the atoms, coarser VACF levels take the sums waiting in the level below
+        float4 whole = ids ? source[idToIdxs[ids[idx]]] : source[idx];
+        v = make_float3(whole) * sourceScale;
+        if (sourceWaiting) {
+            sourceWaiting[idx] = make_float4(0, 0, 0, 0);
+        }
+        history[idx*nPoints + slot] = make_float4(v.x, v.y, v.z, 0);
+        if (waiting) {
+            waiting[idx] += make_float4(v.x, v.y, v.z, 0);
+        }
+    }
+    for (int lag=0; lag<nPoints; lag++) {
+        double c = 0;
+        if (valid and lag >= firstLag and lag < nLags) {
+            float3 other = make_float3(history[idx*nPoints + (slot - lag + nPoints) % nPoints]);
+            if (MSD) {
+                c = lengthSqr(v - other);
+            } else {
+                c = dot(v, other);
+            }
+        }
+        tmp[threadIdx.x] = c;
+        __syncthreads();
+        for (int stride=blockDim.x/2; stride>0; stride/=2) {
+            if (threadIdx.x < stride) {
+                tmp[threadIdx.x] += tmp[threadIdx.x + stride];
+            }
+            __syncthreads();
+        }
+        if (threadIdx.x == 0) {
+            partials[blockIdx.x*nPoints + lag] = tmp[0];
+        }
+        __syncthreads();
+    }
+}
+
+//one block per lag adds the per block sums to the running sums
+__global__ void correlatorAddPartials_cu(double *sums, const double *partials, int nBlocks, int nPoints) {
+    __shared__ double tmp[PERBLOCK];
+    int lag = blockIdx.x;
+    double sum = 0;
+    for (int i=threadIdx.x; i<nBlocks; i+=blockDim.x) {
+        sum += partials[i*nPoints + lag];
+    }
+    tmp[threadIdx.x] = sum;
+    __syncthreads();
+    for (int stride=blockDim.x/2; stride>0; stride/=2) {
+        if (threadIdx.x < stride) {
+            tmp[threadIdx.x] += tmp[threadIdx.x + stride];
+        }
+        __syncthreads();
+    }
+    if (threadIdx.x == 0) {
+        sums[lag] += tmp[0];
+    }
+}
+
+DataComputerCorrelator::DataComputerCorrelator(State *state_, int correlation_, uint32_t groupTag_, int interval_, int nPoints) : DataComputer(state_, "vector", false), correlation(correlation_), groupTag(groupTag_), interval(interval_), schedule(nPoints, 2), nLevelsPushing(0) {
+    //correlations are averaged over the group on the device
+    requiresIds = false;
+    mdAssert(interval > 0, "Correlations need evenly spaced samples, so an interval must be given");
+    mdAssert(nPoints >= 4 and nPoints <= CORRELATOR_MAX_POINTS and nPoints % 2 == 0,
+             "Correlators need an even number of points per level between 4 and %d", CORRELATOR_MAX_POINTS);
+    sums = GPUArrayGlobal<double>(CORRELATOR_MAX_LEVELS * nPoints);
+    sums.d_data.memset(0);
+}
+
+void DataComputerCorrelator::prepareForRun() {
+    Group &group = state->groups[groupTag];
+    if (schedule.nLevels() and group.atomIds != memberIds) {
+        mdWarning("Members of group %s changed, restarting its correlation", group.groupHandle.c_str());
+        resetResult();
+    }
+    memberIds = group.atomIds;
+    mdAssert(memberIds.size(), "Cannot correlate group %s, which has no members", group.groupHandle.c_str());
+    if (correlation == CORRELATEMSD and unwrapped.size() != memberIds.size()) {
+        unwrapped = GPUArrayDeviceGlobal<float4>(memberIds.size());
+        lastWrapped = GPUArrayDeviceGlobal<float4>(memberIds.size());
+    }
+    partials = GPUArrayDeviceGlobal<double>(NBLOCK(memberIds.size()) * schedule.nPoints);
+}
+
+void DataComputerCorrelator::computeVector_GPU(bool transferToCPU, uint32_t) {
+    Group &group = state->groups[groupTag];
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    int nMembers = memberIds.size();
+    int nPoints = schedule.nPoints;
+    int nBlocks = NBLOCK(nMembers);
+    uint *ids = group.ids.getDevData();
+    int *idToIdxs = gpd.idToIdxs.getDevData();
+
+    nLevelsPushing = schedule.levelsForNextSample();
+    mdAssert(nLevelsPushing <= CORRELATOR_MAX_LEVELS, "Correlator ran out of levels");
+    while (history.size() < nLevelsPushing) {
+        history.emplace_back(nMembers * nPoints);
+        if (correlation == CORRELATEVACF) {
+            waiting.emplace_back(nMembers);
+            waiting.back().memset(0);
+        }
+    }
+    if (correlation == CORRELATEMSD) {
+        unwrapMembers_cu<<<nBlocks, PERBLOCK>>>(unwrapped.data(), lastWrapped.data(), nMembers, gpd.xs(activeIdx),
+                                                ids, idToIdxs, state->boundsGPU, schedule.nLevels() == 0);
+    }
+    for (int level=0; level<nLevelsPushing; level++) {
+        int64_t pushed = level < schedule.nLevels() ? schedule.nPushed[level] : 0;
+        int slot = pushed % nPoints;
+        int firstLag = schedule.firstLag(level);
+        int nLags = schedule.nLagsOnPush(level);
+        if (correlation == CORRELATEMSD) {
+            //coarser levels hold the positions themselves, so waiting sums are unused
+            correlatorLevel_cu<true><<<nBlocks, PERBLOCK>>>(partials.data(), nMembers, unwrapped.data(), nullptr, nullptr,
+                                                            nullptr, 1.0f, history[level].data(), nullptr,
+                                                            nPoints, slot, firstLag, nLags);
+        } else if (level == 0) {
+            correlatorLevel_cu<false><<<nBlocks, PERBLOCK>>>(partials.data(), nMembers, gpd.vs(activeIdx), ids, idToIdxs,
+                                                             nullptr, 1.0f, history[level].data(), waiting[level].data(),
+                                                             nPoints, slot, firstLag, nLags);
+        } else {
+            correlatorLevel_cu<false><<<nBlocks, PERBLOCK>>>(partials.data(), nMembers, waiting[level-1].data(), nullptr, nullptr,
+                                                             waiting[level-1].data(), 1.0f / schedule.nAverage,
+                                                             history[level].data(), waiting[level].data(),
+                                                             nPoints, slot, firstLag, nLags);
+        }
+        correlatorAddPartials_cu<<<nPoints, PERBLOCK>>>(sums.getDevData() + level*nPoints, partials.data(), nBlocks, nPoints);
+    }
+}
+
+void DataComputerCorrelator::computeVector_CPU() {
+    schedule.advance(nLevelsPushing);
+    nLevelsPushing = 0;
+}
+
+py::object DataComputerCorrelator::getResult() {
+    sums.dataToHost();
+    cudaDeviceSynchronize();
+    py::list taus;
+    py::list vals;
+    int nPoints = schedule.nPoints;
+    double nMembers = memberIds.size();
+    for (int level=0; level<schedule.nLevels(); level++) {
+        for (int lag=schedule.firstLag(level); lag<nPoints; lag++) {
+            double n = schedule.nCorrelated[level*nPoints + lag];
+            if (n > 0 and nMembers > 0) {
+                taus.append(schedule.lagSamples(level, lag) * interval);
+                vals.append(sums.h_data[level*nPoints + lag] / (n * nMembers));
+            }
+        }
+    }
+    py::object numpy = py::import("numpy");
+    return py::make_tuple(numpy.attr("array")(taus), numpy.attr("array")(vals));
+}
+
+void DataComputerCorrelator::resetResult() {
+    schedule.reset();
+    history.clear();
+    waiting.clear();
+    sums.d_data.memset(0);
+    nLevelsPushing = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef DATACOMPUTERCORRELATOR_H
+#define DATACOMPUTERCORRELATOR_H
+
+#include <vector>
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+#include "MultipleTauSchedule.h"
+
+namespace MD_ENGINE {
+    enum CORRELATION {CORRELATEMSD, CORRELATEVACF};
+
+    //! Mean squared displacement or velocity autocorrelation of a group by multiple tau correlation
+    /*!
+     * Each sample pushes every member's unwrapped position (MSD) or velocity
+     * (VACF) through the levels of a MultipleTauSchedule kept on the device,
+     * so times up to nPoints * 2^levels samples are covered with memory
+     * growing with the log of the run length.  Coarser levels of the VACF
+     * hold block averaged velocities.  Coarser levels of the MSD hold the
+     * positions themselves, since averaging positions would blur the
+     * displacements.
+     *
+     * Positions are unwrapped by following each member from sample to
+     * sample, so members must move less than half the box between samples.
+     * Samples must be evenly spaced.  If the group's members change
+     * between runs, the correlation restarts.
+     */
+    class DataComputerCorrelator : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t){};
+            void computeVector_GPU(bool, uint32_t);
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU(){};
+            void computeVector_CPU();
+            void computeTensor_CPU(){};
+
+            DataComputerCorrelator(State *, int correlation_, uint32_t groupTag_, int interval_, int nPoints);
+            void prepareForRun();
+
+            //! Nothing is appended per sample, the correlation is read through getResult
+            void appendScalar(boost::python::list &){};
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Tuple of numpy arrays of lag times in turns and the correlation at each
+            boost::python::object getResult();
+            void resetResult();
+
+            int correlation; //!< CORRELATEMSD or CORRELATEVACF
+            uint32_t groupTag;
+            int interval; //!< Turns between samples
+
+        private:
+            MultipleTauSchedule schedule;
+            int nLevelsPushing; //!< Levels taking a value on the sample being computed
+            std::vector<uint> memberIds; //!< Members the correlation was started with
+            std::vector<GPUArrayDeviceGlobal<float4> > history; //!< By level, nPoints values per member
+            std::vector<GPUArrayDeviceGlobal<float4> > waiting; //!< By level, sum of values not yet pushed up
+            GPUArrayDeviceGlobal<float4> unwrapped; //!< MSD only, unwrapped position of each member
+            GPUArrayDeviceGlobal<float4> lastWrapped; //!< MSD only, wrapped position at the last sample
+            GPUArrayDeviceGlobal<double> partials; //!< Per block sums of one level's lags
+            GPUArrayGlobal<double> sums; //!< Summed correlations, by level*nPoints + lag
+    };
+};
+
+#endif
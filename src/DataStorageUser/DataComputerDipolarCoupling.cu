@@ -48,6 +48,8 @@ __global__ void coalesceInvR6(int nAtoms, float4 *fs, float *uncoalesced, int *c
 DataComputerDipolarCoupling::DataComputerDipolarCoupling(State *state_, std::string computeMode_, std::string groupHandleA_, std::string groupHandleB_, double magnetoA_, double magnetoB_) : DataComputer(state_, computeMode_, false), groupHandleA(groupHandleA_), groupHandleB(groupHandleB_), magnetoA(magnetoA_), magnetoB(magnetoB_) {
     groupTagA = state->groupTagFromHandle(groupHandleA);
     groupTagB = state->groupTagFromHandle(groupHandleB);
+    //the group-group evaluator tests per-atom tag bits directly
+    mdAssert(not ((groupTagA | groupTagB) & GROUP_TAG_EXTENDED), "Dipolar coupling is only supported for the first %d groups", GROUP_TAG_NBITS);
 }
 
 void DataComputerDipolarCoupling::computeScalar_GPU(bool transferToHost, uint32_t groupTag) {
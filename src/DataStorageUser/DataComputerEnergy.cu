@@ -35,6 +35,7 @@ void DataComputerEnergy::computeScalar_GPU(bool transferToCPU, uint32_t groupTag
         if (otherIsAll) {
             fix->singlePointEng(gpuBuffer.getDevData());
         } else {
+            mdAssert(not ((groupTag | groupTagB) & GROUP_TAG_EXTENDED), "Group-group energies are only supported for the first %d groups", GROUP_TAG_NBITS);
             fix->singlePointEngGroupGroup(gpuBuffer.getDevData(), groupTag, groupTagB);
 
         }
@@ -45,8 +46,13 @@ void DataComputerEnergy::computeScalar_GPU(bool transferToCPU, uint32_t groupTag
          accumulate_gpu<float, float, SumSingle, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
             (gpuBufferReduce.getDevData(), gpuBuffer.getDevData(), nAtoms, state->devManager.prop.warpSize, SumSingle());
     } else {
-        accumulate_gpu_if<float, float, SumSingleIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
-            (gpuBufferReduce.getDevData(), gpuBuffer.getDevData(), nAtoms, state->devManager.prop.warpSize, SumSingleIf(gpd.fs.getDevData(), groupTag));
+        Group &group = state->groups[groupTag];
+        int nInGroup = group.count;
+        if (nInGroup) {
+            accumulate_gpu_if<float, float, SumSingle, N_DATA_PER_THREAD> <<<NBLOCK(nInGroup / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
+                (gpuBufferReduce.getDevData(), gpuBuffer.getDevData(), nInGroup, state->devManager.prop.warpSize, SumSingle(),
+                 IndexGroupMembers(group.ids.getDevData(), gpd.idToIdxs.getDevData()));
+        }
     }
     if (transferToCPU) {
         //does NOT sync
@@ -66,6 +72,7 @@ void DataComputerEnergy::computeVector_GPU(bool transferToCPU, uint32_t groupTag
         if (otherIsAll) {
             fix->singlePointEng(gpuBuffer.getDevData());
         } else {
+            mdAssert(not ((groupTag | groupTagB) & GROUP_TAG_EXTENDED), "Group-group energies are only supported for the first %d groups", GROUP_TAG_NBITS);
             fix->singlePointEngGroupGroup(gpuBuffer.getDevData(), groupTag, groupTagB);
         }
         fix->setEvalWrapperMode("offload");
@@ -29,6 +29,7 @@ namespace MD_ENGINE {
             std::vector<boost::shared_ptr<Fix> > fixes;
 
             void appendScalar(boost::python::list &);
+            bool scalarValue(double &val) { val = engScalar; return computeMode == "scalar"; };
             void appendVector(boost::python::list &); 
             void appendTensor(boost::python::list &){};
 
@@ -0,0 +1,163 @@
+#include "DataComputerEnergyMatrix.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+enum ENERGYMATRIXPART {MATRIXPAIR, MATRIXCHARGE, MATRIXBONDED, N_MATRICES};
+
+//adds per-atom energies to the diagonal entry of each atom's group
+__global__ void energyMatrixDiagonal_cu(float *matrix, int nGroups, int nAtoms, const float *perAtomEngs,
+                                        const uint *ids, const int *groupSlots) {
+    extern __shared__ float diag_shr[];
+    for (int i=threadIdx.x; i<nGroups; i+=blockDim.x) {
+        diag_shr[i] = 0;
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    if (idx < nAtoms) {
+        int slot = groupSlots[ids[idx]];
+        if (slot != -1 and perAtomEngs[idx] != 0) {
+            atomicAdd(diag_shr + slot, perAtomEngs[idx]);
+        }
+    }
+    __syncthreads();
+    for (int i=threadIdx.x; i<nGroups; i+=blockDim.x) {
+        if (diag_shr[i]) {
+            atomicAdd(matrix + i*nGroups + i, diag_shr[i]);
+        }
+    }
+}
+
+//adds one sample's matrices to the running sums in double and clears them for the next
+__global__ void energyMatrixFold_cu(double *sums, float *sampleMatrices, int n) {
+    int idx = GETIDX();
+    if (idx < n) {
+        sums[idx] += sampleMatrices[idx];
+        sampleMatrices[idx] = 0;
+    }
+}
+
+DataComputerEnergyMatrix::DataComputerEnergyMatrix(State *state_, py::list groupHandles_, py::list fixes_) : DataComputer(state_, "vector", false), nSamples(0) {
+    //entries are per pair of groups, not per atom
+    requiresIds = false;
+    nGroups = py::len(groupHandles_);
+    mdAssert(nGroups > 0, "Energy matrices need at least one group");
+    for (int i=0; i<nGroups; i++) {
+        std::string handle = py::extract<std::string>(groupHandles_[i]);
+        groupTags.push_back(state->groupTagFromHandle(handle));
+        groupHandles.push_back(handle);
+    }
+    for (int i=0; i<py::len(fixes_); i++) {
+        py::extract<boost::shared_ptr<Fix> > fixPy(fixes_[i]);
+        mdAssert(fixPy.check(), "Non-fix passed to energy matrix");
+        fixes.push_back(fixPy);
+    }
+    int nFloats = N_MATRICES * nGroups * nGroups;
+    sampleMatrices = GPUArrayDeviceGlobal<float>(nFloats);
+    sampleMatrices.memset(0);
+    sums = GPUArrayGlobal<double>(nFloats);
+    sums.d_data.memset(0);
+}
+
+void DataComputerEnergyMatrix::prepareForRun() {
+    if (fixes.size() == 0) {
+        fixes = state->fixesShr; //if none specified, use them all
+    } else {
+        for (auto fix : fixes) {
+            bool found = false;
+            for (auto fix2 : state->fixesShr) {
+                if (fix->handle == fix2->handle && fix->type == fix2->type) {
+                    found = true;
+                }
+            }
+            mdAssert(found, "Trying to record energy for inactive fix %s", fix->handle.c_str());
+        }
+    }
+    //each atom has one slot, so overlaps would silently drop energies
+    std::vector<int> slots(state->maxIdExisting + 1, -1);
+    for (Atom &a : state->atoms) {
+        int nIn = 0;
+        for (int i=0; i<nGroups; i++) {
+            if (state->atomInGroup(a, groupTags[i])) {
+                slots[a.id] = i;
+                nIn++;
+            }
+        }
+        mdAssert(nIn <= 1, "Groups of an energy matrix must not share atoms, atom %d is in %d of them", a.id, nIn);
+    }
+    groupSlots = GPUArrayDeviceGlobal<int>(slots.size());
+    groupSlots.set(slots.data());
+    perAtomEngs = GPUArrayDeviceGlobal<float>(state->atoms.size());
+}
+
+void DataComputerEnergyMatrix::computeVector_GPU(bool transferToCPU, uint32_t) {
+    int nAtoms = state->atoms.size();
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    int matrixSize = nGroups * nGroups;
+    float *pairMatrix = sampleMatrices.data() + MATRIXPAIR * matrixSize;
+    float *chargeMatrix = sampleMatrices.data() + MATRIXCHARGE * matrixSize;
+    float *bondedMatrix = sampleMatrices.data() + MATRIXBONDED * matrixSize;
+    for (boost::shared_ptr<Fix> fix : fixes) {
+        fix->setEvalWrapperMode("self");
+        fix->setEvalWrapper();
+        if (not fix->singlePointEngGroupMatrix(pairMatrix, chargeMatrix, bondedMatrix, groupSlots.data(), nGroups)) {
+            perAtomEngs.memset(0);
+            fix->singlePointEng(perAtomEngs.data());
+            energyMatrixDiagonal_cu<<<NBLOCK(nAtoms), PERBLOCK, nGroups*sizeof(float)>>>(
+                    bondedMatrix, nGroups, nAtoms, perAtomEngs.data(), gpd.ids(activeIdx), groupSlots.data());
+        }
+        fix->setEvalWrapperMode("offload");
+        fix->setEvalWrapper();
+    }
+    int nFloats = N_MATRICES * matrixSize;
+    energyMatrixFold_cu<<<NBLOCK(nFloats), PERBLOCK>>>(sums.getDevData(), sampleMatrices.data(), nFloats);
+}
+
+void DataComputerEnergyMatrix::computeVector_CPU() {
+    nSamples++;
+}
+
+py::object DataComputerEnergyMatrix::getResult() {
+    sums.dataToHost();
+    cudaDeviceSynchronize();
+    py::object numpy = py::import("numpy");
+    py::dict res;
+    py::list handles;
+    for (std::string &handle : groupHandles) {
+        handles.append(handle);
+    }
+    res["groups"] = handles;
+    const char *names[N_MATRICES] = {"pair", "charge", "bonded"};
+    int matrixSize = nGroups * nGroups;
+    std::vector<double> total(matrixSize, 0);
+    for (int m=0; m<N_MATRICES; m++) {
+        const double *sum = sums.h_data.data() + m * matrixSize;
+        py::list vals;
+        for (int a=0; a<nGroups; a++) {
+            for (int b=0; b<nGroups; b++) {
+                //each direction of a pair holds half its energy
+                double eng = a == b ? sum[a*nGroups + a] : sum[a*nGroups + b] + sum[b*nGroups + a];
+                eng = nSamples ? eng / nSamples : 0;
+                vals.append(eng);
+                total[a*nGroups + b] += eng;
+            }
+        }
+        res[names[m]] = numpy.attr("array")(vals).attr("reshape")(nGroups, nGroups);
+    }
+    py::list totalVals;
+    for (double eng : total) {
+        totalVals.append(eng);
+    }
+    res["total"] = numpy.attr("array")(totalVals).attr("reshape")(nGroups, nGroups);
+    return res;
+}
+
+void DataComputerEnergyMatrix::resetResult() {
+    sums.d_data.memset(0);
+    nSamples = 0;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef DATACOMPUTERENERGYMATRIX_H
+#define DATACOMPUTERENERGYMATRIX_H
+
+#include <vector>
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+#include "Fix.h"
+
+namespace MD_ENGINE {
+    //! Interaction energies between every pair of a list of groups, averaged on the device
+    /*!
+     * Each sample evaluates each fix once, through
+     * Fix::singlePointEngGroupMatrix.  Pair and charge fixes sweep the
+     * neighbor list adding each pair's energy to the matrix entry of the two
+     * atoms' groups, which replaces one group-group evaluation per pair of
+     * groups.  Bonds, angles, dihedrals and impropers split each atom's share
+     * of their energy over the groups of the other atoms, so a bond between
+     * two residues lands off the diagonal.
+     *
+     * Fixes whose energy cannot be split between atoms (external potentials,
+     * for instance) give per-atom energies, which are added to the diagonal
+     * entry of the atom's group.  The reciprocal space energy of Ewald sums
+     * is left out.
+     *
+     * Groups may be of any kind, including extended groups, but must not
+     * share atoms.
+     */
+    class DataComputerEnergyMatrix : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t){};
+            void computeVector_GPU(bool, uint32_t);
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU(){};
+            void computeVector_CPU();
+            void computeTensor_CPU(){};
+
+            DataComputerEnergyMatrix(State *, boost::python::list groupHandles_, boost::python::list fixes_);
+            void prepareForRun();
+
+            //! Nothing is appended per sample, the matrices are read through getResult
+            void appendScalar(boost::python::list &){};
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Dict of the group handles and the pair, charge, bonded and total energy matrices averaged over samples
+            /*!
+             * Matrices are symmetric numpy arrays.  Off diagonal entries are
+             * the whole energy between two groups and diagonal entries the
+             * energy within a group, so the sum over the upper triangle is
+             * the total.
+             */
+            boost::python::object getResult();
+            void resetResult();
+
+            std::vector<std::string> groupHandles;
+            std::vector<boost::shared_ptr<Fix> > fixes;
+            int64_t nSamples;
+
+        private:
+            int nGroups;
+            std::vector<uint32_t> groupTags;
+            GPUArrayDeviceGlobal<int> groupSlots;       //!< Index of the group of each atom id, -1 if none
+            GPUArrayDeviceGlobal<float> sampleMatrices; //!< Pair, charge and bonded matrices of this sample
+            GPUArrayDeviceGlobal<float> perAtomEngs;    //!< For fixes which only give per-atom energies
+            GPUArrayGlobal<double> sums; //!< Pair, charge and bonded matrices summed over samples
+    };
+};
+
+#endif
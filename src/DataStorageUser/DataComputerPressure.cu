@@ -15,28 +15,11 @@ DataComputerPressure::DataComputerPressure(State *state_, std::string computeMod
 
 void DataComputerPressure::computeScalar_GPU(bool transferToCPU, uint32_t groupTag) {
     mdAssert(groupTag == 1, "Trying to compute pressure for group other than 'all'");
-    if (!usingExternalTemperature) {
-        tempComputer.computeScalar_GPU(transferToCPU, groupTag);
-    }
-    GPUData &gpd = state->gpd;
-    gpuBuffer.d_data.memset(0);
     lastGroupTag = groupTag;
-    int nAtoms = state->atoms.size();
-    if (groupTag == 1) {
-         accumulate_gpu<float, Virial, SumVirialToScalar, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
-            (gpuBuffer.getDevData(), gpd.virials.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVirialToScalar());
-    } else {
-        accumulate_gpu_if<float, Virial, SumVirialToScalarIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
-            (gpuBuffer.getDevData(), 
-             gpd.virials.getDevData(), 
-             nAtoms, 
-             state->devManager.prop.warpSize, 
-             SumVirialToScalarIf(gpd.fs.getDevData(), groupTag));
-    }
-    if (transferToCPU) {
-        //does NOT sync
-        gpuBuffer.dataToHost();
-    }
+    //kinetic and virial sums come from the same sweep.  Copies to the host and does NOT sync
+    state->dataManager.reductions.reduce(groupTag, REDUCE_VIRIAL_SCALAR | (usingExternalTemperature ? 0 : REDUCE_KE_SCALAR));
+    //tempComputer reads its kinetic sums from the same sweep
+    tempComputer.lastGroupTag = groupTag;
 }
 
 void DataComputerPressure::computeVector_GPU(bool transferToCPU, uint32_t groupTag) {
@@ -49,25 +32,11 @@ void DataComputerPressure::computeVector_GPU(bool transferToCPU, uint32_t groupT
 
 void DataComputerPressure::computeTensor_GPU(bool transferToCPU, uint32_t groupTag) {
     mdAssert(groupTag == 1, "Trying to compute pressure for group other than 'all'");
-    if (!usingExternalTemperature) {
-        tempComputer.computeTensor_GPU(transferToCPU, groupTag);
-    }
-    GPUData &gpd = state->gpd;
-    gpuBuffer.d_data.memset(0); 
     lastGroupTag = groupTag;
-    int nAtoms = state->atoms.size();
-    if (groupTag == 1) {
-        
-        accumulate_gpu<Virial, Virial, SumVirial, N_DATA_PER_THREAD>  <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(Virial)>>>
-            ((Virial *) gpuBuffer.getDevData(), gpd.virials.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVirial());    
-    } else {
-        accumulate_gpu_if<Virial, Virial, SumVirialIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(Virial)>>>
-            ((Virial *) gpuBuffer.getDevData(), gpd.virials.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVirialIf(gpd.fs.getDevData(), groupTag));
-    } 
-    if (transferToCPU) {
-        //does NOT sync
-        gpuBuffer.dataToHost();
-    }
+    //kinetic and virial sums come from the same sweep.  Copies to the host and does NOT sync
+    state->dataManager.reductions.reduce(groupTag, REDUCE_VIRIAL_TENSOR | (usingExternalTemperature ? 0 : REDUCE_KE_TENSOR));
+    //tempComputer reads its kinetic sums from the same sweep
+    tempComputer.lastGroupTag = groupTag;
 }
 
 void DataComputerPressure::computeScalar_CPU() {
@@ -82,7 +51,7 @@ void DataComputerPressure::computeScalar_CPU() {
         tempScalar_loc = tempComputer.tempScalar;
         ndf_loc = tempComputer.ndf;
     }
-    double sumVirial = gpuBuffer.h_data[0];
+    double sumVirial = state->dataManager.reductions.result(lastGroupTag).virialScalar();
     double dim = state->is2d ? 2 : 3;
     double volume = state->boundsGPU.volume();
     pressureScalar = (tempScalar_loc * ndf_loc * boltz + sumVirial) / (dim * volume) * state->units.nktv_to_press;
@@ -104,7 +73,7 @@ void DataComputerPressure::computeTensor_CPU() {
         tempTensor_loc = tempComputer.tempTensor;
     }
     pressureTensor = Virial(0, 0, 0, 0, 0, 0);
-    Virial sumVirial = * (Virial *) gpuBuffer.h_data.data();
+    Virial sumVirial = state->dataManager.reductions.result(lastGroupTag).virialTensor();
     double volume = state->boundsGPU.volume();
     for (int i=0; i<6; i++) {
         pressureTensor[i] = (tempTensor_loc[i] + sumVirial[i]) / volume * state->units.nktv_to_press;
@@ -135,3 +104,11 @@ void DataComputerPressure::prepareForRun() {
     DataComputer::prepareForRun();
 }
 
+void DataComputerPressure::requestReductions(uint32_t groupTag) {
+    if (computeMode == "scalar") {
+        state->dataManager.reductions.request(groupTag, REDUCE_VIRIAL_SCALAR | (usingExternalTemperature ? 0 : REDUCE_KE_SCALAR));
+    } else if (computeMode == "tensor") {
+        state->dataManager.reductions.request(groupTag, REDUCE_VIRIAL_TENSOR | (usingExternalTemperature ? 0 : REDUCE_KE_TENSOR));
+    }
+}
+
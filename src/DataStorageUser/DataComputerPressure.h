@@ -21,6 +21,7 @@ namespace MD_ENGINE {
 
             DataComputerPressure(State *, std::string);
             void prepareForRun();
+            void requestReductions(uint32_t groupTag);
             double pressureScalar;
             bool usingExternalTemperature;
             double tempScalar; //if using externaltemp, then these must be set each time you go to compute pressure
@@ -30,6 +31,7 @@ namespace MD_ENGINE {
             //so these are just length 2 arrays.  First value is used for the result of the sum.  Second value is bit-cast to an int and used to cound how many values are present.
 
             void appendScalar(boost::python::list &);
+            bool scalarValue(double &val) { val = pressureScalar; return computeMode == "scalar"; };
             void appendVector(boost::python::list &);
             void appendTensor(boost::python::list &);
 
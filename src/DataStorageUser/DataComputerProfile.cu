@@ -0,0 +1,178 @@
+#include "DataComputerProfile.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Virial.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+//larger histograms are added to directly in global memory rather than staged per block
+#define PROFILE_MAX_SHARED_FLOATS 4096
+
+inline __device__ int profileWrapBin(int bin, int n, float periodic) {
+    if (bin < 0 or bin >= n) {
+        if (periodic) {
+            bin = ((bin % n) + n) % n;
+        } else {
+            bin = min(max(bin, 0), n-1);
+        }
+    }
+    return bin;
+}
+
+__global__ void profileBin_cu(float *sampleSums, int nComponents, int3 nBins, int nAtoms, const float4 *xs, const float4 *vs,
+                              const float4 *fs, const Virial *virials, GroupMask group, BoundsGPU bounds, int quantity,
+                              float mvvToEng, bool useShared) {
+    extern __shared__ float bins_shr[];
+    int nFloats = nBins.x * nBins.y * nBins.z * nComponents;
+    float *bins = useShared ? bins_shr : sampleSums;
+    if (useShared) {
+        for (int i=threadIdx.x; i<nFloats; i+=blockDim.x) {
+            bins_shr[i] = 0;
+        }
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    if (idx < nAtoms and group.contains(__float_as_uint(fs[idx].w), idx)) {
+        float3 frac = (make_float3(xs[idx]) - bounds.lo) * bounds.invRectComponents;
+        int3 b = make_int3(floorf(frac.x * nBins.x), floorf(frac.y * nBins.y), floorf(frac.z * nBins.z));
+        b.x = profileWrapBin(b.x, nBins.x, bounds.periodic.x);
+        b.y = profileWrapBin(b.y, nBins.y, bounds.periodic.y);
+        b.z = profileWrapBin(b.z, nBins.z, bounds.periodic.z);
+        float *dst = bins + ((b.x*nBins.y + b.y)*nBins.z + b.z) * nComponents;
+        float4 vWhole = vs[idx];
+        float m = 1.0f / vWhole.w;
+        if (quantity == PROFILEDENSITY) {
+            atomicAdd(dst, 1.0f);
+        } else if (quantity == PROFILETEMPERATURE) {
+            atomicAdd(dst, 1.0f);
+            atomicAdd(dst+1, m * lengthSqr(make_float3(vWhole)) * mvvToEng);
+        } else {
+            Virial virial = virials[idx];
+            float3 v = make_float3(vWhole) * mvvToEng;
+            float kinetic[6] = {m*v.x*vWhole.x, m*v.y*vWhole.y, m*v.z*vWhole.z,
+                                m*v.x*vWhole.y, m*v.x*vWhole.z, m*v.y*vWhole.z};
+            for (int i=0; i<6; i++) {
+                atomicAdd(dst+i, kinetic[i] + virial[i]);
+            }
+        }
+    }
+    if (useShared) {
+        __syncthreads();
+        for (int i=threadIdx.x; i<nFloats; i+=blockDim.x) {
+            if (bins_shr[i]) {
+                atomicAdd(sampleSums + i, bins_shr[i]);
+            }
+        }
+    }
+}
+
+//adds one sample's bins, times scale, to the running sums in double and clears them for the next
+__global__ void profileFold_cu(double *sums, float *sampleSums, int n, double scale) {
+    int idx = GETIDX();
+    if (idx < n) {
+        sums[idx] += sampleSums[idx] * scale;
+        sampleSums[idx] = 0;
+    }
+}
+
+DataComputerProfile::DataComputerProfile(State *state_, int quantity_, uint32_t groupTag_, int axis_, int nBinsPerAxis) : DataComputer(state_, "vector", quantity_ == PROFILESTRESS), quantity(quantity_), groupTag(groupTag_), axis(axis_), nSamples(0) {
+    //bins are by position, not by atom
+    requiresIds = false;
+    mdAssert(nBinsPerAxis > 0, "Profiles need at least one bin");
+    mdAssert(axis >= -1 and axis <= 2, "Profile axis must be x, y, z or xyz");
+    mdAssert(not (state->is2d and axis == 2), "Cannot bin along z in 2d simulations");
+    if (axis == -1) {
+        nBins = make_int3(nBinsPerAxis, nBinsPerAxis, state->is2d ? 1 : nBinsPerAxis);
+    } else {
+        nBins = make_int3(1, 1, 1);
+        ((int *) &nBins)[axis] = nBinsPerAxis;
+    }
+    requiresPerAtomVirials = quantity == PROFILESTRESS;
+    nComponents = quantity == PROFILEDENSITY ? 1 : (quantity == PROFILETEMPERATURE ? 2 : 6);
+    nBinsTotal = nBins.x * nBins.y * nBins.z;
+    sampleSums = GPUArrayDeviceGlobal<float>(nBinsTotal * nComponents);
+    sampleSums.memset(0);
+    sums = GPUArrayGlobal<double>(nBinsTotal * nComponents);
+    sums.d_data.memset(0);
+}
+
+void DataComputerProfile::prepareForRun() {
+    mdAssert(state->nPerRingPoly == 1, "Profiles are not supported for path integral simulations");
+}
+
+void DataComputerProfile::computeVector_GPU(bool transferToCPU, uint32_t) {
+    int nAtoms = state->atoms.size();
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    BoundsGPU &bounds = state->boundsGPU;
+    int nFloats = nBinsTotal * nComponents;
+    bool useShared = nFloats <= PROFILE_MAX_SHARED_FLOATS;
+    profileBin_cu<<<NBLOCK(nAtoms), PERBLOCK, useShared ? nFloats*sizeof(float) : 0>>>(
+            sampleSums.data(), nComponents, nBins, nAtoms, gpd.xs(activeIdx), gpd.vs(activeIdx), gpd.fs(activeIdx),
+            quantity == PROFILESTRESS ? gpd.virials.getDevData() : nullptr, state->groupMask(groupTag), bounds, quantity,
+            state->units.mvv_to_eng, useShared);
+    //densities and stresses are averaged per volume of the box as it is now, temperatures are ratios of sums
+    double binVolume = (state->is2d ? bounds.rectComponents.x * bounds.rectComponents.y : bounds.volume()) / nBinsTotal;
+    double scale = 1;
+    if (quantity == PROFILEDENSITY) {
+        scale = 1.0 / binVolume;
+    } else if (quantity == PROFILESTRESS) {
+        scale = state->units.nktv_to_press / binVolume;
+    }
+    profileFold_cu<<<NBLOCK(nFloats), PERBLOCK>>>(sums.getDevData(), sampleSums.data(), nFloats, scale);
+}
+
+void DataComputerProfile::computeVector_CPU() {
+    nSamples++;
+}
+
+py::object DataComputerProfile::getResult() {
+    sums.dataToHost();
+    cudaDeviceSynchronize();
+    py::list vals;
+    double dim = state->is2d ? 2 : 3;
+    double boltz = state->units.boltz;
+    for (int i=0; i<nBinsTotal; i++) {
+        double *bin = sums.h_data.data() + i*nComponents;
+        if (quantity == PROFILEDENSITY) {
+            vals.append(nSamples ? bin[0] / nSamples : 0.0);
+        } else if (quantity == PROFILETEMPERATURE) {
+            vals.append(bin[0] > 0 ? bin[1] / (dim * boltz * bin[0]) : 0.0);
+        } else {
+            for (int j=0; j<6; j++) {
+                vals.append(nSamples ? bin[j] / nSamples : 0.0);
+            }
+        }
+    }
+    py::object numpy = py::import("numpy");
+    BoundsGPU &bounds = state->boundsGPU;
+    py::list centers;
+    for (int d=0; d<3; d++) {
+        int n = ((int *) &nBins)[d];
+        double lo = ((float *) &bounds.lo)[d];
+        double width = ((float *) &bounds.rectComponents)[d] / n;
+        py::list dimCenters;
+        for (int i=0; i<n; i++) {
+            dimCenters.append(lo + (i + 0.5) * width);
+        }
+        centers.append(numpy.attr("array")(dimCenters));
+    }
+    py::object profile = numpy.attr("array")(vals);
+    if (axis == -1) {
+        py::tuple shape = quantity == PROFILESTRESS ? py::make_tuple(nBins.x, nBins.y, nBins.z, 6)
+                                                    : py::make_tuple(nBins.x, nBins.y, nBins.z);
+        return py::make_tuple(py::tuple(centers), profile.attr("reshape")(shape));
+    }
+    if (quantity == PROFILESTRESS) {
+        profile = profile.attr("reshape")(py::make_tuple(nBinsTotal, 6));
+    }
+    return py::make_tuple(centers[axis], profile);
+}
+
+void DataComputerProfile::resetResult() {
+    sums.d_data.memset(0);
+    nSamples = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef DATACOMPUTERPROFILE_H
+#define DATACOMPUTERPROFILE_H
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+
+namespace MD_ENGINE {
+    enum PROFILE {PROFILEDENSITY, PROFILETEMPERATURE, PROFILESTRESS};
+
+    //! Density, temperature or stress of a group binned along an axis or on a grid, averaged on the device
+    /*!
+     * Each sample adds its atoms to per-block histograms in shared memory,
+     * which are merged into one float histogram and then folded into
+     * running sums in double, so only the compact profile is ever copied
+     * back.  Bins divide the current box, so they follow it if it changes
+     * size.
+     *
+     * Densities are atoms per volume.  Temperatures are sum(m v^2) over the
+     * atoms of a bin divided by dim N k_B, with no degrees of freedom
+     * removed.  Stresses are the pressure tensor of each bin, from its
+     * kinetic tensor and per-atom virials, in the order xx, yy, zz, xy, xz,
+     * yz.
+     */
+    class DataComputerProfile : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t){};
+            void computeVector_GPU(bool, uint32_t);
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU(){};
+            void computeVector_CPU();
+            void computeTensor_CPU(){};
+
+            //! Bins along axis 0, 1 or 2, or along every axis of the box if axis_ is -1
+            DataComputerProfile(State *, int quantity_, uint32_t groupTag_, int axis_, int nBinsPerAxis);
+            void prepareForRun();
+
+            //! Nothing is appended per sample, the profile is read through getResult
+            void appendScalar(boost::python::list &){};
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Tuple of bin centers and the profile averaged over samples, as numpy arrays
+            /*!
+             * Profiles along one axis give a 1D array of centers.  Grids give
+             * a tuple of x, y and z centers and a profile shaped nx, ny, nz.
+             * Stress profiles have a trailing dimension of 6.
+             */
+            boost::python::object getResult();
+            void resetResult();
+
+            int quantity; //!< PROFILEDENSITY, PROFILETEMPERATURE or PROFILESTRESS
+            uint32_t groupTag;
+            int axis; //!< Axis binned along, -1 for a grid
+            int3 nBins; //!< Bins along each axis, 1 along axes which are not binned
+            int64_t nSamples;
+
+        private:
+            int nComponents; //!< Sums kept per bin
+            int nBinsTotal;
+            GPUArrayDeviceGlobal<float> sampleSums; //!< This sample's bins, folded into sums in double
+            GPUArrayGlobal<double> sums; //!< By bin*nComponents + component
+    };
+};
+
+#endif
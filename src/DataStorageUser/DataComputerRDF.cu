@@ -0,0 +1,232 @@
+#include "DataComputerRDF.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+//histograms live in shared memory, one unsigned int per bin
+#define RDF_MAX_BINS 8192
+
+__device__ void rdfBinPair(unsigned int *bins_shr, int nBins, float3 pos, float4 otherWhole, BoundsGPU &bounds, float rMaxSqr, float invDr) {
+    float3 dr = bounds.minImage(pos - make_float3(otherWhole));
+    float lenSqr = lengthSqr(dr);
+    if (lenSqr < rMaxSqr) {
+        //rounding can put distances just under rMax past the last bin
+        int bin = min((int) (sqrtf(lenSqr) * invDr), nBins-1);
+        atomicAdd(bins_shr + bin, 1u);
+    }
+}
+
+__device__ void rdfFlushBins(unsigned long long *counts, unsigned int *bins_shr, int nBins) {
+    __syncthreads();
+    for (int i=threadIdx.x; i<nBins; i+=blockDim.x) {
+        if (bins_shr[i]) {
+            atomicAdd(counts + i, (unsigned long long) bins_shr[i]);
+        }
+    }
+}
+
+//blockDim must be the nThreadPerBlock the neighbor list was built with
+__global__ void rdfNeighborList_cu(unsigned long long *counts, int nBins, float rMaxSqr, float invDr, int nAtoms,
+                                   const float4 *xs, const float4 *fs, GroupMask groupA, GroupMask groupB,
+                                   const uint16_t *neighborCounts, const uint *neighborlist,
+                                   const uint32_t *cumulSumMaxPerBlock, int warpSize, int nThreadPerAtom, BoundsGPU bounds) {
+    extern __shared__ unsigned int bins_shr[];
+    for (int i=threadIdx.x; i<nBins; i+=blockDim.x) {
+        bins_shr[i] = 0;
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    if (idx < nAtoms and groupA.contains(__float_as_uint(fs[idx].w), idx)) {
+        int baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, idx, nThreadPerAtom);
+        float3 pos = make_float3(xs[idx]);
+        int numNeigh = neighborCounts[idx];
+        //one thread walks the entries of the whole team
+        for (int nthNeigh=0; nthNeigh<numNeigh; nthNeigh++) {
+            int nlistIdx = baseIdx + nthNeigh % nThreadPerAtom + warpSize * (nthNeigh / nThreadPerAtom);
+            uint otherIdxRaw = neighborlist[nlistIdx];
+            uint otherIdx = otherIdxRaw & EXCL_MASK;
+            if (groupB.contains(__float_as_uint(fs[otherIdx].w), otherIdx)) {
+                rdfBinPair(bins_shr, nBins, pos, xs[otherIdx], bounds, rMaxSqr, invDr);
+            }
+        }
+    }
+    rdfFlushBins(counts, bins_shr, nBins);
+}
+
+//searches the cells within nShells of an atom's cell, or every cell along a dimension where nShells is -1
+__global__ void rdfCells_cu(unsigned long long *counts, int nBins, float rMaxSqr, float invDr, int nAtoms,
+                            const float4 *xs, const float4 *fs, GroupMask groupA, GroupMask groupB,
+                            const uint32_t *gridCellArrayIdxs, float3 os, float3 ds, int3 ns, int3 nShells,
+                            BoundsGPU bounds) {
+    extern __shared__ unsigned int bins_shr[];
+    for (int i=threadIdx.x; i<nBins; i+=blockDim.x) {
+        bins_shr[i] = 0;
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    if (idx < nAtoms and groupA.contains(__float_as_uint(fs[idx].w), idx)) {
+        float3 pos = make_float3(xs[idx]);
+        int3 sqrIdx = make_int3((pos - os) / ds);
+        sqrIdx = make_int3(min(max(sqrIdx.x, 0), ns.x-1), min(max(sqrIdx.y, 0), ns.y-1), min(max(sqrIdx.z, 0), ns.z-1));
+        int3 lo, n;
+        lo.x = nShells.x < 0 ? 0 : sqrIdx.x - nShells.x;
+        lo.y = nShells.y < 0 ? 0 : sqrIdx.y - nShells.y;
+        lo.z = nShells.z < 0 ? 0 : sqrIdx.z - nShells.z;
+        n.x = nShells.x < 0 ? ns.x : 2*nShells.x + 1;
+        n.y = nShells.y < 0 ? ns.y : 2*nShells.y + 1;
+        n.z = nShells.z < 0 ? ns.z : 2*nShells.z + 1;
+        for (int i=0; i<n.x; i++) {
+            int xIdx = lo.x + i;
+            if (xIdx < 0 or xIdx >= ns.x) {
+                if (not bounds.periodic.x) {
+                    continue;
+                }
+                xIdx = (xIdx + ns.x) % ns.x;
+            }
+            for (int j=0; j<n.y; j++) {
+                int yIdx = lo.y + j;
+                if (yIdx < 0 or yIdx >= ns.y) {
+                    if (not bounds.periodic.y) {
+                        continue;
+                    }
+                    yIdx = (yIdx + ns.y) % ns.y;
+                }
+                for (int k=0; k<n.z; k++) {
+                    int zIdx = lo.z + k;
+                    if (zIdx < 0 or zIdx >= ns.z) {
+                        if (not bounds.periodic.z) {
+                            continue;
+                        }
+                        zIdx = (zIdx + ns.z) % ns.z;
+                    }
+                    int3 cell = make_int3(xIdx, yIdx, zIdx);
+                    int cellLin = LINEARIDX(cell, ns);
+                    uint32_t idxMax = gridCellArrayIdxs[cellLin+1];
+                    for (int otherIdx=gridCellArrayIdxs[cellLin]; otherIdx<idxMax; otherIdx++) {
+                        if (otherIdx != idx and groupB.contains(__float_as_uint(fs[otherIdx].w), otherIdx)) {
+                            rdfBinPair(bins_shr, nBins, pos, xs[otherIdx], bounds, rMaxSqr, invDr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    rdfFlushBins(counts, bins_shr, nBins);
+}
+
+DataComputerRDF::DataComputerRDF(State *state_, std::string groupHandleA_, std::string groupHandleB_, double rMax_, int nBins_) : DataComputer(state_, "vector", false), groupHandleA(groupHandleA_), groupHandleB(groupHandleB_), rMax(rMax_), nBins(nBins_), nSamples(0), sumPairDensity(0), useNeighborList(false), nPairs(0) {
+    //the histogram is by distance, not by atom
+    requiresIds = false;
+    groupTagA = state->groupTagFromHandle(groupHandleA);
+    groupTagB = state->groupTagFromHandle(groupHandleB);
+    mdAssert(rMax > 0, "RDF needs a positive rMax");
+    mdAssert(nBins > 0 and nBins <= RDF_MAX_BINS, "RDF needs between 1 and %d bins", RDF_MAX_BINS);
+    counts = GPUArrayGlobal<unsigned long long>(nBins);
+    counts.d_data.memset(0);
+}
+
+void DataComputerRDF::prepareForRun() {
+    mdAssert(state->nPerRingPoly == 1, "RDF is not supported for path integral simulations");
+    BoundsGPU &bounds = state->boundsGPU;
+    float3 trace = bounds.trace();
+    for (int dim=0; dim<(state->is2d ? 2 : 3); dim++) {
+        bool periodic = ((float *) &bounds.periodic)[dim];
+        float side = ((float *) &trace)[dim];
+        mdAssert(not periodic or rMax <= 0.5 * side, "RDF rMax must be at most half the box");
+    }
+    //pairs are only sure to be in the list if within the cutoff of their types
+    double listCut = state->rCut;
+    GridGPU &grid = state->gridGPU;
+    if (grid.typeCutoffs.size()) {
+        listCut = *std::min_element(grid.typeCutoffs.begin(), grid.typeCutoffs.end());
+    }
+    useNeighborList = rMax <= listCut;
+
+    double nA = 0, nB = 0, nBoth = 0;
+    for (Atom &a : state->atoms) {
+        bool inA = state->atomInGroup(a, groupTagA);
+        bool inB = state->atomInGroup(a, groupTagB);
+        nA += inA;
+        nB += inB;
+        nBoth += inA and inB;
+    }
+    nPairs = nA * nB - nBoth;
+}
+
+void DataComputerRDF::computeVector_GPU(bool transferToCPU, uint32_t groupTag) {
+    int nAtoms = state->atoms.size();
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    float invDr = nBins / rMax;
+    float rMaxSqr = rMax * rMax;
+    GroupMask groupA = state->groupMask(groupTagA);
+    GroupMask groupB = state->groupMask(groupTagB);
+    size_t sharedMem = nBins * sizeof(unsigned int);
+    if (useNeighborList) {
+        int nThreadPerBlock = state->nThreadPerBlock;
+        rdfNeighborList_cu<<<NBLOCKVAR(nAtoms, nThreadPerBlock), nThreadPerBlock, sharedMem>>>(
+                counts.getDevData(), nBins, rMaxSqr, invDr, nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), groupA, groupB,
+                grid.perAtomArray.d_data.data(), grid.neighborlist.data(), grid.perBlockArray.d_data.data(),
+                state->devManager.prop.warpSize, state->nThreadPerAtom, state->boundsGPU);
+    } else {
+        //atoms have moved up to half the padding since they were sorted into cells
+        double reach = rMax + grid.padding;
+        int3 nShells;
+        nShells.x = std::ceil(reach / grid.ds.x);
+        nShells.y = std::ceil(reach / grid.ds.y);
+        nShells.z = std::ceil(reach / grid.ds.z);
+        //search each cell once when the shells would wrap onto themselves
+        if (2*nShells.x + 1 >= grid.ns.x) {
+            nShells.x = -1;
+        }
+        if (2*nShells.y + 1 >= grid.ns.y) {
+            nShells.y = -1;
+        }
+        if (2*nShells.z + 1 >= grid.ns.z) {
+            nShells.z = -1;
+        }
+        rdfCells_cu<<<NBLOCK(nAtoms), PERBLOCK, sharedMem>>>(
+                counts.getDevData(), nBins, rMaxSqr, invDr, nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), groupA, groupB,
+                grid.perCellArray.d_data.data(), grid.os, grid.ds, grid.ns, nShells, state->boundsGPU);
+    }
+}
+
+void DataComputerRDF::computeVector_CPU() {
+    BoundsGPU &bounds = state->boundsGPU;
+    double volume = state->is2d ? bounds.rectComponents.x * bounds.rectComponents.y : bounds.volume();
+    sumPairDensity += nPairs / volume;
+    nSamples++;
+}
+
+py::object DataComputerRDF::getResult() {
+    counts.dataToHost();
+    cudaDeviceSynchronize();
+    py::list rs;
+    py::list gs;
+    double dr = rMax / nBins;
+    for (int i=0; i<nBins; i++) {
+        double rLo = i * dr;
+        double rHi = rLo + dr;
+        double shell = state->is2d ? M_PI * (rHi*rHi - rLo*rLo)
+                                   : 4.0 / 3.0 * M_PI * (rHi*rHi*rHi - rLo*rLo*rLo);
+        double ideal = sumPairDensity * shell;
+        rs.append(rLo + 0.5 * dr);
+        gs.append(ideal > 0 ? counts.h_data[i] / ideal : 0.0);
+    }
+    py::object numpy = py::import("numpy");
+    return py::make_tuple(numpy.attr("array")(rs), numpy.attr("array")(gs));
+}
+
+void DataComputerRDF::resetResult() {
+    counts.d_data.memset(0);
+    nSamples = 0;
+    sumPairDensity = 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef DATACOMPUTERRDF_H
+#define DATACOMPUTERRDF_H
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+
+namespace MD_ENGINE {
+    //! Radial distribution function between two groups, accumulated on the device
+    /*!
+     * Each sample bins the distances from atoms of group A to atoms of group
+     * B closer than rMax.  Counts are kept in per-block shared histograms and
+     * merged into a device histogram which is only copied back when the
+     * result is read, so sampling every few turns costs no transfers.
+     *
+     * If rMax is within the pair cutoff, pairs come from the live neighbor
+     * list.  Otherwise the atoms of the grid cells within rMax plus the
+     * padding are searched.  Both count every pair: bonded neighbors stay in
+     * the list with their special neighbor bits set, and those bits are
+     * masked off rather than used to skip the pair.
+     */
+    class DataComputerRDF : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t){};
+            void computeVector_GPU(bool, uint32_t);
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU(){};
+            void computeVector_CPU();
+            void computeTensor_CPU(){};
+
+            DataComputerRDF(State *, std::string groupHandleA_, std::string groupHandleB_, double rMax_, int nBins_);
+            void prepareForRun();
+
+            //! Nothing is appended per sample, the histogram is read through getResult
+            void appendScalar(boost::python::list &){};
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Tuple of numpy arrays of bin centers and g(r)
+            boost::python::object getResult();
+            //! Discard all samples so far
+            void resetResult();
+
+            std::string groupHandleA;
+            std::string groupHandleB;
+            uint32_t groupTagA;
+            uint32_t groupTagB;
+            double rMax;
+            int nBins;
+
+            GPUArrayGlobal<unsigned long long> counts; //!< Pairs in each bin, summed over samples
+            int64_t nSamples;
+            double sumPairDensity; //!< Sum over samples of distinct A-B pairs per volume
+
+        private:
+            bool useNeighborList; //!< Whether rMax is within the cutoff of every pair in the list
+            double nPairs; //!< Distinct ordered A-B pairs, nA nB less atoms in both groups
+    };
+};
+
+#endif
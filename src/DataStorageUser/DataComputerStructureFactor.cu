@@ -0,0 +1,171 @@
+#include "DataComputerStructureFactor.h"
+#include "cutils_func.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "Logging.h"
+#include "EwaldSpreading.h"
+
+#include <cmath>
+
+namespace py = boost::python;
+using namespace MD_ENGINE;
+
+//shared memory holds a float sum and count per bin
+#define STRUCTURE_FACTOR_MAX_BINS 4096
+#define STRUCTURE_FACTOR_MIN_GRID 16
+#define STRUCTURE_FACTOR_MAX_GRID 1024
+
+__global__ void structureFactorSpread_cu(int nAtoms, const float4 *xs, const float4 *fs, GroupMask group,
+                                         BoundsGPU bounds, int3 sz, float *grid) {
+    int idx = GETIDX();
+    if (idx < nAtoms and group.contains(__float_as_uint(fs[idx].w), idx)) {
+        spreadToGridOrder3(make_float3(xs[idx]), 1.0f, bounds, sz, grid);
+    }
+}
+
+//one thread per grid point, binning |rho(k)|^2 / N with the assignment function divided out
+__global__ void structureFactorBin_cu(float *sampleSums, float *sampleCounts, int nBins, const cufftComplex *grid,
+                                      int3 sz, float3 trace, float kMaxSqr, float invDk, float invN) {
+    extern __shared__ float bins_shr[];
+    for (int i=threadIdx.x; i<2*nBins; i+=blockDim.x) {
+        bins_shr[i] = 0;
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    if (idx < sz.x*sz.y*sz.z) {
+        int3 id = make_int3(idx / (sz.y*sz.z), (idx / sz.z) % sz.y, idx % sz.z);
+        //         2*PI
+        float3 k = 6.28318530717958647693f*make_float3(id)/trace;
+        if (id.x>sz.x/2) k.x= 6.28318530717958647693f*(id.x-sz.x)/trace.x;
+        if (id.y>sz.y/2) k.y= 6.28318530717958647693f*(id.y-sz.y)/trace.y;
+        if (id.z>sz.z/2) k.z= 6.28318530717958647693f*(id.z-sz.z)/trace.z;
+        //2d grids are one point thick
+        if (sz.z == 1) k.z = 0;
+        float kSqr = lengthSqr(k);
+        if (kSqr > 0 and kSqr < kMaxSqr) {
+            float W = assignmentTransform(k, trace/make_float3(sz), 3);
+            cufftComplex rho = grid[idx];
+            float s = (rho.x*rho.x + rho.y*rho.y) * invN / (W*W);
+            //rounding can put wave numbers just under kMax past the last bin
+            int bin = min((int) (sqrtf(kSqr) * invDk), nBins-1);
+            atomicAdd(bins_shr + bin, s);
+            atomicAdd(bins_shr + nBins + bin, 1.0f);
+        }
+    }
+    __syncthreads();
+    for (int i=threadIdx.x; i<nBins; i+=blockDim.x) {
+        if (bins_shr[nBins + i]) {
+            atomicAdd(sampleSums + i, bins_shr[i]);
+            atomicAdd(sampleCounts + i, bins_shr[nBins + i]);
+        }
+    }
+}
+
+//adds one sample's bins to the running sums in double and clears them for the next
+__global__ void structureFactorFold_cu(double *sums, double *counts, float *sampleSums, float *sampleCounts, int nBins) {
+    int idx = GETIDX();
+    if (idx < nBins) {
+        sums[idx] += sampleSums[idx];
+        counts[idx] += sampleCounts[idx];
+        sampleSums[idx] = 0;
+        sampleCounts[idx] = 0;
+    }
+}
+
+//smallest power of two grid whose Nyquist wave number is at least twice kMax along a side
+static int structureFactorGridSize(double side, double kMax) {
+    int n = STRUCTURE_FACTOR_MIN_GRID;
+    while (n < STRUCTURE_FACTOR_MAX_GRID and M_PI * n / side < 2 * kMax) {
+        n *= 2;
+    }
+    mdAssert(M_PI * n / side >= 2 * kMax, "Structure factor kMax of %f needs a grid of more than %d points per side",
+             kMax, STRUCTURE_FACTOR_MAX_GRID);
+    return n;
+}
+
+DataComputerStructureFactor::DataComputerStructureFactor(State *state_, std::string groupHandle_, double kMax_, int nBins_) : DataComputer(state_, "vector", false), groupHandle(groupHandle_), kMax(kMax_), nBins(nBins_), sz(make_int3(0, 0, 0)), planned(false), nMembers(0) {
+    //S(k) is binned by |k|, not by atom
+    requiresIds = false;
+    groupTag = state->groupTagFromHandle(groupHandle);
+    mdAssert(kMax > 0, "Structure factor needs a positive kMax");
+    mdAssert(nBins > 0 and nBins <= STRUCTURE_FACTOR_MAX_BINS, "Structure factor needs between 1 and %d bins",
+             STRUCTURE_FACTOR_MAX_BINS);
+    sums = GPUArrayGlobal<double>(nBins);
+    counts = GPUArrayGlobal<double>(nBins);
+    sampleSums = GPUArrayDeviceGlobal<float>(nBins);
+    sampleCounts = GPUArrayDeviceGlobal<float>(nBins);
+    resetResult();
+    sampleSums.memset(0);
+    sampleCounts.memset(0);
+}
+
+DataComputerStructureFactor::~DataComputerStructureFactor() {
+    if (planned) {
+        cufftDestroy(plan);
+    }
+}
+
+void DataComputerStructureFactor::prepareForRun() {
+    mdAssert(state->nPerRingPoly == 1, "Structure factor is not supported for path integral simulations");
+    BoundsGPU &bounds = state->boundsGPU;
+    mdAssert(bounds.periodic.x and bounds.periodic.y and (state->is2d or bounds.periodic.z),
+             "Structure factor needs a periodic box");
+    float3 trace = bounds.trace();
+    int3 szNew = make_int3(structureFactorGridSize(trace.x, kMax), structureFactorGridSize(trace.y, kMax),
+                           state->is2d ? 1 : structureFactorGridSize(trace.z, kMax));
+    if (not planned or szNew.x != sz.x or szNew.y != sz.y or szNew.z != sz.z) {
+        if (planned) {
+            cufftDestroy(plan);
+        }
+        sz = szNew;
+        if (state->is2d) {
+            cufftPlan2d(&plan, sz.x, sz.y, CUFFT_C2C);
+        } else {
+            cufftPlan3d(&plan, sz.x, sz.y, sz.z, CUFFT_C2C);
+        }
+        planned = true;
+        grid = GPUArrayDeviceGlobal<cufftComplex>(sz.x * sz.y * sz.z);
+    }
+    nMembers = 0;
+    for (Atom &a : state->atoms) {
+        nMembers += state->atomInGroup(a, groupTag);
+    }
+    mdAssert(nMembers, "Cannot compute the structure factor of group %s, which has no members", groupHandle.c_str());
+}
+
+void DataComputerStructureFactor::computeVector_GPU(bool transferToCPU, uint32_t) {
+    int nAtoms = state->atoms.size();
+    GPUData &gpd = state->gpd;
+    int activeIdx = gpd.activeIdx();
+    BoundsGPU &bounds = state->boundsGPU;
+    int nGrid = sz.x * sz.y * sz.z;
+    grid.memset(0);
+    structureFactorSpread_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx),
+                                                            state->groupMask(groupTag), bounds, sz, (float *) grid.data());
+    cufftExecC2C(plan, grid.data(), grid.data(), CUFFT_FORWARD);
+    structureFactorBin_cu<<<NBLOCK(nGrid), PERBLOCK, 2*nBins*sizeof(float)>>>(
+            sampleSums.data(), sampleCounts.data(), nBins, grid.data(), sz, bounds.trace(),
+            kMax*kMax, nBins / kMax, 1.0f / nMembers);
+    structureFactorFold_cu<<<NBLOCK(nBins), PERBLOCK>>>(sums.getDevData(), counts.getDevData(),
+                                                         sampleSums.data(), sampleCounts.data(), nBins);
+}
+
+py::object DataComputerStructureFactor::getResult() {
+    sums.dataToHost();
+    counts.dataToHost();
+    cudaDeviceSynchronize();
+    py::list ks;
+    py::list ss;
+    double dk = kMax / nBins;
+    for (int i=0; i<nBins; i++) {
+        ks.append((i + 0.5) * dk);
+        ss.append(counts.h_data[i] > 0 ? sums.h_data[i] / counts.h_data[i] : 0.0);
+    }
+    py::object numpy = py::import("numpy");
+    return py::make_tuple(numpy.attr("array")(ks), numpy.attr("array")(ss));
+}
+
+void DataComputerStructureFactor::resetResult() {
+    sums.d_data.memset(0);
+    counts.d_data.memset(0);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef DATACOMPUTERSTRUCTUREFACTOR_H
+#define DATACOMPUTERSTRUCTUREFACTOR_H
+
+#include <cufft.h>
+
+#include "DataComputer.h"
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+
+namespace MD_ENGINE {
+    //! Static structure factor S(k) of a group, accumulated on the device
+    /*!
+     * Each sample spreads the group's atoms with unit weights onto a
+     * periodic grid using the order 3 assignment of FixChargeEwald, takes its
+     * FFT, and adds |rho(k)|^2 / N, divided by the squared transform of the
+     * assignment function, into bins of |k|.  The grid is sized so kMax is
+     * at most half its Nyquist wave number, where the assignment correction
+     * is small.  This costs O(M log M) per sample for M grid points instead
+     * of the O(N Nk) of direct sums.
+     */
+    class DataComputerStructureFactor : public DataComputer {
+        public:
+
+            void computeScalar_GPU(bool, uint32_t){};
+            void computeVector_GPU(bool, uint32_t);
+            void computeTensor_GPU(bool, uint32_t){};
+
+            void computeScalar_CPU(){};
+            void computeVector_CPU(){};
+            void computeTensor_CPU(){};
+
+            DataComputerStructureFactor(State *, std::string groupHandle_, double kMax_, int nBins_);
+            ~DataComputerStructureFactor();
+            void prepareForRun();
+
+            //! Nothing is appended per sample, the bins are read through getResult
+            void appendScalar(boost::python::list &){};
+            void appendVector(boost::python::list &){};
+            void appendTensor(boost::python::list &){};
+
+            //! Tuple of numpy arrays of bin centers in |k| and S(k)
+            boost::python::object getResult();
+            //! Discard all samples so far
+            void resetResult();
+
+            std::string groupHandle;
+            uint32_t groupTag;
+            double kMax;
+            int nBins;
+
+            GPUArrayGlobal<double> sums;   //!< S summed over the wave vectors in each bin and over samples
+            GPUArrayGlobal<double> counts; //!< Wave vectors in each bin, summed over samples
+
+        private:
+            int3 sz;
+            bool planned;
+            cufftHandle plan;
+            GPUArrayDeviceGlobal<cufftComplex> grid;
+            GPUArrayDeviceGlobal<float> sampleSums;   //!< This sample's sums, folded into sums in double
+            GPUArrayDeviceGlobal<float> sampleCounts;
+            int nMembers;
+    };
+};
+
+#endif
@@ -14,21 +14,9 @@ DataComputerTemperature::DataComputerTemperature(State *state_, std::string comp
 
 
 void DataComputerTemperature::computeScalar_GPU(bool transferToCPU, uint32_t groupTag) {
-    GPUData &gpd = state->gpd;
-    gpuBuffer.d_data.memset(0);
     lastGroupTag = groupTag;
-    int nAtoms = state->atoms.size();
-    if (groupTag == 1) {
-         accumulate_gpu<float, float4, SumVectorSqr3DOverW, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
-            (gpuBuffer.getDevData(), state->gpd.vs.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVectorSqr3DOverW());
-    } else {
-        accumulate_gpu_if<float, float4, SumVectorSqr3DOverWIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float)>>>
-            (gpuBuffer.getDevData(), gpd.vs.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVectorSqr3DOverWIf(gpd.fs.getDevData(), groupTag));
-    }
-    if (transferToCPU) {
-        //does NOT sync
-        gpuBuffer.dataToHost();
-    }
+    //copies to the host whether or not transferToCPU is set, and does NOT sync
+    state->dataManager.reductions.reduce(groupTag, REDUCE_KE_SCALAR);
 }
 
 
@@ -36,6 +24,14 @@ void DataComputerTemperature::prepareForRun() {
     DataComputer::prepareForRun();
 }
 
+void DataComputerTemperature::requestReductions(uint32_t groupTag) {
+    if (computeMode == "scalar") {
+        state->dataManager.reductions.request(groupTag, REDUCE_KE_SCALAR);
+    } else if (computeMode == "tensor") {
+        state->dataManager.reductions.request(groupTag, REDUCE_KE_TENSOR);
+    }
+}
+
 
 void DataComputerTemperature::computeVector_GPU(bool transferToCPU, uint32_t groupTag) {
     GPUData &gpd = state->gpd;
@@ -53,27 +49,14 @@ void DataComputerTemperature::computeVector_GPU(bool transferToCPU, uint32_t gro
 }
 
 void DataComputerTemperature::computeTensor_GPU(bool transferToCPU, uint32_t groupTag) {
-    GPUData &gpd = state->gpd;
-    gpuBuffer.d_data.memset(0); 
     lastGroupTag = groupTag;
-    int nAtoms = state->atoms.size();
-    if (groupTag == 1) {
-        accumulate_gpu<Virial, float4, SumVectorToVirialOverW, N_DATA_PER_THREAD>  <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(Virial)>>>
-            ((Virial *) gpuBuffer.getDevData(), gpd.vs.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVectorToVirialOverW());    
-    } else {
-        accumulate_gpu_if<Virial, float4, SumVectorToVirialOverWIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(Virial)>>>
-            ((Virial *) gpuBuffer.getDevData(), gpd.vs.getDevData(), nAtoms, state->devManager.prop.warpSize, SumVectorToVirialOverWIf(gpd.fs.getDevData(), groupTag));
-    } 
-    if (transferToCPU) {
-        //does NOT sync
-        gpuBuffer.dataToHost();
-    }
+    //copies to the host whether or not transferToCPU is set, and does NOT sync
+    state->dataManager.reductions.reduce(groupTag, REDUCE_KE_TENSOR);
 }
 
 void DataComputerTemperature::computeScalar_CPU() {
     
-    //int n;
-    double total = gpuBuffer.h_data[0];
+    double total = state->dataManager.reductions.result(lastGroupTag).mvv();
     Group &thisGroup = state->groups[lastGroupTag];
 
     ndf = thisGroup.getNDF();
@@ -96,14 +79,14 @@ void DataComputerTemperature::computeVector_CPU() {
 
     for (int i=0; i<kes.size(); i++) {
         int idx = idToIdxOnCopy[ids[i]];
-        if (atoms[idx].groupTag & lastGroupTag) {
+        if (state->atomInGroup(atoms[idx], lastGroupTag)) {
             tempVector.push_back(kes[i] * conv);
         }
     }
 }
 
 void DataComputerTemperature::computeTensor_CPU() {
-    Virial total = *(Virial *) &gpuBuffer.h_data[0];
+    Virial total = state->dataManager.reductions.result(lastGroupTag).mvvTensor();
     total *= (state->units.mvv_to_eng / state->units.boltz);
     /*
        int n;
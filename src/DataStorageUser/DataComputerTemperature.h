@@ -29,6 +29,7 @@ namespace MD_ENGINE {
             //so these are just length 2 arrays.  First value is used for the result of the sum.  Second value is bit-cast to an int and used to cound how many values are present.
 
             void appendScalar(boost::python::list &);
+            bool scalarValue(double &val) { val = tempScalar; return computeMode == "scalar"; };
             void appendVector(boost::python::list &);
             void appendTensor(boost::python::list &);
 
@@ -36,6 +37,7 @@ namespace MD_ENGINE {
             Virial getTensor();
 
             void prepareForRun();
+            void requestReductions(uint32_t groupTag);
 
     };
 };
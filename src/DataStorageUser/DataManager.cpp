@@ -8,13 +8,21 @@
 #include "DataComputerCOMV.h"
 #include "DataComputerDipolarCoupling.h"
 #include "DataComputerEField.h"
+#include "DataComputerRDF.h"
+#include "DataComputerStructureFactor.h"
+#include "DataComputerProfile.h"
+#include "DataComputerEnergyMatrix.h"
+#include "DataComputerAlchemical.h"
+#include "FixLJCutSoftCore.h"
+#include "DataComputerCV.h"
+#include "DataComputerCorrelator.h"
 #include "DataSetUser.h"
 using namespace MD_ENGINE;
 using std::set;
 using std::pair;
 
 namespace py = boost::python;
-DataManager::DataManager(State * state_) : state(state_) {
+DataManager::DataManager(State * state_) : state(state_), reductions(state_) {
     //turnLastEngs = state->turn-1;
 }
 
@@ -127,6 +135,106 @@ boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordEField(double cutof
     return dataSet;
    
 }
+
+//g(r) of atoms in group B around atoms in group A, accumulated over samples and read through the data set's result
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordRDF(std::string groupHandleA, std::string groupHandleB, double rMax, int nBins, int interval, boost::python::object collectGenerator) {
+    int dataType = DATATYPE::RDF;
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerRDF(state, groupHandleA, groupHandleB, rMax, nBins));
+    uint32_t groupTag = state->groupTagFromHandle(groupHandleA);
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, groupTag, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//S(k) of a group, spherically averaged into bins of |k| up to kMax and read through the data set's result
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordStructureFactor(std::string groupHandle, double kMax, int nBins, int interval, boost::python::object collectGenerator) {
+    int dataType = DATATYPE::STRUCTUREFACTOR;
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerStructureFactor(state, groupHandle, kMax, nBins));
+    uint32_t groupTag = state->groupTagFromHandle(groupHandle);
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, groupTag, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//density, temperature or stress of a group binned along an axis of the box, or on a grid over all of them with axis 'xyz'
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordProfile(std::string quantity, std::string groupHandle, std::string axis, int nBins, int interval, boost::python::object collectGenerator) {
+    int dataType = DATATYPE::PROFILE;
+    int profileQuantity;
+    if (quantity == "density") {
+        profileQuantity = PROFILEDENSITY;
+    } else if (quantity == "temperature") {
+        profileQuantity = PROFILETEMPERATURE;
+    } else if (quantity == "stress") {
+        profileQuantity = PROFILESTRESS;
+    } else {
+        mdError("Unknown profile quantity %s, must be density, temperature or stress", quantity.c_str());
+    }
+    int axisIdx;
+    if (axis == "x") {
+        axisIdx = 0;
+    } else if (axis == "y") {
+        axisIdx = 1;
+    } else if (axis == "z") {
+        axisIdx = 2;
+    } else if (axis == "xyz") {
+        axisIdx = -1;
+    } else {
+        mdError("Unknown profile axis %s, must be x, y, z or xyz", axis.c_str());
+    }
+    uint32_t groupTag = state->groupTagFromHandle(groupHandle);
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerProfile(state, profileQuantity, groupTag, axisIdx, nBins));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, groupTag, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//interaction energies between each pair of a list of groups, from one neighbor list sweep per fix
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordEnergyMatrix(py::list groupHandles, int interval, py::object collectGenerator, py::list fixes) {
+    int dataType = DATATYPE::ENERGYMATRIX;
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerEnergyMatrix(state, groupHandles, fixes));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, 1, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//dU/dlambda of a soft-core fix and its energy at other lambdas, computed in the fix's force sweep on the turns sampled
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordAlchemical(boost::shared_ptr<FixLJCutSoftCore> fix, py::list lambdas, int interval, py::object collectGenerator) {
+    int dataType = DATATYPE::ALCHEMICAL;
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerAlchemical(state, fix, lambdas));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, 1, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//value of a collective variable, evaluated again on the turns recorded so it need not be biased
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordCV(boost::shared_ptr<CollectiveVariable> cv, int interval, py::object collectGenerator) {
+    int dataType = DATATYPE::COLLECTIVEVARIABLE;
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerCV(state, cv));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, 1, interval, collectGenerator);
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//mean squared displacement of a group against lag time, by multiple tau correlation over samples every interval turns
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordMSD(std::string groupHandle, int interval, int nPoints) {
+    int dataType = DATATYPE::MSD;
+    uint32_t groupTag = state->groupTagFromHandle(groupHandle);
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerCorrelator(state, CORRELATEMSD, groupTag, interval, nPoints));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, groupTag, interval, py::object());
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
+//velocity autocorrelation of a group against lag time, by multiple tau correlation over samples every interval turns
+boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordVACF(std::string groupHandle, int interval, int nPoints) {
+    int dataType = DATATYPE::VACF;
+    uint32_t groupTag = state->groupTagFromHandle(groupHandle);
+    boost::shared_ptr<DataComputer> comp = boost::shared_ptr<DataComputer> ( (DataComputer *) new DataComputerCorrelator(state, CORRELATEVACF, groupTag, interval, nPoints));
+    boost::shared_ptr<DataSetUser> dataSet = createDataSet(comp, groupTag, interval, py::object());
+    dataSets.push_back(dataSet);
+    return dataSet;
+}
+
 void DataManager::addVirialTurn(int64_t t, bool perAtomVirials) {
     if (perAtomVirials) {
         clearVirialTurn(t); //to make sure there aren't two entries and that ones with perAtomVirials==true take priority
@@ -223,6 +331,56 @@ void export_DataManager() {
             py::arg("interval") = 0,
             py::arg("collectGenerator") = py::object())
         )
+    .def("recordMSD", &DataManager::recordMSD,
+            (py::arg("handle") = "all",
+             py::arg("interval") = 1,
+             py::arg("nPoints") = 16)
+        )
+    .def("recordVACF", &DataManager::recordVACF,
+            (py::arg("handle") = "all",
+             py::arg("interval") = 1,
+             py::arg("nPoints") = 16)
+        )
+    .def("recordRDF", &DataManager::recordRDF,
+            (py::arg("handleA"),
+             py::arg("handleB"),
+             py::arg("rMax"),
+             py::arg("nBins") = 100,
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object())
+        )
+    .def("recordStructureFactor", &DataManager::recordStructureFactor,
+            (py::arg("handle"),
+             py::arg("kMax"),
+             py::arg("nBins") = 100,
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object())
+        )
+    .def("recordProfile", &DataManager::recordProfile,
+            (py::arg("quantity"),
+             py::arg("handle") = "all",
+             py::arg("axis") = "z",
+             py::arg("nBins") = 50,
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object())
+        )
+    .def("recordEnergyMatrix", &DataManager::recordEnergyMatrix,
+            (py::arg("handles"),
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object(),
+             py::arg("fixes") = py::list())
+        )
+    .def("recordAlchemical", &DataManager::recordAlchemical,
+            (py::arg("fix"),
+             py::arg("lambdas") = py::list(),
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object())
+        )
+    .def("recordCV", &DataManager::recordCV,
+            (py::arg("cv"),
+             py::arg("interval") = 0,
+             py::arg("collectGenerator") = py::object())
+        )
 
 //boost::shared_ptr<MD_ENGINE::DataSetUser> DataManager::recordDipolarCoupling(std::string groupHandle, std::string computeMode, std::string groupHandleB, double magnetoA, double magnetoB, int interval, boost::python::object collectGenerator) {
    /* 
@@ -8,7 +8,10 @@
 #include <string>
 #include <set>
 #include <utility>
+#include "ReductionPlanner.h"
 class State;
+class FixLJCutSoftCore;
+class CollectiveVariable;
 void export_DataManager();
 namespace MD_ENGINE {
 class DataSetUser;
@@ -29,6 +32,14 @@ class DataManager {
         boost::shared_ptr<MD_ENGINE::DataSetUser> recordCOMV(int collectEvery, boost::python::object collectGenerator); 
         boost::shared_ptr<MD_ENGINE::DataSetUser> recordDipolarCoupling(std::string groupHandle,  std::string groupHandleB, double magnetoA, double magnetaB, std::string computeMode, int interval, boost::python::object collectGenerator); 
         boost::shared_ptr<MD_ENGINE::DataSetUser> recordEField(double cutoff, int interval, boost::python::object collectGenerator); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordMSD(std::string groupHandle, int interval, int nPoints); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordVACF(std::string groupHandle, int interval, int nPoints); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordRDF(std::string groupHandleA, std::string groupHandleB, double rMax, int nBins, int interval, boost::python::object collectGenerator); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordStructureFactor(std::string groupHandle, double kMax, int nBins, int interval, boost::python::object collectGenerator); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordProfile(std::string quantity, std::string groupHandle, std::string axis, int nBins, int interval, boost::python::object collectGenerator); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordEnergyMatrix(boost::python::list groupHandles, int interval, boost::python::object collectGenerator, boost::python::list fixes); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordAlchemical(boost::shared_ptr<FixLJCutSoftCore> fix, boost::python::list lambdas, int interval, boost::python::object collectGenerator); 
+        boost::shared_ptr<MD_ENGINE::DataSetUser> recordCV(boost::shared_ptr<CollectiveVariable> cv, int interval, boost::python::object collectGenerator); 
 
         void stopRecord(boost::shared_ptr<MD_ENGINE::DataSetUser>);
 
@@ -37,6 +48,7 @@ class DataManager {
         //std::vector<SHARED(DataSetBounds)> dataSetsBounds;//no reason there should ever be more than one of these
 
         std::vector<boost::shared_ptr<DataSetUser> > dataSets;  //to be continually maintained
+        ReductionPlanner reductions; //!< Shared per-turn sums of kinetic energies, virials and momenta
 
         int getVirialModeForTurn(int64_t t);
         void addVirialTurn(int64_t, bool);
@@ -6,20 +6,22 @@
 namespace py = boost::python;
 using namespace MD_ENGINE;
 
-DataSetUser::DataSetUser(State *state_, boost::shared_ptr<DataComputer> computer_, uint32_t groupTag_, boost::python::object pyFunc_) : state(state_), computeMode(COMPUTEMODE::PYTHON), groupTag(groupTag_), computer(computer_), pyFunc(pyFunc_), pyFuncRaw(pyFunc_.ptr()) {
+DataSetUser::DataSetUser(State *state_, boost::shared_ptr<DataComputer> computer_, uint32_t groupTag_, boost::python::object pyFunc_) : state(state_), computeMode(COMPUTEMODE::PYTHON), groupTag(groupTag_), computer(computer_), keepVals(true), trackStats(false), pyFunc(pyFunc_), pyFuncRaw(pyFunc_.ptr()) {
     mdAssert(PyCallable_Check(pyFuncRaw), "Non-function passed to data set");
     setNextTurn(state->turn);
 }
 
-DataSetUser::DataSetUser(State *state_, boost::shared_ptr<DataComputer> computer_, uint32_t groupTag_, int interval_) : state(state_), computeMode(COMPUTEMODE::INTERVAL), groupTag(groupTag_), computer(computer_), interval(interval_) {
+DataSetUser::DataSetUser(State *state_, boost::shared_ptr<DataComputer> computer_, uint32_t groupTag_, int interval_) : state(state_), computeMode(COMPUTEMODE::INTERVAL), groupTag(groupTag_), computer(computer_), keepVals(true), trackStats(false), interval(interval_) {
     nextCompute = state->turn;
 
 }
 void DataSetUser::prepareForRun() {
     computer->prepareForRun();
+    computer->requestReductions(groupTag);
     
 }
 void DataSetUser::computeData() {
+    TraceScope scope(state->tracer.get(), "computeData");
     computer->compute_GPU(true, groupTag);
     //if (dataMode == DATAMODE::SCALAR) {
     //    computer->computeScalar_GPU(true, groupTag);
@@ -28,14 +30,51 @@ void DataSetUser::computeData() {
     //} else if (dataMode == DATAMODE::TENSOR) {
     //    computer->computeTensor_GPU(true, groupTag);
     //}
-    turns.append(state->turn);
+    if (keepVals) {
+        turns.append(state->turn);
+    }
 }
 
 void DataSetUser::appendData() {
+    TraceScope scope(state->tracer.get(), "appendData");
     computer->compute_CPU();
-    computer->appendData(vals);
+    if (trackStats) {
+        double val;
+        if (not computer->scalarValue(val)) {
+            mdError("Statistics can only be kept for scalar temperature, pressure, energy, lambda derivative and collective variable data");
+        }
+        stats.push(val);
+    }
+    if (keepVals) {
+        computer->appendData(vals);
+    }
+}
+
+boost::python::object DataSetUser::getResult() {
+    return computer->getResult();
 }
 
+void DataSetUser::resetResult() {
+    computer->resetResult();
+    stats.reset();
+    turns = boost::python::list();
+}
+
+boost::python::object DataSetUser::getStats() {
+    py::dict res;
+    res["n"] = stats.count();
+    res["mean"] = stats.mean();
+    res["variance"] = stats.variance();
+    res["error"] = stats.error();
+    res["correlationTime"] = stats.correlationTime();
+    res["converged"] = stats.converged();
+    py::list blockErrors;
+    for (int level=0; level<stats.levels.size(); level++) {
+        blockErrors.append(stats.blockError(level));
+    }
+    res["blockErrors"] = blockErrors;
+    return res;
+}
         
 int64_t DataSetUser::setNextTurn(int64_t currentTurn) {
     if (computeMode == COMPUTEMODE::INTERVAL) {
@@ -69,6 +108,11 @@ void export_DataSetUser() {
     .def_readonly("turns", &DataSetUser::turns)
     .def_readonly("vals", &DataSetUser::vals)
     .def_readwrite("interval", &DataSetUser::interval)
+    .add_property("result", &DataSetUser::getResult)
+    .def("resetResult", &DataSetUser::resetResult)
+    .def_readwrite("keepVals", &DataSetUser::keepVals)
+    .def_readwrite("trackStats", &DataSetUser::trackStats)
+    .add_property("stats", &DataSetUser::getStats)
     .add_property("pyFunc", &DataSetUser::getPyFunc, &DataSetUser::setPyFunc);
  //   .def("getDataSet", &DataManager::getDataSet)
     ;
@@ -9,6 +9,7 @@
 #undef _POSIX_C_SOURCE
 #include <boost/python.hpp>
 #include <string.h>
+#include "BlockAverager.h"
 class State;
 void export_DataSetUser();
 namespace MD_ENGINE {
@@ -16,7 +17,7 @@ namespace MD_ENGINE {
 class DataComputer;
 enum COMPUTEMODE {INTERVAL, PYTHON};
 enum DATAMODE {SCALAR, VECTOR, TENSOR};
-enum DATATYPE {TEMPERATURE, PRESSURE, ENERGY, BOUNDS, COMV, DIPOLARCOUPLING, EFIELD};
+enum DATATYPE {TEMPERATURE, PRESSURE, ENERGY, BOUNDS, COMV, DIPOLARCOUPLING, EFIELD, RDF, MSD, VACF, STRUCTUREFACTOR, PROFILE, ENERGYMATRIX, ALCHEMICAL, COLLECTIVEVARIABLE};
 class DataSetUser {
 private:
     State *state;
@@ -39,6 +40,19 @@ public:
     void computeData();
     void appendData();
 
+    //! Result accumulated by the computer over all samples, None if it appends per sample
+    boost::python::object getResult();
+    //! Discard the accumulated result, statistics and the turns sampled
+    void resetResult();
+
+    //! Whether turns and values are appended to turns and vals.  Turning this off keeps memory constant over a run
+    bool keepVals;
+    //! Whether running statistics of the scalar values are kept
+    bool trackStats;
+    BlockAverager stats;
+    //! Dict of the count, mean, variance, standard error, correlation time and block errors of the values
+    boost::python::object getStats();
+
     void setPyFunc(boost::python::object func_);
     boost::python::object getPyFunc();
     boost::python::object pyFunc;
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef MULTIPLETAUSCHEDULE_H
+#define MULTIPLETAUSCHEDULE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+namespace MD_ENGINE {
+
+    //! Bookkeeping of an order-n multiple tau correlator
+    /*!
+     * Level 0 keeps the last nPoints samples.  Every nAverage values pushed
+     * into a level are combined into one value of the next level, so level l
+     * keeps nPoints values spaced nAverage^l samples apart and the levels
+     * needed grow with the log of the number of samples.  Each value pushed
+     * into a level is correlated with the values the level holds, at lags of
+     * 0 to nPoints-1 entries.  Above level 0, lags below nPoints/nAverage are
+     * skipped as the level below already covers those times more finely.
+     *
+     * This class only decides which levels take a value on each sample and
+     * counts the correlations made.  What is stored and correlated, and
+     * where, is up to its user.
+     */
+    class MultipleTauSchedule {
+    public:
+        int nPoints;  //!< Values kept per level
+        int nAverage; //!< Values of a level combined into one of the next
+        std::vector<int64_t> nPushed; //!< Values pushed into each level
+        std::vector<int> nWaiting;    //!< Values of each level not yet combined
+        std::vector<double> nCorrelated; //!< Correlations made, by level*nPoints + lag
+
+        MultipleTauSchedule(int nPoints_=16, int nAverage_=2) : nPoints(nPoints_), nAverage(nAverage_) {};
+
+        //! Number of levels, starting from level 0, which take a value on the next sample
+        int levelsForNextSample() const {
+            int n = 1;
+            while (n <= nWaiting.size() and nWaiting[n-1] == nAverage - 1) {
+                n++;
+            }
+            return n;
+        }
+
+        //! Lowest lag correlated in a level
+        int firstLag(int level) const {
+            return level ? nPoints / nAverage : 0;
+        }
+
+        //! Lags correlated when the next value is pushed into a level, from firstLag
+        int nLagsOnPush(int level) const {
+            int64_t held = level < nPushed.size() ? nPushed[level] : 0;
+            return std::min<int64_t>(held + 1, nPoints);
+        }
+
+        //! Record that the first nLevels levels took a value
+        void advance(int nLevels) {
+            if (nPushed.size() < nLevels) {
+                nPushed.resize(nLevels, 0);
+                nWaiting.resize(nLevels, 0);
+                nCorrelated.resize(nLevels * nPoints, 0);
+            }
+            for (int level=0; level<nLevels; level++) {
+                int nLags = nLagsOnPush(level);
+                for (int lag=firstLag(level); lag<nLags; lag++) {
+                    nCorrelated[level*nPoints + lag]++;
+                }
+                nPushed[level]++;
+                //the last level taking a value starts collecting for the next one
+                nWaiting[level] = level < nLevels - 1 ? 0 : nWaiting[level] + 1;
+            }
+        }
+
+        //! Samples between the values correlated at a lag of a level
+        int64_t lagSamples(int level, int lag) const {
+            int64_t spacing = 1;
+            for (int i=0; i<level; i++) {
+                spacing *= nAverage;
+            }
+            return lag * spacing;
+        }
+
+        int nLevels() const {
+            return nPushed.size();
+        }
+
+        void reset() {
+            nPushed.clear();
+            nWaiting.clear();
+            nCorrelated.clear();
+        }
+    };
+
+}
+
+#endif
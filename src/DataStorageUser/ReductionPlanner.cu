@@ -0,0 +1,128 @@
+#include "ReductionPlanner.h"
+
+#include <algorithm>
+
+#include "State.h"
+#include "Group.h"
+#include "Logging.h"
+
+using namespace MD_ENGINE;
+
+//at most this many blocks sweep the atoms, so the partial sums stay small
+#define REDUCTION_MAX_BLOCKS 1024
+
+//sums of the observables over each block, one block after another
+__global__ void reduceObservables_cu(double *partials, const float4 *vs, const Virial *virials,
+                                     const uint *groupIds, const int *idToIdxs, int n, int observables) {
+    double sums[N_REDUCTION_SLOTS];
+    for (int i=0; i<N_REDUCTION_SLOTS; i++) {
+        sums[i] = 0;
+    }
+    for (int i=blockIdx.x*blockDim.x + threadIdx.x; i<n; i+=blockDim.x*gridDim.x) {
+        int idx = groupIds ? idToIdxs[groupIds[i]] : i;
+        reductionAddAtom(sums, vs[idx], virials ? virials + idx : nullptr, observables);
+    }
+    __shared__ double tmp[PERBLOCK];
+    for (int slot=0; slot<N_REDUCTION_SLOTS; slot++) {
+        if (not reductionSlotUsed(slot, observables)) {
+            if (threadIdx.x == 0) {
+                partials[blockIdx.x*N_REDUCTION_SLOTS + slot] = 0;
+            }
+            continue;
+        }
+        tmp[threadIdx.x] = sums[slot];
+        __syncthreads();
+        for (int stride=blockDim.x/2; stride>0; stride/=2) {
+            if (threadIdx.x < stride) {
+                tmp[threadIdx.x] += tmp[threadIdx.x + stride];
+            }
+            __syncthreads();
+        }
+        if (threadIdx.x == 0) {
+            partials[blockIdx.x*N_REDUCTION_SLOTS + slot] = tmp[0];
+        }
+        __syncthreads();
+    }
+}
+
+//one block per slot sums that slot over the blocks of the sweep, leaving the slots of keep
+__global__ void sumPartials_cu(double *sums, const double *partials, int nBlocks, int keep) {
+    __shared__ double tmp[PERBLOCK];
+    int slot = blockIdx.x;
+    if (reductionSlotUsed(slot, keep)) {
+        return;
+    }
+    double sum = 0;
+    for (int i=threadIdx.x; i<nBlocks; i+=blockDim.x) {
+        sum += partials[i*N_REDUCTION_SLOTS + slot];
+    }
+    tmp[threadIdx.x] = sum;
+    __syncthreads();
+    for (int stride=blockDim.x/2; stride>0; stride/=2) {
+        if (threadIdx.x < stride) {
+            tmp[threadIdx.x] += tmp[threadIdx.x + stride];
+        }
+        __syncthreads();
+    }
+    if (threadIdx.x == 0) {
+        sums[slot] = tmp[0];
+    }
+}
+
+void ReductionPlanner::request(uint32_t groupTag, int observables) {
+    requested[groupTag] |= observables;
+}
+
+void ReductionPlanner::clearRequests() {
+    requested.clear();
+    invalidate();
+}
+
+void ReductionPlanner::setCaching(bool caching_) {
+    caching = caching_;
+    invalidate();
+}
+
+void ReductionPlanner::reduce(uint32_t groupTag, int observables) {
+    Slot &slot = slots[groupTag];
+    bool current = caching and slot.turn == state->turn and slot.stamp == stamp;
+    if (current and (slot.observables & observables) == observables) {
+        return;
+    }
+    int planned = observables;
+    auto it = requested.find(groupTag);
+    if (it != requested.end()) {
+        planned |= it->second;
+    }
+    //sums from earlier this turn may still be read, so only the rest are swept
+    int keep = current ? slot.observables : 0;
+    GPUData &gpd = state->gpd;
+    int n = state->atoms.size();
+    uint *groupIds = nullptr;
+    int *idToIdxs = nullptr;
+    if (groupTag != 1) {
+        Group &group = state->groups[groupTag];
+        n = group.count;
+        groupIds = group.ids.getDevData();
+        idToIdxs = gpd.idToIdxs.getDevData();
+    }
+    int nBlocks = std::max(1, std::min(NBLOCK(n), REDUCTION_MAX_BLOCKS));
+    if (slot.partials.size() == 0) {
+        slot.partials = GPUArrayDeviceGlobal<double>(REDUCTION_MAX_BLOCKS * N_REDUCTION_SLOTS);
+        slot.sums = GPUArrayGlobal<double>(N_REDUCTION_SLOTS);
+    }
+    reduceObservables_cu<<<nBlocks, PERBLOCK>>>(slot.partials.data(), gpd.vs.getDevData(), gpd.virials.getDevData(),
+                                                groupIds, idToIdxs, n, planned & ~keep);
+    sumPartials_cu<<<N_REDUCTION_SLOTS, PERBLOCK>>>(slot.sums.getDevData(), slot.partials.data(), nBlocks, keep);
+    //does NOT sync
+    slot.sums.dataToHost();
+    slot.turn = state->turn;
+    slot.stamp = stamp;
+    slot.observables = planned | keep;
+    nSweeps++;
+}
+
+ReductionResult ReductionPlanner::result(uint32_t groupTag) {
+    mdAssert(slots.find(groupTag) != slots.end(), "No reductions were computed for group tag %u", groupTag);
+    return ReductionResult(slots[groupTag].sums.h_data.data());
+}
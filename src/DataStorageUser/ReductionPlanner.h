@@ -0,0 +1,208 @@
+#pragma once
+#ifndef REDUCTIONPLANNER_H
+#define REDUCTIONPLANNER_H
+
+#include <map>
+#include <stdint.h>
+
+#include "globalDefs.h"
+#include "cutils_math.h"
+#include "Virial.h"
+#include "GPUArrayGlobal.h"
+#include "GPUArrayDeviceGlobal.h"
+
+class State;
+
+namespace MD_ENGINE {
+
+    //! Observables which the ReductionPlanner sums over the atoms of a group
+    enum REDUCTION {
+        REDUCE_KE_SCALAR = 1,     //!< Sum of m v^2
+        REDUCE_KE_TENSOR = 2,     //!< Sum of m v_a v_b, ordered like Virial
+        REDUCE_VIRIAL_SCALAR = 4, //!< Sum of the diagonal of the per-atom virials
+        REDUCE_VIRIAL_TENSOR = 8, //!< Sum of the per-atom virials
+        REDUCE_MOMENTUM = 16      //!< Sum of m v and of m
+    };
+
+    //! Where each observable is kept in the array of sums
+    enum REDUCTIONSLOT {
+        SLOT_MVV = 0,
+        SLOT_MVV_TENSOR = 1,
+        SLOT_VIRIAL = 7,
+        SLOT_MOMENTUM = 13,
+        N_REDUCTION_SLOTS = 17
+    };
+
+    //! Whether a slot of the sums is filled for a set of observables
+    inline __host__ __device__ bool reductionSlotUsed(int slot, int observables) {
+        if (slot == SLOT_MVV) {
+            return observables & REDUCE_KE_SCALAR;
+        } else if (slot < SLOT_VIRIAL) {
+            return observables & REDUCE_KE_TENSOR;
+        } else if (slot < SLOT_VIRIAL + 3) {
+            return observables & (REDUCE_VIRIAL_SCALAR | REDUCE_VIRIAL_TENSOR);
+        } else if (slot < SLOT_MOMENTUM) {
+            return observables & REDUCE_VIRIAL_TENSOR;
+        }
+        return observables & REDUCE_MOMENTUM;
+    }
+
+    //! Add the contributions of one atom to the sums
+    /*!
+     * \param sums Running sums, N_REDUCTION_SLOTS long
+     * \param v Velocity, with the inverse mass in w
+     * \param virial Per-atom virial, only read if a virial is reduced
+     * \param observables Bitwise or of REDUCTION values
+     */
+    inline __host__ __device__ void reductionAddAtom(double *sums, float4 v, const Virial *virial, int observables) {
+        if (observables & (REDUCE_KE_SCALAR | REDUCE_KE_TENSOR | REDUCE_MOMENTUM)) {
+            double m = 1.0 / v.w;
+            double vx = v.x;
+            double vy = v.y;
+            double vz = v.z;
+            if (observables & REDUCE_KE_SCALAR) {
+                sums[SLOT_MVV] += m * (vx*vx + vy*vy + vz*vz);
+            }
+            if (observables & REDUCE_KE_TENSOR) {
+                sums[SLOT_MVV_TENSOR] += m * vx*vx;
+                sums[SLOT_MVV_TENSOR+1] += m * vy*vy;
+                sums[SLOT_MVV_TENSOR+2] += m * vz*vz;
+                sums[SLOT_MVV_TENSOR+3] += m * vx*vy;
+                sums[SLOT_MVV_TENSOR+4] += m * vx*vz;
+                sums[SLOT_MVV_TENSOR+5] += m * vy*vz;
+            }
+            if (observables & REDUCE_MOMENTUM) {
+                sums[SLOT_MOMENTUM] += m * vx;
+                sums[SLOT_MOMENTUM+1] += m * vy;
+                sums[SLOT_MOMENTUM+2] += m * vz;
+                sums[SLOT_MOMENTUM+3] += m;
+            }
+        }
+        if (observables & (REDUCE_VIRIAL_SCALAR | REDUCE_VIRIAL_TENSOR)) {
+            int nComponents = (observables & REDUCE_VIRIAL_TENSOR) ? 6 : 3;
+            for (int i=0; i<nComponents; i++) {
+                sums[SLOT_VIRIAL+i] += virial->vals[i];
+            }
+        }
+    }
+
+    //! Host version of the fused sweep over the atoms
+    /*!
+     * \param sums Set to the sums, N_REDUCTION_SLOTS long
+     * \param vs Velocities, with inverse masses in w
+     * \param virials Per-atom virials, or nullptr if none are reduced
+     * \param idxs Indices of the atoms to sum over, or nullptr for the first n
+     * \param n Number of atoms to sum over
+     * \param observables Bitwise or of REDUCTION values
+     * \param keep Observables already in sums, whose slots are left as they are
+     */
+    inline void reduceHost(double *sums, const float4 *vs, const Virial *virials, const int *idxs, int n, int observables,
+                           int keep=0) {
+        double swept[N_REDUCTION_SLOTS];
+        for (int i=0; i<N_REDUCTION_SLOTS; i++) {
+            swept[i] = 0;
+        }
+        for (int i=0; i<n; i++) {
+            int idx = idxs ? idxs[i] : i;
+            reductionAddAtom(swept, vs[idx], virials ? virials + idx : nullptr, observables);
+        }
+        for (int i=0; i<N_REDUCTION_SLOTS; i++) {
+            if (not reductionSlotUsed(i, keep)) {
+                sums[i] = swept[i];
+            }
+        }
+    }
+
+    //! Sums from one sweep, read through named observables
+    class ReductionResult {
+    public:
+        const double *sums;
+        ReductionResult(const double *sums_) : sums(sums_) {};
+        double mvv() const {
+            return sums[SLOT_MVV];
+        }
+        Virial mvvTensor() const {
+            const double *s = sums + SLOT_MVV_TENSOR;
+            return Virial(s[0], s[1], s[2], s[3], s[4], s[5]);
+        }
+        double virialScalar() const {
+            return sums[SLOT_VIRIAL] + sums[SLOT_VIRIAL+1] + sums[SLOT_VIRIAL+2];
+        }
+        Virial virialTensor() const {
+            const double *s = sums + SLOT_VIRIAL;
+            return Virial(s[0], s[1], s[2], s[3], s[4], s[5]);
+        }
+        //! Summed momentum in xyz and total mass in w
+        float4 momentum() const {
+            const double *s = sums + SLOT_MOMENTUM;
+            return make_float4(s[0], s[1], s[2], s[3]);
+        }
+    };
+
+    //! Computes the thermodynamic sums needed on a turn in one pass over the atoms
+    /*!
+     * Temperature, pressure and center of mass velocity computers, and the
+     * thermostats and barostats using them, each used to sweep the velocities
+     * or virials separately.  Instead, consumers request the observables they
+     * will need for a group when preparing for a run, and the first reduction
+     * of a group on a turn computes all of them at once, accumulating in
+     * double precision.  Later reductions of the group are served from those
+     * sums until the velocities or virials may have changed.  A later
+     * reduction wanting observables the sweep did not cover, as the
+     * temperature and pressure computers fixes keep for themselves do, sweeps
+     * only those and keeps the rest.
+     *
+     * The integrator calls invalidate() before each fix's step hooks and
+     * before forces, so results are only shared between consumers which run
+     * back to back, such as a thermostat's stepFinal and the data sets of the
+     * same turn.  Fixes which change velocities after reducing them call
+     * invalidate() themselves.  Outside of runs nothing is cached.
+     */
+    class ReductionPlanner {
+    public:
+        ReductionPlanner() : state(nullptr), stamp(0), caching(false), nSweeps(0) {};
+        ReductionPlanner(State *state_) : state(state_), stamp(0), caching(false), nSweeps(0) {};
+
+        //! Add observables to compute whenever a group is swept
+        void request(uint32_t groupTag, int observables);
+        //! Forget all requests, at the start of preparing a run
+        void clearRequests();
+        //! Mark all sums as stale, because velocities or virials may have changed
+        void invalidate() {
+            stamp++;
+        }
+        //! Turn sharing of sums within a turn on or off
+        void setCaching(bool caching_);
+
+        //! Make sure the sums of the observables over a group are computed
+        /*!
+         * Launches the sweep and the copy to the host if needed, without
+         * synchronizing.  Read the sums with result() after synchronizing.
+         */
+        void reduce(uint32_t groupTag, int observables);
+        //! Sums of the last sweep over a group
+        ReductionResult result(uint32_t groupTag);
+
+        int64_t nSweeps; //!< Number of sweeps over the atoms so far
+
+    private:
+        //! Sums of one group
+        class Slot {
+        public:
+            int64_t turn;
+            uint64_t stamp;
+            int observables;
+            GPUArrayGlobal<double> sums;
+            GPUArrayDeviceGlobal<double> partials; //!< Sums of each block of the sweep
+            Slot() : turn(-1), stamp(0), observables(0) {};
+        };
+        State *state;
+        uint64_t stamp;
+        bool caching;
+        std::map<uint32_t, int> requested;
+        std::map<uint32_t, Slot> slots;
+    };
+
+}
+
+#endif
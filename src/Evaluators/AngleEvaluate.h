@@ -1,3 +1,4 @@
+#include "GroupMatrixShare.h"
 #define SMALL 0.0001f
 template <class ANGLETYPE, class EVALUATOR, bool COMPUTEVIRIALS>
 __global__ void compute_force_angle(int nAtoms, float4 *xs, float4 *forces, int *idToIdxs, AngleGPU *angles, int *startstops, BoundsGPU bounds, ANGLETYPE *parameters_arg, int nParameters, Virial *__restrict__ virials, bool usingSharedMemForParams, EVALUATOR evaluator) {
@@ -159,7 +160,7 @@ __global__ void compute_force_angle(int nAtoms, float4 *xs, float4 *forces, int
 
 
 template <class ANGLETYPE, class EVALUATOR>
-__global__ void compute_energy_angle(int nAtoms, float4 *xs, float *perParticleEng, int *idToIdxs, AngleGPU *angles, int *startstops, BoundsGPU bounds, ANGLETYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator) {
+__global__ void compute_energy_angle(int nAtoms, float4 *xs, float *perParticleEng, int *idToIdxs, AngleGPU *angles, int *startstops, BoundsGPU bounds, ANGLETYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator, GroupMatrix groupMatrix) {
 
     int idx = GETIDX();
     extern __shared__ char all_shr[];
@@ -247,10 +248,17 @@ __global__ void compute_energy_angle(int nAtoms, float4 *xs, float *perParticleE
                 }
                 s = 1.0f / s;
                 float theta = acosf(c);
-                engSum += evaluator.energy(angleType, theta, directors);
+                float eng = evaluator.energy(angleType, theta, directors);
+                if (groupMatrix.matrix) {
+                    addGroupMatrixShare(groupMatrix, angle.ids, 3, myIdxInAngle, eng);
+                } else {
+                    engSum += eng;
+                }
 
             }
-            perParticleEng[idxSelf] += engSum;
+            if (not groupMatrix.matrix) {
+                perParticleEng[idxSelf] += engSum;
+            }
         }
     }
 }
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef EVALUATOR_ANGLE_TABULATED
+#define EVALUATOR_ANGLE_TABULATED
+
+#include "cutils_math.h"
+#include "Angle.h"
+#include "TabulatedSpline.h"
+
+//! Angle energies and forces from spline tables of energy against angle
+/*!
+ * Same as AngleEvaluatorHarmonic, with dE/dtheta read from the angle type's
+ * table instead of k (theta - theta0).  See FixAngleTabulated.
+ */
+class AngleEvaluatorTabulated {
+public:
+    const float4 *coefs;
+
+    inline __device__ float2 lookup(AngleTabulatedType angleType, float theta) {
+        return TabulatedSpline::evaluate(coefs + angleType.offset, angleType.nSegments,
+                                         angleType.x0, angleType.invDx, theta);
+    }
+
+    inline __device__ float3 force(AngleTabulatedType angleType, float theta, float s, float c, float distSqrs[2], float3 directors[2], float invDistProd, int myIdxInAngle) {
+        float forceConst = lookup(angleType, theta).y;
+        float a = -2.0f * forceConst * s;
+        float a11 = a*c/distSqrs[0];
+        float a12 = -a*invDistProd;
+        float a22 = a*c/distSqrs[1];
+        if (myIdxInAngle==0) {
+            return ((directors[0] * a11) + (directors[1] * a12)) * 0.5;
+        } else if (myIdxInAngle==1) {
+            return ((directors[0] * a11) + (directors[1] * a12) + (directors[1] * a22) + (directors[0] * a12)) * -0.5; 
+        } else {
+            return ((directors[1] * a22) + (directors[0] * a12)) * 0.5;
+        }
+    }
+
+    inline __device__ double3 force(AngleTabulatedType angleType, double theta, double s, double c, double distSqrs[2], double3 directors[2], double invDistProd, int myIdxInAngle) {
+        double forceConst = lookup(angleType, theta).y;
+        double a = -2.0f * forceConst * s;
+        double a11 = a*c/distSqrs[0];
+        double a12 = -a*invDistProd;
+        double a22 = a*c/distSqrs[1];
+        if (myIdxInAngle==0) {
+            return ((directors[0] * a11) + (directors[1] * a12)) * 0.5;
+        } else if (myIdxInAngle==1) {
+            return ((directors[0] * a11) + (directors[1] * a12) + (directors[1] * a22) + (directors[0] * a12)) * -0.5; 
+        } else {
+            return ((directors[1] * a22) + (directors[0] * a12)) * 0.5;
+        }
+    }
+
+    inline __device__ void forcesAll(AngleTabulatedType angleType, float theta, float s, float c, float distSqrs[2], float3 directors[2], float invDistProd, float3 forces[3]) {
+        float forceConst = lookup(angleType, theta).y;
+        float a = -2.0f * forceConst * s;
+        float a11 = a*c/distSqrs[0];
+        float a12 = -a*invDistProd;
+        float a22 = a*c/distSqrs[1];
+        forces[0] = ((directors[0] * a11) + (directors[1] * a12)) * 0.5;
+        forces[1] = ((directors[0] * a11) + (directors[1] * a12) + (directors[1] * a22) + (directors[0] * a12)) * -0.5; 
+        forces[2] = ((directors[1] * a22) + (directors[0] * a12)) * 0.5;
+    }
+
+    inline __device__ void forcesAll(AngleTabulatedType angleType, double theta, double s, double c, double distSqrs[2], double3 directors[2], double invDistProd, double3 forces[3]) {
+        double forceConst = lookup(angleType, theta).y;
+        double a = -2.0f * forceConst * s;
+        double a11 = a*c/distSqrs[0];
+        double a12 = -a*invDistProd;
+        double a22 = a*c/distSqrs[1];
+        forces[0] = ((directors[0] * a11) + (directors[1] * a12)) * 0.5;
+        forces[1] = ((directors[0] * a11) + (directors[1] * a12) + (directors[1] * a22) + (directors[0] * a12)) * -0.5; 
+        forces[2] = ((directors[1] * a22) + (directors[0] * a12)) * 0.5;
+    }
+
+    inline __device__ float energy(AngleTabulatedType angleType, float theta, float3 directors[2]) {
+        return lookup(angleType, theta).x * (1.0f / 3.0f); // energy split between three atoms
+    }
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include "GroupMatrixShare.h"
 #define SMALL 0.0001f
 template <class BONDTYPE, class EVALUATOR, bool COMPUTEVIRIALS>
 __global__ void compute_force_bond(int nAtoms, float4 *xs, float4 *forces, int *idToIdxs, BondGPU *bonds, int *startstops, BONDTYPE *parameters_arg, int nParameters, BoundsGPU bounds, Virial *__restrict__ virials, bool usingSharedMemForParams, EVALUATOR T) {
@@ -78,7 +79,7 @@ __global__ void compute_force_bond(int nAtoms, float4 *xs, float4 *forces, int *
 
 
 template <class BONDTYPE, class EVALUATOR>
-__global__ void compute_energy_bond(int nAtoms, float4 *xs, float *perParticleEng, int *idToIdxs, BondGPU *bonds, int *startstops, BONDTYPE *parameters_arg, int nParameters, BoundsGPU bounds, bool usingSharedMemForParams, EVALUATOR T) {
+__global__ void compute_energy_bond(int nAtoms, float4 *xs, float *perParticleEng, int *idToIdxs, BondGPU *bonds, int *startstops, BONDTYPE *parameters_arg, int nParameters, BoundsGPU bounds, bool usingSharedMemForParams, EVALUATOR T, GroupMatrix groupMatrix) {
     int idx = GETIDX();
     extern __shared__ char all_shr[];
     int idxBeginCopy = startstops[blockDim.x*blockIdx.x];
@@ -123,9 +124,17 @@ __global__ void compute_energy_bond(int nAtoms, float4 *xs, float *perParticleEn
                 // printf("xs %f %f\n", pos.x, posOther.x);
                 float3 bondVec  = bounds.minImage(pos - posOther);
                 float rSqr = lengthSqr(bondVec);
-                energySum += T.energy(bondVec, rSqr, bondType);
+                float eng = T.energy(bondVec, rSqr, bondType);
+                if (groupMatrix.matrix) {
+                    int ids[2] = {myId, otherId};
+                    addGroupMatrixShare(groupMatrix, ids, 2, 0, eng);
+                } else {
+                    energySum += eng;
+                }
+            }
+            if (not groupMatrix.matrix) {
+                perParticleEng[myIdx] += energySum;
             }
-            perParticleEng[myIdx] += energySum;
         }
     }
 }
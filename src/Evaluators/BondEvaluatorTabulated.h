@@ -0,0 +1,45 @@
+#pragma once
+#ifndef BONDEVALUATORTABULATED_H
+#define BONDEVALUATORTABULATED_H
+
+#include "Bond.h"
+#include "TabulatedSpline.h"
+
+//! Bond energies and forces from spline tables of energy against length
+/*!
+ * Each bond type points at its segments in coefs, see FixBondTabulated.
+ */
+class BondEvaluatorTabulated {
+public:
+    const float4 *coefs;
+
+    inline __device__ float3 force(float3 bondVec, float rSqr, BondTabulatedType bondType) {
+        float r = sqrtf(rSqr);
+        if (r > 0) {
+            float2 ed = TabulatedSpline::evaluate(coefs + bondType.offset, bondType.nSegments,
+                                                  bondType.x0, bondType.invDx, r);
+            float fBond = -ed.y/r;
+            return bondVec * fBond;
+        }
+        return make_float3(0, 0, 0);
+    }
+
+    // double precision
+    inline __device__ double3 force(double3 bondVec, double rSqr, BondTabulatedType bondType) {
+        double r = sqrt(rSqr);
+        if (r > 0) {
+            float2 ed = TabulatedSpline::evaluate(coefs + bondType.offset, bondType.nSegments,
+                                                  bondType.x0, bondType.invDx, r);
+            double fBond = -ed.y/r;
+            return bondVec * fBond;
+        }
+        return make_double3(0, 0, 0);
+    }
+
+    inline __device__ float energy(float3 bondVec, float rSqr, BondTabulatedType bondType) {
+        float2 ed = TabulatedSpline::evaluate(coefs + bondType.offset, bondType.nSegments,
+                                              bondType.x0, bondType.invDx, sqrtf(rSqr));
+        return 0.5f * ed.x; //0.5 for splitting between atoms
+    }
+};
+#endif
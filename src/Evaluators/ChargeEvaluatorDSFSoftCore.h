@@ -0,0 +1,57 @@
+#pragma once
+#ifndef EVALUATOR_DSF_SOFTCORE
+#define EVALUATOR_DSF_SOFTCORE
+//Damped shifted force Coulomb (see ChargeEvaluatorDSF) scaled by lambda with a soft core
+//U = lambda U_DSF(R),  R = sqrt(alphaSC (1-lambda) + r^2)
+//alphaSC is in units of distance squared.  Pairs are still cut off at r = r_cut
+
+#include "cutils_math.h"
+
+class ChargeEvaluatorDSFSoftCore {
+    public:
+        float alpha;
+        float A;
+        float shift;
+        float qqr_to_eng;
+        float r_cut;
+        float alphaSC;
+        //-dU_DSF/dR
+        inline __device__ float dsfForce(float len, float qiqj) {
+            return qqr_to_eng * qiqj * (erfcf(alpha*len)/(len*len) + A*expf(-alpha*alpha*len*len)/len - shift);
+        }
+
+        inline __device__ float dsfEnergy(float len, float qiqj) {
+            return qqr_to_eng * qiqj * (erfcf(alpha*len)/len - erfcf(alpha*r_cut)/r_cut + shift*(len-r_cut));
+        }
+
+        inline __device__ float3 force(float3 dr, float lenSqr, float qi, float qj, float multiplier, float lambda) {
+            if (multiplier and lambda) {
+                float len = sqrtf(alphaSC*(1-lambda) + lenSqr);
+                float forceScalar = lambda * dsfForce(len, qi*qj) / len * multiplier;
+                return dr * forceScalar;
+            }
+            return make_float3(0, 0, 0);
+        }
+
+        inline __device__ float energy(float lenSqr, float qi, float qj, float multiplier, float lambda) {
+            if (multiplier and lambda) {
+                float len = sqrtf(alphaSC*(1-lambda) + lenSqr);
+                return 0.5f * lambda * dsfEnergy(len, qi*qj) * multiplier;
+            }
+            return 0;
+        }
+
+        //dU/dlambda = U_DSF(R) + lambda dU_DSF/dR dR/dlambda, with dR/dlambda = -alphaSC / 2R
+        inline __device__ float dEnergyDLambda(float lenSqr, float qi, float qj, float multiplier, float lambda) {
+            if (multiplier) {
+                float len = sqrtf(alphaSC*(1-lambda) + lenSqr);
+                float qiqj = qi*qj;
+                return 0.5f * (dsfEnergy(len, qiqj) + lambda * dsfForce(len, qiqj) * alphaSC / (2*len)) * multiplier;
+            }
+            return 0;
+        }
+        ChargeEvaluatorDSFSoftCore(float alpha_, float A_, float shift_, float qqr_to_eng_, float r_cut_, float alphaSC_) : alpha(alpha_), A(A_), shift(shift_), qqr_to_eng(qqr_to_eng_), r_cut(r_cut_), alphaSC(alphaSC_) {};
+
+};
+
+#endif
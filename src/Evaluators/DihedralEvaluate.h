@@ -1,3 +1,4 @@
+#include "GroupMatrixShare.h"
 template <class DIHEDRALTYPE, class EVALUATOR, bool COMPUTEVIRIALS> //don't need DihedralGPU, are all DihedralGPU.  Worry about later 
 __global__ void compute_force_dihedral(int nDihedrals, float4 *xs, float4 *fs, int *idToIdxs, DihedralGPU *dihedrals, BoundsGPU bounds, DIHEDRALTYPE *parameters_arg, int nParameters, Virial *virials, bool usingSharedMemForParams, EVALUATOR evaluator) {
 
@@ -171,7 +172,7 @@ __global__ void compute_force_dihedral(int nDihedrals, float4 *xs, float4 *fs, i
 
 
 template <class DIHEDRALTYPE, class EVALUATOR>
-__global__ void compute_energy_dihedral(int nDihedrals, float4 *xs, float *perParticleEng, int *idToIdxs, DihedralGPU *dihedrals, BoundsGPU bounds, DIHEDRALTYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator) {
+__global__ void compute_energy_dihedral(int nDihedrals, float4 *xs, float *perParticleEng, int *idToIdxs, DihedralGPU *dihedrals, BoundsGPU bounds, DIHEDRALTYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator, GroupMatrix groupMatrix) {
  
     int idx = GETIDX();
     extern __shared__ char all_shr[];
@@ -274,7 +275,11 @@ __global__ void compute_energy_dihedral(int nDihedrals, float4 *xs, float *perPa
         //printf("no force\n");
         float potential = evaluator.potential(dihedralType, phi) * 0.25f;
         for (int i=0; i<4; i++) {
-            atomicAdd(perParticleEng + idxs[i], potential);
+            if (groupMatrix.matrix) {
+                addGroupMatrixShare(groupMatrix, dihedral.ids, 4, i, potential);
+            } else {
+                atomicAdd(perParticleEng + idxs[i], potential);
+            }
         }
     }
 }
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef EVALUATOR_DIHEDRAL_TABULATED
+#define EVALUATOR_DIHEDRAL_TABULATED
+
+#include "cutils_math.h"
+#include "Dihedral.h"
+#include "TabulatedSpline.h"
+
+//! Dihedral energies and forces from periodic spline tables of energy against phi
+/*!
+ * Each table covers one period of 2 pi starting at the type's x0, and phi is
+ * wrapped into it.  See FixDihedralTabulated.
+ */
+class DihedralEvaluatorTabulated {
+    public:
+        const float4 *coefs;
+
+        inline __device__ float2 lookup(DihedralTabulatedType dihedralType, float phi) {
+            float period = dihedralType.nSegments / dihedralType.invDx;
+            phi -= period * floorf((phi - dihedralType.x0) / period);
+            return TabulatedSpline::evaluate(coefs + dihedralType.offset, dihedralType.nSegments,
+                                             dihedralType.x0, dihedralType.invDx, phi);
+        }
+
+        inline __device__ float dPotential(DihedralTabulatedType dihedralType, float phi) {
+            return lookup(dihedralType, phi).y;
+        }
+
+        inline __device__ double dPotential(DihedralTabulatedType dihedralType, double phi) {
+            return lookup(dihedralType, phi).y;
+        }
+
+        inline __device__ float potential(DihedralTabulatedType dihedralType, float phi) {
+            return lookup(dihedralType, phi).x;
+        }
+};
+
+#endif
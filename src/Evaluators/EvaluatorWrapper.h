@@ -32,6 +32,21 @@ public:
                                   float onefourStr, float *qs, float qCutoffSqr, 
                                   uint32_t tagA, uint32_t tagB, int nThreadPerBlock, 
                                   int nThreadPerAtom) {};
+
+    //! Adds pair and charge energies between each pair of nGroups groups into nGroups x nGroups matrices
+    /*!
+     * groupSlots gives the group of each atom id.  The matrices are kept in
+     * shared memory if they fit in maxSharedMem along with the parameters.
+     */
+    virtual void energyGroupMatrix(int nAtoms, int nPerRingPoly, float4 *xs, 
+                                   uint *ids, uint16_t *neighborCounts, 
+                                   uint *neighborlist, uint32_t *cumulSumMaxPerBlock, 
+                                   int warpSize, float *parameters, int numTypes, 
+                                   BoundsGPU bounds, float onetwoStr, float onethreeStr, 
+                                   float onefourStr, float *qs, float qCutoff, 
+                                   float *pairMatrix, float *chargeMatrix, 
+                                   const int *groupSlots, int nGroups, size_t maxSharedMem, 
+                                   int nThreadPerBlock, int nThreadPerAtom) {};
 };
 
 
@@ -175,6 +190,47 @@ public:
 
     }
 
+    virtual void energyGroupMatrix(int nAtoms, int nPerRingPoly, 
+                                   float4 *xs, uint *ids, 
+                                   uint16_t *neighborCounts, uint *neighborlist, 
+                                   uint32_t *cumulSumMaxPerBlock, int warpSize, 
+                                   float *parameters, int numTypes, BoundsGPU bounds, 
+                                   float onetwoStr, float onethreeStr, float onefourStr, 
+                                   float *qs, float qCutoff, 
+                                   float *pairMatrix, float *chargeMatrix, 
+                                   const int *groupSlots, int nGroups, size_t maxSharedMem, 
+                                   int nThreadPerBlock, int nThreadPerAtom) {
+        size_t paramsMem = N_PARAM*numTypes*numTypes*sizeof(float);
+        size_t sharedMem = paramsMem + 2*nGroups*nGroups*sizeof(float);
+        bool matrixInShared = sharedMem <= maxSharedMem;
+        if (not matrixInShared) {
+            sharedMem = paramsMem;
+        }
+        if (nThreadPerAtom==1) {
+            compute_energy_iso_group_matrix<PAIR_EVAL, COMP_PAIRS, 
+                N_PARAM, CHARGE_EVAL, COMP_CHARGES, 0> <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), 
+                    nThreadPerBlock, sharedMem>>> (nAtoms, nPerRingPoly, xs, 
+                            ids, neighborCounts, neighborlist, 
+                            cumulSumMaxPerBlock, warpSize, parameters, 
+                            numTypes, bounds, 
+                            onetwoStr, onethreeStr, onefourStr, 
+                            qs, qCutoff*qCutoff, 
+                            pairMatrix, chargeMatrix, groupSlots, nGroups, matrixInShared, 
+                            nThreadPerAtom, pairEval, chargeEval);
+        } else {
+            compute_energy_iso_group_matrix<PAIR_EVAL, COMP_PAIRS, 
+                N_PARAM, CHARGE_EVAL, COMP_CHARGES, 1> <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), 
+                    nThreadPerBlock, sharedMem>>> (nAtoms, nPerRingPoly, xs, 
+                            ids, neighborCounts, neighborlist, 
+                            cumulSumMaxPerBlock, warpSize, parameters, 
+                            numTypes, bounds, 
+                            onetwoStr, onethreeStr, onefourStr, 
+                            qs, qCutoff*qCutoff, 
+                            pairMatrix, chargeMatrix, groupSlots, nGroups, matrixInShared, 
+                            nThreadPerAtom, pairEval, chargeEval);
+        }
+    }
+
 };
 
 template<class PAIR_EVAL, int N_PARAM, bool COMP_PAIRS>
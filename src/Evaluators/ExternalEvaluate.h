@@ -4,14 +4,14 @@
 
 
 template <class EVALUATOR, bool COMPUTE_VIRIALS>
-__global__ void compute_force_external(int nAtoms,float4 *xs, float4 *fs, uint groupTag,Virial *__restrict__ virials, EVALUATOR eval) 
+__global__ void compute_force_external(int nAtoms,float4 *xs, float4 *fs, GroupMask group,Virial *__restrict__ virials, EVALUATOR eval) 
         {
 	int idx = GETIDX();
 	if (idx < nAtoms) {
 	    float4 forceWhole = fs[idx];
 	    uint groupTagAtom = * (uint *) &forceWhole.w;
 	    // Check if atom is part of group affected by external potential
-	    if (groupTagAtom & groupTag) {
+	    if (group.contains(groupTagAtom, idx)) {
             //Virial virialSum(0, 0, 0, 0, 0, 0);
 	        float4 posWhole = xs[idx];
 	        float3 pos      = make_float3(posWhole);
@@ -29,14 +29,14 @@ __global__ void compute_force_external(int nAtoms,float4 *xs, float4 *fs, uint g
 
 
 template <class EVALUATOR>
-__global__ void compute_energy_external(int nAtoms,float4 *xs, float4 *fs, float *perParticleEng, uint groupTag, EVALUATOR eval) 
+__global__ void compute_energy_external(int nAtoms,float4 *xs, float4 *fs, float *perParticleEng, GroupMask group, EVALUATOR eval) 
         {
 	int idx = GETIDX();
 	if (idx < nAtoms) {
 	  float4 forceWhole = fs[idx];
 	  uint groupTagAtom = * (uint *) &forceWhole.w;
 	  // Check if atom is part of group affected by external potential
-	  if (groupTagAtom & groupTag) {
+	  if (group.contains(groupTagAtom, idx)) {
 	    float4 posWhole = xs[idx];
 	    float3 pos      = make_float3(posWhole);
             float  uext     = eval.energy( pos );      // compute the energy due to ext. potential!
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef GROUPMATRIXSHARE_H
+#define GROUPMATRIXSHARE_H
+
+#include "GroupMask.h"
+
+//! Adds eng, the share of member self of an n-atom interaction, to the group matrix
+/*!
+ * The share is split equally over the other n-1 members, so an interaction
+ * between two groups lands in the off-diagonal entries however its atoms are
+ * ordered.  Members in none of the groups drop their part.
+ */
+inline __device__ void addGroupMatrixShare(GroupMatrix groupMatrix, const int *ids, int n, int self, float eng) {
+    int slotSelf = groupMatrix.slots[ids[self]];
+    if (slotSelf == -1) {
+        return;
+    }
+    float share = eng / (n-1);
+    for (int i=0; i<n; i++) {
+        if (i == self) {
+            continue;
+        }
+        int slotOther = groupMatrix.slots[ids[i]];
+        if (slotOther != -1) {
+            atomicAdd(groupMatrix.matrix + slotSelf*groupMatrix.nGroups + slotOther, share);
+        }
+    }
+}
+
+#endif
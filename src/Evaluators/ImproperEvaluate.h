@@ -1,3 +1,4 @@
+#include "GroupMatrixShare.h"
 template <class IMPROPERTYPE, class EVALUATOR, bool COMPUTEVIRIALS> 
 __global__ void compute_force_improper(int nImpropers, float4 *xs, float4 *fs, int *idToIdxs, ImproperGPU *impropers, BoundsGPU bounds, IMPROPERTYPE *parameters_arg, int nParameters, Virial *virials, bool usingSharedMemForParams, EVALUATOR evaluator) {
 
@@ -136,7 +137,7 @@ __global__ void compute_force_improper(int nImpropers, float4 *xs, float4 *fs, i
 
 
 template <class IMPROPERTYPE, class EVALUATOR> 
-__global__ void compute_energy_improper(int nImpropers, float4 *xs, float *perParticleEng, int *idToIdxs, ImproperGPU *impropers, BoundsGPU bounds, IMPROPERTYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator) {
+__global__ void compute_energy_improper(int nImpropers, float4 *xs, float *perParticleEng, int *idToIdxs, ImproperGPU *impropers, BoundsGPU bounds, IMPROPERTYPE *parameters_arg, int nParameters, bool usingSharedMemForParams, EVALUATOR evaluator, GroupMatrix groupMatrix) {
 
     int idx = GETIDX();
     extern __shared__ char all_shr[];
@@ -206,7 +207,11 @@ __global__ void compute_energy_improper(int nImpropers, float4 *xs, float *perPa
         float theta = acosf(c);
         float potential = 0.25f * evaluator.potential(improperType, theta);
         for (int i=0; i<4; i++) {
-            atomicAdd(perParticleEng + idxs[i], potential);
+            if (groupMatrix.matrix) {
+                addGroupMatrixShare(groupMatrix, improper.ids, 4, i, potential);
+            } else {
+                atomicAdd(perParticleEng + idxs[i], potential);
+            }
         }
 
 
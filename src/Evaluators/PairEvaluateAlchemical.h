@@ -0,0 +1,341 @@
+#pragma once
+#ifndef PAIR_EVALUATE_ALCHEMICAL_H
+#define PAIR_EVALUATE_ALCHEMICAL_H
+#include "BoundsGPU.h"
+#include "cutils_func.h"
+#include "Virial.h"
+#include "helpers.h"
+#include "SquareVector.h"
+
+//most energies at other lambdas one sweep can sample
+#define MAX_SAMPLE_LAMBDAS 16
+
+//Pair kernels for lambda-scaled (alchemical) interactions.  Pairs with exactly one atom in the
+//alchemical group are evaluated at lambda, all others at lambda = 1.  The evaluators take lambda
+//as a last argument and give its derivative through dEnergyDLambda.
+//
+//With COMP_LAMBDA the force sweep also writes, per atom, dU/dlambda and the energy differences
+//U(sampleLambdas[k]) - U(lambda), so sampling them needs no second pass over the neighbor list.
+//Both are half-counted like energies, so summing over atoms gives the totals.
+template <class PAIR_EVAL, int N_PARAM, bool COMP_VIRIALS, class CHARGE_EVAL, bool COMP_CHARGES, bool COMP_LAMBDA, int MULTITHREADPERATOM>
+__global__ void compute_force_alchemical
+        (int nAtoms,
+         int nPerRingPoly,
+         const float4 *__restrict__ xs,
+         float4 *__restrict__ fs,
+         const uint16_t *__restrict__ neighborCounts,
+         const uint *__restrict__ neighborlist,
+         const uint32_t * __restrict__ cumulSumMaxPerBlock,
+         int warpSize,
+         const float *__restrict__ parameters,
+         int numTypes,
+         BoundsGPU bounds,
+         float onetwoStr,
+         float onethreeStr,
+         float onefourStr,
+         Virial *__restrict__ virials,
+         float *qs,
+         float qCutoffSqr,
+         uint32_t alchemicalTag,
+         float lambda,
+         const float *__restrict__ sampleLambdas,
+         int nSampleLambdas,
+         float *dEngDLambdas,
+         float *deltaEngs,
+         int nThreadPerAtom,
+         PAIR_EVAL pairEval,
+         CHARGE_EVAL chargeEval)
+{
+    float multipliers[4] = {1, onetwoStr, onethreeStr, onefourStr};
+    extern __shared__ float paramsAll[];
+    int sqrSize = numTypes*numTypes;
+    float *params_shr[N_PARAM];
+    float3 *forces_shr;
+    Virial *virials_shr;
+    float *lambdas_shr;
+    if (MULTITHREADPERATOM) {
+        forces_shr = (float3 *) (paramsAll + sqrSize*N_PARAM);
+        virials_shr = (Virial *) (forces_shr + blockDim.x);
+        //1 + nSampleLambdas slices of blockDim.x
+        lambdas_shr = (float *) (virials_shr + blockDim.x);
+    }
+    for (int i=0; i<N_PARAM; i++) {
+        params_shr[i] = paramsAll + i * sqrSize;
+    }
+    copyToShared<float>(parameters, paramsAll, N_PARAM*sqrSize);
+    __syncthreads();
+
+    int idx = GETIDX();
+    if (idx < nAtoms*nThreadPerAtom) {
+        Virial virialsSum;
+        if (COMP_VIRIALS) {
+            virialsSum = Virial(0, 0, 0, 0, 0, 0);
+        }
+        int atomIdx;
+        if (MULTITHREADPERATOM) {
+            atomIdx = idx/nThreadPerAtom;
+        } else {
+            atomIdx = idx;
+        }
+        int ringPolyIdx = atomIdx / nPerRingPoly;
+        int beadIdx     = atomIdx % nPerRingPoly;
+        int baseIdx;
+        if (MULTITHREADPERATOM) {
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx, nThreadPerAtom);
+        } else {
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx);
+        }
+        float qi;
+        if (COMP_CHARGES) {
+            qi = qs[atomIdx];
+        }
+        float4 posWhole = xs[atomIdx];
+        int type = __float_as_int(posWhole.w);
+        float3 pos = make_float3(posWhole);
+        bool alchemical = __float_as_uint(fs[atomIdx].w) & alchemicalTag;
+        float3 forceSum = make_float3(0, 0, 0);
+        float dEngDLambdaSum = 0;
+        float deltaEngSums[MAX_SAMPLE_LAMBDAS];
+        if (COMP_LAMBDA) {
+            for (int k=0; k<nSampleLambdas; k++) {
+                deltaEngSums[k] = 0;
+            }
+        }
+        int myIdxInTeam;
+        if (MULTITHREADPERATOM) {
+            myIdxInTeam = threadIdx.x % nThreadPerAtom;
+        } else {
+            myIdxInTeam = 0;
+        }
+        int numNeigh = neighborCounts[ringPolyIdx];
+        for (int nthNeigh=myIdxInTeam; nthNeigh<numNeigh; nthNeigh+=nThreadPerAtom) {
+            int nlistIdx;
+            if (MULTITHREADPERATOM) {
+                nlistIdx = baseIdx + myIdxInTeam + warpSize * (nthNeigh/nThreadPerAtom);
+            } else {
+                nlistIdx = baseIdx + warpSize * nthNeigh;
+            }
+            uint otherIdxRaw = neighborlist[nlistIdx];
+            uint neighDist = otherIdxRaw >> 30;
+            float multiplier = multipliers[neighDist];
+            uint otherRPIdx = otherIdxRaw & EXCL_MASK;
+            uint otherIdx   = nPerRingPoly*otherRPIdx + beadIdx;
+            float4 otherPosWhole = xs[otherIdx];
+            int otherType = __float_as_int(otherPosWhole.w);
+            float3 otherPos = make_float3(otherPosWhole);
+            int sqrIdx = squareVectorIndex(numTypes, type, otherType);
+            float3 dr  = bounds.minImage(pos - otherPos);
+            float lenSqr = lengthSqr(dr);
+            float params_pair[N_PARAM];
+            for (int pIdx=0; pIdx<N_PARAM; pIdx++) {
+                params_pair[pIdx] = params_shr[pIdx][sqrIdx];
+            }
+            bool inPair = lenSqr < params_pair[0];
+            bool inCharge = COMP_CHARGES && lenSqr < qCutoffSqr;
+            if (not (inPair or inCharge)) {
+                continue;
+            }
+            bool otherAlchemical = __float_as_uint(fs[otherIdx].w) & alchemicalTag;
+            bool scaled = alchemical != otherAlchemical;
+            float pairLambda = scaled ? lambda : 1;
+            float qj;
+            if (inCharge) {
+                qj = qs[otherIdx];
+            }
+            float3 force = make_float3(0, 0, 0);
+            if (inPair) {
+                force += pairEval.force(dr, params_pair, lenSqr, multiplier, pairLambda);
+            }
+            if (inCharge) {
+                force += chargeEval.force(dr, lenSqr, qi, qj, multiplier, pairLambda);
+            }
+            forceSum += force;
+            if (COMP_VIRIALS) {
+                computeVirial(virialsSum, force, dr);
+            }
+            if (COMP_LAMBDA and scaled) {
+                float eng = 0;
+                if (inPair) {
+                    dEngDLambdaSum += pairEval.dEnergyDLambda(params_pair, lenSqr, multiplier, lambda);
+                    eng += pairEval.energy(params_pair, lenSqr, multiplier, lambda);
+                }
+                if (inCharge) {
+                    dEngDLambdaSum += chargeEval.dEnergyDLambda(lenSqr, qi, qj, multiplier, lambda);
+                    eng += chargeEval.energy(lenSqr, qi, qj, multiplier, lambda);
+                }
+                for (int k=0; k<nSampleLambdas; k++) {
+                    float lambdaK = sampleLambdas[k];
+                    float engK = 0;
+                    if (inPair) {
+                        engK += pairEval.energy(params_pair, lenSqr, multiplier, lambdaK);
+                    }
+                    if (inCharge) {
+                        engK += chargeEval.energy(lenSqr, qi, qj, multiplier, lambdaK);
+                    }
+                    deltaEngSums[k] += engK - eng;
+                }
+            }
+        }
+        if (MULTITHREADPERATOM) {
+            forces_shr[threadIdx.x] = forceSum;
+            reduceByN_NOSYNC<float3>(forces_shr, nThreadPerAtom);
+            if (myIdxInTeam==0) {
+                float4 forceCur = fs[atomIdx];
+                forceCur += forces_shr[threadIdx.x];
+                fs[atomIdx] = forceCur;
+            }
+            if (COMP_VIRIALS) {
+                virials_shr[threadIdx.x] = virialsSum;
+                reduceByN_NOSYNC<Virial>(virials_shr, nThreadPerAtom);
+                if (myIdxInTeam==0) {
+                    Virial tmp = virials_shr[threadIdx.x] * 0.5;
+                    virials[atomIdx] += tmp;
+                }
+            }
+            if (COMP_LAMBDA) {
+                lambdas_shr[threadIdx.x] = dEngDLambdaSum;
+                for (int k=0; k<nSampleLambdas; k++) {
+                    lambdas_shr[(k+1)*blockDim.x + threadIdx.x] = deltaEngSums[k];
+                }
+                for (int k=0; k<=nSampleLambdas; k++) {
+                    reduceByN_NOSYNC<float>(lambdas_shr + k*blockDim.x, nThreadPerAtom);
+                }
+                if (myIdxInTeam==0) {
+                    dEngDLambdas[atomIdx] = lambdas_shr[threadIdx.x];
+                    for (int k=0; k<nSampleLambdas; k++) {
+                        deltaEngs[k*nAtoms + atomIdx] = lambdas_shr[(k+1)*blockDim.x + threadIdx.x];
+                    }
+                }
+            }
+        } else {
+            float4 forceCur = fs[atomIdx];
+            forceCur += forceSum;
+            fs[atomIdx] = forceCur;
+            if (COMP_VIRIALS) {
+                virialsSum *= 0.5f;
+                virials[atomIdx] += virialsSum;
+            }
+            if (COMP_LAMBDA) {
+                dEngDLambdas[atomIdx] = dEngDLambdaSum;
+                for (int k=0; k<nSampleLambdas; k++) {
+                    deltaEngs[k*nAtoms + atomIdx] = deltaEngSums[k];
+                }
+            }
+        }
+    }
+}
+
+template <class PAIR_EVAL, int N_PARAM, class CHARGE_EVAL, bool COMP_CHARGES, int MULTITHREADPERATOM>
+__global__ void compute_energy_alchemical
+        (int nAtoms,
+         int nPerRingPoly,
+         float4 *xs,
+         float4 *fs,
+         float *perParticleEng,
+         uint16_t *neighborCounts,
+         uint *neighborlist,
+         uint32_t *cumulSumMaxPerBlock,
+         int warpSize,
+         float *parameters,
+         int numTypes,
+         BoundsGPU bounds,
+         float onetwoStr,
+         float onethreeStr,
+         float onefourStr,
+         float *qs,
+         float qCutoffSqr,
+         uint32_t alchemicalTag,
+         float lambda,
+         int nThreadPerAtom,
+         PAIR_EVAL pairEval,
+         CHARGE_EVAL chargeEval)
+{
+    float multipliers[4] = {1, onetwoStr, onethreeStr, onefourStr};
+    extern __shared__ float paramsAll[];
+    int sqrSize = numTypes*numTypes;
+    float *params_shr[N_PARAM];
+    float *engs_shr;
+    if (MULTITHREADPERATOM) {
+        engs_shr = paramsAll + N_PARAM*sqrSize;
+    }
+    for (int i=0; i<N_PARAM; i++) {
+        params_shr[i] = paramsAll + i * sqrSize;
+    }
+    copyToShared<float>(parameters, paramsAll, N_PARAM*sqrSize);
+    __syncthreads();
+
+    int idx = GETIDX();
+    if (idx < nAtoms*nThreadPerAtom) {
+        int atomIdx;
+        if (MULTITHREADPERATOM) {
+            atomIdx = idx/nThreadPerAtom;
+        } else {
+            atomIdx = idx;
+        }
+        int ringPolyIdx = atomIdx / nPerRingPoly;
+        int beadIdx     = atomIdx % nPerRingPoly;
+        int baseIdx;
+        if (MULTITHREADPERATOM) {
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx, nThreadPerAtom);
+        } else {
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx);
+        }
+        float qi;
+        if (COMP_CHARGES) {
+            qi = qs[atomIdx];
+        }
+        float4 posWhole = xs[atomIdx];
+        int type = __float_as_int(posWhole.w);
+        float3 pos = make_float3(posWhole);
+        bool alchemical = __float_as_uint(fs[atomIdx].w) & alchemicalTag;
+        float engSum = 0;
+        int myIdxInTeam;
+        if (MULTITHREADPERATOM) {
+            myIdxInTeam = threadIdx.x % nThreadPerAtom;
+        } else {
+            myIdxInTeam = 0;
+        }
+        int numNeigh = neighborCounts[ringPolyIdx];
+        for (int nthNeigh=myIdxInTeam; nthNeigh<numNeigh; nthNeigh+=nThreadPerAtom) {
+            int nlistIdx;
+            if (MULTITHREADPERATOM) {
+                nlistIdx = baseIdx + myIdxInTeam + warpSize * (nthNeigh/nThreadPerAtom);
+            } else {
+                nlistIdx = baseIdx + warpSize * nthNeigh;
+            }
+            uint otherIdxRaw = neighborlist[nlistIdx];
+            uint neighDist = otherIdxRaw >> 30;
+            float multiplier = multipliers[neighDist];
+            uint otherRPIdx = otherIdxRaw & EXCL_MASK;
+            uint otherIdx   = nPerRingPoly*otherRPIdx + beadIdx;
+            float4 otherPosWhole = xs[otherIdx];
+            int otherType = __float_as_int(otherPosWhole.w);
+            float3 dr = bounds.minImage(pos - make_float3(otherPosWhole));
+            float lenSqr = lengthSqr(dr);
+            int sqrIdx = squareVectorIndex(numTypes, type, otherType);
+            float params_pair[N_PARAM];
+            for (int pIdx=0; pIdx<N_PARAM; pIdx++) {
+                params_pair[pIdx] = params_shr[pIdx][sqrIdx];
+            }
+            bool otherAlchemical = __float_as_uint(fs[otherIdx].w) & alchemicalTag;
+            float pairLambda = alchemical != otherAlchemical ? lambda : 1;
+            if (lenSqr < params_pair[0]) {
+                engSum += pairEval.energy(params_pair, lenSqr, multiplier, pairLambda);
+            }
+            if (COMP_CHARGES && lenSqr < qCutoffSqr) {
+                engSum += chargeEval.energy(lenSqr, qi, qs[otherIdx], multiplier, pairLambda);
+            }
+        }
+        if (MULTITHREADPERATOM) {
+            engs_shr[threadIdx.x] = engSum;
+            reduceByN_NOSYNC<float>(engs_shr, nThreadPerAtom);
+            if (myIdxInTeam==0) {
+                perParticleEng[atomIdx] += engs_shr[threadIdx.x];
+            }
+        } else {
+            perParticleEng[atomIdx] += engSum;
+        }
+    }
+}
+
+#endif
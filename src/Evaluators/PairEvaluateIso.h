@@ -4,6 +4,7 @@
 #include "Virial.h"
 #include "helpers.h"
 #include "SquareVector.h"
+#include "GroupMask.h"
 
 template <class PAIR_EVAL, bool COMP_PAIRS, int N_PARAM, bool COMP_VIRIALS, class CHARGE_EVAL, bool COMP_CHARGES, int MULTITHREADPERATOM>
 __global__ void compute_force_iso
@@ -575,3 +576,155 @@ __global__ void compute_energy_iso_group_group
 
 }
 
+
+//energies between every pair of nGroups groups in one sweep.  groupSlots gives the group of each
+//atom id.  Each block keeps nGroups x nGroups pair and charge matrices in shared memory after the
+//parameters if they fit, else adds straight to the global ones.  Each thread keeps a running sum
+//for the group of the last neighbor it saw, since neighbors of one group tend to come together
+template <class PAIR_EVAL, bool COMP_PAIRS, int N, class CHARGE_EVAL, bool COMP_CHARGES, int MULTITHREADPERATOM>
+__global__ void compute_energy_iso_group_matrix
+        (int nAtoms, 
+         int nPerRingPoly,
+         float4 *xs, 
+         uint *ids, 
+         uint16_t *neighborCounts, 
+         uint *neighborlist, 
+         uint32_t *cumulSumMaxPerBlock, 
+         int warpSize, 
+         float *parameters, 
+         int numTypes, 
+         BoundsGPU bounds, 
+         float onetwoStr, 
+         float onethreeStr, 
+         float onefourStr, 
+         float *qs, 
+         float qCutoffSqr, 
+         float *pairMatrix,
+         float *chargeMatrix,
+         const int *groupSlots,
+         int nGroups,
+         bool matrixInShared,
+         int nThreadPerAtom,
+         PAIR_EVAL pairEval, 
+         CHARGE_EVAL chargeEval) 
+{
+    float multipliers[4] = {1, onetwoStr, onethreeStr, onefourStr};
+    extern __shared__ float paramsAll[];
+    int sqrSize = numTypes*numTypes;
+    int matrixSize = nGroups*nGroups;
+    float *params_shr[N];
+    float *pairMatrix_shr = paramsAll + N*sqrSize;
+    float *chargeMatrix_shr = pairMatrix_shr + matrixSize;
+    float *pairTarget = matrixInShared ? pairMatrix_shr : pairMatrix;
+    float *chargeTarget = matrixInShared ? chargeMatrix_shr : chargeMatrix;
+
+    if (COMP_PAIRS) {
+        for (int i=0; i<N; i++) {
+            params_shr[i] = paramsAll + i * sqrSize;
+        }
+        copyToShared<float>(parameters, paramsAll, N*sqrSize);
+    }
+    if (matrixInShared) {
+        for (int i=threadIdx.x; i<2*matrixSize; i+=blockDim.x) {
+            pairMatrix_shr[i] = 0;
+        }
+    }
+    __syncthreads();
+
+    int idx = GETIDX();
+    if (idx < nAtoms*nThreadPerAtom) {
+        int atomIdx;
+        if (MULTITHREADPERATOM) {
+            atomIdx = idx/nThreadPerAtom;
+        } else {
+            atomIdx = idx;
+        }
+        int ringPolyIdx = atomIdx / nPerRingPoly;
+        int beadIdx     = atomIdx % nPerRingPoly;
+        int slot = groupSlots[ids[atomIdx]];
+        if (slot != -1) {
+            int baseIdx;
+            if (MULTITHREADPERATOM) {
+                baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx, nThreadPerAtom);
+            } else {
+                baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx);
+            }
+            float4 posWhole = xs[atomIdx];
+            int type = __float_as_int(posWhole.w);
+            float qi;
+            if (COMP_CHARGES) {
+                qi = qs[atomIdx];
+            }
+            float3 pos = make_float3(posWhole);
+            int myIdxInTeam;
+            if (MULTITHREADPERATOM) {
+                myIdxInTeam = threadIdx.x % nThreadPerAtom;
+            } else {
+                myIdxInTeam = 0;
+            }
+            int lastSlot = -1;
+            float pairSum = 0;
+            float chargeSum = 0;
+            int numNeigh = neighborCounts[ringPolyIdx];
+            for (int nthNeigh=myIdxInTeam; nthNeigh<numNeigh; nthNeigh+=nThreadPerAtom) {
+                int nlistIdx;
+                if (MULTITHREADPERATOM) {
+                    nlistIdx = baseIdx + myIdxInTeam + warpSize * (nthNeigh/nThreadPerAtom);
+                } else {
+                    nlistIdx = baseIdx + warpSize * nthNeigh;
+                }
+                uint otherIdxRaw = neighborlist[nlistIdx];
+                uint neighDist = otherIdxRaw >> 30;
+                float multiplier = multipliers[neighDist];
+                uint otherRPIdx = otherIdxRaw & EXCL_MASK;
+                uint otherIdx   = nPerRingPoly*otherRPIdx + beadIdx;
+                int otherSlot = groupSlots[ids[otherIdx]];
+                if (otherSlot == -1) {
+                    continue;
+                }
+                if (otherSlot != lastSlot) {
+                    if (lastSlot != -1) {
+                        atomicAdd(pairTarget + slot*nGroups + lastSlot, pairSum);
+                        atomicAdd(chargeTarget + slot*nGroups + lastSlot, chargeSum);
+                    }
+                    lastSlot = otherSlot;
+                    pairSum = 0;
+                    chargeSum = 0;
+                }
+                float4 otherPosWhole = xs[otherIdx];
+                int otherType = __float_as_int(otherPosWhole.w);
+                float3 dr = bounds.minImage(pos - make_float3(otherPosWhole));
+                float lenSqr = lengthSqr(dr);
+                if (COMP_PAIRS) {
+                    int sqrIdx = squareVectorIndex(numTypes, type, otherType);
+                    float params_pair[N];
+                    for (int pIdx=0; pIdx<N; pIdx++) {
+                        params_pair[pIdx] = params_shr[pIdx][sqrIdx];
+                    }
+                    if (lenSqr < params_pair[0]) {
+                        pairSum += pairEval.energy(params_pair, lenSqr, multiplier);
+                    }
+                }
+                if (COMP_CHARGES && lenSqr < qCutoffSqr) {
+                    chargeSum += chargeEval.energy(lenSqr, qi, qs[otherIdx], multiplier);
+                }
+            }
+            if (lastSlot != -1) {
+                atomicAdd(pairTarget + slot*nGroups + lastSlot, pairSum);
+                atomicAdd(chargeTarget + slot*nGroups + lastSlot, chargeSum);
+            }
+        }
+    }
+    if (not matrixInShared) {
+        return;
+    }
+    __syncthreads();
+    for (int i=threadIdx.x; i<matrixSize; i+=blockDim.x) {
+        if (pairMatrix_shr[i]) {
+            atomicAdd(pairMatrix + i, pairMatrix_shr[i]);
+        }
+        if (chargeMatrix_shr[i]) {
+            atomicAdd(chargeMatrix + i, chargeMatrix_shr[i]);
+        }
+    }
+}
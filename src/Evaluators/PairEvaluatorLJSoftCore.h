@@ -0,0 +1,59 @@
+#pragma once
+#ifndef EVALUATOR_LJ_SOFTCORE
+#define EVALUATOR_LJ_SOFTCORE
+//Lennard-Jones scaled by lambda with a Beutler soft core
+//U = lambda 4 eps (sig^12/s^2 - sig^6/s),  s = alpha sig^6 (1-lambda) + r^6
+//shifted to zero at the cutoff.  lambda = 1 is plain LJ, and for lambda < 1 U stays finite at r = 0
+
+#include "cutils_math.h"
+
+class EvaluatorLJSoftCore {
+    public:
+        float alpha;
+        //same parameters as EvaluatorLJ: rCut^2, 24 eps, sig^6
+        inline __device__ float3 force(float3 dr, float params[3], float lenSqr, float multiplier, float lambda) {
+            if (multiplier and lambda) {
+                float epstimes24 = params[1];
+                float sig6 = params[2];
+                float r4 = lenSqr*lenSqr;
+                float sInv = 1 / (alpha*sig6*(1-lambda) + r4*lenSqr);
+                float forceScalar = lambda * epstimes24 * r4 * sig6 * (2*sig6*sInv - 1) * sInv*sInv * multiplier;
+                return dr * forceScalar;
+            }
+            return make_float3(0, 0, 0);
+        }
+
+        inline __device__ float energy(float params[3], float lenSqr, float multiplier, float lambda) {
+            if (multiplier and lambda) {
+                float eps4 = params[1] / 6.0f;
+                float sig6 = params[2];
+                float rCutSqr = params[0];
+                float core = alpha*sig6*(1-lambda);
+                float sInv = 1 / (core + lenSqr*lenSqr*lenSqr);
+                float sCutInv = 1 / (core + rCutSqr*rCutSqr*rCutSqr);
+                float eng = eps4 * sig6 * (sig6*sInv*sInv - sInv - (sig6*sCutInv*sCutInv - sCutInv));
+                return 0.5f * lambda * eng * multiplier; //0.5 b/c pairs are redundant
+            }
+            return 0;
+        }
+
+        //dU/dlambda = U/lambda + lambda dU/ds ds/dlambda, with ds/dlambda = -alpha sig^6
+        inline __device__ float dEnergyDLambda(float params[3], float lenSqr, float multiplier, float lambda) {
+            if (multiplier) {
+                float eps4 = params[1] / 6.0f;
+                float sig6 = params[2];
+                float rCutSqr = params[0];
+                float core = alpha*sig6*(1-lambda);
+                float sInv = 1 / (core + lenSqr*lenSqr*lenSqr);
+                float sCutInv = 1 / (core + rCutSqr*rCutSqr*rCutSqr);
+                float engOverLambda = sig6*sInv*sInv - sInv - (sig6*sCutInv*sCutInv - sCutInv);
+                float dCore = alpha * sig6 * ((2*sig6*sInv - 1)*sInv*sInv - (2*sig6*sCutInv - 1)*sCutInv*sCutInv);
+                return 0.5f * eps4 * sig6 * (engOverLambda + lambda * dCore) * multiplier;
+            }
+            return 0;
+        }
+        EvaluatorLJSoftCore(float alpha_) : alpha(alpha_) {};
+
+};
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef EVALUATOR_TABULATED
+#define EVALUATOR_TABULATED
+
+#include "cutils_math.h"
+#include "TabulatedSpline.h"
+
+//! Pair energies and forces from spline tables of energy against distance
+/*!
+ * Parameters are rCut^2, the distance of the first table point, the inverse
+ * table spacing, the index of the pair's first segment in coefs and its
+ * number of segments.  See FixPairTabulated.
+ */
+class EvaluatorTabulated {
+    public:
+        const float4 *coefs;
+
+        inline __device__ float3 force(float3 dr, float params[5], float lenSqr, float multiplier) {
+            if (multiplier and lenSqr > 0) {
+                float len = sqrtf(lenSqr);
+                float2 ed = TabulatedSpline::evaluate(coefs + (int) params[3], (int) params[4],
+                                                      params[1], params[2], len);
+                float forceScalar = -ed.y / len * multiplier;
+                return dr * forceScalar;
+            }
+            return make_float3(0, 0, 0);
+        }
+
+        // double precision version
+        inline __device__ double3 force(double3 dr, double params[5], double lenSqr, double multiplier) {
+            if (multiplier and lenSqr > 0) {
+                double len = sqrt(lenSqr);
+                float2 ed = TabulatedSpline::evaluate(coefs + (int) params[3], (int) params[4],
+                                                      params[1], params[2], len);
+                double forceScalar = -ed.y / len * multiplier;
+                return dr * forceScalar;
+            }
+            return make_double3(0, 0, 0);
+        }
+
+        inline __device__ float energy(float params[5], float lenSqr, float multiplier) {
+            if (multiplier) {
+                float2 ed = TabulatedSpline::evaluate(coefs + (int) params[3], (int) params[4],
+                                                      params[1], params[2], sqrtf(lenSqr));
+                return 0.5f * ed.x * multiplier; //0.5 b/c we need to half-count energy b/c pairs are redundant
+            }
+            return 0;
+        }
+
+};
+
+#endif
@@ -5,7 +5,7 @@
 
 template <class EVALUATOR, bool COMPUTE_VIRIALS>
 __global__ void compute_wall_iso(int nAtoms,float4 *xs, float4 *fs,float3 origin,
-		float3 forceDir,  uint groupTag, EVALUATOR eval) {
+		float3 forceDir,  GroupMask group, EVALUATOR eval) {
 
 
 	int idx = GETIDX();
@@ -13,7 +13,7 @@ __global__ void compute_wall_iso(int nAtoms,float4 *xs, float4 *fs,float3 origin
 		float4 forceWhole = fs[idx];
 		uint groupTagAtom = * (uint *) &forceWhole.w;
 		// if this atom is assigned to the group affected by this wall fix, then..
-		if (groupTagAtom & groupTag) {
+		if (group.contains(groupTagAtom, idx)) {
 			float4 posWhole = xs[idx];
 			float3 pos = make_float3(posWhole);
 			float3 particleDist = pos - origin;
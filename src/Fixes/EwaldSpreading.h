@@ -0,0 +1,81 @@
+#pragma once
+#ifndef EWALD_SPREADING_H
+#define EWALD_SPREADING_H
+
+#include "BoundsGPU.h"
+#include "cutils_math.h"
+
+//! Spreading of point weights onto the periodic grid of a complex FFT
+/*!
+ * Shared by FixChargeEwald, which spreads charges, and
+ * DataComputerStructureFactor, which spreads unit weights.  The grid is
+ * stored as cufftComplex, so the real part of point p is at
+ * grid[2*(p.x*sz.y*sz.z + p.y*sz.z + p.z)].
+ */
+
+//! Order 3 assignment weight of the grid point i (-1, 0 or 1) away from the nearest, at distance x from it in grid spacings
+inline __host__ __device__ float W_p_3(int i,float x){
+    if (i==-1) return 0.125-0.5*x+0.5*x*x;
+    if (i== 0) return 0.75-x*x;
+    /*if (i== 1)*/ return 0.125+0.5*x+0.5*x*x;
+}
+
+inline __device__ float sinc(float x){
+  if ((x<0.1)&&(x>-0.1)){
+    float x2=x*x;
+    return 1.0 - x2*0.16666666667f + x2*x2*0.008333333333333333f - x2*x2*x2*0.00019841269841269841f;
+  }
+    else return sin(x)/x;
+}
+
+//! Fourier transform of the assignment function at wave vector k, for grid spacing h
+inline __device__ float assignmentTransform(float3 k, float3 h, int order) {
+    float W = sinc(k.x*h.x*0.5)*sinc(k.y*h.y*0.5)*sinc(k.z*h.z*0.5);
+    return pow(W, order);
+}
+
+inline __device__ int3 wrapGridPoint(int3 p, int3 sz) {
+    if (p.x>0) p.x-=int(p.x/sz.x)*sz.x;
+    if (p.y>0) p.y-=int(p.y/sz.y)*sz.y;
+    if (p.z>0) p.z-=int(p.z/sz.z)*sz.z;
+    if (p.x<0) p.x-=int((p.x+1)/sz.x-1)*sz.x;
+    if (p.y<0) p.y-=int((p.y+1)/sz.y-1)*sz.y;
+    if (p.z<0) p.z-=int((p.z+1)/sz.z-1)*sz.z;
+    return p;
+}
+
+//order 1 nearest point
+inline __device__ void spreadToGridOrder1(float3 pos, float weight, BoundsGPU &bounds, int3 sz, float *grid) {
+    pos -= bounds.lo;
+    float3 h=bounds.trace()/make_float3(sz);
+    int3 p=wrapGridPoint(make_int3((pos+0.5*h)/h), sz);
+    atomicAdd(&grid[p.x*sz.y*sz.z*2+p.y*sz.z*2+p.z*2], weight);
+}
+
+inline __device__ void spreadToGridOrder3(float3 pos, float weight, BoundsGPU &bounds, int3 sz, float *grid) {
+    pos -= bounds.lo;
+    //find nearest grid point
+    float3 h=bounds.trace()/make_float3(sz);
+    int3 nearest_grid_point=make_int3((pos+0.5*h)/h);
+    //distance from nearest_grid_point /h
+    float3 d=pos/h-make_float3(nearest_grid_point);
+
+    int3 p=nearest_grid_point;
+    for (int ix=-1;ix<=1;ix++){
+      p.x=nearest_grid_point.x+ix;
+      float yz_w=weight*W_p_3(ix,d.x);
+      for (int iy=-1;iy<=1;iy++){
+        p.y=nearest_grid_point.y+iy;
+        float z_w=yz_w*W_p_3(iy,d.y);
+        for (int iz=-1;iz<=1;iz++){
+            p.z=nearest_grid_point.z+iz;
+            float w=z_w*W_p_3(iz,d.z);
+            //wrapGridPoint folds any offset back onto the grid
+            int3 pw=wrapGridPoint(p, sz);
+            atomicAdd(&grid[pw.x*sz.y*sz.z*2+pw.y*sz.z*2+pw.z*2], w);
+        }
+      }
+    }
+}
+
+#endif
@@ -20,8 +20,10 @@ Fix::Fix(boost::shared_ptr<State> state_, std::string handle_, std::string group
     updateGroupTag();
     requiresPostNVE_V = false;
     requiresForces = false;
+    supportsExtendedGroups = false;
     requiresPerAtomVirials = false;
     prepared = false;
+    timerGeneration = -1;
     canOffloadChargePairCalc = false;
     canAcceptChargePairCalc = false;
     
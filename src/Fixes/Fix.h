@@ -151,6 +151,22 @@ public:
     virtual void singlePointEng(float *perParticleEng) {}
     virtual void singlePointEngGroupGroup(float *perParticleEng, uint32_t groupTagA, uint32_t groupTagB) {}
 
+    //! Add energies between each pair of groups into matrices
+    /*!
+     * \param pairMatrix nGroups x nGroups device matrix the pair energies are added to
+     * \param chargeMatrix Matrix the charge energies are added to
+     * \param bondedMatrix Matrix the bonded energies are added to
+     * \param groupSlots Device array of the group index of each atom id, -1 for atoms in none
+     * \param nGroups Number of groups
+     *
+     * \return False if the fix's energy cannot be split between groups
+     *
+     * Entry (a, b) gets the energy of atoms in group a with atoms in group b,
+     * each atom's share of an interaction being split over its partners.
+     */
+    virtual bool singlePointEngGroupMatrix(float *pairMatrix, float *chargeMatrix, float *bondedMatrix,
+                                           const int *groupSlots, int nGroups) { return false; }
+
     //! Accomodate for new type of Atoms added to the system
     /*!
      * \param handle String specifying the new type of Atoms
@@ -227,6 +243,17 @@ public:
         return std::vector<float>();
     }
 
+    //! Return the cutoff of each pair of atom types
+    /*!
+     * \return numTypes^2 cutoffs, with unset pairs filled in as they will be
+     *         at prepare time, or an empty list if the fix has no per-pair
+     *         cutoffs.  Used to trim the neighbor list when
+     *         State::typePairCutoffs is set.
+     */
+    virtual std::vector<float> getRCutsByType() {
+        return std::vector<float>();
+    }
+
 
     //! Returns the atom ids of atoms belonging to rigid bodies as denoted by this Fix.
     /*!
@@ -274,6 +301,9 @@ public:
     const std::string type; //!< String naming the Fix type
     int applyEvery; //!< Applyt this fix every this many timesteps
     unsigned int groupTag; //!< Bitmask for the group handle
+    bool supportsExtendedGroups; //!< True if the Fix tests membership through
+                                 //!< GroupMask, so it can act on groups
+                                 //!< beyond the per-atom tag bits
     const bool forceSingle; //!< True if Fix contributes to single point energy.
     bool requiresVirials; //!< True if Fix needs virials.  Fixes will compute virials if any fix has this as true
     bool requiresPerAtomVirials; //!< True if Fix needs perAtom virials.  Fixes will compute per atom virials if any fix has this as true
@@ -294,6 +324,10 @@ public:
     int orderPreference; //!< Fixes with a high order preference are calculated
                          //!< later.
 
+    std::vector<int> timerPhases; //!< Phase id of each of this fix's timed
+                                  //!< hooks, cached by IntegratorUtil
+    int timerGeneration; //!< IntegratorUtil timer setup timerPhases belong to
+
     const std::string restartHandle; //!< Handle for restart string
 
     void setVirialTurnPrepare();
@@ -0,0 +1,175 @@
+
+#include "FixHelpers.h"
+#include "helpers.h"
+#include "FixAngleTabulated.h"
+#include "cutils_func.h"
+#include "AngleEvaluate.h"
+#include "Logging.h"
+#include "xml_func.h"
+using namespace std;
+const string angleTabulatedType = "AngleTabulated";
+FixAngleTabulated::FixAngleTabulated(boost::shared_ptr<State> state_, string handle)
+  : FixPotentialMultiAtom(state_, handle, angleTabulatedType, true)
+{
+    evaluator.coefs = nullptr;
+    readFromRestart(); 
+}
+
+namespace py = boost::python;
+
+void FixAngleTabulated::compute(int virialMode) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+    GPUData &gpd = state->gpd;
+    if (forcersGPU.size()) {
+        if (virialMode) {
+            compute_force_angle<AngleTabulatedType, AngleEvaluatorTabulated, true> <<<NBLOCK(nAtoms), PERBLOCK, sizeof(AngleGPU) * maxForcersPerBlock + sharedMemSizeForParams>>>(nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), forcersGPU.data(), forcerIdxs.data(), state->boundsGPU, parameters.data(), parameters.size(), gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        } else {
+            compute_force_angle<AngleTabulatedType, AngleEvaluatorTabulated, false> <<<NBLOCK(nAtoms), PERBLOCK, sizeof(AngleGPU) * maxForcersPerBlock + sharedMemSizeForParams>>>(nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), forcersGPU.data(), forcerIdxs.data(), state->boundsGPU, parameters.data(), parameters.size(), gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        }
+    }
+
+}
+
+void FixAngleTabulated::singlePointEng(float *perParticleEng) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+    if (forcersGPU.size()) {
+        compute_energy_angle<<<NBLOCK(nAtoms), PERBLOCK, sizeof(AngleGPU) * maxForcersPerBlock + sharedMemSizeForParams>>>(nAtoms, state->gpd.xs(activeIdx), perParticleEng, state->gpd.idToIdxs.d_data.data(), forcersGPU.data(), forcerIdxs.data(), state->boundsGPU, parameters.data(), parameters.size(), usingSharedMemForParams, evaluator, groupMatrix);
+    }
+}
+
+void FixAngleTabulated::createAngle(Atom *a, Atom *b, Atom *c, int type) {
+    vector<Atom *> atoms = {a, b, c};
+    validAtoms(atoms);
+    mdAssert(type >= 0, "Tabulated angles need an angle type");
+    forcers.push_back(AngleTabulated(a, b, c, type));
+    pyListInterface.updateAppendedMember();
+}
+
+void FixAngleTabulated::setTable(int type, TabulatedSpline::Table table) {
+    mdAssert(type >= 0, "Tried to set table for invalid angle type %d", type);
+    AngleTabulated angleType;
+    auto it = forcerTypes.find(type);
+    if (it != forcerTypes.end()) {
+        angleType.table = it->second.table;
+        tables[angleType.table] = table;
+    } else {
+        angleType.table = tables.size();
+        tables.push_back(table);
+    }
+    angleType.x0 = table.x0;
+    angleType.invDx = 1 / table.dx;
+    angleType.offset = 0; //filled in by prepareForRun
+    angleType.nSegments = table.values.size() - 1;
+    setForcerType(type, angleType);
+    prepared = false;
+}
+
+TabulatedSpline::Table &FixAngleTabulated::tableFor(int type) {
+    auto it = forcerTypes.find(type);
+    mdAssert(it != forcerTypes.end(), "No table for angle type %d in fix %s", type, handle.c_str());
+    return tables[it->second.table];
+}
+
+void FixAngleTabulated::setAngleTypeTable(int type, double thetaMin, double thetaMax,
+                                          py::object energies, py::object forces) {
+    setTable(type, TabulatedSpline::tableFromPython(thetaMin, thetaMax, energies, forces));
+}
+
+void FixAngleTabulated::readAngleTypeTable(int type, string fn) {
+    setTable(type, TabulatedSpline::tableFromFile(fn));
+}
+
+py::tuple FixAngleTabulated::evaluate(int type, double theta) {
+    std::pair<double, double> ef = tableFor(type).evaluate(theta);
+    return py::make_tuple(ef.first, ef.second);
+}
+
+bool FixAngleTabulated::prepareForRun() {
+    //every type in use needs a table
+    for (AngleVariant &forcerVar : forcers) {
+        tableFor(boost::get<AngleTabulated>(forcerVar).type);
+    }
+    std::vector<float4> allCoefs;
+    for (auto &entry : forcerTypes) {
+        std::vector<float4> tableCoefs = tables[entry.second.table].coefficients();
+        entry.second.offset = allCoefs.size();
+        allCoefs.insert(allCoefs.end(), tableCoefs.begin(), tableCoefs.end());
+    }
+    coefs = GPUArrayDeviceGlobal<float4>(allCoefs.size());
+    coefs.set(allCoefs.data());
+    evaluator.coefs = coefs.data();
+    return FixPotentialMultiAtom::prepareForRun();
+}
+
+string FixAngleTabulated::restartChunk(string format) {
+    stringstream ss;
+    for (auto &entry : forcerTypes) {
+        ss << tables[entry.second.table].restartChunk("type='" + std::to_string(entry.first) + "'");
+    }
+    ss << "<members>\n";
+    for (AngleVariant &forcerVar : forcers) {
+        AngleTabulated &forcer = boost::get<AngleTabulated>(forcerVar);
+        ss << forcer.getInfoString();
+    }
+    ss << "</members>\n";
+    return ss.str();
+}
+
+bool FixAngleTabulated::readFromRestart() {
+    auto restData = getRestartNode();
+    if (restData) {
+        auto curr_node = restData.first_child();
+        while (curr_node) {
+            std::string tag = curr_node.name();
+            if (tag == "table") {
+                int type = atoi(curr_node.attribute("type").value());
+                setTable(type, TabulatedSpline::tableFromRestart(curr_node));
+            } else if (tag == "members") {
+                for (auto member_node = curr_node.first_child(); member_node; member_node = member_node.next_sibling()) {
+                    int type = atoi(member_node.attribute("type").value());
+                    Atom * a = &state->idToAtom(atoi(member_node.attribute("atomID_a").value()));
+                    Atom * b = &state->idToAtom(atoi(member_node.attribute("atomID_b").value()));
+                    Atom * c = &state->idToAtom(atoi(member_node.attribute("atomID_c").value()));
+                    createAngle(a, b, c, type);
+                }
+            }
+            curr_node = curr_node.next_sibling();
+        }
+    }
+    return true;
+}
+
+void export_FixAngleTabulated() {
+    boost::python::class_<FixAngleTabulated,
+                          boost::shared_ptr<FixAngleTabulated>,
+                          boost::python::bases<Fix, TypedItemHolder> >(
+        "FixAngleTabulated",
+        boost::python::init<boost::shared_ptr<State>, string>(
+                                boost::python::args("state", "handle"))
+    )
+    .def("createAngle", &FixAngleTabulated::createAngle,
+            (boost::python::arg("type"))
+        )
+    .def("setAngleTypeTable", &FixAngleTabulated::setAngleTypeTable,
+            (boost::python::arg("type"),
+             boost::python::arg("thetaMin"),
+             boost::python::arg("thetaMax"),
+             boost::python::arg("energies"),
+             boost::python::arg("forces")=boost::python::list()
+            )
+        )
+    .def("readAngleTypeTable", &FixAngleTabulated::readAngleTypeTable,
+            (boost::python::arg("type"),
+             boost::python::arg("fn")
+            )
+        )
+    .def("evaluate", &FixAngleTabulated::evaluate,
+            (boost::python::arg("type"),
+             boost::python::arg("theta")
+            )
+        )
+    .def_readonly("angles", &FixAngleTabulated::pyForcers)
+    ;
+}
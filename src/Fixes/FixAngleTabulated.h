@@ -0,0 +1,50 @@
+#pragma once
+#ifndef FIXANGLETABULATED_H
+#define FIXANGLETABULATED_H
+
+#include <vector>
+
+#include "FixPotentialMultiAtom.h"
+#include "Angle.h"
+#include "AngleEvaluatorTabulated.h"
+#include "TabulatedSpline.h"
+
+void export_FixAngleTabulated();
+
+//! Fix for angles whose potential is given as a table of energy against angle
+/*!
+ * Tables are set per angle type, over any range of angles in radians, like
+ * those of FixBondTabulated, and held by the angle type holders in
+ * forcerTypes.  Outside its table an angle's energy continues linearly.
+ */
+class FixAngleTabulated : public FixPotentialMultiAtom<AngleVariant, AngleTabulated, Angle, AngleGPU, AngleTabulatedType, 3> {
+
+private:
+    AngleEvaluatorTabulated evaluator; 
+    std::vector<TabulatedSpline::Table> tables; //!< Tables, indexed by the table of each angle type
+    GPUArrayDeviceGlobal<float4> coefs; //!< Segments of all tables, one after another
+
+    void setTable(int type, TabulatedSpline::Table table);
+    TabulatedSpline::Table &tableFor(int type);
+public:
+    FixAngleTabulated(boost::shared_ptr<State> state_, std::string handle);
+
+    void compute(int);
+    void singlePointEng(float *);
+    bool prepareForRun();
+    std::string restartChunk(std::string format);
+
+    void createAngle(Atom *, Atom *, Atom *, int type_);
+    //! Set the table of an angle type from energies, and optionally -dE/dtheta, at uniformly spaced angles
+    void setAngleTypeTable(int type, double thetaMin, double thetaMax,
+                           boost::python::object energies, boost::python::object forces);
+    //! Read the table of an angle type from a file of lines "theta energy [force]"
+    void readAngleTypeTable(int type, std::string fn);
+    //! Energy and -dE/dtheta of an angle type at theta, evaluated on the host
+    boost::python::tuple evaluate(int type, double theta);
+
+    bool readFromRestart();
+
+};
+
+#endif
@@ -92,12 +92,15 @@ class FixBond : public Fix, public TypedItemHolder {
         bool usingSharedMemForParams;
 
         int maxBondsPerBlock;
+        uint64_t preparedChecksum; //!< Hash of bonds and types last copied to the GPU
         std::unordered_map<int, BONDTYPEHOLDER> bondTypes;
+        GroupMatrix groupMatrix; //!< Set only while singlePointEngGroupMatrix runs
         
         FixBond(SHARED(State) state_, std::string handle_, std::string groupHandle_, std::string type_,
                 bool forceSingle_, int applyEvery_)
             : Fix(state_, handle_, groupHandle_, type_, forceSingle_, false, false, applyEvery_), pyListInterface(&bonds, &pyBonds) {
             maxBondsPerBlock = 0;
+            preparedChecksum = 0;
         }
 
         void setBondType(int n, CPUMember &forcer) {
@@ -108,6 +111,14 @@ class FixBond : public Fix, public TypedItemHolder {
             bondTypes[n] = forcer;
         }
 
+        //! Splits each bond's energy over the groups of its two atoms
+        bool singlePointEngGroupMatrix(float *, float *, float *bondedMatrix, const int *groupSlots, int nGroups) {
+            groupMatrix = GroupMatrix(bondedMatrix, groupSlots, nGroups);
+            singlePointEng(nullptr);
+            groupMatrix = GroupMatrix();
+            return true;
+        }
+
 
         virtual bool prepareForRun() {
             std::vector<Atom> &atoms = state->atoms;
@@ -139,8 +150,25 @@ class FixBond : public Fix, public TypedItemHolder {
                     }
                 } 
             }
-            maxBondsPerBlock = copyBondsToGPU<CPUMember, GPUMember, BONDTYPEHOLDER>(
-                    atoms, bonds, state->idToIdx, &bondsGPU, &bondIdxs, &parameters, maxExistingType, bondTypes);
+            // bonds are laid out by host atom index, so the arrays from the
+            // last run can be kept if neither the bonds nor the atoms changed
+            uint64_t checksum = state->atomIdChecksum;
+            for (BondVariant &bondVar : bonds) {
+                CPUMember &bond = boost::get<CPUMember>(bondVar);
+                checksum = hashBytes(checksum, bond.ids.data(), sizeof(bond.ids));
+                checksum = hashBytes(checksum, &bond.type, sizeof(bond.type));
+            }
+            std::hash<BONDTYPEHOLDER> hashType;
+            for (int i=0; i<=maxExistingType; i++) {
+                auto it = bondTypes.find(i);
+                size_t typeHash = it == bondTypes.end() ? 0 : hashType(it->second);
+                checksum = hashBytes(checksum, &typeHash, sizeof(typeHash));
+            }
+            if (checksum != preparedChecksum) {
+                maxBondsPerBlock = copyBondsToGPU<CPUMember, GPUMember, BONDTYPEHOLDER>(
+                        atoms, bonds, state->idToIdx, &bondsGPU, &bondIdxs, &parameters, maxExistingType, bondTypes);
+                preparedChecksum = checksum;
+            }
            // maxbondsPerBlock = copyMultiAtomToGPU<CPUVariant, CPUBase, CPUMember, GPUMember, ForcerTypeHolder, N>(state->atoms.size(), forcers, state->idToIdx, &forcersGPU, &forcerIdxs, &forcerTypes, &parameters, maxExistingType);
             setSharedMemForParams();
             prepared = true;
@@ -0,0 +1,176 @@
+#include "helpers.h"
+#include "FixBondTabulated.h"
+#include "cutils_func.h"
+#include "FixHelpers.h"
+#include "BondEvaluate.h"
+#include "Logging.h"
+#include "xml_func.h"
+namespace py = boost::python;
+using namespace std;
+
+const std::string bondTabulatedType = "BondTabulated";
+
+FixBondTabulated::FixBondTabulated(SHARED(State) state_, string handle)
+    : FixBond(state_, handle, string("None"), bondTabulatedType, true, 1) {
+        evaluator.coefs = nullptr;
+        readFromRestart();
+    }
+
+
+
+void FixBondTabulated::createBond(Atom *a, Atom *b, int type) {
+    vector<Atom *> atoms = {a, b};
+    validAtoms(atoms);
+    mdAssert(type >= 0, "Tabulated bonds need a bond type");
+    bonds.push_back(BondTabulated(a, b, type));
+    pyListInterface.updateAppendedMember();
+}
+
+void FixBondTabulated::setTable(int type, TabulatedSpline::Table table) {
+    mdAssert(type >= 0, "Tried to set table for invalid bond type %d", type);
+    BondTabulated bondType;
+    auto it = bondTypes.find(type);
+    if (it != bondTypes.end()) {
+        bondType.table = it->second.table;
+        tables[bondType.table] = table;
+    } else {
+        bondType.table = tables.size();
+        tables.push_back(table);
+    }
+    bondType.x0 = table.x0;
+    bondType.invDx = 1 / table.dx;
+    bondType.offset = 0; //filled in by prepareForRun
+    bondType.nSegments = table.values.size() - 1;
+    setBondType(type, bondType);
+    prepared = false;
+}
+
+TabulatedSpline::Table &FixBondTabulated::tableFor(int type) {
+    auto it = bondTypes.find(type);
+    mdAssert(it != bondTypes.end(), "No table for bond type %d in fix %s", type, handle.c_str());
+    return tables[it->second.table];
+}
+
+void FixBondTabulated::setBondTypeTable(int type, double rMin, double rMax,
+                                        py::object energies, py::object forces) {
+    mdAssert(rMin >= 0, "Bond tables must start at a non-negative length");
+    setTable(type, TabulatedSpline::tableFromPython(rMin, rMax, energies, forces));
+}
+
+void FixBondTabulated::readBondTypeTable(int type, string fn) {
+    setTable(type, TabulatedSpline::tableFromFile(fn));
+}
+
+py::tuple FixBondTabulated::evaluate(int type, double r) {
+    std::pair<double, double> ef = tableFor(type).evaluate(r);
+    return py::make_tuple(ef.first, ef.second);
+}
+
+bool FixBondTabulated::prepareForRun() {
+    //every type in use needs a table
+    for (BondVariant &bondVar : bonds) {
+        tableFor(boost::get<BondTabulated>(bondVar).type);
+    }
+    std::vector<float4> allCoefs;
+    for (auto &entry : bondTypes) {
+        std::vector<float4> tableCoefs = tables[entry.second.table].coefficients();
+        entry.second.offset = allCoefs.size();
+        allCoefs.insert(allCoefs.end(), tableCoefs.begin(), tableCoefs.end());
+    }
+    coefs = GPUArrayDeviceGlobal<float4>(allCoefs.size());
+    coefs.set(allCoefs.data());
+    evaluator.coefs = coefs.data();
+    return FixBond::prepareForRun();
+}
+
+void FixBondTabulated::compute(int virialMode) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+    GPUData &gpd = state->gpd;
+    if (bondsGPU.size()) {
+        if (virialMode) {
+            compute_force_bond<BondTabulatedType, BondEvaluatorTabulated, true> <<<NBLOCK(nAtoms), PERBLOCK, sizeof(BondGPU) * maxBondsPerBlock + sharedMemSizeForParams>>>(nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), bondsGPU.data(), bondIdxs.data(), parameters.data(), parameters.size(), state->boundsGPU, gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        } else {
+            compute_force_bond<BondTabulatedType, BondEvaluatorTabulated, false> <<<NBLOCK(nAtoms), PERBLOCK, sizeof(BondGPU) * maxBondsPerBlock + sharedMemSizeForParams>>>(nAtoms, gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), bondsGPU.data(), bondIdxs.data(), parameters.data(), parameters.size(), state->boundsGPU, gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        }
+    }
+}
+
+void FixBondTabulated::singlePointEng(float *perParticleEng) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+    if (bondsGPU.size()) {
+        compute_energy_bond<<<NBLOCK(nAtoms), PERBLOCK, sizeof(BondGPU) * maxBondsPerBlock + sharedMemSizeForParams>>>(nAtoms, state->gpd.xs(activeIdx), perParticleEng, state->gpd.idToIdxs.d_data.data(), bondsGPU.data(), bondIdxs.data(), parameters.data(), parameters.size(), state->boundsGPU, usingSharedMemForParams, evaluator, groupMatrix);
+    }
+
+}
+
+string FixBondTabulated::restartChunk(string format) {
+    stringstream ss;
+    for (auto &entry : bondTypes) {
+        ss << tables[entry.second.table].restartChunk("type='" + std::to_string(entry.first) + "'");
+    }
+    ss << "<members>\n";
+    for (BondVariant &forcerVar : bonds) {
+        BondTabulated &forcer= boost::get<BondTabulated>(forcerVar);
+        ss << forcer.getInfoString();
+    }
+    ss << "</members>\n";
+    return ss.str();
+}
+
+bool FixBondTabulated::readFromRestart() {
+    auto restData = getRestartNode();
+    if (restData) {
+        auto curr_node = restData.first_child();
+        while (curr_node) {
+            std::string tag = curr_node.name();
+            if (tag == "table") {
+                int type = atoi(curr_node.attribute("type").value());
+                setTable(type, TabulatedSpline::tableFromRestart(curr_node));
+            } else if (tag == "members") {
+                for (auto member_node = curr_node.first_child(); member_node; member_node = member_node.next_sibling()) {
+                    int type = atoi(member_node.attribute("type").value());
+                    int idA = atoi(member_node.attribute("atomID_a").value());
+                    int idB = atoi(member_node.attribute("atomID_b").value());
+                    Atom * a = &state->idToAtom(idA);
+                    Atom * b = &state->idToAtom(idB);
+                    createBond(a, b, type);
+                }
+            }
+            curr_node = curr_node.next_sibling();
+        }
+    }
+    return true;
+}
+
+void export_FixBondTabulated() {
+    py::class_<FixBondTabulated, SHARED(FixBondTabulated), py::bases<Fix, TypedItemHolder> >
+    (
+        "FixBondTabulated", py::init<SHARED(State), string> (py::args("state", "handle"))
+    )
+    .def("createBond", &FixBondTabulated::createBond,
+            (py::arg("type"))
+        )
+    .def("setBondTypeTable", &FixBondTabulated::setBondTypeTable,
+            (py::arg("type"),
+             py::arg("rMin"),
+             py::arg("rMax"),
+             py::arg("energies"),
+             py::arg("forces")=py::list()
+             )
+        )
+    .def("readBondTypeTable", &FixBondTabulated::readBondTypeTable,
+            (py::arg("type"),
+             py::arg("fn")
+             )
+        )
+    .def("evaluate", &FixBondTabulated::evaluate,
+            (py::arg("type"),
+             py::arg("r")
+             )
+        )
+    .def_readonly("bonds", &FixBondTabulated::pyBonds)
+    ;
+
+}
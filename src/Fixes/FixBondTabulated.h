@@ -0,0 +1,69 @@
+#pragma once
+#ifndef FIXBONDTABULATED_H
+#define FIXBONDTABULATED_H
+
+#include <vector>
+
+#include "Bond.h"
+#include "FixBond.h"
+#include "BondEvaluatorTabulated.h"
+#include "TabulatedSpline.h"
+void export_FixBondTabulated();
+
+//! Fix for bonds whose potential is given as a table of energy against length
+/*!
+ * Each bond type has a table of energies, and optionally forces, at uniformly
+ * spaced bond lengths, from python sequences or a file as in
+ * FixPairTabulated.  Each bond type's holder in bondTypes points at its table
+ * and, once prepared, at its segments in one device array shared by all
+ * types, so bonds are packed and evaluated like any analytic bond style.
+ * Outside its table a bond's energy continues linearly.
+ */
+class FixBondTabulated : public FixBond<BondTabulated, BondGPU, BondTabulatedType> {
+
+public:
+    FixBondTabulated(boost::shared_ptr<State> state_, std::string handle);
+
+    ~FixBondTabulated(){};
+
+    void compute(int);
+    void singlePointEng(float *);
+    bool prepareForRun();
+    std::string restartChunk(std::string format);
+    bool readFromRestart();
+    BondEvaluatorTabulated evaluator;
+
+    void createBond(Atom *, Atom *, int);
+
+    //! Set the table of a bond type
+    /*!
+     * \param type Bond type
+     * \param rMin Length of the first point
+     * \param rMax Length of the last point
+     * \param energies Energies at uniformly spaced lengths from rMin to rMax
+     * \param forces -dE/dr at the same points, or empty for the natural spline
+     */
+    void setBondTypeTable(int type, double rMin, double rMax,
+                          boost::python::object energies, boost::python::object forces);
+    //! Read the table of a bond type from a file of lines "r energy [force]"
+    void readBondTypeTable(int type, std::string fn);
+    //! Energy and force of a bond type at length r, evaluated on the host
+    boost::python::tuple evaluate(int type, double r);
+
+    const BondTabulated getBond(size_t i) {
+        return boost::get<BondTabulated>(bonds[i]);
+    }
+    virtual std::vector<BondVariant> *getBonds() {
+        return &bonds;
+    }
+
+private:
+    std::vector<TabulatedSpline::Table> tables; //!< Tables, indexed by the table of each bond type
+    GPUArrayDeviceGlobal<float4> coefs; //!< Segments of all tables, one after another
+
+    void setTable(int type, TabulatedSpline::Table table);
+    TabulatedSpline::Table &tableFor(int type);
+
+};
+
+#endif
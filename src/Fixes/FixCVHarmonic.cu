@@ -0,0 +1,115 @@
+#include "FixCVHarmonic.h"
+#include "boost_for_export.h"
+#include "State.h"
+
+namespace py = boost::python;
+
+const std::string CVHarmonicType = "CVHarmonic";
+
+FixCVHarmonic::FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                             py::list intervals_, py::list centers_)
+    : Interpolator(intervals_, centers_), Fix(state_, handle_, "all", CVHarmonicType, true, false, false, 1),
+      cv(cv_), k(k_), lastCenter(0), bias(GPUArrayGlobal<float>(2)), work(GPUArrayGlobal<double>(1))
+{
+    resetWork();
+}
+
+FixCVHarmonic::FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                             py::object centerFunc_)
+    : Interpolator(centerFunc_), Fix(state_, handle_, "all", CVHarmonicType, true, false, false, 1),
+      cv(cv_), k(k_), lastCenter(0), bias(GPUArrayGlobal<float>(2)), work(GPUArrayGlobal<double>(1))
+{
+    resetWork();
+}
+
+FixCVHarmonic::FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                             double center_)
+    : Interpolator(center_), Fix(state_, handle_, "all", CVHarmonicType, true, false, false, 1),
+      cv(cv_), k(k_), lastCenter(0), bias(GPUArrayGlobal<float>(2)), work(GPUArrayGlobal<double>(1))
+{
+    resetWork();
+}
+
+bool FixCVHarmonic::prepareForRun() {
+    turnBeginRun = state->runInit;
+    turnFinishRun = state->runInit + state->runningFor;
+    cv->prepareForRun();
+    computeCurrentVal(state->turn);
+    lastCenter = getCurrentVal();
+    prepared = true;
+    return prepared;
+}
+
+bool FixCVHarmonic::postRun() {
+    finishRun();
+    prepared = false;
+    return true;
+}
+
+__global__ void compute_cv_harmonic(float *value, float k, float center, float lastCenter, float *bias, double *work) {
+    float s = value[0];
+    float ds = s - center;
+    bias[0] = k * ds;
+    bias[1] = 0.5f * k * ds * ds;
+    if (work) {
+        float dsLast = s - lastCenter;
+        work[0] += 0.5 * k * (ds*ds - dsLast*dsLast);
+    }
+}
+
+void FixCVHarmonic::compute(int virialMode) {
+    computeCurrentVal(state->turn);
+    double center = getCurrentVal();
+    cv->compute();
+    compute_cv_harmonic<<<1, 1>>>(cv->value.getDevData(), k, center, lastCenter, bias.getDevData(), work.getDevData());
+    bool computeVirials = virialMode==1 or virialMode==2;
+    cv->applyForce(bias.getDevData(), computeVirials ? state->gpd.virials.d_data.data() : nullptr);
+    lastCenter = center;
+}
+
+void FixCVHarmonic::singlePointEng(float *perParticleEng) {
+    computeCurrentVal(state->turn);
+    cv->compute();
+    compute_cv_harmonic<<<1, 1>>>(cv->value.getDevData(), k, getCurrentVal(), lastCenter, bias.getDevData(), nullptr);
+    cv->addEnergy(perParticleEng, bias.getDevData() + 1);
+}
+
+Interpolator *FixCVHarmonic::getInterpolator(std::string type) {
+    if (type == "center") {
+        return (Interpolator *) this;
+    }
+    return nullptr;
+}
+
+double FixCVHarmonic::getWork() {
+    work.dataToHost();
+    cudaDeviceSynchronize();
+    return work.h_data[0];
+}
+
+void FixCVHarmonic::resetWork() {
+    work.h_data[0] = 0;
+    work.dataToDevice();
+}
+
+void export_FixCVHarmonic() {
+    py::class_<FixCVHarmonic, boost::shared_ptr<FixCVHarmonic>, py::bases<Fix>, boost::noncopyable> (
+        "FixCVHarmonic",
+        py::init<boost::shared_ptr<State>, std::string, boost::shared_ptr<CollectiveVariable>, double, py::list, py::list>(
+            py::args("state", "handle", "cv", "k", "intervals", "centers")
+        )
+    )
+    //as in FixNVTRescale, the constructor taking a double must be added last so it is tried before the one taking a py::object
+    .def(py::init<boost::shared_ptr<State>, std::string, boost::shared_ptr<CollectiveVariable>, double, py::object>(
+            py::args("state", "handle", "cv", "k", "centerFunc")
+        )
+    )
+    .def(py::init<boost::shared_ptr<State>, std::string, boost::shared_ptr<CollectiveVariable>, double, double>(
+            py::args("state", "handle", "cv", "k", "center")
+        )
+    )
+    .def("getWork", &FixCVHarmonic::getWork)
+    .def("resetWork", &FixCVHarmonic::resetWork)
+    .def_readwrite("k", &FixCVHarmonic::k)
+    ;
+}
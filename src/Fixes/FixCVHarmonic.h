@@ -0,0 +1,70 @@
+#pragma once
+#ifndef FIXCVHARMONIC_H
+#define FIXCVHARMONIC_H
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python.hpp>
+#include <string>
+
+#include "Fix.h"
+#include "GPUArrayGlobal.h"
+#include "Interpolator.h"
+#include "CollectiveVariable.h"
+
+void export_FixCVHarmonic();
+
+//! Harmonic bias on a collective variable, for umbrella sampling and moving restraints
+/*!
+ * \f[
+ * U = \frac{1}{2} k (s - s_0)^2
+ * \f]
+ * The center \f$ s_0 \f$ is interpolated like a thermostat's temperature, so
+ * a list of intervals and centers gives a restraint moving over the run with
+ * no Python per turn.  The work done by moving the center,
+ * \f$ \sum_t U(s_t; s_{0,t}) - U(s_t; s_{0,t-1}) \f$, is accumulated on the
+ * device for Jarzynski estimates.
+ *
+ * Bias forces contribute to the virial, so the fix may be used with a barostat.
+ */
+class FixCVHarmonic : public Interpolator, public Fix {
+public:
+    //! Constructor for a moving restraint
+    /*!
+     * \param cv_ Variable to bias
+     * \param k_ Spring constant, in energy over the variable's units squared
+     * \param intervals_ Fractions of the run, from 0 to 1
+     * \param centers_ Center at each interval
+     */
+    FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                  boost::python::list intervals_, boost::python::list centers_);
+    //! Constructor with the center given by a Python function of the run's first and last turns and the current turn
+    /*!
+     * The function is called once per turn of each run, all at the start of
+     * the run (see Interpolator::sampleFunc), so an expression string or a
+     * list of intervals is cheaper for long runs.
+     */
+    FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                  boost::python::object centerFunc_);
+    //! Constructor for a fixed center
+    FixCVHarmonic(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_, double k_,
+                  double center_);
+
+    bool prepareForRun();
+    bool postRun();
+    void compute(int);
+    void singlePointEng(float *);
+    Interpolator *getInterpolator(std::string);
+
+    //! Work done on the system by moving the center.  Synchronizes with the device
+    double getWork();
+    void resetWork();
+
+    boost::shared_ptr<CollectiveVariable> cv;
+    double k;
+    double lastCenter; //!< Center at the last force evaluation
+    GPUArrayGlobal<float> bias; //!< dU/ds and the energy of the last evaluation
+    GPUArrayGlobal<double> work;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "FixCVMetadynamics.h"
+#include "boost_for_export.h"
+#include "State.h"
+#include "xml_func.h"
+#include "Logging.h"
+
+#include <iomanip>
+
+namespace py = boost::python;
+
+const std::string CVMetadynamicsType = "CVMetadynamics";
+
+FixCVMetadynamics::FixCVMetadynamics(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_,
+                                     double height_, double width_, int depositEvery_, double lo_, double hi_, int nBins_,
+                                     double biasFactor_, double temp_)
+    : Fix(state_, handle_, "all", CVMetadynamicsType, true, false, false, 1),
+      cv(cv_), height(height_), width(width_), depositEvery(depositEvery_), lo(lo_), hi(hi_), nBins(nBins_),
+      biasFactor(biasFactor_), temp(temp_), nHills(0), lastDepositTurn(-1), bias(GPUArrayGlobal<float>(3))
+{
+    mdAssert(height > 0 and width > 0, "Metadynamics hills need positive height and width");
+    mdAssert(depositEvery > 0, "Metadynamics must deposit hills every one or more turns, not %d", depositEvery);
+    mdAssert(hi > lo and nBins >= 2, "Metadynamics grid needs hi > lo and at least two points");
+    mdAssert(biasFactor == 0 or (biasFactor > 1 and temp > 0), "Well-tempered metadynamics needs a bias factor above 1 and a positive temperature");
+    grid = std::vector<float>(nBins, 0);
+    gridDeriv = std::vector<float>(nBins, 0);
+    readFromRestart();
+    grid.dataToDevice();
+    gridDeriv.dataToDevice();
+}
+
+bool FixCVMetadynamics::prepareForRun() {
+    cv->prepareForRun();
+    prepared = true;
+    return prepared;
+}
+
+__global__ void compute_cv_metadynamics(float *value, float *grid, float *gridDeriv, int nBins, float lo, float spacing,
+                                        float height, float wellTemperedFactor, float *bias) {
+    float x = (value[0] - lo) / spacing;
+    float eng;
+    float deriv;
+    if (x < 0 or x > nBins - 1) {
+        eng = grid[x < 0 ? 0 : nBins - 1];
+        deriv = 0;
+    } else {
+        int i = min((int) x, nBins - 2);
+        float frac = x - i;
+        eng = grid[i] * (1 - frac) + grid[i+1] * frac;
+        deriv = gridDeriv[i] * (1 - frac) + gridDeriv[i+1] * frac;
+    }
+    bias[0] = deriv;
+    bias[1] = eng;
+    bias[2] = wellTemperedFactor > 0 ? height * expf(-eng * wellTemperedFactor) : height;
+}
+
+__global__ void deposit_cv_hill(float *value, float *bias, float *grid, float *gridDeriv, int nBins, float lo, float spacing, float width) {
+    int idx = GETIDX();
+    if (idx < nBins) {
+        float ds = lo + idx * spacing - value[0];
+        float hill = bias[2] * expf(-ds * ds / (2 * width * width));
+        grid[idx] += hill;
+        gridDeriv[idx] -= hill * ds / (width * width);
+    }
+}
+
+void FixCVMetadynamics::compute(int virialMode) {
+    float spacing = (hi - lo) / (nBins - 1);
+    float wellTemperedFactor = biasFactor > 0 ? 1.0 / (state->units.boltz * temp * (biasFactor - 1)) : 0;
+    cv->compute();
+    compute_cv_metadynamics<<<1, 1>>>(cv->value.getDevData(), grid.getDevData(), gridDeriv.getDevData(), nBins, lo, spacing,
+                                      height, wellTemperedFactor, bias.getDevData());
+    bool computeVirials = virialMode==1 or virialMode==2;
+    cv->applyForce(bias.getDevData(), computeVirials ? state->gpd.virials.d_data.data() : nullptr);
+    //a turn can evaluate forces more than once
+    if (state->turn % depositEvery == 0 and state->turn != lastDepositTurn) {
+        deposit_cv_hill<<<NBLOCK(nBins), PERBLOCK>>>(cv->value.getDevData(), bias.getDevData(), grid.getDevData(), gridDeriv.getDevData(),
+                                                     nBins, lo, spacing, width);
+        lastDepositTurn = state->turn;
+        nHills++;
+    }
+}
+
+void FixCVMetadynamics::singlePointEng(float *perParticleEng) {
+    float spacing = (hi - lo) / (nBins - 1);
+    cv->compute();
+    compute_cv_metadynamics<<<1, 1>>>(cv->value.getDevData(), grid.getDevData(), gridDeriv.getDevData(), nBins, lo, spacing,
+                                      height, 0, bias.getDevData());
+    cv->addEnergy(perParticleEng, bias.getDevData() + 1);
+}
+
+py::list FixCVMetadynamics::getBias() {
+    grid.dataToHost();
+    cudaDeviceSynchronize();
+    py::list res;
+    for (float eng : grid.h_data) {
+        res.append(eng);
+    }
+    return res;
+}
+
+py::list FixCVMetadynamics::getGridPoints() {
+    py::list res;
+    for (int i=0; i<nBins; i++) {
+        res.append(lo + i * (hi - lo) / (nBins - 1));
+    }
+    return res;
+}
+
+std::string FixCVMetadynamics::restartChunk(std::string format) {
+    grid.dataToHost();
+    gridDeriv.dataToHost();
+    cudaDeviceSynchronize();
+    std::stringstream ss;
+    ss << std::setprecision(9);
+    ss << "<nHills>" << nHills << "</nHills>\n";
+    ss << "<bias n=\"" << nBins << "\">\n";
+    for (float eng : grid.h_data) {
+        ss << eng << "\n";
+    }
+    ss << "</bias>\n";
+    ss << "<biasDeriv n=\"" << nBins << "\">\n";
+    for (float deriv : gridDeriv.h_data) {
+        ss << deriv << "\n";
+    }
+    ss << "</biasDeriv>\n";
+    return ss.str();
+}
+
+bool FixCVMetadynamics::readFromRestart() {
+    pugi::xml_node restData = getRestartNode();
+    if (restData) {
+        auto curr_param = restData.first_child();
+        while (curr_param) {
+            std::string tag = curr_param.name();
+            if (tag == "nHills") {
+                nHills = atoi(curr_param.first_child().value());
+            } else if (tag == "bias" or tag == "biasDeriv") {
+                std::vector<float> vals = xml_readNums<float>(curr_param);
+                mdAssert(vals.size() == nBins, "Restart data for metadynamics fix %s has %d grid points, not %d", handle.c_str(), (int) vals.size(), nBins);
+                (tag == "bias" ? grid : gridDeriv).h_data = vals;
+            }
+            curr_param = curr_param.next_sibling();
+        }
+    }
+    return true;
+}
+
+void export_FixCVMetadynamics() {
+    py::class_<FixCVMetadynamics, boost::shared_ptr<FixCVMetadynamics>, py::bases<Fix>, boost::noncopyable> (
+        "FixCVMetadynamics",
+        py::init<boost::shared_ptr<State>, std::string, boost::shared_ptr<CollectiveVariable>, double, double, int, double, double, int,
+                 py::optional<double, double> >(
+            py::args("state", "handle", "cv", "height", "width", "depositEvery", "lo", "hi", "nBins", "biasFactor", "temp")
+        )
+    )
+    .def("getBias", &FixCVMetadynamics::getBias)
+    .def("getGridPoints", &FixCVMetadynamics::getGridPoints)
+    .def_readwrite("height", &FixCVMetadynamics::height)
+    .def_readwrite("width", &FixCVMetadynamics::width)
+    .def_readwrite("depositEvery", &FixCVMetadynamics::depositEvery)
+    .def_readwrite("biasFactor", &FixCVMetadynamics::biasFactor)
+    .def_readwrite("temp", &FixCVMetadynamics::temp)
+    .def_readonly("nHills", &FixCVMetadynamics::nHills)
+    ;
+}
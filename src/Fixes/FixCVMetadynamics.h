@@ -0,0 +1,76 @@
+#pragma once
+#ifndef FIXCVMETADYNAMICS_H
+#define FIXCVMETADYNAMICS_H
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python.hpp>
+#include <string>
+
+#include "Fix.h"
+#include "GPUArrayGlobal.h"
+#include "CollectiveVariable.h"
+
+void export_FixCVMetadynamics();
+
+//! Metadynamics on one collective variable, with the bias stored on a grid on the device
+/*!
+ * Every depositEvery turns a Gaussian hill of the given height and width is
+ * added at the current value of the variable to the bias and its derivative
+ * at each grid point.  The force comes from linear interpolation of the
+ * derivative, so the cost per turn does not grow with the number of hills.
+ *
+ * With a bias factor \f$ \gamma > 1 \f$ the run is well-tempered: hills are
+ * scaled by \f$ \exp(-V(s) / (k_B T (\gamma - 1))) \f$.
+ *
+ * Outside the grid the bias exerts no force, so the variable should be kept
+ * inside it.  Bias forces contribute to the virial.
+ */
+class FixCVMetadynamics : public Fix {
+public:
+    //! Constructor
+    /*!
+     * \param cv_ Variable to bias
+     * \param height_ Hill height, in energy
+     * \param width_ Hill standard deviation, in the variable's units
+     * \param depositEvery_ Turns between hills
+     * \param lo_ Lowest grid point
+     * \param hi_ Highest grid point
+     * \param nBins_ Number of grid points
+     * \param biasFactor_ Well-tempered bias factor.  0 for plain metadynamics
+     * \param temp_ Temperature, needed for well-tempered metadynamics
+     */
+    FixCVMetadynamics(boost::shared_ptr<State> state_, std::string handle_, boost::shared_ptr<CollectiveVariable> cv_,
+                      double height_, double width_, int depositEvery_, double lo_, double hi_, int nBins_,
+                      double biasFactor_=0, double temp_=0);
+
+    bool prepareForRun();
+    void compute(int);
+    void singlePointEng(float *);
+
+    bool readFromRestart();
+    std::string restartChunk(std::string format);
+
+    //! Bias at each grid point.  Synchronizes with the device
+    boost::python::list getBias();
+    //! Value of the variable at each grid point
+    boost::python::list getGridPoints();
+
+    boost::shared_ptr<CollectiveVariable> cv;
+    double height;
+    double width;
+    int depositEvery;
+    double lo;
+    double hi;
+    int nBins;
+    double biasFactor;
+    double temp;
+    int nHills; //!< Hills deposited so far
+    int64_t lastDepositTurn;
+
+    GPUArrayGlobal<float> grid; //!< Bias at each grid point
+    GPUArrayGlobal<float> gridDeriv; //!< Derivative of the bias at each grid point
+    GPUArrayGlobal<float> bias; //!< dV/ds, V and the height of a hill deposited now, at the last evaluation
+};
+
+#endif
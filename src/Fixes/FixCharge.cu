@@ -1,5 +1,6 @@
 #include "FixCharge.h"
 #include "State.h"
+#include "EvaluatorWrapper.h"
 
 namespace py = boost::python;
 
@@ -22,6 +23,27 @@ bool FixCharge::prepareForRun() {
     return true;
 }
 
+bool FixCharge::singlePointEngGroupMatrix(float *pairMatrix, float *chargeMatrix, float *,
+                                          const int *groupSlots, int nGroups) {
+    if (not evalWrap) {
+        return false;
+    }
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    evalWrap->energyGroupMatrix(nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.ids(activeIdx),
+                  neighborCounts, grid.neighborlist.data(), grid.perBlockArray.d_data.data(),
+                  state->devManager.prop.warpSize, nullptr, 0, state->boundsGPU,
+                  neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), getRCuts()[0],
+                  pairMatrix, chargeMatrix, groupSlots, nGroups, state->devManager.prop.sharedMemPerBlock,
+                  nThreadPerBlock(), nThreadPerAtom());
+    return true;
+}
+
 void export_FixCharge() {
     py::class_<FixCharge, SHARED(FixCharge), py::bases<Fix> > (
         "FixCharge",
@@ -20,6 +20,14 @@ public:
     bool prepareForRun();
     virtual void compute(int) { };
 
+    //! Charge energies between groups, within the real space cutoff only
+    /*!
+     * The reciprocal space energy of Ewald sums cannot be split between
+     * pairs of atoms and is left out.
+     */
+    bool singlePointEngGroupMatrix(float *pairMatrix, float *chargeMatrix, float *bondedMatrix,
+                                   const int *groupSlots, int nGroups);
+
 };
 
 #endif
@@ -10,6 +10,8 @@
 #include <fstream>
 #include "Virial.h"
 #include "helpers.h"
+#include "AllocationRegistry.h"
+#include "EwaldSpreading.h"
 
 #include "PairEvaluatorNone.h"
 #include "EvaluatorWrapper.h"
@@ -75,75 +77,18 @@ __global__ void map_charge_to_grid_order_1_cu(int nRingPoly, int nPerRingPoly, f
 
     int idx = GETIDX();
     if (idx < nRingPoly) {
-        float4 posWhole = xs[idx];
-        float3 pos = make_float3(posWhole)-bounds.lo;
-
         float qi = Qunit*qs[idx * nPerRingPoly];
-        
-        //find nearest grid point
-        float3 h=bounds.trace()/make_float3(sz);
-        int3 nearest_grid_point=make_int3((pos+0.5*h)/h);
-        //or
-        int3 p=nearest_grid_point;
-        if (p.x>0) p.x-=int(p.x/sz.x)*sz.x;
-        if (p.y>0) p.y-=int(p.y/sz.y)*sz.y;
-        if (p.z>0) p.z-=int(p.z/sz.z)*sz.z;
-        if (p.x<0) p.x-=int((p.x+1)/sz.x-1)*sz.x;
-        if (p.y<0) p.y-=int((p.y+1)/sz.y-1)*sz.y;
-        if (p.z<0) p.z-=int((p.z+1)/sz.z-1)*sz.z;
-        atomicAdd(&grid[p.x*sz.y*sz.z*2+p.y*sz.z*2+p.z*2], 1.0*qi);
+        spreadToGridOrder1(make_float3(xs[idx]), qi, bounds, sz, grid);
     }
 }
 
-inline __host__ __device__ float W_p_3(int i,float x){
-    if (i==-1) return 0.125-0.5*x+0.5*x*x;
-    if (i== 0) return 0.75-x*x;
-    /*if (i== 1)*/ return 0.125+0.5*x+0.5*x*x;
-}
-
-
 __global__ void map_charge_to_grid_order_3_cu(int nRingPoly, int nPerRingPoly, float4 *xs,  float *qs,  BoundsGPU bounds,
                                       int3 sz,float *grid/*convert to float for cufffComplex*/,float  Qunit) {
 
     int idx = GETIDX();
     if (idx < nRingPoly) {
-        float4 posWhole = xs[idx];
-        float3 pos = make_float3(posWhole)-bounds.lo;
-
         float qi = Qunit*qs[idx * nPerRingPoly];
-        
-        //find nearest grid point
-        float3 h=bounds.trace()/make_float3(sz);
-        int3 nearest_grid_point=make_int3((pos+0.5*h)/h);
-        
-        //distance from nearest_grid_point /h
-        float3 d=pos/h-make_float3(nearest_grid_point);
-        
-        int3 p=nearest_grid_point;
-        for (int ix=-1;ix<=1;ix++){
-          p.x=nearest_grid_point.x+ix;
-          float charge_yz_w=qi*W_p_3(ix,d.x);
-          for (int iy=-1;iy<=1;iy++){
-            p.y=nearest_grid_point.y+iy;
-            float charge_z_w=charge_yz_w*W_p_3(iy,d.y);
-            for (int iz=-1;iz<=1;iz++){
-                p.z=nearest_grid_point.z+iz;
-                float charge_w=charge_z_w*W_p_3(iz,d.z);
-                if (p.x>0) p.x-=int(p.x/sz.x)*sz.x;
-                if (p.y>0) p.y-=int(p.y/sz.y)*sz.y;
-                if (p.z>0) p.z-=int(p.z/sz.z)*sz.z;
-                if (p.x<0) p.x-=int((p.x+1)/sz.x-1)*sz.x;
-                if (p.y<0) p.y-=int((p.y+1)/sz.y-1)*sz.y;
-                if (p.z<0) p.z-=int((p.z+1)/sz.z-1)*sz.z;
-                if ((p.x<0) or (p.x>sz.x-1)) printf("grid point miss x  %d, %d, %d, %f \n", idx,p.x,nearest_grid_point.x,pos.x);
-                if ((p.y<0) or (p.y>sz.y-1)) printf("grid point miss y  %d, %d, %d, %f \n", idx,p.y,nearest_grid_point.y,pos.y);
-                if ((p.z<0) or (p.z>sz.z-1)) printf("grid point miss z  %d, %d, %d, %f \n", idx,p.z,nearest_grid_point.z,pos.z);
-                
-                atomicAdd(&grid[p.x*sz.y*sz.z*2+p.y*sz.z*2+p.z*2], charge_w);
-                
-            }
-          }
-        }
+        spreadToGridOrder3(make_float3(xs[idx]), qi, bounds, sz, grid);
     }
 }
 
@@ -157,14 +102,6 @@ __global__ void map_charge_set_to_zero_cu(int3 sz,cufftComplex *grid) {
          grid[id.x*sz.y*sz.z+id.y*sz.z+id.z]=make_cuComplex (0.0f, 0.0f);    
 }
 
-__device__ float sinc(float x){
-  if ((x<0.1)&&(x>-0.1)){
-    float x2=x*x;
-    return 1.0 - x2*0.16666666667f + x2*x2*0.008333333333333333f - x2*x2*x2*0.00019841269841269841f;    
-  }
-    else return sin(x)/x;
-}
-
 __global__ void Green_function_cu(BoundsGPU bounds, int3 sz,float *Green_function,float alpha,
                                   //now some parameter for Gf calc
                                   int sum_limits, int intrpl_order) {
@@ -629,10 +566,10 @@ FixChargeEwald::FixChargeEwald(SHARED(State) state_, string handle_, string grou
 FixChargeEwald::~FixChargeEwald(){
     cufftDestroy(plan);
     if (malloced) {
-        cudaFree(FFT_Qs);
-        cudaFree(FFT_Ex);
-        cudaFree(FFT_Ey);
-        cudaFree(FFT_Ez);
+        trackedCudaFree(FFT_Qs);
+        trackedCudaFree(FFT_Ex);
+        trackedCudaFree(FFT_Ey);
+        trackedCudaFree(FFT_Ez);
     }
 }
 
@@ -774,14 +711,15 @@ void FixChargeEwald::setParameters(int szx_,int szy_,int szz_,float rcut_,int in
     }
     sz=make_int3(szx_,szy_,szz_);
     r_cut=rcut_;
-    cudaMalloc((void**)&FFT_Qs, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+    AllocationScope scope(handle);
+    trackedCudaMalloc((void**)&FFT_Qs, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
 
     cufftPlan3d(&plan, sz.x,sz.y, sz.z, CUFFT_C2C);
 
     
-    cudaMalloc((void**)&FFT_Ex, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
-    cudaMalloc((void**)&FFT_Ey, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
-    cudaMalloc((void**)&FFT_Ez, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+    trackedCudaMalloc((void**)&FFT_Ex, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+    trackedCudaMalloc((void**)&FFT_Ey, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+    trackedCudaMalloc((void**)&FFT_Ez, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
     
     Green_function=GPUArrayGlobal<float>(sz.x*sz.y*sz.z);
     CUT_CHECK_ERROR("setParameters execution failed");
@@ -824,19 +762,19 @@ void FixChargeEwald::setGridToErrorTolerance(bool printMsg) {
     if (!malloced or szOld != sz) {
         if (malloced) {
             cufftDestroy(plan);
-            cudaFree(FFT_Qs);
-            cudaFree(FFT_Ex);
-            cudaFree(FFT_Ey);
-            cudaFree(FFT_Ez);
+            trackedCudaFree(FFT_Qs);
+            trackedCudaFree(FFT_Ex);
+            trackedCudaFree(FFT_Ey);
+            trackedCudaFree(FFT_Ez);
         }
-        cudaMalloc((void**)&FFT_Qs, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+        trackedCudaMalloc((void**)&FFT_Qs, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
 
         cufftPlan3d(&plan, sz.x,sz.y, sz.z, CUFFT_C2C);
 
 
-        cudaMalloc((void**)&FFT_Ex, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
-        cudaMalloc((void**)&FFT_Ey, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
-        cudaMalloc((void**)&FFT_Ez, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+        trackedCudaMalloc((void**)&FFT_Ex, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+        trackedCudaMalloc((void**)&FFT_Ey, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
+        trackedCudaMalloc((void**)&FFT_Ez, sizeof(cufftComplex)*sz.x*sz.y*sz.z);
 
         Green_function=GPUArrayGlobal<float>(sz.x*sz.y*sz.z);
         malloced = true;
@@ -29,6 +29,7 @@ FixDeform::FixDeform(boost::shared_ptr<State> state_, std::string handle_,
 bool FixDeform::prepareForRun() {
     deformRateInterpolator.turnBeginRun = state->runInit;
     deformRateInterpolator.turnFinishRun = state->runInit + state->runningFor;
+    deformRateInterpolator.sampleEvery = applyEvery;
     if (setPtVolume != -1) {
         //then override entered rate
         double curVol = state->bounds.volume();
@@ -36,7 +36,7 @@ void FixDihedralCHARMM::singlePointEng(float *perParticleEng) {
 
     GPUData &gpd = state->gpd;
     if (forcersGPU.size()) {
-        compute_energy_dihedral<<<NBLOCK(forcersGPU.size()), PERBLOCK, sizeof(DihedralGPU) * maxForcersPerBlock + sharedMemSizeForParams>>>(forcersGPU.size(), gpd.xs(activeIdx), perParticleEng, gpd.idToIdxs.d_data.data(), forcersGPU.data(), state->boundsGPU, parameters.data(), parameters.size(), usingSharedMemForParams, evaluator);
+        compute_energy_dihedral<<<NBLOCK(forcersGPU.size()), PERBLOCK, sizeof(DihedralGPU) * maxForcersPerBlock + sharedMemSizeForParams>>>(forcersGPU.size(), gpd.xs(activeIdx), perParticleEng, gpd.idToIdxs.d_data.data(), forcersGPU.data(), state->boundsGPU, parameters.data(), parameters.size(), usingSharedMemForParams, evaluator, groupMatrix);
     }
 
 }
@@ -0,0 +1,192 @@
+#include "helpers.h"
+#include "FixDihedralTabulated.h"
+#include "FixHelpers.h"
+#include "cutils_func.h"
+#include "DihedralEvaluate.h"
+#include "Logging.h"
+#include "xml_func.h"
+namespace py = boost::python;
+using namespace std;
+
+const std::string dihedralTabulatedType = "DihedralTabulated";
+
+
+FixDihedralTabulated::FixDihedralTabulated(SHARED(State) state_, string handle) : FixPotentialMultiAtom (state_, handle, dihedralTabulatedType, true){
+    evaluator.coefs = nullptr;
+    readFromRestart();
+}
+
+
+void FixDihedralTabulated::compute(int virialMode) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+
+
+    GPUData &gpd = state->gpd;
+    if (forcersGPU.size()) {
+        if (virialMode) {
+            compute_force_dihedral<DihedralTabulatedType, DihedralEvaluatorTabulated, true><<<NBLOCK(forcersGPU.size()), PERBLOCK, sharedMemSizeForParams >>>(forcersGPU.size(), gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), forcersGPU.data(), state->boundsGPU, parameters.data(), parameters.size(), gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        } else {
+            compute_force_dihedral<DihedralTabulatedType, DihedralEvaluatorTabulated, false><<<NBLOCK(forcersGPU.size()), PERBLOCK, sharedMemSizeForParams >>>(forcersGPU.size(), gpd.xs(activeIdx), gpd.fs(activeIdx), gpd.idToIdxs.d_data.data(), forcersGPU.data(), state->boundsGPU, parameters.data(), parameters.size(), gpd.virials.d_data.data(), usingSharedMemForParams, evaluator);
+        }
+    }
+
+}
+
+void FixDihedralTabulated::singlePointEng(float *perParticleEng) {
+    int nAtoms = state->atoms.size();
+    int activeIdx = state->gpd.activeIdx();
+
+    GPUData &gpd = state->gpd;
+    if (forcersGPU.size()) {
+        compute_energy_dihedral<<<NBLOCK(forcersGPU.size()), PERBLOCK, sharedMemSizeForParams>>>(forcersGPU.size(), gpd.xs(activeIdx), perParticleEng, gpd.idToIdxs.d_data.data(), forcersGPU.data(), state->boundsGPU, parameters.data(), parameters.size(), usingSharedMemForParams, evaluator, groupMatrix);
+    }
+
+}
+
+
+
+void FixDihedralTabulated::createDihedral(Atom *a, Atom *b, Atom *c, Atom *d, int type) {
+    vector<Atom *> atoms = {a, b, c, d};
+    validAtoms(atoms);
+    mdAssert(type >= 0, "Tabulated dihedrals need a dihedral type");
+    forcers.push_back(DihedralTabulated(a, b, c, d, type));
+    pyListInterface.updateAppendedMember();
+}
+
+void FixDihedralTabulated::setTable(int type, TabulatedSpline::Table table) {
+    mdAssert(type >= 0, "Tried to set table for invalid dihedral type %d", type);
+    mdAssert(fabs(table.xMax() - table.x0 - 2 * M_PI) < 1e-4,
+             "Dihedral tables must span one period of 2 pi");
+    table.periodic = true;
+    DihedralTabulated dihedralType;
+    auto it = forcerTypes.find(type);
+    if (it != forcerTypes.end()) {
+        dihedralType.table = it->second.table;
+        tables[dihedralType.table] = table;
+    } else {
+        dihedralType.table = tables.size();
+        tables.push_back(table);
+    }
+    dihedralType.x0 = table.x0;
+    dihedralType.invDx = 1 / table.dx;
+    dihedralType.offset = 0; //filled in by prepareForRun
+    dihedralType.nSegments = table.values.size() - 1;
+    setForcerType(type, dihedralType);
+    prepared = false;
+}
+
+TabulatedSpline::Table &FixDihedralTabulated::tableFor(int type) {
+    auto it = forcerTypes.find(type);
+    mdAssert(it != forcerTypes.end(), "No table for dihedral type %d in fix %s", type, handle.c_str());
+    return tables[it->second.table];
+}
+
+void FixDihedralTabulated::setDihedralTypeTable(int type, double phiMin, double phiMax,
+                                                py::object energies, py::object forces) {
+    setTable(type, TabulatedSpline::tableFromPython(phiMin, phiMax, energies, forces));
+}
+
+void FixDihedralTabulated::readDihedralTypeTable(int type, string fn) {
+    setTable(type, TabulatedSpline::tableFromFile(fn));
+}
+
+py::tuple FixDihedralTabulated::evaluate(int type, double phi) {
+    TabulatedSpline::Table &table = tableFor(type);
+    double period = table.xMax() - table.x0;
+    phi -= period * floor((phi - table.x0) / period);
+    std::pair<double, double> ef = table.evaluate(phi);
+    return py::make_tuple(ef.first, ef.second);
+}
+
+bool FixDihedralTabulated::prepareForRun() {
+    //every type in use needs a table
+    for (DihedralVariant &forcerVar : forcers) {
+        tableFor(boost::get<DihedralTabulated>(forcerVar).type);
+    }
+    std::vector<float4> allCoefs;
+    for (auto &entry : forcerTypes) {
+        std::vector<float4> tableCoefs = tables[entry.second.table].coefficients();
+        entry.second.offset = allCoefs.size();
+        allCoefs.insert(allCoefs.end(), tableCoefs.begin(), tableCoefs.end());
+    }
+    coefs = GPUArrayDeviceGlobal<float4>(allCoefs.size());
+    coefs.set(allCoefs.data());
+    evaluator.coefs = coefs.data();
+    return FixPotentialMultiAtom::prepareForRun();
+}
+
+string FixDihedralTabulated::restartChunk(string format) {
+    stringstream ss;
+    for (auto &entry : forcerTypes) {
+        ss << tables[entry.second.table].restartChunk("type='" + std::to_string(entry.first) + "'");
+    }
+    ss << "<members>\n";
+    for (DihedralVariant &forcerVar : forcers) {
+        DihedralTabulated &forcer = boost::get<DihedralTabulated>(forcerVar);
+        ss << forcer.getInfoString();
+    }
+    ss << "</members>\n";
+    return ss.str();
+}
+
+bool FixDihedralTabulated::readFromRestart() {
+    auto restData = getRestartNode();
+    if (restData) {
+        auto curr_node = restData.first_child();
+        while (curr_node) {
+            string tag = curr_node.name();
+            if (tag == "table") {
+                int type = atoi(curr_node.attribute("type").value());
+                setTable(type, TabulatedSpline::tableFromRestart(curr_node));
+            } else if (tag == "members") {
+                for (auto member_node = curr_node.first_child(); member_node; member_node = member_node.next_sibling()) {
+                    int type = atoi(member_node.attribute("type").value());
+                    Atom * a = &state->idToAtom(atoi(member_node.attribute("atomID_a").value()));
+                    Atom * b = &state->idToAtom(atoi(member_node.attribute("atomID_b").value()));
+                    Atom * c = &state->idToAtom(atoi(member_node.attribute("atomID_c").value()));
+                    Atom * d = &state->idToAtom(atoi(member_node.attribute("atomID_d").value()));
+                    createDihedral(a, b, c, d, type);
+                }
+            }
+            curr_node = curr_node.next_sibling();
+        }
+    }
+    return true;
+}
+
+
+void export_FixDihedralTabulated() {
+    py::class_<FixDihedralTabulated,
+                          SHARED(FixDihedralTabulated),
+                          py::bases<Fix, TypedItemHolder> > (
+        "FixDihedralTabulated",
+        py::init<SHARED(State), string> (
+            py::args("state", "handle")
+        )
+    )
+    .def("createDihedral", &FixDihedralTabulated::createDihedral,
+            (py::arg("type"))
+        )
+    .def("setDihedralTypeTable", &FixDihedralTabulated::setDihedralTypeTable,
+            (py::arg("type"),
+             py::arg("phiMin"),
+             py::arg("phiMax"),
+             py::arg("energies"),
+             py::arg("forces")=py::list()
+            )
+        )
+    .def("readDihedralTypeTable", &FixDihedralTabulated::readDihedralTypeTable,
+            (py::arg("type"),
+             py::arg("fn")
+            )
+        )
+    .def("evaluate", &FixDihedralTabulated::evaluate,
+            (py::arg("type"),
+             py::arg("phi")
+            )
+        )
+    .def_readonly("dihedrals", &FixDihedralTabulated::pyForcers)
+    ;
+
+}
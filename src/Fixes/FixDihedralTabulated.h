@@ -0,0 +1,55 @@
+#pragma once
+#ifndef FIXDIHEDRALTABULATED_H
+#define FIXDIHEDRALTABULATED_H
+
+#include <vector>
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python.hpp>
+
+#include "FixPotentialMultiAtom.h"
+#include "Dihedral.h"
+#include "DihedralEvaluatorTabulated.h"
+#include "TabulatedSpline.h"
+
+void export_FixDihedralTabulated();
+
+//! Fix for dihedrals whose potential is given as a table of energy against phi
+/*!
+ * Tables are set per dihedral type and held like those of FixAngleTabulated,
+ * and must span one full period of 2 pi, with the last energy equal to the
+ * first.  If no forces are given the periodic spline through the energies is
+ * used.  phi follows the convention of FixDihedralOPLS, with trans at +-pi.
+ */
+class FixDihedralTabulated : public FixPotentialMultiAtom<DihedralVariant, DihedralTabulated, Dihedral, DihedralGPU, DihedralTabulatedType, 4> {
+
+private:
+    DihedralEvaluatorTabulated evaluator;
+    std::vector<TabulatedSpline::Table> tables; //!< Tables, indexed by the table of each dihedral type
+    GPUArrayDeviceGlobal<float4> coefs; //!< Segments of all tables, one after another
+
+    void setTable(int type, TabulatedSpline::Table table);
+    TabulatedSpline::Table &tableFor(int type);
+public:
+    FixDihedralTabulated(boost::shared_ptr<State> state_, std::string handle);
+
+    void compute(int);
+    void singlePointEng(float *);
+    bool prepareForRun();
+    std::string restartChunk(std::string format);
+
+    void createDihedral(Atom *, Atom *, Atom *, Atom *, int);
+    //! Set the table of a dihedral type from energies, and optionally -dE/dphi, at uniformly spaced angles
+    void setDihedralTypeTable(int type, double phiMin, double phiMax,
+                              boost::python::object energies, boost::python::object forces);
+    //! Read the table of a dihedral type from a file of lines "phi energy [force]"
+    void readDihedralTypeTable(int type, std::string fn);
+    //! Energy and -dE/dphi of a dihedral type at phi, evaluated on the host
+    boost::python::tuple evaluate(int type, double phi);
+
+    bool readFromRestart();
+
+};
+
+#endif
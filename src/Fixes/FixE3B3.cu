@@ -451,10 +451,6 @@ bool FixE3B3::prepareForRun(){
     // tell gridGPU not to do any exclusions stuff
     gridGPULocal.doExclusions(false);
 
-    // so, the only buffers that we need are the xs and ids!
-    gpdLocal.xsBuffer = GPUArrayGlobal<float4>(nMolecules);
-    gpdLocal.idsBuffer = GPUArrayGlobal<uint>(nMolecules);
-    
     gridGPULocal.periodicBoundaryConditions(-1, true);
 
     prepared = true;
@@ -25,7 +25,7 @@ public:
 			bool forceSingle_, bool requiresCharges_, int applyEvery_)
 		: Fix(state_, handle_, groupHandle_, type_, true, false, false, applyEvery_)
 		{
-		
+            supportsExtendedGroups = true;
        		 };
 };
 
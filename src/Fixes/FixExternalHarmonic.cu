@@ -24,10 +24,10 @@ void FixExternalHarmonic::compute(int virialMode) {
 	int n         = state->atoms.size();
 	if (virialMode==2 or virialMode == 1) {
 		compute_force_external<EvaluatorExternalHarmonic, true> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), groupTag, gpd.virials.d_data.data(), evaluator);
+                    gpd.fs(activeIdx), state->groupMask(groupTag), gpd.virials.d_data.data(), evaluator);
 	} else {
 		compute_force_external<EvaluatorExternalHarmonic, false> <<<NBLOCK(n), PERBLOCK>>>(n, gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), groupTag, gpd.virials.d_data.data(), evaluator);
+                    gpd.fs(activeIdx), state->groupMask(groupTag), gpd.virials.d_data.data(), evaluator);
 	}
 };
 
@@ -36,7 +36,7 @@ void FixExternalHarmonic::singlePointEng(float *perParticleEng) {
         int activeIdx = gpd.activeIdx();
         int n         = state->atoms.size();
         compute_energy_external<EvaluatorExternalHarmonic> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), perParticleEng, groupTag, evaluator);
+                    gpd.fs(activeIdx), perParticleEng, state->groupMask(groupTag), evaluator);
 };
 
 
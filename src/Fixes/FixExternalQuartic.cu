@@ -25,10 +25,10 @@ void FixExternalQuartic::compute(int virialMode) {
 	int n         = state->atoms.size();
 	if (virialMode==2 or virialMode==1) {
 		compute_force_external<EvaluatorExternalQuartic, true> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), groupTag, gpd.virials.d_data.data(), evaluator);
+                    gpd.fs(activeIdx), state->groupMask(groupTag), gpd.virials.d_data.data(), evaluator);
 	} else {
 		compute_force_external<EvaluatorExternalQuartic, false> <<<NBLOCK(n), PERBLOCK>>>(n, gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), groupTag, gpd.virials.d_data.data(), evaluator);
+                    gpd.fs(activeIdx), state->groupMask(groupTag), gpd.virials.d_data.data(), evaluator);
 	}
 };
 
@@ -37,7 +37,7 @@ void FixExternalQuartic::singlePointEng(float *perParticleEng) {
         int activeIdx = gpd.activeIdx();
         int n         = state->atoms.size();
         compute_energy_external<EvaluatorExternalQuartic> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), perParticleEng, groupTag, evaluator);
+                    gpd.fs(activeIdx), perParticleEng, state->groupMask(groupTag), evaluator);
 };
 
 
@@ -203,6 +203,10 @@ vector<float> FixLJCHARMM::getRCuts() {
     return res;
 }
 
+vector<float> FixLJCHARMM::getRCutsByType() {
+    return rCutsByType(rCutHandle);
+}
+
 void export_FixLJCHARMM() {
     py::class_<FixLJCHARMM, boost::shared_ptr<FixLJCHARMM>, py::bases<FixPair>, boost::noncopyable > (
         "FixLJCHARMM",
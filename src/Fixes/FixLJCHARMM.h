@@ -75,6 +75,8 @@ class FixLJCHARMM : public FixPair {
 
         //! Return list of cutoff values
         std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types
+        std::vector<float> getRCutsByType();
     public:
         void setEvalWrapper();
         const std::string epsHandle; //!< Handle for parameter epsilon
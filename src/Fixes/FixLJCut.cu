@@ -153,6 +153,10 @@ vector<float> FixLJCut::getRCuts() {
     return res;
 }
 
+vector<float> FixLJCut::getRCutsByType() {
+    return rCutsByType(rCutHandle);
+}
+
 void export_FixLJCut() {
     py::class_<FixLJCut, boost::shared_ptr<FixLJCut>, py::bases<FixPair>, boost::noncopyable > (
         "FixLJCut",
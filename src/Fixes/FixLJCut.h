@@ -77,6 +77,8 @@ class FixLJCut : public FixPair {
 
         //! Return list of cutoff values
         std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types
+        std::vector<float> getRCutsByType();
     public:
         void setEvalWrapper();
 
@@ -172,6 +172,10 @@ std::vector<float> FixLJCutFS::getRCuts() {
     return res;
 }
 
+std::vector<float> FixLJCutFS::getRCutsByType() {
+    return rCutsByType(rCutHandle);
+}
+
 void export_FixLJCutFS() {
     py::class_<FixLJCutFS,
                           SHARED(FixLJCutFS),
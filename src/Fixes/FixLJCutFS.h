@@ -61,6 +61,8 @@ class FixLJCutFS : public FixPair {
 
         //! Return list of cutoff values
         std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types
+        std::vector<float> getRCutsByType();
 
     public:
         const std::string epsHandle; //!< Handle for parameter epsilon
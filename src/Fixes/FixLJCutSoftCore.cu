@@ -0,0 +1,283 @@
+#include "FixLJCutSoftCore.h"
+
+#include "BoundsGPU.h"
+#include "GridGPU.h"
+#include "State.h"
+#include "GroupMask.h"
+#include "cutils_func.h"
+#include "PairEvaluatorLJSoftCore.h"
+#include "ChargeEvaluatorDSFSoftCore.h"
+#include "PairEvaluateAlchemical.h"
+#include "DataComputerAlchemical.h"
+#include "Logging.h"
+#include <iomanip>
+using namespace std;
+using namespace MD_ENGINE;
+namespace py = boost::python;
+const string LJCutSoftCoreType = "LJCutSoftCore";
+
+//launches the force sweep for one combination of what it computes
+template <bool COMP_VIRIALS, bool COMP_CHARGES, bool COMP_LAMBDA>
+void computeSoftCore(State *state, float *parameters, int numTypes, float qCutoff, uint32_t alchemicalTag, float lambda,
+                     DataComputerAlchemical *sample, int nThreadPerBlock, int nThreadPerAtom,
+                     EvaluatorLJSoftCore pairEval, ChargeEvaluatorDSFSoftCore chargeEval) {
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    const float *sampleLambdas = nullptr;
+    int nSampleLambdas = 0;
+    float *dEngDLambdas = nullptr;
+    float *deltaEngs = nullptr;
+    if (COMP_LAMBDA) {
+        sampleLambdas = sample->sampleLambdas.getDevData();
+        nSampleLambdas = sample->lambdas.size();
+        dEngDLambdas = sample->gpuBuffer.getDevData();
+        deltaEngs = dEngDLambdas + nAtoms;
+    }
+    size_t sharedMem = 3*numTypes*numTypes*sizeof(float);
+    if (nThreadPerAtom == 1) {
+        compute_force_alchemical<EvaluatorLJSoftCore, 3, COMP_VIRIALS, ChargeEvaluatorDSFSoftCore, COMP_CHARGES, COMP_LAMBDA, 0>
+            <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), nThreadPerBlock, sharedMem>>>(
+                nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx), neighborCounts, grid.neighborlist.data(),
+                grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, parameters, numTypes, state->boundsGPU,
+                neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.virials.d_data.data(), gpd.qs(activeIdx), qCutoff*qCutoff,
+                alchemicalTag, lambda, sampleLambdas, nSampleLambdas, dEngDLambdas, deltaEngs, nThreadPerAtom, pairEval, chargeEval);
+    } else {
+        sharedMem += nThreadPerBlock*(sizeof(float3) + sizeof(Virial));
+        if (COMP_LAMBDA) {
+            sharedMem += nThreadPerBlock*(1 + nSampleLambdas)*sizeof(float);
+        }
+        compute_force_alchemical<EvaluatorLJSoftCore, 3, COMP_VIRIALS, ChargeEvaluatorDSFSoftCore, COMP_CHARGES, COMP_LAMBDA, 1>
+            <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), nThreadPerBlock, sharedMem>>>(
+                nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx), neighborCounts, grid.neighborlist.data(),
+                grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, parameters, numTypes, state->boundsGPU,
+                neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.virials.d_data.data(), gpd.qs(activeIdx), qCutoff*qCutoff,
+                alchemicalTag, lambda, sampleLambdas, nSampleLambdas, dEngDLambdas, deltaEngs, nThreadPerAtom, pairEval, chargeEval);
+    }
+}
+
+template <bool COMP_CHARGES, bool COMP_LAMBDA>
+void computeSoftCore(bool computeVirials, State *state, float *parameters, int numTypes, float qCutoff, uint32_t alchemicalTag, float lambda,
+                     DataComputerAlchemical *sample, int nThreadPerBlock, int nThreadPerAtom,
+                     EvaluatorLJSoftCore pairEval, ChargeEvaluatorDSFSoftCore chargeEval) {
+    if (computeVirials) {
+        computeSoftCore<true, COMP_CHARGES, COMP_LAMBDA>(state, parameters, numTypes, qCutoff, alchemicalTag, lambda, sample, nThreadPerBlock, nThreadPerAtom, pairEval, chargeEval);
+    } else {
+        computeSoftCore<false, COMP_CHARGES, COMP_LAMBDA>(state, parameters, numTypes, qCutoff, alchemicalTag, lambda, sample, nThreadPerBlock, nThreadPerAtom, pairEval, chargeEval);
+    }
+}
+
+template <bool COMP_CHARGES>
+void energySoftCore(State *state, float *perParticleEng, float *parameters, int numTypes, float qCutoff, uint32_t alchemicalTag, float lambda,
+                    int nThreadPerBlock, int nThreadPerAtom, EvaluatorLJSoftCore pairEval, ChargeEvaluatorDSFSoftCore chargeEval) {
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    size_t sharedMem = 3*numTypes*numTypes*sizeof(float);
+    if (nThreadPerAtom == 1) {
+        compute_energy_alchemical<EvaluatorLJSoftCore, 3, ChargeEvaluatorDSFSoftCore, COMP_CHARGES, 0>
+            <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), nThreadPerBlock, sharedMem>>>(
+                nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx), perParticleEng, neighborCounts, grid.neighborlist.data(),
+                grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, parameters, numTypes, state->boundsGPU,
+                neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), qCutoff*qCutoff,
+                alchemicalTag, lambda, nThreadPerAtom, pairEval, chargeEval);
+    } else {
+        compute_energy_alchemical<EvaluatorLJSoftCore, 3, ChargeEvaluatorDSFSoftCore, COMP_CHARGES, 1>
+            <<<NBLOCKTEAM(nAtoms, nThreadPerBlock, nThreadPerAtom), nThreadPerBlock, sharedMem + nThreadPerBlock*sizeof(float)>>>(
+                nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx), perParticleEng, neighborCounts, grid.neighborlist.data(),
+                grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, parameters, numTypes, state->boundsGPU,
+                neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), qCutoff*qCutoff,
+                alchemicalTag, lambda, nThreadPerAtom, pairEval, chargeEval);
+    }
+}
+
+FixLJCutSoftCore::FixLJCutSoftCore(boost::shared_ptr<State> state_, string handle_, string alchemicalHandle_, string mixingRules_)
+    : FixPair(state_, handle_, "all", LJCutSoftCoreType, true, false, 1, mixingRules_),
+    epsHandle("eps"), sigHandle("sig"), rCutHandle("rCut"), alchemicalHandle(alchemicalHandle_),
+    lambda(1), alphaLJ(0.5), alphaCharge(1), chargesOn(false), chargeAlpha(0.25), chargeCutoff(9)
+{
+    alchemicalTag = state->groupTagFromHandle(alchemicalHandle);
+    mdAssert(not (alchemicalTag & GROUP_TAG_EXTENDED), "Alchemical groups are only supported for the first %d groups, not %s",
+             GROUP_TAG_NBITS, alchemicalHandle.c_str());
+    initializeParameters(epsHandle, epsilons);
+    initializeParameters(sigHandle, sigmas);
+    initializeParameters(rCutHandle, rCuts);
+    paramOrder = {rCutHandle, epsHandle, sigHandle};
+    readFromRestart();
+}
+
+void FixLJCutSoftCore::setCharges(float alpha_, float rCut_) {
+    chargesOn = true;
+    requiresCharges = true;
+    chargeAlpha = alpha_;
+    chargeCutoff = rCut_;
+}
+
+ChargeEvaluatorDSFSoftCore FixLJCutSoftCore::generateChargeEvaluator() {
+    float A = 2.0/sqrt(M_PI)*chargeAlpha;
+    float shift = std::erfc(chargeAlpha*chargeCutoff)/(chargeCutoff*chargeCutoff)+A*exp(-chargeAlpha*chargeAlpha*chargeCutoff*chargeCutoff)/chargeCutoff;
+    return ChargeEvaluatorDSFSoftCore(chargeAlpha, A, shift, state->units.qqr_to_eng, chargeCutoff, alphaCharge);
+}
+
+void FixLJCutSoftCore::compute(int virialMode) {
+    int numTypes = state->atomParams.numTypes;
+    bool computeVirials = virialMode==1 or virialMode==2;
+    DataComputerAlchemical *sample = DataComputerAlchemical::sampling(state, this);
+    EvaluatorLJSoftCore pairEval(alphaLJ);
+    ChargeEvaluatorDSFSoftCore chargeEval = generateChargeEvaluator();
+    if (chargesOn) {
+        if (sample) {
+            computeSoftCore<true, true>(computeVirials, state, paramsCoalesced.data(), numTypes, chargeCutoff, alchemicalTag, lambda, sample, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+        } else {
+            computeSoftCore<true, false>(computeVirials, state, paramsCoalesced.data(), numTypes, chargeCutoff, alchemicalTag, lambda, sample, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+        }
+    } else {
+        if (sample) {
+            computeSoftCore<false, true>(computeVirials, state, paramsCoalesced.data(), numTypes, 0, alchemicalTag, lambda, sample, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+        } else {
+            computeSoftCore<false, false>(computeVirials, state, paramsCoalesced.data(), numTypes, 0, alchemicalTag, lambda, sample, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+        }
+    }
+}
+
+void FixLJCutSoftCore::singlePointEng(float *perParticleEng) {
+    int numTypes = state->atomParams.numTypes;
+    EvaluatorLJSoftCore pairEval(alphaLJ);
+    ChargeEvaluatorDSFSoftCore chargeEval = generateChargeEvaluator();
+    if (chargesOn) {
+        energySoftCore<true>(state, perParticleEng, paramsCoalesced.data(), numTypes, chargeCutoff, alchemicalTag, lambda, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+    } else {
+        energySoftCore<false>(state, perParticleEng, paramsCoalesced.data(), numTypes, 0, alchemicalTag, lambda, nThreadPerBlock(), nThreadPerAtom(), pairEval, chargeEval);
+    }
+}
+
+bool FixLJCutSoftCore::prepareForRun() {
+    mdAssert(lambda >= 0 and lambda <= 1, "Lambda of fix %s must be between 0 and 1, not %f", handle.c_str(), lambda);
+    auto fillGeo = [] (float a, float b) {
+        return sqrt(a*b);
+    };
+    auto fillArith = [] (float a, float b) {
+        return (a+b) / 2.0;
+    };
+    auto fillRCut = [this] (float a, float b) {
+        return (float) std::fmax(a, b);
+    };
+    auto fillRCutDiag = [this] () {
+        return (float) state->rCut;
+    };
+    auto processEps = [] (float a) {
+        return 24*a;
+    };
+    auto processSig = [] (float a) {
+        return pow(a, 6);
+    };
+    auto processRCut = [] (float a) {
+        return a*a;
+    };
+    prepareParameters(epsHandle, fillGeo, processEps, false);
+    if (mixingRules==ARITHMETICTYPE) {
+        prepareParameters(sigHandle, fillArith, processSig, false);
+    } else {
+        prepareParameters(sigHandle, fillGeo, processSig, false);
+    }
+    prepareParameters(rCutHandle, fillRCut, processRCut, true, fillRCutDiag);
+
+    sendAllToDevice();
+    prepared = true;
+    return prepared;
+}
+
+string FixLJCutSoftCore::restartChunk(string format) {
+    stringstream ss;
+    ss << restartChunkPairParams(format);
+    ss << setprecision(17);
+    ss << "<lambda>" << lambda << "</lambda>\n";
+    ss << "<alphaLJ>" << alphaLJ << "</alphaLJ>\n";
+    ss << "<alphaCharge>" << alphaCharge << "</alphaCharge>\n";
+    if (chargesOn) {
+        ss << "<charges alpha=\"" << chargeAlpha << "\" rCut=\"" << chargeCutoff << "\"/>\n";
+    }
+    return ss.str();
+}
+
+bool FixLJCutSoftCore::readFromRestart() {
+    FixPair::readFromRestart();
+    pugi::xml_node restData = getRestartNode();
+    if (restData) {
+        auto curr_param = restData.first_child();
+        while (curr_param) {
+            string tag = curr_param.name();
+            if (tag == "lambda") {
+                lambda = atof(curr_param.first_child().value());
+            } else if (tag == "alphaLJ") {
+                alphaLJ = atof(curr_param.first_child().value());
+            } else if (tag == "alphaCharge") {
+                alphaCharge = atof(curr_param.first_child().value());
+            } else if (tag == "charges") {
+                setCharges(curr_param.attribute("alpha").as_float(), curr_param.attribute("rCut").as_float());
+            }
+            curr_param = curr_param.next_sibling();
+        }
+    }
+    return true;
+}
+
+bool FixLJCutSoftCore::postRun() {
+    return true;
+}
+
+void FixLJCutSoftCore::addSpecies(string handle) {
+    initializeParameters(epsHandle, epsilons);
+    initializeParameters(sigHandle, sigmas);
+    initializeParameters(rCutHandle, rCuts);
+}
+
+vector<float> FixLJCutSoftCore::getRCuts() {
+    vector<float> res;
+    vector<float> &src = *(paramMap[rCutHandle]);
+    for (float x : src) {
+        if (x == DEFAULT_FILL) {
+            res.push_back(-1);
+        } else {
+            res.push_back(x);
+        }
+    }
+    if (chargesOn) {
+        res.push_back(chargeCutoff);
+    }
+    return res;
+}
+
+vector<float> FixLJCutSoftCore::getRCutsByType() {
+    vector<float> res = rCutsByType(rCutHandle);
+    if (chargesOn) {
+        for (float &x : res) {
+            x = std::fmax(x, chargeCutoff);
+        }
+    }
+    return res;
+}
+
+void export_FixLJCutSoftCore() {
+    py::class_<FixLJCutSoftCore, boost::shared_ptr<FixLJCutSoftCore>, py::bases<FixPair>, boost::noncopyable > (
+        "FixLJCutSoftCore",
+        py::init<boost::shared_ptr<State>, string, string, py::optional<string> > (py::args("state", "handle", "alchemicalHandle", "mixingRules"))
+    )
+    .def("setCharges", &FixLJCutSoftCore::setCharges,
+            (py::arg("alpha") = 0.25,
+             py::arg("rCut") = 9.0)
+        )
+    .def_readwrite("lambda_", &FixLJCutSoftCore::lambda)
+    .def_readwrite("alphaLJ", &FixLJCutSoftCore::alphaLJ)
+    .def_readwrite("alphaCharge", &FixLJCutSoftCore::alphaCharge)
+    .def_readonly("alchemicalHandle", &FixLJCutSoftCore::alchemicalHandle)
+    ;
+}
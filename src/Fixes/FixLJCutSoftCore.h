@@ -0,0 +1,87 @@
+#pragma once
+#ifndef FIXLJCUTSOFTCORE_H
+#define FIXLJCUTSOFTCORE_H
+
+#include "FixPair.h"
+#include "xml_func.h"
+#include "ChargeEvaluatorDSFSoftCore.h"
+void export_FixLJCutSoftCore();
+
+//! Fix for Lennard-Jones and optional DSF Coulomb interactions scaled by lambda, for free energy calculations
+/*!
+ * Pairs with exactly one atom in the alchemical group are scaled by lambda
+ * with soft cores, so the group is decoupled from the rest of the system as
+ * lambda goes from 1 to 0 while its internal interactions are kept. The LJ
+ * part is
+ * \f[
+ * V(r_{ij}) = \lambda 4 \varepsilon \left[ \frac{\sigma^{12}}{s^2} - \frac{\sigma^6}{s}\right],
+ * \quad s = \alpha \sigma^6 (1 - \lambda) + r_{ij}^6,
+ * \f]
+ * and the Coulomb part is the damped shifted force potential of
+ * FixChargePairDSF evaluated at \f$ \sqrt{\alpha_q (1-\lambda) + r_{ij}^2} \f$
+ * and scaled by \f$ \lambda \f$. All other pairs are evaluated at
+ * \f$ \lambda = 1 \f$, which is plain LJ and DSF.  This fix therefore replaces
+ * FixLJCut and FixChargePairDSF rather than being used alongside them.
+ *
+ * On turns a DataComputerAlchemical of this fix samples, the force sweep
+ * also computes dU/dlambda and the energy at the computer's other lambdas.
+ */
+
+extern const std::string LJCutSoftCoreType;
+class FixLJCutSoftCore : public FixPair {
+    public:
+        //! Constructor
+        /*!
+         * \param handle Name of the fix
+         * \param alchemicalHandle Group whose interactions with the other atoms are scaled.  Must have per-atom tags
+         * \param mixingRules geometric or arithmetic
+         */
+        FixLJCutSoftCore(SHARED(State), std::string handle, std::string alchemicalHandle, std::string mixingRules="geometric");
+
+        //! Compute forces, and lambda derivatives if a data set samples them this turn
+        void compute(int);
+
+        //! Compute single point energy at the current lambda
+        void singlePointEng(float *);
+
+        //! Turn on soft-core DSF Coulomb interactions
+        /*!
+         * \param alpha_ Damping parameter of the DSF potential
+         * \param rCut_ Cutoff of the Coulomb interactions
+         */
+        void setCharges(float alpha_, float rCut_);
+
+        bool prepareForRun();
+        bool postRun();
+        //! Pair parameters, lambda, the soft-core parameters and the Coulomb settings
+        std::string restartChunk(std::string format);
+        bool readFromRestart();
+        void addSpecies(std::string handle);
+
+        //! Return list of cutoff values
+        std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types, including the Coulomb cutoff if charges are on
+        std::vector<float> getRCutsByType();
+
+        const std::string epsHandle; //!< Handle for parameter epsilon
+        const std::string sigHandle; //!< Handle for parameter sigma
+        const std::string rCutHandle; //!< Handle for parameter rCut
+        std::vector<float> epsilons; //!< vector storing epsilon values
+        std::vector<float> sigmas; //!< vector storing sigma values
+        std::vector<float> rCuts; //!< vector storing cutoff distance values
+
+        std::string alchemicalHandle;
+        uint32_t alchemicalTag;
+        double lambda; //!< 1 is fully coupled, 0 decoupled
+        double alphaLJ; //!< Soft-core parameter of the LJ part, dimensionless
+        double alphaCharge; //!< Soft-core parameter of the Coulomb part, in distance squared
+
+        //! DSF evaluator with this fix's charge parameters
+        ChargeEvaluatorDSFSoftCore generateChargeEvaluator();
+
+        bool chargesOn;
+        float chargeAlpha; //!< DSF damping parameter
+        float chargeCutoff; //!< DSF cutoff
+};
+
+#endif
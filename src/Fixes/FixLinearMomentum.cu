@@ -6,7 +6,9 @@ const std::string linearMomentumType = "LinearMomentum";
 
 FixLinearMomentum::FixLinearMomentum(SHARED(State) state_, std::string handle_, std::string groupHandle_, int applyEvery_, Vector dimensions_)
   : Fix(state_, handle_, groupHandle_, linearMomentumType, false, false, false, applyEvery_), dimensions(dimensions_), sumMomentum(GPUArrayDeviceGlobal<float4>(2))
-{   }
+{
+    supportsExtendedGroups = true;
+}
 
 bool FixLinearMomentum::prepareForRun() {
     prepared = true;
@@ -28,11 +30,11 @@ __global__ void rescale_all(int nAtoms, float4 *vs, float4 *sumData, float3 dims
 }
 
 
-__global__ void rescale_group(int nAtoms, float4 *vs, float4 *fs, uint32_t groupTag, float4 *sumData, float3 dims) {
+__global__ void rescale_group(int nAtoms, float4 *vs, float4 *fs, GroupMask group, float4 *sumData, float3 dims) {
     int idx = GETIDX();
     if (idx < nAtoms) {
         uint32_t tag = *(uint32_t *) &(fs[idx].w);
-        if (tag & groupTag) {
+        if (group.contains(tag, idx)) {
             float4 v = vs[idx];
             float4 sum = sumData[0];
             float invMassTotal = 1.0f / sum.w;
@@ -48,7 +50,7 @@ void FixLinearMomentum::compute(int virialMode) {
     float3 dimsFloat3 = dimensions.asFloat3();
     int nAtoms = state->atoms.size();
     float4 *vs = state->gpd.vs.getDevData();
-    float4 *fs = state->gpd.vs.getDevData();
+    float4 *fs = state->gpd.fs.getDevData();
     int warpSize = state->devManager.prop.warpSize;
 
     sumMomentum.memset(0); 
@@ -65,15 +67,17 @@ void FixLinearMomentum::compute(int virialMode) {
 
 
     } else {
+        GroupMask group = state->groupMask(groupTag);
         accumulate_gpu_if<float4, float4, SumVectorXYZOverWIf, N_DATA_PER_THREAD> <<<NBLOCK(nAtoms / (double) N_DATA_PER_THREAD), PERBLOCK, N_DATA_PER_THREAD*PERBLOCK*sizeof(float4)>>>
             (
              sumMomentum.data(),
              vs,
              nAtoms,
              warpSize,
-             SumVectorXYZOverWIf(fs, groupTag)
+             SumVectorXYZOverWIf(fs, group),
+             IndexAll()
             );
-        rescale_group<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, vs, fs, groupTag, sumMomentum.data(), dimsFloat3);
+        rescale_group<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, vs, fs, group, sumMomentum.data(), dimsFloat3);
     }
 }
 
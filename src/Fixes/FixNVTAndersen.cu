@@ -22,6 +22,7 @@ FixNVTAndersen::FixNVTAndersen(SHARED(State) state_, string handle_, string grou
 {
     setDefaults();
     isThermostat = true;
+    supportsExtendedGroups = true;
     nudt         = state_->dt * nu_; 
 }
 
@@ -32,6 +33,7 @@ FixNVTAndersen::FixNVTAndersen(SHARED(State) state_, string handle_, string grou
 {
     setDefaults();
     isThermostat = true;
+    supportsExtendedGroups = true;
     nudt         = state_->dt * nu_; 
 }
 
@@ -42,6 +44,7 @@ FixNVTAndersen::FixNVTAndersen(SHARED(State) state_, string handle_, string grou
 {
     setDefaults();
     isThermostat = true;
+    supportsExtendedGroups = true;
     nudt         = state_->dt * nu_; 
 }
 
@@ -54,6 +57,7 @@ void __global__ initRand(int nAtoms, curandState_t *states, int seed,int turn) {
 bool FixNVTAndersen::prepareForRun() {
     turnBeginRun = state->runInit;
     turnFinishRun = state->runInit + state->runningFor;
+    sampleEvery = applyEvery;
     tempComputer.prepareForRun();
     randStates = GPUArrayDeviceGlobal<curandState_t>(state->atoms.size());
     initRand<<<NBLOCK(state->atoms.size()), PERBLOCK>>>(state->atoms.size(), randStates.data(), seed,state->turn);
@@ -84,14 +88,14 @@ void __global__ resample_no_tags_cu(int nAtoms, float4 *vs, curandState_t *randS
     }
 }
 
-void __global__ resample_cu(int nAtoms, uint groupTag, float4 *vs, float4 *fs, curandState_t *randStates, float tempSet, float nudt, float boltz, float mvv_to_e) {
+void __global__ resample_cu(int nAtoms, GroupMask group, float4 *vs, float4 *fs, curandState_t *randStates, float tempSet, float nudt, float boltz, float mvv_to_e) {
 
     int idx = GETIDX();
     if (tempSet > 0 and idx < nAtoms) {
         curandState_t *randState = randStates + idx;
         curandState_t localState=*randState;
         uint groupTagAtom = ((uint *) (fs+idx))[3];
-        if (groupTag & groupTagAtom) {
+        if (group.contains(groupTagAtom, idx)) {
             if ( curand_uniform(&localState) <= nudt ) {
                 // resample from Boltzmann distribution
                 float4 vnew    = vs[idx];
@@ -126,9 +130,10 @@ void FixNVTAndersen::compute(int virialMode) {
                 temp, nudt,state->units.boltz,state->units.mvv_to_eng);
 
     } else {
-        resample_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, groupTag, gpd.vs(activeIdx),gpd.fs(activeIdx), randStates.data(), 
+        resample_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, state->groupMask(groupTag), gpd.vs(activeIdx),gpd.fs(activeIdx), randStates.data(), 
                 temp, nudt,state->units.boltz,state->units.mvv_to_eng);
     }
+    state->dataManager.reductions.invalidate();
 }
 
 
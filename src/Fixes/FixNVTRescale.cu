@@ -7,9 +7,9 @@
 class SumVectorSqr3DOverWIf_Bounds {
 public:
     float4 *fs;
-    uint32_t groupTag;
+    GroupMask group;
     BoundsGPU bounds;
-    SumVectorSqr3DOverWIf_Bounds(float4 *fs_, uint32_t groupTag_, BoundsGPU &bounds_) : fs(fs_), groupTag(groupTag_), bounds(bounds_) {}
+    SumVectorSqr3DOverWIf_Bounds(float4 *fs_, GroupMask group_, BoundsGPU &bounds_) : fs(fs_), group(group_), bounds(bounds_) {}
     inline __host__ __device__ float process (float4 &velocity ) {
         return lengthSqrOverW(velocity);
     }
@@ -19,7 +19,7 @@ public:
     inline __host__ __device__ bool willProcess(float4 *src, int idx) {
         float3 pos = make_float3(src[idx]);
         uint32_t atomGroupTag = * (uint32_t *) &(fs[idx].w);
-        return (atomGroupTag & groupTag) && bounds.inBounds(pos);
+        return group.contains(atomGroupTag, idx) && bounds.inBounds(pos);
     }
 };
 
@@ -35,6 +35,7 @@ FixNVTRescale::FixNVTRescale(SHARED(State) state_, string handle_, string groupH
       curIdx(0), tempComputer(state, "scalar")
 {
     isThermostat = true;
+    supportsExtendedGroups = true;
 
 }
 
@@ -43,6 +44,7 @@ FixNVTRescale::FixNVTRescale(SHARED(State) state_, string handle_, string groupH
       curIdx(0), tempComputer(state, "scalar")
 {
     isThermostat = true;
+    supportsExtendedGroups = true;
 
 
 }
@@ -52,6 +54,7 @@ FixNVTRescale::FixNVTRescale(SHARED(State) state_, string handle_, string groupH
       curIdx(0), tempComputer(state, "scalar")
 {
     isThermostat = true;
+    supportsExtendedGroups = true;
 
 
 }
@@ -62,17 +65,18 @@ FixNVTRescale::FixNVTRescale(SHARED(State) state_, string handle_, string groupH
 bool FixNVTRescale::prepareFinal() {
     turnBeginRun = state->runInit;
     turnFinishRun = state->runInit + state->runningFor;
+    sampleEvery = applyEvery;
     tempComputer = MD_ENGINE::DataComputerTemperature(state,"scalar");
     tempComputer.prepareForRun();
     prepared = true;
     return prepared;
 }
 
-void __global__ rescale(int nAtoms, uint groupTag, float4 *vs, float4 *fs, float tempSet, float tempCur) {
+void __global__ rescale(int nAtoms, GroupMask group, float4 *vs, float4 *fs, float tempSet, float tempCur) {
     int idx = GETIDX();
     if (tempSet > 0 and idx < nAtoms) {
         uint groupTagAtom = ((uint *) (fs+idx))[3];
-        if (groupTag & groupTagAtom) {
+        if (group.contains(groupTagAtom, idx)) {
             float4 vel = vs[idx];
             float w = vel.w;
             vel *= sqrtf(tempSet / tempCur);
@@ -98,7 +102,8 @@ bool FixNVTRescale::stepFinal() {
 
     cudaDeviceSynchronize();
     tempComputer.computeScalar_CPU();
-    rescale<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, groupTag, gpd.vs(activeIdx), gpd.fs(activeIdx), temp, tempComputer.tempScalar);
+    rescale<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, state->groupMask(groupTag), gpd.vs(activeIdx), gpd.fs(activeIdx), temp, tempComputer.tempScalar);
+    state->dataManager.reductions.invalidate();
 
     return true;
 }
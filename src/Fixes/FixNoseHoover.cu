@@ -24,12 +24,12 @@ std::string NoseHooverType = "NoseHoover";
 // CUDA function to calculate the total kinetic energy
 
 // CUDA function to rescale particle velocities
-__global__ void rescale_cu(int nAtoms, uint groupTag, float4 *vs, float4 *fs, float3 scale)
+__global__ void rescale_cu(int nAtoms, GroupMask group, float4 *vs, float4 *fs, float3 scale)
 {
     int idx = GETIDX();
     if (idx < nAtoms) {
         uint groupTagAtom = ((uint *) (fs+idx))[3];
-        if (groupTag & groupTagAtom) {
+        if (group.contains(groupTagAtom, idx)) {
             float4 vel = vs[idx];
             vel.x *= scale.x;
             vel.y *= scale.y;
@@ -52,14 +52,14 @@ __global__ void rescale_no_tags_cu(int nAtoms, float4 *vs, float3 scale)
 }
 
 
-__global__ void barostat_vel_cu(int nAtoms,uint groupTag, float4 *vs,
+__global__ void barostat_vel_cu(int nAtoms, GroupMask group, float4 *vs,
                                         float4 *fs, float3 addScale,
                                         float3 multScale, float dtf) {
 
     int idx = GETIDX();
     if (idx < nAtoms) {
         uint groupTagAtom = ((uint *) (fs+idx))[3];
-        if (groupTag & groupTagAtom) {
+        if (group.contains(groupTagAtom, idx)) {
             float4 vel = vs[idx];
             float invmass = vel.w;
             float4 force = fs[idx];
@@ -143,6 +143,7 @@ FixNoseHoover::FixNoseHoover(boost::shared_ptr<State> state_, std::string handle
 
     // this is a thermostat (if we are barostatting, we are also thermostatting)
     isThermostat = true;
+    supportsExtendedGroups = true;
 
     // denote whether or not this is the first time prepareForRun was called
     // --- need this, because we need to initialize this with proper virials
@@ -261,6 +262,11 @@ bool FixNoseHoover::prepareFinal()
     tempInterpolator.turnFinishRun = state->runInit + state->runningFor;
 
     tempComputer.prepareForRun();
+    // the kinetic sums, and virials if barostatting, are then taken in one sweep each turn
+    tempComputer.requestReductions(groupTag);
+    if (barostatting) {
+        pressComputer.requestReductions(groupTag);
+    }
     
     calculateKineticEnergy();
     
@@ -987,13 +993,14 @@ void FixNoseHoover::scaleVelocitiesBarostat(bool preNVE_X) {
                                                  dtf);
     } else {
         barostat_vel_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms,
-                                                 groupTag,
+                                                 state->groupMask(groupTag),
                                                  state->gpd.vs.getDevData(),
                                                  state->gpd.fs.getDevData(),
                                                  velScaleAdditive,
                                                  velScaleMultiplicative,
                                                  dtf);
     }
+    state->dataManager.reductions.invalidate();
 
 }
 
@@ -1069,11 +1076,12 @@ void FixNoseHoover::rescale()
                                                  scale);
     } else {
         rescale_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms,
-                                                 groupTag,
+                                                 state->groupMask(groupTag),
                                                  state->gpd.vs.getDevData(),
                                                  state->gpd.fs.getDevData(),
                                                  scale);
     }
+    state->dataManager.reductions.invalidate();
 
     scale = make_float3(1.0f, 1.0f, 1.0f);
 }
@@ -1,6 +1,7 @@
 #include "FixPair.h"
 #include "GPUArrayGlobal.h"
 #include "State.h"
+#include "EvaluatorWrapper.h"
 
 #include <cmath>
 #include "xml_func.h"
@@ -93,6 +94,23 @@ void FixPair::acceptChargePairCalc(Fix *chargeFix) {
     //setEvalWrapper(); done in integrator after prepareForRun is done
 
 }
+bool FixPair::singlePointEngGroupMatrix(float *pairMatrix, float *chargeMatrix, float *,
+                                        const int *groupSlots, int nGroups) {
+    if (not evalWrap) {
+        return false;
+    }
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    int numTypes = state->atomParams.numTypes;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    evalWrap->energyGroupMatrix(nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.ids(activeIdx), neighborCounts, grid.neighborlist.data(), grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, paramsCoalesced.data(), numTypes, state->boundsGPU, neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), chargeRCut, pairMatrix, chargeMatrix, groupSlots, nGroups, state->devManager.prop.sharedMemPerBlock, nThreadPerBlock(), nThreadPerAtom());
+    return true;
+}
+
 void FixPair::ensureParamSize(std::vector<float> &array)
 {
     int desiredSize = state->atomParams.numTypes;
@@ -107,6 +125,21 @@ void FixPair::ensureParamSize(std::vector<float> &array)
     }
 }
 
+std::vector<float> FixPair::rCutsByType(std::string handle) {
+    std::vector<float> cuts = *paramMap[handle];
+    int numTypes = state->atomParams.numTypes;
+    ensureParamSize(cuts);
+    std::function<float ()> fillDiag = [this] () {
+        return (float) state->rCut;
+    };
+    std::function<float (float, float)> fillOffDiag = [] (float a, float b) {
+        return (float) std::fmax(a, b);
+    };
+    SquareVector::populateDiagonal<float>(&cuts, numTypes, fillDiag);
+    SquareVector::populate<float>(&cuts, numTypes, fillOffDiag);
+    return cuts;
+}
+
 void FixPair::ensureOrderGivenForAllParams() {
     for (auto it=paramMap.begin(); it!=paramMap.end(); it++) {
         std::string handle = it->first;
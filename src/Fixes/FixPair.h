@@ -37,6 +37,14 @@ public:
             // Empty constructor
         };
 
+    //! Pair and charge energies between groups, through the evaluator set by setEvalWrapper
+    /*!
+     * Returns false for fixes with their own energy kernels and no evaluator,
+     * such as FixLJCutSoftCore.
+     */
+    bool singlePointEngGroupMatrix(float *pairMatrix, float *chargeMatrix, float *bondedMatrix,
+                                   const int *groupSlots, int nGroups);
+
 protected:
     //! Initialize the parameters
     /*!
@@ -93,6 +101,15 @@ protected:
      */
     void ensureParamSize(std::vector<float> &array);
 
+    //! Cutoffs of all pairs of types, filled as the LJ fixes fill them
+    /*!
+     * \param handle Handle of the cutoff parameter
+     *
+     * Unset diagonal elements are State::rCut, and unset off-diagonal
+     * elements are the larger of the two diagonal elements.
+     */
+    std::vector<float> rCutsByType(std::string handle);
+
     //! Read pair parameters from XML node (Not yet implemented)
     /*!
      * \param xmlNode Node to read the parameters from
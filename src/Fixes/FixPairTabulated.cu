@@ -0,0 +1,228 @@
+#include "FixPairTabulated.h"
+
+#include "BoundsGPU.h"
+#include "GridGPU.h"
+#include "list_macro.h"
+#include "State.h"
+#include "cutils_func.h"
+#include "PairEvaluatorTabulated.h"
+#include "EvaluatorWrapper.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+const std::string PairTabulatedType = "PairTabulated";
+
+FixPairTabulated::FixPairTabulated(boost::shared_ptr<State> state_, std::string handle_)
+    : FixPair(state_, handle_, "all", PairTabulatedType, true, false, 1, GEOMETRICTYPE),
+    rCutHandle("rCut")
+{
+    initializeParameters(rCutHandle, rCuts);
+    //table placement is worked out in prepareForRun, not set by the user
+    paramOrder = {rCutHandle, "rMin", "invDr", "segmentOffset", "nSegments"};
+    readFromRestart();
+    readTablesFromRestart();
+    canAcceptChargePairCalc = true;
+    setEvalWrapper();
+}
+
+void FixPairTabulated::compute(int virialMode) {
+    int nAtoms       = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    int numTypes = state->atomParams.numTypes;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    evalWrap->compute(nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx),
+                      neighborCounts, grid.neighborlist.data(), grid.perBlockArray.d_data.data(),
+                      state->devManager.prop.warpSize, paramsCoalesced.data(), numTypes, state->boundsGPU,
+                      neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.virials.d_data.data(), gpd.qs(activeIdx), chargeRCut, virialMode, nThreadPerBlock(), nThreadPerAtom());
+}
+
+void FixPairTabulated::singlePointEng(float *perParticleEng) {
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    int numTypes = state->atomParams.numTypes;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    evalWrap->energy(nAtoms, nPerRingPoly, gpd.xs(activeIdx), perParticleEng, neighborCounts, grid.neighborlist.data(), grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, paramsCoalesced.data(), numTypes, state->boundsGPU, neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), chargeRCut, nThreadPerBlock(), nThreadPerAtom());
+}
+
+void FixPairTabulated::singlePointEngGroupGroup(float *perParticleEng, uint32_t tagA, uint32_t tagB) {
+    int nAtoms = state->atoms.size();
+    int nPerRingPoly = state->nPerRingPoly;
+    int numTypes = state->atomParams.numTypes;
+    GPUData &gpd = state->gpd;
+    GridGPU &grid = state->gridGPU;
+    int activeIdx = gpd.activeIdx();
+    uint16_t *neighborCounts = grid.perAtomArray.d_data.data();
+    float *neighborCoefs = state->specialNeighborCoefs;
+    evalWrap->energyGroupGroup(nAtoms, nPerRingPoly, gpd.xs(activeIdx), gpd.fs(activeIdx), perParticleEng, neighborCounts, grid.neighborlist.data(), grid.perBlockArray.d_data.data(), state->devManager.prop.warpSize, paramsCoalesced.data(), numTypes, state->boundsGPU, neighborCoefs[0], neighborCoefs[1], neighborCoefs[2], gpd.qs(activeIdx), chargeRCut, tagA, tagB, nThreadPerBlock(), nThreadPerAtom());
+}
+
+void FixPairTabulated::setEvalWrapper() {
+    EvaluatorTabulated eval;
+    eval.coefs = coefs.data();
+    if (evalWrapperMode == "offload") {
+        evalWrap = pickEvaluator<EvaluatorTabulated, 5, true>(eval, chargeCalcFix);
+    } else if (evalWrapperMode == "self") {
+        evalWrap = pickEvaluator<EvaluatorTabulated, 5, true>(eval, nullptr);
+    }
+}
+
+std::pair<int, int> FixPairTabulated::typePair(std::string handleA, std::string handleB) {
+    int i = state->atomParams.typeFromHandle(handleA);
+    int j = state->atomParams.typeFromHandle(handleB);
+    mdAssert(i != -1 and j != -1, "Invalid types %s and %s for tabulated pair fix", handleA.c_str(), handleB.c_str());
+    return i < j ? std::make_pair(i, j) : std::make_pair(j, i);
+}
+
+float FixPairTabulated::cutoffFor(int i, int j) {
+    auto it = tables.find(i < j ? std::make_pair(i, j) : std::make_pair(j, i));
+    if (it == tables.end()) {
+        return 0;
+    }
+    float cut = it->second.xMax();
+    int numTypes = state->atomParams.numTypes;
+    if (rCuts.size() == numTypes*numTypes) {
+        float set = squareVectorItem<float>(rCuts.data(), numTypes, i, j);
+        if (set != DEFAULT_FILL and set < cut) {
+            cut = set;
+        }
+    }
+    return cut;
+}
+
+void FixPairTabulated::setTable(std::string handleA, std::string handleB, double rMin, double rMax,
+                                py::object energies, py::object forces) {
+    tables[typePair(handleA, handleB)] = TabulatedSpline::tableFromPython(rMin, rMax, energies, forces);
+    prepared = false;
+}
+
+void FixPairTabulated::readTable(std::string handleA, std::string handleB, std::string fn) {
+    tables[typePair(handleA, handleB)] = TabulatedSpline::tableFromFile(fn);
+    prepared = false;
+}
+
+py::tuple FixPairTabulated::evaluate(std::string handleA, std::string handleB, double r) {
+    auto it = tables.find(typePair(handleA, handleB));
+    mdAssert(it != tables.end(), "No table for types %s and %s", handleA.c_str(), handleB.c_str());
+    std::pair<double, double> ef = it->second.evaluate(r);
+    return py::make_tuple(ef.first, ef.second);
+}
+
+bool FixPairTabulated::prepareForRun() {
+    int numTypes = state->atomParams.numTypes;
+    ensureParamSize(rCuts);
+    std::vector<float> rCutSqrs(numTypes*numTypes);
+    std::vector<float> rMins(numTypes*numTypes);
+    std::vector<float> invDrs(numTypes*numTypes);
+    std::vector<float> offsets(numTypes*numTypes);
+    std::vector<float> nSegments(numTypes*numTypes);
+    std::vector<float4> allCoefs;
+    mdAssert(tables.size(), "Tabulated pair fix %s has no tables", handle.c_str());
+    for (int i=0; i<numTypes; i++) {
+        for (int j=i; j<numTypes; j++) {
+            auto it = tables.find(std::make_pair(i, j));
+            if (it == tables.end()) {
+                //rCut^2 of zero, so the pair is never evaluated
+                continue;
+            }
+            TabulatedSpline::Table &table = it->second;
+            std::vector<float4> tableCoefs = table.coefficients();
+            float cut = cutoffFor(i, j);
+            //segment offsets are passed as floats, exact up to 2^24
+            mdAssert(allCoefs.size() + tableCoefs.size() < (1 << 24), "Tables of fix %s are too large", handle.c_str());
+            for (int pair=0; pair<2; pair++) {
+                int a = pair ? j : i;
+                int b = pair ? i : j;
+                squareVectorRef<float>(rCutSqrs.data(), numTypes, a, b) = cut*cut;
+                squareVectorRef<float>(rMins.data(), numTypes, a, b) = table.x0;
+                squareVectorRef<float>(invDrs.data(), numTypes, a, b) = 1 / table.dx;
+                squareVectorRef<float>(offsets.data(), numTypes, a, b) = allCoefs.size();
+                squareVectorRef<float>(nSegments.data(), numTypes, a, b) = tableCoefs.size();
+            }
+            allCoefs.insert(allCoefs.end(), tableCoefs.begin(), tableCoefs.end());
+        }
+    }
+    paramMapProcessed[rCutHandle] = rCutSqrs;
+    paramMapProcessed["rMin"] = rMins;
+    paramMapProcessed["invDr"] = invDrs;
+    paramMapProcessed["segmentOffset"] = offsets;
+    paramMapProcessed["nSegments"] = nSegments;
+    coefs = GPUArrayDeviceGlobal<float4>(allCoefs.size());
+    coefs.set(allCoefs.data());
+
+    sendAllToDevice();
+    setEvalWrapper();
+    prepared = true;
+    return prepared;
+}
+
+std::string FixPairTabulated::restartChunk(std::string format) {
+    std::stringstream ss;
+    ss << restartChunkPairParams(format);
+    std::vector<std::string> &handles = state->atomParams.handles;
+    for (auto &entry : tables) {
+        std::string attributes = "handleA='" + handles[entry.first.first] +
+                                 "' handleB='" + handles[entry.first.second] + "'";
+        ss << entry.second.restartChunk(attributes);
+    }
+    return ss.str();
+}
+
+bool FixPairTabulated::readTablesFromRestart() {
+    pugi::xml_node restData = getRestartNode();
+    if (restData) {
+        for (auto node = restData.first_child(); node; node = node.next_sibling()) {
+            if (std::string(node.name()) == "table") {
+                std::string handleA = node.attribute("handleA").value();
+                std::string handleB = node.attribute("handleB").value();
+                tables[typePair(handleA, handleB)] = TabulatedSpline::tableFromRestart(node);
+            }
+        }
+    }
+    return true;
+}
+
+bool FixPairTabulated::postRun() {
+    return true;
+}
+
+void FixPairTabulated::addSpecies(std::string handle) {
+    initializeParameters(rCutHandle, rCuts);
+}
+
+std::vector<float> FixPairTabulated::getRCuts() {
+    std::vector<float> res;
+    int numTypes = state->atomParams.numTypes;
+    for (int i=0; i<numTypes; i++) {
+        for (int j=0; j<numTypes; j++) {
+            res.push_back(cutoffFor(i, j));
+        }
+    }
+    return res;
+}
+
+std::vector<float> FixPairTabulated::getRCutsByType() {
+    return getRCuts();
+}
+
+void export_FixPairTabulated() {
+    py::class_<FixPairTabulated, boost::shared_ptr<FixPairTabulated>, py::bases<FixPair>, boost::noncopyable > (
+        "FixPairTabulated",
+        py::init<boost::shared_ptr<State>, std::string> (py::args("state", "handle"))
+    )
+    .def("setTable", &FixPairTabulated::setTable,
+         (py::arg("handleA"), py::arg("handleB"), py::arg("rMin"), py::arg("rMax"),
+          py::arg("energies"), py::arg("forces")=py::list()))
+    .def("readTable", &FixPairTabulated::readTable,
+         (py::arg("handleA"), py::arg("handleB"), py::arg("fn")))
+    .def("evaluate", &FixPairTabulated::evaluate,
+         (py::arg("handleA"), py::arg("handleB"), py::arg("r")))
+      ;
+}
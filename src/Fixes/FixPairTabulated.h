@@ -0,0 +1,97 @@
+#pragma once
+#ifndef FIXPAIRTABULATED_H
+#define FIXPAIRTABULATED_H
+
+#include <map>
+#include <utility>
+
+#include "FixPair.h"
+#include "TabulatedSpline.h"
+#include "xml_func.h"
+
+class EvaluatorWrapper;
+void export_FixPairTabulated();
+
+//! Fix for pair interactions given as tables of energy against distance
+/*!
+ * Each pair of types interacting through this fix is given a table of energies,
+ * and optionally forces, at uniformly spaced distances, given from python
+ * sequences or read from a file.  Energies and forces between the points come
+ * from one cubic spline per pair (see TabulatedSpline), so any isotropic pair
+ * potential, such as those from iterative Boltzmann inversion or force
+ * matching, or an expensive analytic form, costs one table lookup.
+ *
+ * The cutoff of a pair is the end of its table, or the rCut parameter if that
+ * is set and shorter.  Tables are not mixed, so pairs without their own table
+ * have a cutoff of zero and contribute nothing.  Closer than the first table point, the energy continues
+ * linearly with the force at that point.
+ */
+
+extern const std::string PairTabulatedType;
+class FixPairTabulated : public FixPair {
+    public:
+        //! Constructor
+        FixPairTabulated(SHARED(State), std::string handle);
+
+        //! Compute forces
+        void compute(int);
+
+        //! Compute single point energy
+        void singlePointEng(float *);
+        void singlePointEngGroupGroup(float *, uint32_t, uint32_t);
+
+        //! Build the spline coefficients and send them to the device
+        bool prepareForRun();
+
+        //! Run after simulation
+        bool postRun();
+
+        //! Create restart string, including the tables
+        std::string restartChunk(std::string format);
+
+        //! Add new type of atoms
+        void addSpecies(std::string handle);
+
+        //! Return list of cutoff values
+        std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types, as getRCuts
+        std::vector<float> getRCutsByType();
+
+        //! Set the table of a pair of types
+        /*!
+         * \param handleA First atom type
+         * \param handleB Second atom type
+         * \param rMin Distance of the first point
+         * \param rMax Distance of the last point
+         * \param energies Energies at uniformly spaced points from rMin to rMax
+         * \param forces -dE/dr at the same points.  If empty, the natural
+         *               spline through the energies is used
+         */
+        void setTable(std::string handleA, std::string handleB, double rMin, double rMax,
+                      boost::python::object energies, boost::python::object forces);
+
+        //! Read the table of a pair of types from a file of lines "r energy [force]"
+        void readTable(std::string handleA, std::string handleB, std::string fn);
+
+        //! Energy and force of a pair at distance r, evaluated on the host
+        boost::python::tuple evaluate(std::string handleA, std::string handleB, double r);
+
+    public:
+        void setEvalWrapper();
+
+        const std::string rCutHandle; //!< Handle for parameter rCut
+        std::vector<float> rCuts; //!< vector storing cutoff distance values
+
+    private:
+        //! Tables by pair of type indices, lower index first
+        std::map<std::pair<int, int>, TabulatedSpline::Table> tables;
+        //! Segments of all tables, one after another
+        GPUArrayDeviceGlobal<float4> coefs;
+
+        std::pair<int, int> typePair(std::string handleA, std::string handleB);
+        //! Cutoff of a pair of type indices, or 0 if it has no table
+        float cutoffFor(int i, int j);
+        bool readTablesFromRestart();
+};
+
+#endif
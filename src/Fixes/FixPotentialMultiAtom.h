@@ -25,6 +25,7 @@ class FixPotentialMultiAtom : public Fix, public TypedItemHolder {
         FixPotentialMultiAtom (SHARED(State) state_, std::string handle_, std::string type_, bool forceSingle_) : Fix(state_, handle_, "None", type_, forceSingle_, false, false, 1), forcersGPU(1), forcerIdxs(1), pyListInterface(&forcers, &pyForcers)
     {
         maxForcersPerBlock = 0;
+        preparedChecksum = 0;
     }
         //TO DO - make copies of the forcer, forcer typesbefore doing all the prepare for run modifications
         std::vector<CPUVariant> forcers;
@@ -37,6 +38,16 @@ class FixPotentialMultiAtom : public Fix, public TypedItemHolder {
         int sharedMemSizeForParams;
         bool usingSharedMemForParams;
         int maxForcersPerBlock;
+        uint64_t preparedChecksum; //!< Hash of forcers and types last copied to the GPU
+        GroupMatrix groupMatrix; //!< Set only while singlePointEngGroupMatrix runs
+
+        //! Splits each forcer's energy over the groups of its N atoms
+        bool singlePointEngGroupMatrix(float *, float *, float *bondedMatrix, const int *groupSlots, int nGroups) {
+            groupMatrix = GroupMatrix(bondedMatrix, groupSlots, nGroups);
+            singlePointEng(nullptr);
+            groupMatrix = GroupMatrix();
+            return true;
+        }
         virtual bool prepareForRun() {
             int maxExistingType = -1;
             std::unordered_map<ForcerTypeHolder, int> reverseMap;
@@ -68,7 +79,24 @@ class FixPotentialMultiAtom : public Fix, public TypedItemHolder {
                     }
                 } 
             }
-            maxForcersPerBlock = copyMultiAtomToGPU<CPUVariant, CPUBase, CPUMember, GPUMember, ForcerTypeHolder, N>(state->atoms.size(), forcers, state->idToIdx, &forcersGPU, &forcerIdxs, &forcerTypes, &parameters, maxExistingType);
+            // forcers are laid out by host atom index, so the arrays from the
+            // last run can be kept if neither the forcers nor the atoms changed
+            uint64_t checksum = state->atomIdChecksum;
+            for (CPUVariant &forcerVar : forcers) {
+                CPUMember &forcer = boost::get<CPUMember>(forcerVar);
+                checksum = hashBytes(checksum, forcer.ids.data(), sizeof(forcer.ids));
+                checksum = hashBytes(checksum, &forcer.type, sizeof(forcer.type));
+            }
+            std::hash<ForcerTypeHolder> hashType;
+            for (int i=0; i<=maxExistingType; i++) {
+                auto it = forcerTypes.find(i);
+                size_t typeHash = it == forcerTypes.end() ? 0 : hashType(it->second);
+                checksum = hashBytes(checksum, &typeHash, sizeof(typeHash));
+            }
+            if (checksum != preparedChecksum) {
+                maxForcersPerBlock = copyMultiAtomToGPU<CPUVariant, CPUBase, CPUMember, GPUMember, ForcerTypeHolder, N>(state->atoms.size(), forcers, state->idToIdx, &forcersGPU, &forcerIdxs, &forcerTypes, &parameters, maxExistingType);
+                preparedChecksum = checksum;
+            }
 
 
             setSharedMemForParams(); 
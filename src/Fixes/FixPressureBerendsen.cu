@@ -11,9 +11,16 @@ FixPressureBerendsen::FixPressureBerendsen(boost::shared_ptr<State> state_, std:
     requiresPerAtomVirials=true;
 };
 
+FixPressureBerendsen::FixPressureBerendsen(boost::shared_ptr<State> state_, std::string handle_, py::object pressureFunc_, double period_, int applyEvery_) : Interpolator(pressureFunc_), Fix(state_, handle_, "all", BerendsenType, false, true, false, applyEvery_), pressureComputer(state, "scalar"), period(period_) {
+    bulkModulus = 10; //lammps
+    maxDilation = 0.00001;
+    requiresPerAtomVirials=true;
+};
+
 bool FixPressureBerendsen::prepareFinal() {
     turnBeginRun = state->runInit;
     turnFinishRun = state->runInit + state->runningFor;
+    sampleEvery = applyEvery;
     pressureComputer.prepareForRun(); 
 
     // get rigid bodies, if any, in simulation
@@ -56,10 +63,15 @@ void FixPressureBerendsen::setParameters(double maxDilation_) {
 void export_FixPressureBerendsen() {
     py::class_<FixPressureBerendsen, boost::shared_ptr<FixPressureBerendsen>, py::bases<Fix> > (
         "FixPressureBerendsen", 
-        py::init<boost::shared_ptr<State>, std::string, double, double, int>(
-            py::args("state", "handle", "pressure", "period", "applyEvery")
+        py::init<boost::shared_ptr<State>, std::string, py::object, double, int>(
+            py::args("state", "handle", "pressureFunc", "period", "applyEvery")
             )
     )
+    //constant pressure constructor added last so it is checked before the py::object one
+    .def(py::init<boost::shared_ptr<State>, std::string, double, double, int>(
+            py::args("state", "handle", "pressure", "period", "applyEvery")
+            )
+        )
     .def("setParameters", &FixPressureBerendsen::setParameters, (py::arg("maxDilation")=-1))
     ;
 }
@@ -10,6 +10,7 @@ namespace MD_ENGINE {
     class FixPressureBerendsen : public Interpolator, public Fix {
     public: 
         FixPressureBerendsen(boost::shared_ptr<State> state_, std::string handle_, double pressure_, double period_, int applyEvery_);
+        FixPressureBerendsen(boost::shared_ptr<State> state_, std::string handle_, boost::python::object pressureFunc_, double period_, int applyEvery_);
 
         //bool prepareForRun();
         bool prepareFinal();
@@ -212,7 +212,7 @@ __global__ void rigid_scaleSystem_cu(int4* waterIds, float4* xs, int* idToIdxs,
 template <class DATA, bool TIP4P>
 __global__ void rigid_scaleSystemGroup_cu(int4* waterIds, float4* xs, int* idToIdxs,
                                           float3 lo, float3 rectLen, BoundsGPU bounds, float3 scaleBy,
-                                          DATA fixRigidData, int nMolecules, uint32_t groupTag,
+                                          DATA fixRigidData, int nMolecules, GroupMask group,
                                           float4* fs) {
 
     int idx = GETIDX();
@@ -221,7 +221,7 @@ __global__ void rigid_scaleSystemGroup_cu(int4* waterIds, float4* xs, int* idToI
         int4 atomsFromMolecule = waterIds[idx];
         int idxO = idToIdxs[atomsFromMolecule.x];
         uint32_t tag = * (uint32_t *) &(fs[idxO].w);
-        if (tag & groupTag) {
+        if (group.contains(tag, idxO)) {
             // compute the COM; 
             // perform the displacement;
             // compute the difference in the positions
@@ -1689,7 +1689,7 @@ void FixRigid::scaleRigidBodies(float3 scaleBy, uint32_t groupTag) {
                                                                   scaleBy,
                                                                   fixRigidData,
                                                                   nMolecules, 
-                                                                  groupTag,
+                                                                  state->groupMask(groupTag),
                                                                   gpd.fs(activeIdx)
                                                                   );
         } else {
@@ -1702,7 +1702,7 @@ void FixRigid::scaleRigidBodies(float3 scaleBy, uint32_t groupTag) {
                                                                   scaleBy,
                                                                   fixRigidData,
                                                                   nMolecules, 
-                                                                  groupTag,
+                                                                  state->groupMask(groupTag),
                                                                   gpd.fs(activeIdx)
                                                                   );
         }
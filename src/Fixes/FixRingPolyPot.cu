@@ -14,13 +14,13 @@ namespace py = boost::python;
 FixRingPolyPot::FixRingPolyPot(SHARED(State) state_, std::string handle_, std::string groupHandle_)
   : Fix(state_, handle_, groupHandle_, RingPolyPotType, true, false,false, 1 ) { };
 
-void __global__ compute_RP_energy_cu(int nAtoms, int nPerRingPoly, float omegaP, float4 *xs, float4 *vs, float4 *fs, BoundsGPU bounds, float *perParticleEng, uint groupTag, float mvv_to_eng ) {
+void __global__ compute_RP_energy_cu(int nAtoms, int nPerRingPoly, float omegaP, float4 *xs, float4 *vs, float4 *fs, BoundsGPU bounds, float *perParticleEng, GroupMask group, float mvv_to_eng ) {
 
     int idx = GETIDX();
     if (idx < nAtoms) {
         uint groupTagAtom = * (uint *) &fs[idx].w;
         // Check if atom is part of the group
-        if (groupTagAtom & groupTag) {
+        if (group.contains(groupTagAtom, idx)) {
             float mi    = (float) 1.0 / vs[idx].w;
             int beadIdx = idx% nPerRingPoly; // time slice
             int beadIdp = (beadIdx + 1) % nPerRingPoly;
@@ -56,7 +56,7 @@ void FixRingPolyPot::singlePointEng(float *perParticleEng) {
         }
         float omegaP = (float) state->units.boltz * temp / state->units.hbar  ;
         compute_RP_energy_cu<<<NBLOCK(nAtoms), PERBLOCK>>>(nAtoms, nPerRingPoly,omegaP,
-                gpd.xs(activeIdx),gpd.vs(activeIdx),gpd.fs(activeIdx),state->boundsGPU,perParticleEng, groupTag,state->units.mvv_to_eng);
+                gpd.xs(activeIdx),gpd.vs(activeIdx),gpd.fs(activeIdx),state->boundsGPU,perParticleEng, state->groupMask(groupTag),state->units.mvv_to_eng);
 };
 
 // export function
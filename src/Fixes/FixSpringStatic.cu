@@ -14,6 +14,7 @@ FixSpringStatic::FixSpringStatic(boost::shared_ptr<State> state_,
   : Fix(state_, handle_, groupHandle_, springStaticType, true, false, false, 1),
     k(k_), tetherFunc(tetherFunc_), multiplier(multiplier_)
 {
+    supportsExtendedGroups = true;
     updateTethers();
     readFromRestart();
     mdAssert(k!=-1, "spring k value not assigned");
@@ -24,14 +25,14 @@ void FixSpringStatic::updateTethers() {
     PyObject *funcRaw = tetherFunc.ptr();
     if (PyCallable_Check(funcRaw)) {
         for (Atom &a : state->atoms) {
-            if (a.groupTag & groupTag) {
+            if (state->atomInGroup(a, groupTag)) {
                 Vector res = boost::python::call<Vector>(funcRaw, a);
                 tethers_loc.push_back(make_float4(res[0], res[1], res[2], *(float *)&a.id));
             }
         }
     } else {
         for (Atom &a : state->atoms) {
-            if (a.groupTag & groupTag) {
+            if (state->atomInGroup(a, groupTag)) {
                 tethers_loc.push_back(make_float4(a.pos[0], a.pos[1], a.pos[2], *(float *)&a.id));
             }
         }
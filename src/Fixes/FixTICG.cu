@@ -114,6 +114,10 @@ std::vector<float> FixTICG::getRCuts() {
     return res;
 }
 
+std::vector<float> FixTICG::getRCutsByType() {
+    return rCutsByType(rCutHandle);
+}
+
 void export_FixTICG() {
     boost::python::class_<FixTICG,
                           boost::shared_ptr<FixTICG>,
@@ -60,6 +60,8 @@ class FixTICG : public FixPair {
 
         //! Return list of cutoff values
         std::vector<float> getRCuts();
+        //! Return the cutoff of each pair of types
+        std::vector<float> getRCutsByType();
 
     public:
         const std::string CHandle; //!< Handle for parameter C -stregth of potential
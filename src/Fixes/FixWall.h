@@ -27,7 +27,7 @@ public:
 		applyEvery_), origin(origin_), forceDir(forceDir_)
 
 		{
-		
+            supportsExtendedGroups = true;
         };
 
 	// all will have origin
@@ -32,11 +32,11 @@ void FixWallHarmonic::compute(int virialMode) {
 		// I think we just need the evaluator and whether or not to compute the virials - correct? we'll see..
 		// ^ referring to what to pass in as template specifiers
 		compute_wall_iso<EvaluatorWallHarmonic, true> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  groupTag, 
+                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  state->groupMask(groupTag), 
                     evaluator);
 	} else {
 		compute_wall_iso<EvaluatorWallHarmonic, false> <<<NBLOCK(n), PERBLOCK>>>(n, gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  groupTag,
+                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  state->groupMask(groupTag),
                     evaluator);
 	}
 };
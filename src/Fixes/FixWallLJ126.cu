@@ -29,10 +29,10 @@ void FixWallLJ126::compute(int virialMode) {
 	int n = state->atoms.size();
 	if (virialMode) {
 		compute_wall_iso<EvaluatorWallLJ126, true> <<<NBLOCK(n), PERBLOCK>>>(n,  gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  groupTag, evaluator);
+                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  state->groupMask(groupTag), evaluator);
 	} else {
 		compute_wall_iso<EvaluatorWallLJ126, false> <<<NBLOCK(n), PERBLOCK>>>(n, gpd.xs(activeIdx),
-                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  groupTag, evaluator);
+                    gpd.fs(activeIdx), origin.asFloat3(), forceDir.asFloat3(),  state->groupMask(groupTag), evaluator);
 	}
 };
 
@@ -2,15 +2,65 @@
 #ifndef GPUARRAY_H
 #define GPUARRAY_H
 
+#include "AllocationRegistry.h"
+
 //! Base class for a GPUArray
 class GPUArray {
     protected:
         //! Constructor
-        GPUArray() = default;
+        GPUArray() : trackedBytes(0) {}
+
+        //! Copies register the footprint of the array they copy
+        /*!
+         * The copy's own host vector is not constructed yet, so this is the
+         * source's last reported size; the copy corrects it the next time it
+         * transfers or changes size.
+         */
+        GPUArray(const GPUArray &other) : trackedBytes(0) {
+            trackHost(other.trackedBytes);
+        }
+        GPUArray &operator=(const GPUArray &other) {
+            if (this != &other) {
+                trackHost(other.trackedBytes);
+            }
+            return *this;
+        }
+
+        //! Moves take over the footprint, leaving the source untracked
+        GPUArray(GPUArray &&other) : trackedBytes(0) {
+            trackHost(other.trackedBytes);
+            other.trackHost(0);
+        }
+        GPUArray &operator=(GPUArray &&other) {
+            if (this != &other) {
+                trackHost(other.trackedBytes);
+                other.trackHost(0);
+            }
+            return *this;
+        }
+
+        //! Report the host mirror's current footprint to the AllocationRegistry
+        /*!
+         * Called on every transfer, so the registry, and its lock, is only
+         * touched when the footprint has changed since it was last reported.
+         */
+        void trackHost(size_t bytes) {
+            if (bytes != trackedBytes) {
+                trackedBytes = bytes;
+                AllocationRegistry::instance().hostResized(this, bytes);
+            }
+        }
 
     public:
         //! Destructor
-        virtual ~GPUArray(){};
+        virtual ~GPUArray() {
+            trackHost(0);
+        }
+
+        //! Host bytes last reported to the AllocationRegistry
+        size_t hostBytesTracked() const {
+            return trackedBytes;
+        }
 
         //! Send data from host to GPU device
         virtual void dataToDevice() = 0;
@@ -27,6 +77,9 @@ class GPUArray {
          * where T is the class used in the GPUArray.
          */
         virtual size_t size() const = 0;
+
+    private:
+        size_t trackedBytes; //!< Host bytes last reported to the registry
 };
 
 #endif
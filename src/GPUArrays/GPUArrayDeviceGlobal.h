@@ -6,6 +6,7 @@
 
 #include "globalDefs.h"
 #include "GPUArrayDevice.h"
+#include "AllocationRegistry.h"
 #include "Logging.h"
 
 //! Global function to set the device memory
@@ -49,6 +50,7 @@ public:
     GPUArrayDeviceGlobal(GPUArrayDeviceGlobal<T> &&other)
         : GPUArrayDevice(other.n)
     {
+        cap = other.cap;
         ptr = other.ptr;
         other.n = 0;
         other.cap = 0;
@@ -80,6 +82,7 @@ public:
     GPUArrayDeviceGlobal<T> &operator=(GPUArrayDeviceGlobal<T> &&other) {
         deallocate();
         n = other.n;
+        cap = other.cap;
         ptr = other.ptr;
         other.n = 0;
         other.cap = 0;
@@ -214,11 +217,11 @@ public:
 
 private:
     //! Allocate memory
-    void allocate() { CUCHECK(cudaMalloc(&ptr, n * sizeof(T))); cap = size(); }
+    void allocate() { CUCHECK(trackedCudaMalloc(&ptr, n * sizeof(T))); cap = size(); }
 
     //! Deallocate memory
     void deallocate() {
-        CUCHECK(cudaFree(ptr));
+        CUCHECK(trackedCudaFree(ptr));
         n = 0;
         cap = 0;
         ptr = nullptr;
@@ -6,6 +6,7 @@
 
 #include "globalDefs.h"
 #include "GPUArrayDevice.h"
+#include "AllocationRegistry.h"
 #include "Logging.h"
 
 void MEMSETFUNC(cudaSurfaceObject_t, void *, int, int);
@@ -272,6 +273,7 @@ private:
         size_t y = nY();
         CUCHECK(cudaMallocArray((cudaArray_t *)(&ptr), &channelDesc, x, y) );
         cap = x*y;
+        AllocationRegistry::instance().deviceAllocated(ptr, cap * sizeof(T));
         //assuming address gets set in blocking manner
         resDesc.res.array.array = data();
     }
@@ -287,7 +289,9 @@ private:
             surfObject = 0;
         }
         if (data() != nullptr) {
+            AllocationRegistry::instance().deviceFreed(ptr);
             CUCHECK(cudaFreeArray(data()));
+            ptr = nullptr;
         }
     }
 
@@ -32,7 +32,9 @@ public:
      * and the GPU.
      */
     explicit GPUArrayGlobal(int size_)
-        : h_data(std::vector<T>(size_,T())), d_data(GPUArrayDeviceGlobal<T>(size_)) {}
+        : h_data(std::vector<T>(size_,T())), d_data(GPUArrayDeviceGlobal<T>(size_)) {
+        trackHost(h_data.capacity() * sizeof(T));
+    }
 
     //! Copy from vector constructor
     /*!
@@ -43,6 +45,7 @@ public:
     explicit GPUArrayGlobal(std::vector<T> const &vals) {
         h_data = vals;
         d_data = GPUArrayDeviceGlobal<T>(h_data.size());
+        trackHost(h_data.capacity() * sizeof(T));
     }
 
     //! Move from vector constructor
@@ -53,6 +56,7 @@ public:
     {
         h_data = std::move(vals);
         d_data = GPUArrayDeviceGlobal<T>(h_data.size());
+        trackHost(h_data.capacity() * sizeof(T));
     }
 
     //! Copy assignment from vector
@@ -64,6 +68,7 @@ public:
     {
         d_data.resize(vals.size());
         h_data = vals;
+        trackHost(h_data.capacity() * sizeof(T));
 
         return *this;
     }
@@ -77,6 +82,7 @@ public:
     {
         d_data.resize(vals.size());
         h_data = std::move(vals);
+        trackHost(h_data.capacity() * sizeof(T));
 
         return *this;
     }
@@ -89,16 +95,19 @@ public:
 
     //! Send data from CPU to GPU
     void dataToDevice() {
+        trackHost(h_data.capacity() * sizeof(T));
         d_data.set(h_data.data());
     }
     bool set(std::vector<T> &other) {
     
         if (other.size() < size()) {
             h_data = other;
+            trackHost(h_data.capacity() * sizeof(T));
             return true;
         } else {
             d_data = GPUArrayDeviceGlobal<T>(other.size());
             h_data = other;
+            trackHost(h_data.capacity() * sizeof(T));
         }
         return false;
     }
@@ -113,6 +122,7 @@ public:
         //eeh, want to deal with the case where data originates on the device,
         //which is a real case, so removed checked on whether data is on device
         //or not
+        trackHost(h_data.capacity() * sizeof(T));
         d_data.get(h_data.data());
     }
 
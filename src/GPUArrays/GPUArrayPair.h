@@ -35,6 +35,7 @@ private:
      */
     void setHost(std::vector<T> &vals) {
         h_data = vals;
+        trackHost(h_data.capacity() * sizeof(T));
     }
 public:
     unsigned int activeIdx; //!< Index of active GPUArrayDeviceGlobal
@@ -131,6 +132,7 @@ public:
 
     //! Copy data from CPU memory to active GPU memory
     void dataToDevice() {
+        trackHost(h_data.capacity() * sizeof(T));
         CUCHECK(cudaMemcpy(d_data[activeIdx].data(), h_data.data(), size()*sizeof(T), cudaMemcpyHostToDevice ));
 
     }
@@ -145,6 +147,7 @@ public:
      * \param idx Index specifying which GPU memory to access
      */
     void dataToHost(int idx) {
+        trackHost(h_data.capacity() * sizeof(T));
         CUCHECK(cudaMemcpy(h_data.data(), d_data[idx].data(), size()*sizeof(T), cudaMemcpyDeviceToHost));
     }
 
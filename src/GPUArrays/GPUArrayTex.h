@@ -59,16 +59,19 @@ class GPUArrayTex : public GPUArray {
             d_data.resize(other.size());
             h_data = other;
             h_data.reserve(d_data.capacity());
+            trackHost(h_data.capacity() * sizeof(T));
             return true;
         }
 
         //! Send data from CPU to GPU
         void dataToDevice() {
+            trackHost(h_data.capacity() * sizeof(T));
             d_data.set(h_data.data());
         }
 
         //! Send data from GPU to CPU
         void dataToHost() {
+            trackHost(h_data.capacity() * sizeof(T));
             d_data.get(h_data.data());
         }
 
@@ -24,11 +24,6 @@ public:
     GPUArrayGlobal<int> idToIdxs;
     GPUArrayGlobal<Virial> virials;
 
-    GPUArrayGlobal<float4> xsBuffer;
-    GPUArrayGlobal<float4> vsBuffer;
-    GPUArrayGlobal<float4> fsBuffer;
-    GPUArrayGlobal<uint> idsBuffer;
-
     /* for transfer between GPUs */
     std::map<int, GPUArrayGlobal<float4>> neighborValBuffers;
     std::map<int, GPUArrayGlobal<uint>> neighborIdsBuffers;
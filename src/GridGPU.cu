@@ -2,6 +2,7 @@
 
 #include "State.h"
 #include "helpers.h"
+#include "AllocationRegistry.h"
 #include "Bond.h"
 #include "list_macro.h"
 #include "Mod.h"
@@ -29,7 +30,7 @@ void GridGPU::initArrays() {
     xsLastBuild = GPUArrayDeviceGlobal<float4>(state->atoms.size());
 
     // in prepare for run, you make GPU grid _after_ copying xs to device
-    buildFlag = GPUArrayGlobal<int>(1);
+    buildFlag = GPUArrayGlobal<int>(4);
     buildFlag.d_data.memset(0);
     copyPositionsAsync();
     
@@ -71,6 +72,33 @@ void GridGPU::setBounds(BoundsGPU &newBounds) {
     boundsLastBuild = newBounds;
 }
 
+void GridGPU::setPadding(double padding_) {
+    neighCutoffMax += padding_ - padding;
+    padding = padding_;
+    minGridDim = make_float3(neighCutoffMax, neighCutoffMax, neighCutoffMax);
+    setBounds(state->boundsGPU);
+    if (typeCutoffs.size()) {
+        setTypeCutoffs(typeCutoffs, numTypes);
+    }
+}
+
+void GridGPU::setTypeCutoffs(std::vector<float> cutoffs, int numTypes_) {
+    typeCutoffs = cutoffs;
+    numTypes = numTypes_;
+    if (not cutoffs.size()) {
+        typeCutSqrs = GPUArrayGlobal<float>();
+        return;
+    }
+    mdAssert(cutoffs.size() == numTypes*numTypes, "Type pair cutoffs need numTypes^2 entries");
+    std::vector<float> cutSqrs(cutoffs.size());
+    for (int i=0; i<cutoffs.size(); i++) {
+        //unused pairs still list atoms on top of each other, as the uniform list does
+        float cut = fmax(cutoffs[i], 0) + padding;
+        cutSqrs[i] = fmin(cut, neighCutoffMax) * fmin(cut, neighCutoffMax);
+    }
+    typeCutSqrs = GPUArrayGlobal<float>(cutSqrs);
+}
+
 void GridGPU::initStream() {
     //std::cout << "initializing stream" << std::endl;
     //streamCreated = true;
@@ -80,6 +108,10 @@ void GridGPU::initStream() {
 
 GridGPU::GridGPU() {
     streamCreated = false;
+    stats = nullptr;
+    checkMargin = 0;
+    trackMotion = false;
+    numTypes = 0;
     //initStream();
 }
 
@@ -107,7 +139,7 @@ __global__ void printGPD_xsOnly(uint* ids, float4 *xs, int nAtoms) {
 }
 
 
-GridGPU::GridGPU(State *state_, float dx_, float dy_, float dz_, float neighCutoffMax_, int exclusionMode_, double padding_, GPUData *gpd_, int nPerRingPoly_)
+GridGPU::GridGPU(State *state_, float dx_, float dy_, float dz_, float neighCutoffMax_, int exclusionMode_, double padding_, GPUData *gpd_, int nPerRingPoly_, bool buildExclusions)
   : state(state_), nPerRingPoly(nPerRingPoly_) {
     nThreadPerAtom(state->nThreadPerAtom);
     nThreadPerBlock(state->nThreadPerBlock);
@@ -115,6 +147,10 @@ GridGPU::GridGPU(State *state_, float dx_, float dy_, float dz_, float neighCuto
     gpd = gpd_;
     padding = padding_;
     streamCreated = false;
+    stats = nullptr;
+    checkMargin = 0;
+    trackMotion = false;
+    numTypes = 0;
     onlyPositionsFlag = false;
     ns = make_int3(0, 0, 0);
     minGridDim = make_float3(dx_, dy_, dz_);
@@ -127,7 +163,9 @@ GridGPU::GridGPU(State *state_, float dx_, float dy_, float dz_, float neighCuto
     exclusionMode = exclusionMode_;
     
     int activeIdx = gpd->activeIdx();
-    handleExclusions();
+    if (buildExclusions) {
+        handleExclusions();
+    }
     int nAtoms = gpd->xs.size();
 }
 
@@ -349,14 +387,17 @@ __global__ void sortPerAtomArrays_xsOnly(
 /*! modifies myCount to be the number of neighbors in this cell */
 __device__ void checkCell(float3 pos, float4 *xs,
                           uint32_t *gridCellArrayIdxs, int squareIdx,
-                          float3 loop, float neighCutSqr, int &myCount, int nThreadPerRP, int myIdxInAtomTeam) {
+                          float3 loop, float neighCutSqr, const float *typeCutSqrs, int myTypeRow,
+                          int &myCount, int nThreadPerRP, int myIdxInAtomTeam) {
 
     uint32_t idxMin = gridCellArrayIdxs[squareIdx];
     uint32_t idxMax = gridCellArrayIdxs[squareIdx+1];
     for (int i=idxMin+myIdxInAtomTeam; i<idxMax; i+=nThreadPerRP) {
-        float3 otherPos = make_float3(xs[i]);
+        float4 otherWhole = xs[i];
+        float3 otherPos = make_float3(otherWhole);
         float3 distVec  = otherPos + loop - pos;
-        if (dot(distVec, distVec) < neighCutSqr) {
+        float cutSqr = typeCutSqrs ? typeCutSqrs[myTypeRow + __float_as_int(otherWhole.w)] : neighCutSqr;
+        if (dot(distVec, distVec) < cutSqr) {
             myCount++;
         }
     }
@@ -367,7 +408,8 @@ template
 __global__ void countNumNeighbors(float4 *xs, int nRingPoly,
                                   uint16_t *neighborCounts, uint32_t *gridCellArrayIdxs,
                                   float3 os, float3 ds, int3 ns,
-                                  float3 periodic, float3 trace, float neighCutSqr, int nThreadPerRP) {
+                                  float3 periodic, float3 trace, float neighCutSqr,
+                                  const float *typeCutSqrs, int numTypes, int nThreadPerRP) {
 
     extern __shared__ uint16_t counts_shr[];
     int idx = GETIDX();
@@ -385,6 +427,7 @@ __global__ void countNumNeighbors(float4 *xs, int nRingPoly,
         float4 posWhole = xs[atomIdx];
         float3 pos      = make_float3(posWhole);
         int3   sqrIdx   = make_int3((pos - os) / ds);
+        int myTypeRow   = __float_as_int(posWhole.w) * numTypes;
 
         int myIdxInAtomTeam;
         if (MULTITHREADPERATOM) {
@@ -416,7 +459,8 @@ __global__ void countNumNeighbors(float4 *xs, int nRingPoly,
                                 // updates myCount for this cell
                                 checkCell(pos, xs, 
                                           gridCellArrayIdxs, sqrIdxOtherLin,
-                                          loop, neighCutSqr, myCount, nThreadPerRP, myIdxInAtomTeam);
+                                          loop, neighCutSqr, typeCutSqrs, myTypeRow,
+                                          myCount, nThreadPerRP, myIdxInAtomTeam);
                                 //note sign switch on offset!
 
                             } // endif periodic.z
@@ -468,6 +512,7 @@ template
 __device__ int assignFromCell(float3 pos, int idx, uint myId, float4 *xs, uint *ids,
                               uint32_t *gridCellArrayIdxs, int squareIdx,
                               float3 offset, float3 trace, float neighCutSqr,
+                              const float *typeCutSqrs, int myTypeRow,
                               int currentNeighborIdx, uint32_t *teamNlist_base_shr, int teamOffset, uint *neighborlist,
                               uint *exclusionIds_shr, int exclIdxLo_shr, int exclIdxHi_shr,
                               int nPerRingPoly, int nThreadPerRP,
@@ -495,11 +540,13 @@ __device__ int assignFromCell(float3 pos, int idx, uint myId, float4 *xs, uint *
         bool validAtom = i<idxMax;
         uint nlistItem = nlistDefault;
         if (validAtom) {
-            float3 otherPos = make_float3(xs[i]);
+            float4 otherWhole = xs[i];
+            float3 otherPos = make_float3(otherWhole);
             float3 distVec = otherPos + (offset * trace) - pos;
             uint otherId = ids[i*nPerRingPoly];
             bool idsFine = CHECKIDS ? myId != otherId : true;
-            if (idsFine && dot(distVec, distVec) < neighCutSqr) {
+            float cutSqr = typeCutSqrs ? typeCutSqrs[myTypeRow + __float_as_int(otherWhole.w)] : neighCutSqr;
+            if (idsFine && dot(distVec, distVec) < cutSqr) {
                 if (EXCLUSIONS) {
                     uint exclusionTag = addExclusion(otherId, exclusionIds_shr, exclIdxLo_shr, exclIdxHi_shr);
 
@@ -553,6 +600,7 @@ __global__ void assignNeighbors(float4 *xs, int nRingPoly, int nPerRingPoly, uin
                                 uint32_t *gridCellArrayIdxs, uint32_t *cumulSumMaxPerBlock,
                                 float3 os, float3 ds, int3 ns,
                                 float3 periodic, float3 trace, float neighCutSqr,
+                                const float *typeCutSqrs, int numTypes,
                                 uint *neighborlist, int warpSize,
                                 int *exclusionIndexes, uint *exclusionIds, int maxExclusionsPerAtom, int nThreadPerRP) {
 
@@ -621,6 +669,7 @@ __global__ void assignNeighbors(float4 *xs, int nRingPoly, int nPerRingPoly, uin
     int xIdx, yIdx, zIdx;
     int xIdxLoop, yIdxLoop, zIdxLoop;
     int currentNeighborIdx;
+    int myTypeRow = 0;
 
 
     if (validThread) {
@@ -630,8 +679,9 @@ __global__ void assignNeighbors(float4 *xs, int nRingPoly, int nPerRingPoly, uin
         //printf("atom idx %d tid %d base idx %d\n", idx/nThreadPerRP, threadIdx.x, currentNeighborIdx); 
         pos = make_float3(posWhole);
         sqrIdx = make_int3((pos - os) / ds);
+        myTypeRow = __float_as_int(posWhole.w) * numTypes;
     }
-    currentNeighborIdx = assignFromCell<MULTITHREADPERATOM, 1,EXCLUSIONS>(pos, idx, myId, xs, ids, gridCellArrayIdxs, LINEARIDX(sqrIdx, ns), offset, trace, neighCutSqr, currentNeighborIdx, teamNlist_base_shr, teamOffset, neighborlist, exclusionIds_shr, exclIdxLo_shr, exclIdxHi_shr, nPerRingPoly, nThreadPerRP, warpSize, myIdxInTeam, validThread);
+    currentNeighborIdx = assignFromCell<MULTITHREADPERATOM, 1,EXCLUSIONS>(pos, idx, myId, xs, ids, gridCellArrayIdxs, LINEARIDX(sqrIdx, ns), offset, trace, neighCutSqr, typeCutSqrs, myTypeRow, currentNeighborIdx, teamNlist_base_shr, teamOffset, neighborlist, exclusionIds_shr, exclIdxLo_shr, exclIdxHi_shr, nPerRingPoly, nThreadPerRP, warpSize, myIdxInTeam, validThread);
     for (xIdx=sqrIdx.x-1; xIdx<=sqrIdx.x+1; xIdx++) {
         offset.x = -floorf((float) xIdx / ns.x);
         xIdxLoop = xIdx + ns.x * offset.x;
@@ -653,6 +703,7 @@ __global__ void assignNeighbors(float4 *xs, int nRingPoly, int nPerRingPoly, uin
                                 currentNeighborIdx = assignFromCell<MULTITHREADPERATOM, 0,EXCLUSIONS>(
                                         pos, idx, myId, xs, ids, gridCellArrayIdxs,
                                         sqrIdxOtherLin, -offset, trace, neighCutSqr,
+                                        typeCutSqrs, myTypeRow,
                                         currentNeighborIdx,
                                         teamNlist_base_shr,
                                         teamOffset, neighborlist,
@@ -692,15 +743,28 @@ void setPerBlockCounts(std::vector<uint16_t> &neighborCounts, std::vector<uint32
 }
 
 
-__global__ void setBuildFlag(float4 *xsA, float4 *xsB, int nAtoms, BoundsGPU boundsGPU,
-                             float paddingSqr, int *buildFlag, int warpSize) {
+__global__ void setBuildFlag(float4 *xsA, float4 *xsB, float4 *vs, float dt, int nAtoms, BoundsGPU boundsGPU,
+                             float triggerSqr, float paddingSqr, int *buildFlag, bool trackMotion, int warpSize) {
 
     int idx = GETIDX();
     extern __shared__ short flags_shr[];
+    float lenSqr = 0;
+    float speedSqr = 0;
     if (idx < nAtoms) {
         float3 distVector = boundsGPU.minImage(make_float3(xsA[idx] - xsB[idx]));
-        float lenSqr = lengthSqr(distVector);
-        flags_shr[threadIdx.x] = (short) (lenSqr > (paddingSqr * 0.25f));
+        lenSqr = lengthSqr(distVector);
+        flags_shr[threadIdx.x] = (short) (lenSqr > triggerSqr);
+        if (vs != nullptr) {
+            speedSqr = lengthSqr(make_float3(vs[idx]));
+            //if the atom was already past half the padding a step ago, pairs
+            //may have been missed before this check
+            if (lenSqr > paddingSqr * 0.25f) {
+                float lenLastStep = sqrtf(lenSqr) - sqrtf(speedSqr) * dt;
+                if (lenLastStep > 0 and lenLastStep * lenLastStep > paddingSqr * 0.25f) {
+                    buildFlag[1] = 1;
+                }
+            }
+        }
     } else {
         flags_shr[threadIdx.x] = 0;
     }
@@ -710,6 +774,23 @@ __global__ void setBuildFlag(float4 *xsA, float4 *xsB, int nAtoms, BoundsGPU bou
     if (threadIdx.x == 0 and flags_shr[0] != 0) {
         buildFlag[0] = 1;
     }
+    if (trackMotion) {
+        //non-negative floats order the same as their bits
+        float *motion_shr = (float *) (flags_shr + blockDim.x);
+        motion_shr[threadIdx.x] = lenSqr;
+        __syncthreads();
+        maxByN<float>(motion_shr, blockDim.x, warpSize);
+        if (threadIdx.x == 0) {
+            atomicMax(buildFlag + 2, __float_as_int(motion_shr[0]));
+        }
+        __syncthreads();
+        motion_shr[threadIdx.x] = speedSqr;
+        __syncthreads();
+        maxByN<float>(motion_shr, blockDim.x, warpSize);
+        if (threadIdx.x == 0) {
+            atomicMax(buildFlag + 3, __float_as_int(motion_shr[0]));
+        }
+    }
 
 }
 
@@ -756,6 +837,82 @@ __global__ void setCumulativeSumPerBlock(int numBlocks, uint32_t *perBlockArray,
 }
 
 
+//! Adds neighbors per atom, and how many lie inside cutSqr, to the run's statistics
+/*!
+ * Walks the neighbor list the way the pair kernels do, so it must be
+ * launched with the same block size and threads per atom.  Shared memory
+ * holds the block's histogram, then its neighbors, neighbors inside the
+ * cutoff, atoms and largest count.
+ */
+template <int MULTITHREADPERATOM>
+__global__ void accumulateNeighborStats(float4 *xs, int nRingPoly, uint16_t *neighborCounts,
+                                        uint *neighborlist, uint32_t *cumulSumMaxPerBlock, int warpSize,
+                                        BoundsGPU bounds, float cutSqr, const float *typeCutSqrs,
+                                        int numTypes, float padding, int nThreadPerRP,
+                                        unsigned long long *sums, uint32_t *histogram,
+                                        int nBins, int binWidth) {
+    extern __shared__ uint32_t stats_shr[];
+    for (int i=threadIdx.x; i<nBins+4; i+=blockDim.x) {
+        stats_shr[i] = 0;
+    }
+    __syncthreads();
+    int idx = GETIDX();
+    int ringPolyIdx = MULTITHREADPERATOM ? idx / nThreadPerRP : idx;
+    if (ringPolyIdx < nRingPoly) {
+        int myIdxInTeam;
+        int baseIdx;
+        if (MULTITHREADPERATOM) {
+            myIdxInTeam = threadIdx.x % nThreadPerRP;
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx, nThreadPerRP);
+        } else {
+            myIdxInTeam = 0;
+            baseIdx = baseNeighlistIdxFromRPIndex(cumulSumMaxPerBlock, warpSize, ringPolyIdx);
+        }
+        uint exclMask = EXCL_MASK;
+        float4 posWhole = xs[ringPolyIdx];
+        float3 pos = make_float3(posWhole);
+        int myTypeRow = __float_as_int(posWhole.w) * numTypes;
+        int numNeigh = neighborCounts[ringPolyIdx];
+        uint32_t inCutoff = 0;
+        for (int nthNeigh=myIdxInTeam; nthNeigh<numNeigh; nthNeigh+=nThreadPerRP) {
+            int nlistIdx;
+            if (MULTITHREADPERATOM) {
+                nlistIdx = baseIdx + myIdxInTeam + warpSize * (nthNeigh/nThreadPerRP);
+            } else {
+                nlistIdx = baseIdx + warpSize * nthNeigh;
+            }
+            uint otherIdx = neighborlist[nlistIdx] & exclMask;
+            float4 otherWhole = xs[otherIdx];
+            float3 dr = bounds.minImage(make_float3(otherWhole) - pos);
+            float pairCutSqr = cutSqr;
+            if (typeCutSqrs) {
+                float pairCut = fmaxf(sqrtf(typeCutSqrs[myTypeRow + __float_as_int(otherWhole.w)]) - padding, 0);
+                pairCutSqr = pairCut * pairCut;
+            }
+            inCutoff += lengthSqr(dr) < pairCutSqr;
+        }
+        atomicAdd(stats_shr + nBins + 1, inCutoff);
+        if (myIdxInTeam == 0) {
+            atomicAdd(stats_shr + min(numNeigh / binWidth, nBins - 1), 1);
+            atomicAdd(stats_shr + nBins, (uint32_t) numNeigh);
+            atomicAdd(stats_shr + nBins + 2, 1);
+            atomicMax(stats_shr + nBins + 3, (uint32_t) numNeigh);
+        }
+    }
+    __syncthreads();
+    for (int i=threadIdx.x; i<nBins; i+=blockDim.x) {
+        if (stats_shr[i]) {
+            atomicAdd(histogram + i, stats_shr[i]);
+        }
+    }
+    if (threadIdx.x < 3) {
+        atomicAdd(sums + threadIdx.x, (unsigned long long) stats_shr[nBins + threadIdx.x]);
+    } else if (threadIdx.x == 3) {
+        atomicMax(histogram + nBins, stats_shr[nBins + 3]);
+    }
+}
+
+
 void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
     DeviceManager &devManager = state->devManager;
     int warpSize = devManager.prop.warpSize;
@@ -763,6 +920,10 @@ void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
     if (neighCut == -1) {
         neighCut = neighCutoffMax;
     }
+    //type pair cutoffs only apply to builds at the grid's own cutoff, and
+    //ring polymer centroids carry no type
+    float *typeCuts = (typeCutSqrs.size() and neighCut == neighCutoffMax and nPerRingPoly == 1)
+                      ? typeCutSqrs.getDevData() : nullptr;
 
     int nAtoms       = gpd->xs.size();
     //int nPerRingPoly = gpd->nPerRingPoly;
@@ -782,15 +943,28 @@ void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
     // multigpu: needs to rebuild if any proc needs to rebuild
 
     // NOTE:  nothing to do here, if onlyPositionsFlag is True
-    setBuildFlag<<<NBLOCK(nAtoms), PERBLOCK, PERBLOCK * sizeof(short)>>>(
-                gpd->xs(activeIdx), xsLastBuild.data(), nAtoms, bounds,
-		padding * padding, buildFlag.d_data.data(), warpSize);
+    // velocities are only needed to spot dangerous builds and track motion
+    float4 *vs = ((stats or trackMotion) and not onlyPositionsFlag) ? gpd->vs(activeIdx) : nullptr;
+    float trigger = fmaxf(0.5f * padding - checkMargin, 0);
+    setBuildFlag<<<NBLOCK(nAtoms), PERBLOCK, PERBLOCK * (sizeof(short) + (trackMotion ? sizeof(float) : 0))>>>(
+                gpd->xs(activeIdx), xsLastBuild.data(), vs, state->dt, nAtoms, bounds,
+		trigger * trigger, padding * padding, buildFlag.d_data.data(), trackMotion, warpSize);
     buildFlag.dataToHost();
     cudaDeviceSynchronize();
+    if (stats) {
+        stats->recordCheck();
+    }
 
     if (buildFlag.h_data[0] or forceBuild) {
+        TraceScope scope(state->tracer.get(), "buildNeighborList");
+        AllocationScope allocationScope("grid");
         state->nlistBuildCount++;
         state->nlistBuildTurns.push_back((int)state->turn);
+        bool sampleStats = false;
+        if (stats) {
+            sampleStats = stats->recordBuild(state->turn, not buildFlag.h_data[0], buildFlag.h_data[1]);
+            state->dangerousRebuilds = stats->dangerousBuilds;
+        }
         float3 ds_orig = ds;
         float3 os_orig = os;
 
@@ -909,12 +1083,12 @@ void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
             countNumNeighbors<0><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock()>>>(
                             centroids, nRingPoly, 
                             perAtomArray.d_data.data(), perCellArray.d_data.data(),
-                            os, ds, ns, bounds.periodic, trace, neighCut*neighCut, nThreadPerRP); //PER RP CENTROID
+                            os, ds, ns, bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, nThreadPerRP); //PER RP CENTROID
         } else {
             countNumNeighbors<1><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), nThreadPerBlock()*sizeof(uint16_t)>>>(
                             centroids, nRingPoly, 
                             perAtomArray.d_data.data(), perCellArray.d_data.data(),
-                            os, ds, ns, bounds.periodic, trace, neighCut*neighCut, nThreadPerRP); //PER RP CENTROID
+                            os, ds, ns, bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, nThreadPerRP); //PER RP CENTROID
         }
 
  
@@ -964,14 +1138,14 @@ void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
                 assignNeighbors<0,true><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), (nThreadPerBlock()/nThreadPerRP)*maxExclusionsPerAtom*sizeof(uint32_t)>>>(
                                 centroids, nRingPoly, nPerRingPoly, state->gpd.ids(gridIdx),
                                 perCellArray.d_data.data(), perBlockArray.d_data.data(), os, ds, ns,
-                                bounds.periodic, trace, neighCut*neighCut, neighborlist.data(), warpSize,
+                                bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, neighborlist.data(), warpSize,
                                 exclusionIndexes.data(), exclusionIds.data(), maxExclusionsPerAtom, nThreadPerRP
                                 ); //PER RP CENTROID
             } else {
                 assignNeighbors<0,false><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), (nThreadPerBlock()/nThreadPerRP)*maxExclusionsPerAtom*sizeof(uint32_t)>>>(
                                 centroids, nRingPoly, nPerRingPoly, state->gpd.ids(gridIdx),
                                 perCellArray.d_data.data(), perBlockArray.d_data.data(), os, ds, ns,
-                                bounds.periodic, trace, neighCut*neighCut, neighborlist.data(), warpSize,
+                                bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, neighborlist.data(), warpSize,
                                 exclusionIndexes.data(), exclusionIds.data(), maxExclusionsPerAtom, nThreadPerRP
                                 ); //PER RP CENTROID
             }
@@ -980,19 +1154,39 @@ void GridGPU::periodicBoundaryConditions(float neighCut, bool forceBuild) {
                 assignNeighbors<1,true><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), (nThreadPerBlock()/nThreadPerRP)*maxExclusionsPerAtom*sizeof(uint32_t) + nThreadPerBlock()*sizeof(uint32_t)>>>(
                                 centroids, nRingPoly, nPerRingPoly, state->gpd.ids(gridIdx),
                                 perCellArray.d_data.data(), perBlockArray.d_data.data(), os, ds, ns,
-                                bounds.periodic, trace, neighCut*neighCut, neighborlist.data(), warpSize,
+                                bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, neighborlist.data(), warpSize,
                                 exclusionIndexes.data(), exclusionIds.data(), maxExclusionsPerAtom, nThreadPerRP
                                 ); //PER RP CENTROID
             } else {
                 assignNeighbors<1,false><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), (nThreadPerBlock()/nThreadPerRP)*maxExclusionsPerAtom*sizeof(uint32_t) + nThreadPerBlock()*sizeof(uint32_t)>>>(
                                 centroids, nRingPoly, nPerRingPoly, state->gpd.ids(gridIdx),
                                 perCellArray.d_data.data(), perBlockArray.d_data.data(), os, ds, ns,
-                                bounds.periodic, trace, neighCut*neighCut, neighborlist.data(), warpSize,
+                                bounds.periodic, trace, neighCut*neighCut, typeCuts, numTypes, neighborlist.data(), warpSize,
                                 exclusionIndexes.data(), exclusionIds.data(), maxExclusionsPerAtom, nThreadPerRP
                                 ); //PER RP CENTROID
             }
         }
 
+        if (sampleStats) {
+            float cut = fmaxf(neighCut - padding, 0);
+            int nBins = NeighborListStats::nBins;
+            size_t sharedSize = (nBins + 4) * sizeof(uint32_t);
+            if (nThreadPerRP==1) {
+                accumulateNeighborStats<0><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), sharedSize>>>(
+                                centroids, nRingPoly, perAtomArray.d_data.data(), neighborlist.data(),
+                                perBlockArray.d_data.data(), warpSize, bounds, cut*cut, typeCuts, numTypes, padding, nThreadPerRP,
+                                stats->sums.getDevData(), stats->histogram.getDevData(),
+                                nBins, NeighborListStats::binWidth);
+            } else {
+                accumulateNeighborStats<1><<<NBLOCKTEAM(nRingPoly, nThreadPerBlock(), nThreadPerRP), nThreadPerBlock(), sharedSize>>>(
+                                centroids, nRingPoly, perAtomArray.d_data.data(), neighborlist.data(),
+                                perBlockArray.d_data.data(), warpSize, bounds, cut*cut, typeCuts, numTypes, padding, nThreadPerRP,
+                                stats->sums.getDevData(), stats->histogram.getDevData(),
+                                nBins, NeighborListStats::binWidth);
+            }
+            stats->recordLayout(totalNumNeighbors, neighborlist.size());
+        }
+
         /*
         std::vector<int> nlistCPU(neighborlist.size()); 
         neighborlist.get(nlistCPU.data());
@@ -1188,6 +1382,14 @@ void GridGPU::handleExclusions() {
 }
 
 
+void GridGPU::takeExclusions(GridGPU &other) {
+    exclusions = other.exclusions;
+    maxExclusionsPerAtom = other.maxExclusionsPerAtom;
+    exclusionIndexes = std::move(other.exclusionIndexes);
+    exclusionIds = std::move(other.exclusionIds);
+}
+
+
 void GridGPU::handleExclusionsForcers() {
 
     std::vector<std::vector<BondVariant> *> allBonds;
@@ -4,6 +4,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include "GPUArrayGlobal.h"
 #include "GPUArrayDeviceGlobal.h"
@@ -14,6 +15,7 @@
 #include "Tunable.h"
 
 #include "BoundsGPU.h"
+#include "NeighborListStats.h"
 class State;
 
 #include "globalDefs.h"
@@ -80,7 +82,13 @@ public:
     GPUArrayDeviceGlobal<float4> rpCentroids;
                                                 //!< the time of the last build.
     GPUArrayGlobal<int> buildFlag;  //!< If buildFlag[0] == true, neighbor list
-                                    //!< will be rebuilt
+                                    //!< will be rebuilt.  buildFlag[1] is set
+                                    //!< if the build is dangerous.  If
+                                    //!< trackMotion, [2] and [3] hold the bits
+                                    //!< of the largest squared displacement
+                                    //!< and speed at the check
+    NeighborListStats *stats;       //!< Where checks and builds are reported,
+                                    //!< or null.  Set for the state's grid
     float3 ds;      //!< Grid spacing in x-, y-, and z-dimension
     float3 os;      //!< Point of origin (lower value for all bounds)
     int3 ns;        //!< Number of grid points in each dimension
@@ -89,6 +97,14 @@ public:
     GPUData *gpd;   //!< Pointer to the gpu data for this grid
     float neighCutoffMax;   //!< largest cutoff radius of any interacting pair + padding, default value for grid building
     double padding; //!< padding for this grid
+    double checkMargin; //!< Rebuild once an atom has moved half the padding
+                        //!< less this distance.  Zero by default
+    bool trackMotion;   //!< Record the largest displacement and speed at each check
+    std::vector<float> typeCutoffs; //!< Cutoff of each pair of types, numTypes^2
+                                    //!< entries without padding.  Empty if all
+                                    //!< pairs use neighCutoffMax
+    int numTypes;                   //!< Rows of typeCutoffs
+    GPUArrayGlobal<float> typeCutSqrs; //!< (typeCutoffs + padding)^2, used in builds
 
     /*! \brief Constructor
      *
@@ -100,9 +116,10 @@ public:
      *
      * Constructor to create Grid with approximate resolution. The final
      * resolution will be the next larger value such that the box size is
-     * a multiple of the resolution.
+     * a multiple of the resolution.  If buildExclusions is false, the
+     * caller is expected to provide them with takeExclusions().
      */
-    GridGPU(State *state_, float dx, float dy, float dz, float neighCutoffMax, int exclusionMode_, double padding_, GPUData *gpd_, int nPerRingPoly=1);
+    GridGPU(State *state_, float dx, float dy, float dz, float neighCutoffMax, int exclusionMode_, double padding_, GPUData *gpd_, int nPerRingPoly=1, bool buildExclusions=true);
 
     /*! \brief Default constructor
      *
@@ -132,6 +149,9 @@ public:
      * 
      */
     void handleExclusions();
+
+    //! Take over the exclusions of a grid built for the same atoms and bonds
+    void takeExclusions(GridGPU &other);
     void handleExclusionsDistance();
     void handleExclusionsForcers();
 
@@ -200,6 +220,16 @@ public:
                                         //!< transfer.
     BoundsGPU boundsLastBuild;
     void setBounds(BoundsGPU &newBounds);
+    //! Change the padding, resizing the grid cells.  The caller must force a rebuild
+    void setPadding(double padding_);
+    //! Only list pairs of types i, j closer than cutoffs[i*numTypes+j] + padding
+    /*!
+     * \param cutoffs Cutoff of each pair of types.  Empty to list every pair
+     *                within neighCutoffMax.  No entry may exceed
+     *                neighCutoffMax - padding, which sets the cell size
+     * \param numTypes_ Number of atom types
+     */
+    void setTypeCutoffs(std::vector<float> cutoffs, int numTypes_);
     float3 minGridDim;
 
     /*! \brief Set flag to true/false
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <iostream>
 #include <stdint.h>
+#include <algorithm>
 
 namespace py = boost::python;
 
@@ -16,6 +17,8 @@ Group::Group(State *state_, std::string groupHandle_) {
     groupHandle = groupHandle_;
     groupTag = state->groupTagFromHandle(groupHandle);
     ndf = 0;
+    count = 0;
+    dirty = true;
 }
 
 
@@ -24,12 +27,100 @@ int Group::getNDF() {
 }
 
 
+bool Group::refreshMembers() {
+    if (not dirty) {
+        return false;
+    }
+    std::vector<Atom> &atoms = state->atoms;
+    atomIdxs.clear();
+    if (isExtended()) {
+        std::vector<int> &idToIdx = state->idToIdx;
+        for (uint id : atomIds) {
+            atomIdxs.push_back(idToIdx[id]);
+        }
+        std::sort(atomIdxs.begin(), atomIdxs.end());
+    } else {
+        atomIds.clear();
+        for (int i=0, ii=atoms.size(); i<ii; i++) {
+            if (atoms[i].groupTag & groupTag) {
+                atomIdxs.push_back(i);
+                atomIds.push_back(atoms[i].id);
+            }
+        }
+        std::sort(atomIds.begin(), atomIds.end());
+    }
+    count = atomIdxs.size();
+    dirty = false;
+    return true;
+}
+
+
+void Group::prepareForRun() {
+    bool rebuilt = refreshMembers();
+    if (rebuilt or ids.size() != atomIds.size()) {
+        ids = GPUArrayGlobal<uint>(atomIds);
+        ids.dataToDevice();
+        if (isExtended()) {
+            std::vector<uint32_t> bits((state->maxIdExisting + 32) / 32, 0);
+            for (uint id : atomIds) {
+                bits[id >> 5] |= 1u << (id & 31);
+            }
+            bitmap = GPUArrayGlobal<uint32_t>(bits);
+            bitmap.dataToDevice();
+        }
+    }
+}
+
+
+bool Group::hasMember(uint id) {
+    if (not isExtended()) {
+        int idx = state->idToIdx[id];
+        return state->atoms[idx].groupTag & groupTag;
+    }
+    return std::binary_search(atomIds.begin(), atomIds.end(), id);
+}
+
+
+void Group::addMember(uint id) {
+    auto it = std::lower_bound(atomIds.begin(), atomIds.end(), id);
+    if (it == atomIds.end() or *it != id) {
+        atomIds.insert(it, id);
+        dirty = true;
+    }
+}
+
+
+void Group::removeMember(uint id) {
+    auto it = std::lower_bound(atomIds.begin(), atomIds.end(), id);
+    if (it != atomIds.end() and *it == id) {
+        atomIds.erase(it);
+        dirty = true;
+    }
+}
+
+
+void Group::clearMembers() {
+    atomIds.clear();
+    dirty = true;
+}
+
+
+GroupMask Group::mask() {
+    if (isExtended()) {
+        return GroupMask(groupTag, bitmap.getDevData(), state->gpd.ids.getDevData());
+    }
+    return GroupMask(groupTag, nullptr, nullptr);
+}
+
+
 void Group::computeNDF() {
+    // atoms' ndf can be changed by constraints while being prepared, so this
+    // is summed every run, but only over members
+    refreshMembers();
     ndf = 0; // we are about to sum over all atoms; re-set to zero
-    for (Atom &a: state->atoms) {
-        if (a.groupTag & groupTag) {
-            ndf += a.ndf;
-        }
+    std::vector<Atom> &atoms = state->atoms;
+    for (int idx : atomIdxs) {
+        ndf += atoms[idx].ndf;
     }
 //    cout << "Group " << groupHandle << " was found to have " << ndf << " degrees of freedom." << endl;
 }
@@ -46,6 +137,7 @@ void export_Group() {
     py::class_<Group>("Group", py::no_init)
         .def_readonly("ndf", &Group::ndf)
         .def_readonly("groupHandle", &Group::groupHandle)
+        .def_readonly("count", &Group::count)
         //.add_property("pos", &Atom::getPos, &Atom::setPos)
     ;
 }
@@ -6,6 +6,8 @@
 #include <string.h>
 #include "Vector.h"
 #include "globalDefs.h"
+#include "GPUArrayGlobal.h"
+#include "GroupMask.h"
 #include <boost/python/list.hpp>
 
 
@@ -33,10 +35,53 @@ class Group {
         // pointer to simulation state
         State *state;
 
-        // probably not worth it to store in memory all atoms associated with this group..
-        // instead, we iterate over atoms to find the members of the group
+        // compact member lists, so writers and reductions over small groups touch
+        // only the members rather than every atom.  Rebuilt when dirty in prepareForRun,
+        // on the main thread, or by State::groupMembers between runs
 
-        Group() {};
+        // indices into state->atoms of the members, ascending
+        std::vector<int> atomIdxs;
+
+        // ids of the members, ascending.  Mirrored to the device in ids, where
+        // member indices are found through gpd.idToIdxs.  For extended groups
+        // (see GroupMask.h) this is the membership itself rather than being
+        // derived from per-atom tags
+        std::vector<uint> atomIds;
+        GPUArrayGlobal<uint> ids;
+
+        // membership bits indexed by atom id, extended groups only
+        GPUArrayGlobal<uint32_t> bitmap;
+
+        bool isExtended() const {
+            return groupTag & GROUP_TAG_EXTENDED;
+        }
+
+        // membership of extended groups
+        bool hasMember(uint id);
+        void addMember(uint id);
+        void removeMember(uint id);
+        void clearMembers();
+
+        // view of this group for membership tests on the device
+        GroupMask mask();
+
+        // number of atoms in the group
+        int count;
+
+        // set when membership or the atom list changed since the last rebuild
+        bool dirty;
+
+        void markDirty() {
+            dirty = true;
+        }
+
+        // rebuild the member lists if they are out of date.  Returns true if rebuilt
+        bool refreshMembers();
+
+        // refresh the member lists and send the ids to the device
+        void prepareForRun();
+
+        Group() : groupTag(0), ndf(0), state(nullptr), count(0), dirty(true) {};
 
         // pointer to state, groupHandle; we assign the groupTag via the grouphandle in the 
         // actual constructor
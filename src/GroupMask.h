@@ -0,0 +1,68 @@
+#pragma once
+#ifndef GROUPMASK_H
+#define GROUPMASK_H
+
+#include <stdint.h>
+#include "globalDefs.h"
+
+//! Tags with this bit set name groups beyond the per-atom bits
+/*!
+ * The first 31 groups (including "all") get a bit each in the per-atom
+ * groupTag, which is bit cast into fs.w.  Groups created once those bits are
+ * used up get a tag of GROUP_TAG_EXTENDED | index instead, and their
+ * membership is kept by the Group itself as a list of atom ids, mirrored to
+ * the device as a bitmap indexed by atom id.
+ */
+#define GROUP_TAG_EXTENDED 0x80000000u
+#define GROUP_TAG_NBITS 31
+
+//! Device-side view of a group used for membership tests in kernels
+/*!
+ * For groups which have a bit in the per-atom tag, contains() is the same
+ * single AND the kernels have always done.  Only extended groups read the
+ * atom id and look it up in the group's bitmap.
+ */
+class GroupMask {
+public:
+    uint32_t groupTag; //!< Bitmask, or GROUP_TAG_EXTENDED | index
+    uint32_t *bitmap;  //!< Membership bits indexed by atom id, extended groups only
+    uint *ids;         //!< Atom ids in current device order, extended groups only
+
+    GroupMask() : groupTag(0), bitmap(nullptr), ids(nullptr) {}
+    GroupMask(uint32_t groupTag_, uint32_t *bitmap_, uint *ids_)
+        : groupTag(groupTag_), bitmap(bitmap_), ids(ids_) {}
+
+    inline __host__ __device__ bool isExtended() const {
+        return groupTag & GROUP_TAG_EXTENDED;
+    }
+
+    //! Test whether the atom at idx, whose per-atom tag is atomTag, is a member
+    inline __host__ __device__ bool contains(uint32_t atomTag, int idx) const {
+        if (!(groupTag & GROUP_TAG_EXTENDED)) {
+            return atomTag & groupTag;
+        }
+        uint id = ids[idx];
+        return (bitmap[id >> 5] >> (id & 31)) & 1;
+    }
+};
+
+//! Energies between nGroups groups, filled by the bonded energy kernels
+/*!
+ * slots holds the index in the matrix of the group of each atom id, or -1 for
+ * atoms in none of the groups.  Kernels spread each atom's share of an
+ * interaction's energy over the other atoms of the interaction, adding it to
+ * the row of the atom's group and the column of the other atom's group.  A
+ * null matrix means energies go to per-atom arrays as usual.
+ */
+class GroupMatrix {
+public:
+    float *matrix;
+    const int *slots;
+    int nGroups;
+
+    GroupMatrix() : matrix(nullptr), slots(nullptr), nGroups(0) {}
+    GroupMatrix(float *matrix_, const int *slots_, int nGroups_)
+        : matrix(matrix_), slots(slots_), nGroups(nGroups_) {}
+};
+
+#endif
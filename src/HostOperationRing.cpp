@@ -0,0 +1,101 @@
+#include "HostOperationRing.h"
+
+#include <chrono>
+
+HostOperationRing::~HostOperationRing() {
+    freeSlots();
+}
+
+void HostOperationRing::freeSlots() {
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (boost::shared_ptr<Slot> &slot : slots) {
+        if (slot->worker and slot->worker->joinable()) {
+            slot->worker->join();
+        }
+        if (slot->copied) {
+            cudaEventDestroy(slot->copied);
+        }
+    }
+    slots.clear();
+    next = 0;
+    stopping = false;
+}
+
+void HostOperationRing::allocate(int depth, int nAtoms) {
+    drain();
+    if (depth < 1) {
+        depth = 1;
+    }
+    if ((int) slots.size() == depth and slots.size() and (int) slots[0]->xs.size() == nAtoms) {
+        return;
+    }
+    freeSlots();
+    for (int i=0; i<depth; i++) {
+        boost::shared_ptr<Slot> slot = boost::shared_ptr<Slot>(new Slot());
+        slot->xs = GPUArrayGlobal<float4>(nAtoms);
+        slot->vs = GPUArrayGlobal<float4>(nAtoms);
+        slot->fs = GPUArrayGlobal<float4>(nAtoms);
+        slot->ids = GPUArrayGlobal<uint>(nAtoms);
+        CUCHECK(cudaEventCreateWithFlags(&slot->copied, cudaEventDisableTiming));
+        slot->worker = boost::shared_ptr<std::thread>(new std::thread(&HostOperationRing::work, this, slot.get()));
+        slots.push_back(slot);
+    }
+}
+
+void HostOperationRing::work(Slot *slot) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this, slot] { return slot->busy or stopping; });
+            if (not slot->busy) {
+                return;
+            }
+        }
+        slot->job(slot);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            nCompleted++;
+            slot->busy = false;
+        }
+        cv.notify_all();
+    }
+}
+
+HostOperationRing::Slot *HostOperationRing::acquire(double &stall) {
+    Slot *slot = slots[next].get();
+    next = (next + 1) % slots.size();
+    stall = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (slot->busy) {
+        auto start = std::chrono::high_resolution_clock::now();
+        cv.wait(lock, [slot] { return not slot->busy; });
+        std::chrono::duration<double> waited = std::chrono::high_resolution_clock::now() - start;
+        stall = waited.count();
+    }
+    return slot;
+}
+
+void HostOperationRing::launch(Slot *slot, std::function<void (Slot *)> func) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slot->job = func;
+        slot->seq = nIssued++;
+        slot->busy = true;
+    }
+    cv.notify_all();
+}
+
+void HostOperationRing::waitForTurn(Slot *slot) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this, slot] { return nCompleted == slot->seq; });
+}
+
+void HostOperationRing::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return nCompleted == nIssued; });
+}
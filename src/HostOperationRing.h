@@ -0,0 +1,93 @@
+#pragma once
+#ifndef HOSTOPERATIONRING_H
+#define HOSTOPERATIONRING_H
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <boost/shared_ptr.hpp>
+
+#include "globalDefs.h"
+#include "GPUArrayGlobal.h"
+#include "BoundsGPU.h"
+
+//! Ring of device snapshot buffers used by asynchronous host operations
+/*!
+ * Each asynchronous host operation (writers and python operations) gets its
+ * own slot holding a copy of the positions, velocities, forces, ids, and
+ * bounds at the turn it was issued.  Every slot has a long-lived worker
+ * thread which runs the operations handed to that slot.  Workers unpack into
+ * State::atoms and run their callbacks strictly in the order they were
+ * issued, so consumers see snapshots in turn order.  The integrator only has
+ * to wait when every slot is still busy.
+ */
+class HostOperationRing {
+public:
+    //! A single snapshot buffer and the worker which owns it
+    class Slot {
+    public:
+        GPUArrayGlobal<float4> xs; //!< Snapshot of positions
+        GPUArrayGlobal<float4> vs; //!< Snapshot of velocities
+        GPUArrayGlobal<float4> fs; //!< Snapshot of forces
+        GPUArrayGlobal<uint> ids;  //!< Snapshot of atom ids
+        BoundsGPU bounds;          //!< Bounds at the snapshot turn
+        int64_t turn;              //!< Turn the snapshot was taken on
+        int64_t seq;               //!< Position of this operation in issue order
+        cudaEvent_t copied;        //!< Recorded once the device-side copy is queued
+        bool busy;                 //!< Set while an operation is pending or running, guarded by the ring's mutex
+        std::function<void (Slot *)> job; //!< Operation to run on the snapshot
+        boost::shared_ptr<std::thread> worker; //!< Thread consuming this slot for the life of the ring
+
+        Slot() : turn(0), seq(0), copied(nullptr), busy(false) {}
+    };
+
+    HostOperationRing() : next(0), nIssued(0), nCompleted(0), stopping(false) {}
+    ~HostOperationRing();
+
+    //! Allocate depth slots sized for nAtoms, draining any outstanding work first
+    void allocate(int depth, int nAtoms);
+
+    //! Number of slots in the ring
+    int depth() const {
+        return slots.size();
+    }
+
+    //! Claim the next slot in the ring for a new operation
+    /*!
+     * \param stall Set to the number of seconds spent waiting for the slot,
+     *              zero if it was already free
+     * \return Slot to fill
+     *
+     * Slots are handed out round-robin and consumed in order, so if the next
+     * slot is busy every other slot is as well.
+     */
+    Slot *acquire(double &stall);
+
+    //! Hand a filled slot to its worker thread, which runs func(slot)
+    void launch(Slot *slot, std::function<void (Slot *)> func);
+
+    //! Block the calling worker until every earlier operation has finished
+    void waitForTurn(Slot *slot);
+
+    //! Wait for all outstanding operations to finish
+    void drain();
+
+private:
+    std::vector<boost::shared_ptr<Slot> > slots;
+    int next;
+    int64_t nIssued;
+    int64_t nCompleted;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    //! Loop run by each slot's worker until the slots are freed
+    void work(Slot *slot);
+    void freeSlots();
+};
+
+#endif
@@ -100,10 +100,7 @@ void InitializeAtoms::populateRand(SHARED(State) state, Bounds &bounds,
 void InitializeAtoms::initTemp(SHARED(State) state, string groupHandle,
                                double temp) {
     std::mt19937 generator = state->getRNG();
-    int groupTag = state->groupTagFromHandle(groupHandle);
-
-    vector<Atom *> atoms = LISTMAPREFTEST(Atom, Atom *, a, state->atoms, &a,
-                                          a.groupTag & groupTag);
+    vector<Atom *> atoms = state->selectGroup(groupHandle);
 
     assert(atoms.size());
     map<double, normal_distribution<double> > dists;
@@ -9,6 +9,12 @@
 #include "PythonOperation.h"
 #include "WriteConfig.h"
 #include "Interpolator.h"
+#include "TuneCache.h"
+#include "AllocationRegistry.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -32,20 +38,31 @@ void Integrator::stepInit(bool computeVirials)
 
     for (Fix *f : state->fixes) {
         if (state->turn % f->applyEvery == 0) {
+            // velocities may have changed since the last fix, so sums are not shared across it
+            state->dataManager.reductions.invalidate();
+            startFixTimer(HOOK_STEPINIT, f);
             f->stepInit();
+            stopFixTimer(HOOK_STEPINIT, f);
         }
     }
     if (computeVirials) {
         //reset virials each turn
         state->gpd.virials.d_data.memset(0);
     }
+    state->dataManager.reductions.invalidate();
 }
 
 void Integrator::stepFinal()
 {
+    // the second half kick has changed the velocities
+    state->dataManager.reductions.invalidate();
     for (Fix *f : state->fixes) {
         if (state->turn % f->applyEvery == 0) {
+            // velocities may have changed since the last fix, so sums are not shared across it
+            state->dataManager.reductions.invalidate();
+            startFixTimer(HOOK_STEPFINAL, f);
             f->stepFinal();
+            stopFixTimer(HOOK_STEPFINAL, f);
         }
     }
 }
@@ -55,16 +72,17 @@ void Integrator::asyncOperations() {
 
     // well, if I try to use a local state pointer, this segfaults. Need to
     // capture this instead.  Little confused
-    auto writeAndPy = [this] (int64_t ts) {
+    auto writeAndPy = [this] (int64_t ts, Bounds &bounds) {
         // have to set device in each thread
         state->devManager.setDevice(state->devManager.currentDevice, false);
         for (SHARED(WriteConfig) wc : state->writeConfigs) {
             if (not (ts % wc->writeEvery)) {
-                wc->write(ts);
+                wc->write(ts, bounds);
             }
         }
         for (SHARED(PythonOperation) po : state->pythonOperations) {
             if (not (ts % po->operateEvery)) {
+                TraceScope scope(state->tracer.get(), "pythonOperation", po->handle);
                 po->operate(ts);
             }
         }
@@ -122,6 +140,10 @@ void Integrator::prepareFixes(bool requiresForces_) {
             f->takeStateNThreadPerBlock(state->nThreadPerBlock);//grid will also have this value
             f->takeStateNThreadPerAtom(state->nThreadPerAtom);//grid will also have this value
             f->updateGroupTag();
+            mdAssert(f->supportsExtendedGroups or not (f->groupTag & GROUP_TAG_EXTENDED),
+                     "Fix %s does not support group %s.  Only the first %d groups can be used with this fix",
+                     f->handle.c_str(), f->groupHandle.c_str(), GROUP_TAG_NBITS);
+            AllocationScope scope(f->handle);
             if (f->prepareForRun()) {
                 f->prepared = true;
             }
@@ -139,6 +161,7 @@ void Integrator::prepareFinal() {
 
     // prepare the DataComputers that are present
     for (boost::shared_ptr<MD_ENGINE::DataSetUser> ds : state->dataManager.dataSets) {
+        AllocationScope scope("data");
         ds->prepareForRun(); //will also prepare those data sets' computers
         if (ds->requiresVirials()) {
             state->dataManager.addVirialTurn(ds->nextCompute, ds->requiresPerAtomVirials());
@@ -148,6 +171,7 @@ void Integrator::prepareFinal() {
     // finally, prepare any barostats or thermostats that are present in simulation
     for (Fix *f : state->fixes) {
         // final stuff that needs to be prepared; in the cases of barostats & thermostats, all the things.
+        AllocationScope scope(f->handle);
         f->prepareFinal();
 
     }
@@ -174,11 +198,30 @@ void Integrator::basicPrepare(int numTurns) {
     state->runningFor = numTurns;
     state->runInit = state->turn;
     state->nlistBuildCount = 0;
+    if (state->tuneCacheFile.size()) {
+        // start from what the tuner chose for this system last time, so the
+        // grid and fixes are prepared with those parameters
+        std::string signature = tuneSignature();
+        TuneCache::Entry cached;
+        if (signature != tunedSignature and TuneCache(state->tuneCacheFile).lookup(signature, cached)) {
+            state->nThreadPerBlock = cached.nThreadPerBlock;
+            state->nThreadPerAtom = cached.nThreadPerAtom;
+        }
+        tunedSignature = signature;
+    }
+    AllocationRegistry::instance().beginRun();
+    AllocationScope scope("atoms");
+    // data sets and fixes request their sums again as they are prepared
+    state->dataManager.reductions.clearRequests();
+    state->dataManager.reductions.setCaching(true);
     state->prepareForRun();
     state->atomParams.guessAtomicNumbers();
     setActiveData();
-    for (GPUArray *dat : activeData) {
-        dat->dataToDevice();
+    // otherwise the device still holds everything the last run left there
+    if (not state->deviceDataCurrent) {
+        for (GPUArray *dat : activeData) {
+            dat->dataToDevice();
+        }
     }
     /*
     std::vector<bool> prepared;
@@ -200,20 +243,30 @@ void Integrator::basicPrepare(int numTurns) {
         }
     }
     */
-    state->gridGPU.periodicBoundaryConditions(-1, true);
+    // a kept grid already has a neighbor list for these positions, and the
+    // usual displacement check decides whether it needs rebuilding
+    AllocationScope gridScope("grid");
+    state->nlistStats.reset();
+    state->dangerousRebuilds = 0;
+    // integrators which adapt the list set these again once prepared
+    state->gridGPU.checkMargin = 0;
+    state->gridGPU.trackMotion = false;
+    state->gridGPU.periodicBoundaryConditions(-1, not state->gridCurrent);
 
     return;
 }
 
 
 void Integrator::basicFinish() {
+    state->dataManager.reductions.setCaching(false);
     for (Fix *f : state->fixes) {
         f->postRun();
         f->hasAcceptedChargePairCalc = false;
         f->hasOffloadedChargePairCalc = false;
     }
-    if (state->asyncData && state->asyncData->joinable()) {
-        state->asyncData->join();
+    state->finishHostOperations();
+    if (state->tracer) {
+        state->tracer->write(state->traceFile);
     }
     for (GPUArray *dat : activeData) {
         dat->dataToHost();
@@ -240,12 +293,58 @@ void Integrator::setActiveData() {
 
 
 Integrator::Integrator(State *state_) : IntegratorUtil(state_) {
+    timingInterval = 0;
+    timedTurns = 0;
+    timedRuntime = 0;
+    timedNlistBuilds = 0;
+}
+
+void Integrator::prepareTimers(const int hookPhases[HOOK_COUNT]) {
+    prepareFixTimers(hookPhases);
+    timers->reset(timingInterval, state->tracer.get());
+}
+
+void Integrator::finishTimers(int numTurns, double runtime) {
+    timers->finish();
+    if (not timingInterval) {
+        return;
+    }
+    timedTurns = numTurns;
+    timedRuntime = runtime;
+    timedNlistBuilds = state->nlistBuildCount;
+    if (timingFile.size()) {
+        std::ofstream f(timingFile.c_str(), std::ios::app);
+        f << timingsJSON() << "\n";
+    }
+}
+
+boost::python::dict Integrator::timings() {
+    boost::python::dict t;
+    t["turns"] = timedTurns;
+    t["runtime"] = timedRuntime;
+    t["nlistBuilds"] = timedNlistBuilds;
+    t["phases"] = timers->asDict();
+    return t;
+}
+
+std::string Integrator::timingsJSON() {
+    std::ostringstream out;
+    out << "{\"turn\": " << state->turn << ", \"turns\": " << timedTurns
+        << ", \"runtime\": " << timedRuntime << ", \"nlistBuilds\": " << timedNlistBuilds
+        << ", \"phases\": " << timers->asJSON() << "}";
+    return out.str();
+}
+
+void Integrator::writeTimings(std::string fn) {
+    std::ofstream f(fn.c_str());
+    mdAssert(f.is_open(), "Could not open %s to write timings", fn.c_str());
+    f << timingsJSON() << "\n";
 }
 
 
 void Integrator::writeOutput() {
     for (SHARED(WriteConfig) wc : state->writeConfigs) {
-        wc->write(state->turn);
+        wc->write(state->turn, state->bounds);
     }
 }
 
@@ -268,7 +367,8 @@ double Integrator::singlePointEngPythonAvg(string groupHandle) {
          state->gpd.perParticleEng.getDevData(),
          state->atoms.size(),
          warpSize,
-         SumSingleIf(state->gpd.fs.getDevData(), groupTag)
+         SumSingleIf(state->gpd.fs.getDevData(), state->groupMask(groupTag)),
+         IndexAll()
         );
     eng.dataToHost();
     cudaDeviceSynchronize();
@@ -303,6 +403,31 @@ boost::python::list Integrator::singlePointEngPythonPerParticle() {
     */
 
 
+std::string Integrator::tuneSignature() {
+    int nAtoms = state->atoms.size();
+    double density = std::max(nAtoms, 1) / state->bounds.volume();
+    std::vector<std::string> fixTypes;
+    for (Fix *f : state->fixes) {
+        fixTypes.push_back(f->type);
+    }
+    cudaDeviceProp &prop = state->devManager.prop;
+    //the grid is sized by the largest cutoff of any fix, not state->rCut
+    double cutoff = state->getMaxRCut() + state->padding;
+    return TuneCache::signature(nAtoms, density, cutoff, state->nPerRingPoly, prop.name, prop.major, prop.minor, fixTypes);
+}
+
+void Integrator::setTuneParams(int ntpb, int ntpa) {
+    state->nThreadPerBlock = ntpb;
+    state->nThreadPerAtom = ntpa;
+    state->gridGPU.nThreadPerBlock(ntpb);
+    state->gridGPU.nThreadPerAtom(ntpa);
+    state->gridGPU.initArraysTune();
+    for (auto fix : state->fixes) {
+        fix->takeStateNThreadPerBlock(ntpb);
+        fix->takeStateNThreadPerAtom(ntpa);
+    }
+}
+
 double Integrator::tune() {
     auto startTune = std::chrono::high_resolution_clock::now();
 
@@ -313,82 +438,97 @@ double Integrator::tune() {
     int nForceEvals = 30;
     //estimating how many times we should build nlists for good estimate
     int nNlistBuilds = round(nForceEvals * nlistBuildFrac);
+    int nAtoms = state->atoms.size();
 
-    auto setParams = [this] (int ntpb, int ntpa) {
-        state->nThreadPerBlock = ntpb;
-        state->nThreadPerAtom = ntpa;
-        state->gridGPU.nThreadPerBlock(ntpb);
-        state->gridGPU.nThreadPerAtom(ntpa);
-        state->gridGPU.initArraysTune();
-        for (auto fix : state->fixes) {
-            fix->takeStateNThreadPerBlock(ntpb);
-            fix->takeStateNThreadPerAtom(ntpa);
+    auto timeParams = [&] (int ntpb, int ntpa) {
+        setTuneParams(ntpb, ntpa);
+        state->gridGPU.periodicBoundaryConditions(-1, true);
+        state->nlistBuildCount--;
+        cudaDeviceSynchronize();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int k=0; k<nNlistBuilds; k++) {
+            state->gridGPU.periodicBoundaryConditions(-1, true);
+            state->nlistBuildCount--;
+        }
+        for (int k=0; k<nForceEvals; k++) {
+            force(false);
         }
+        cudaDeviceSynchronize();
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        return duration.count();
     };
 
 	int curNTPB = state->nThreadPerBlock;
 	int curNTPA = state->nThreadPerAtom;
-    vector<vector<double> > times;
-    //REMEMBER TO MAKE COPY OF FORCES AND SET THEM BACK AFTER THIS;
-    for (int i=0; i<threadPerBlocks.size(); i++) {
-        vector<double> timesWithBlock;
-        for (int j=0; j<threadPerAtoms.size(); j++) {
-            int threadPerBlock = threadPerBlocks[i];
-            int threadPerAtom = threadPerAtoms[j];
-
-            int nBlock = NBLOCKTEAM(state->atoms.size(), threadPerBlock, threadPerAtom);
-            if (nBlock < 65536) {
-                setParams(threadPerBlock, threadPerAtom);
-                state->gridGPU.periodicBoundaryConditions(-1, true);
-                state->nlistBuildCount--;
-                cudaDeviceSynchronize();
-                auto start = std::chrono::high_resolution_clock::now();
-                for (int k=0; k<nNlistBuilds; k++) {
-                    state->gridGPU.periodicBoundaryConditions(-1, true);
-                    state->nlistBuildCount--;
-                }
-                for (int k=0; k<nForceEvals; k++) {
-                    force(false);
+    //the builds made while timing say nothing about the run
+    NeighborListStats *stats = state->gridGPU.stats;
+    state->gridGPU.stats = nullptr;
+
+    TuneCache cache(state->tuneCacheFile);
+    std::string signature = tuneSignature();
+    TuneCache::Entry cached;
+    bool haveTuned = false;
+    if (cache.lookup(signature, cached)) {
+        double timePerAtomEval = timeParams(cached.nThreadPerBlock, cached.nThreadPerAtom) / (nForceEvals * nAtoms);
+        if (timePerAtomEval <= cached.timePerAtomEval * (1 + state->tuneCacheTolerance)) {
+            haveTuned = true;
+        } else {
+            mdMessage("Cached runtime parameters (%d, %d) have slowed from %e to %e s per atom per force evaluation, re-tuning\n",
+                      cached.nThreadPerBlock, cached.nThreadPerAtom, cached.timePerAtomEval, timePerAtomEval);
+        }
+    }
+
+    if (not haveTuned) {
+        vector<vector<double> > times;
+        //REMEMBER TO MAKE COPY OF FORCES AND SET THEM BACK AFTER THIS;
+        for (int i=0; i<threadPerBlocks.size(); i++) {
+            vector<double> timesWithBlock;
+            for (int j=0; j<threadPerAtoms.size(); j++) {
+                int threadPerBlock = threadPerBlocks[i];
+                int threadPerAtom = threadPerAtoms[j];
+
+                int nBlock = NBLOCKTEAM(nAtoms, threadPerBlock, threadPerAtom);
+                if (nBlock < 65536) {
+                    timesWithBlock.push_back(timeParams(threadPerBlock, threadPerAtom));
+                } else {
+                    timesWithBlock.push_back(DBL_MAX);
                 }
-                cudaDeviceSynchronize();
-                auto end = std::chrono::high_resolution_clock::now();
-                std::chrono::duration<double> duration = end - start;
-                timesWithBlock.push_back(duration.count());
-            } else {
-                timesWithBlock.push_back(DBL_MAX);
             }
+            times.push_back(timesWithBlock);
         }
-        times.push_back(timesWithBlock);
-    }
 
-    double bestTime = times[0][0];
-    int bestNTPB, bestNTPA;
-    bestNTPB = 0;
-    bestNTPA = 0;
-    
-    
-    
-    for (int i=0; i<threadPerBlocks.size(); i++) {
-        for (int j=0; j<threadPerAtoms.size(); j++) {
-            if (times[i][j] < bestTime) {
-                bestNTPB=threadPerBlocks[i];
-                bestNTPA=threadPerAtoms[j];
-                bestTime = times[i][j];
+        double bestTime = times[0][0];
+        int bestNTPB, bestNTPA;
+        bestNTPB = threadPerBlocks[0];
+        bestNTPA = threadPerAtoms[0];
+        
+        
+        
+        for (int i=0; i<threadPerBlocks.size(); i++) {
+            for (int j=0; j<threadPerAtoms.size(); j++) {
+                if (times[i][j] < bestTime) {
+                    bestNTPB=threadPerBlocks[i];
+                    bestNTPA=threadPerAtoms[j];
+                    bestTime = times[i][j];
+                }
             }
         }
+        cached = TuneCache::Entry(bestNTPB, bestNTPA, bestTime / (nForceEvals * nAtoms));
+        cache.store(signature, cached);
     }
-    setParams(bestNTPB, bestNTPA);
-	if (bestNTPB != curNTPB or bestNTPA != curNTPA) {
-		printf("Optimized runtime parameters from (%d, %d) to (%d, %d)\n", curNTPB, curNTPA, bestNTPB, bestNTPA);
+    setTuneParams(cached.nThreadPerBlock, cached.nThreadPerAtom);
+	if (cached.nThreadPerBlock != curNTPB or cached.nThreadPerAtom != curNTPA) {
+		printf("Optimized runtime parameters from (%d, %d) to (%d, %d)\n", curNTPB, curNTPA, cached.nThreadPerBlock, cached.nThreadPerAtom);
 	}
 
     state->gridGPU.periodicBoundaryConditions(-1, true);
     state->nlistBuildCount--;
-    //then pick best one
+    state->gridGPU.stats = stats;
 
 
     //zero forces that you calculated here
-    zeroVectorPreserveW<<<NBLOCKVAR(state->atoms.size(), state->nThreadPerBlock), state->nThreadPerBlock>>>(state->gpd.fs.getDevData(), state->atoms.size());
+    zeroVectorPreserveW<<<NBLOCKVAR(nAtoms, state->nThreadPerBlock), state->nThreadPerBlock>>>(state->gpd.fs.getDevData(), nAtoms);
     auto endTune = std::chrono::high_resolution_clock::now();
 
     std::chrono::duration<double> durationTune = endTune - startTune;
@@ -401,6 +541,10 @@ void export_Integrator() {
         "Integrator"
     )
     .def("writeOutput", &Integrator::writeOutput)
+    .def("timings", &Integrator::timings)
+    .def("writeTimings", &Integrator::writeTimings, (boost::python::arg("fn")))
+    .def_readwrite("timingInterval", &Integrator::timingInterval)
+    .def_readwrite("timingFile", &Integrator::timingFile)
    // .def("energyAverage", &Integrator::singlePointEngPythonAvg,
     //        (boost::python::arg("groupHandle")="all")
     //    )
@@ -5,6 +5,7 @@
 #undef _XOPEN_SOURCE
 #undef _POSIX_C_SOURCE
 #include <boost/python/list.hpp>
+#include <boost/python/dict.hpp>
 #include <string>
 #include <vector>
 #include "IntegratorUtil.h"
@@ -88,12 +89,49 @@ protected:
     void setActiveData();
 
     //set runtime tunable parameters for performance
+    /*!
+     * \return Seconds spent tuning
+     *
+     * If state->tuneCacheFile names a cache holding an entry for this
+     * system, only the cached parameters are timed.  They are kept unless
+     * they have become more than state->tuneCacheTolerance slower than when
+     * they were cached, in which case the full sweep runs and the entry is
+     * replaced.
+     */
     double tune();
 
+    //! Key identifying this system in the tuning cache
+    /*!
+     * Built from the atom count and density (in logarithmic buckets), the
+     * largest cutoff of any fix plus padding, ring polymer size, the types of
+     * active fixes, and the device name and compute capability.  See
+     * TuneCache::signature.
+     */
+    std::string tuneSignature();
+
+    //! Set thread counts on the state, grid, and fixes
+    void setTuneParams(int nThreadPerBlock, int nThreadPerAtom);
+
+    //! Signature whose cached parameters were last applied in basicPrepare
+    std::string tunedSignature;
+
 
     // checks that all fixes now register as 'prepared'
     void verifyPrepared();
 
+    //! Reset timers for a run and register the per-fix phases
+    /*!
+     * \param hookPhases Phase id for each FIXHOOK
+     */
+    void prepareTimers(const int hookPhases[HOOK_COUNT]);
+
+    //! Close out the timers after a run and write timingFile if set
+    void finishTimers(int numTurns, double runtime);
+
+    int timedTurns; //!< Turns in the last timed run
+    double timedRuntime; //!< Wall time of the last timed run
+    int timedNlistBuilds; //!< Neighbor list builds in the last timed run
+
 public:
     //! Calculate and return single point energy
     /*!
@@ -120,7 +158,7 @@ public:
     /*!
      * \todo Do we need a default constructor?
      */
-    Integrator() {};
+    Integrator() : timingInterval(0), timedTurns(0), timedRuntime(0), timedNlistBuilds(0) {};
 
     //! Constructor
     /*!
@@ -135,6 +173,18 @@ public:
 
     //! Write output for all \link WriteConfig WriteConfigs \endlink
     void writeOutput();
+
+    int timingInterval; //!< Time loop phases every this many turns.  0 (default) disables
+    std::string timingFile; //!< If set, a JSON summary of each timed run is appended here
+
+    //! Estimated time per phase of the last run, as nested dicts
+    boost::python::dict timings();
+
+    //! Timings of the last run as a JSON object
+    std::string timingsJSON();
+
+    //! Write timingsJSON() to a file
+    void writeTimings(std::string fn);
     float dtf;
 };
 
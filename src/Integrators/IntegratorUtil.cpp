@@ -8,11 +8,33 @@
 #include <vector>
 #include "Mod.h"
 using namespace MD_ENGINE;
-IntegratorUtil::IntegratorUtil(State *state_) {
+IntegratorUtil::IntegratorUtil(State *state_) : timers(new PhaseTimers()), hookPhases{-1, -1, -1, -1, -1}, timerGeneration(-1) {
     state = state_;
 }
 
+void IntegratorUtil::prepareFixTimers(const int hookPhases_[HOOK_COUNT]) {
+    // unique across integrators, since each has its own timers
+    static int generations = 0;
+    timerGeneration = generations++;
+    for (int hook=0; hook<HOOK_COUNT; hook++) {
+        hookPhases[hook] = hookPhases_[hook];
+    }
+    for (Fix *f : state->fixes) {
+        registerFixTimers(f);
+    }
+}
+
+void IntegratorUtil::registerFixTimers(Fix *f) {
+    f->timerPhases.resize(HOOK_COUNT);
+    for (int hook=0; hook<HOOK_COUNT; hook++) {
+        f->timerPhases[hook] = timers->phase(f->handle, hookPhases[hook]);
+    }
+    f->timerGeneration = timerGeneration;
+}
+
 void IntegratorUtil::force(int virialMode) {
+    // forces rewrite the virials, and some fixes change velocities here
+    state->dataManager.reductions.invalidate();
     int simTurn = state->turn;
     std::vector<Fix *> &fixes = state->fixes;
     //okay - things with order pref == -1 are pair forces.  They for first.  Afterwards, we compute f dot r if necessary, then do the rest
@@ -23,13 +45,19 @@ void IntegratorUtil::force(int virialMode) {
            //     Mod::FDotR(state);
            //     computedFDotR = true;
            // }
+            startFixTimer(HOOK_FORCE, f);
+            state->skinController.beforeFix(f);
             f->compute(virialMode);
             f->setVirialTurn();
+            state->skinController.afterFix(f);
+            stopFixTimer(HOOK_FORCE, f);
         }
     }
 };
 
 void IntegratorUtil::forceInitial(int virialMode) {
+    // forces rewrite the virials, and some fixes change velocities here
+    state->dataManager.reductions.invalidate();
     int simTurn = state->turn;
     std::vector<Fix *> &fixes = state->fixes;
     //okay - things with order pref == -1 are pair forces.  They for first.  Afterwards, we compute f dot r if necessary, then do the rest
@@ -53,7 +81,10 @@ void IntegratorUtil::postNVE_V() {
     std::vector<Fix *> &fixes = state->fixes;
     for (Fix *f : fixes) {
         if (f->willFire(simTurn)) {
+            state->dataManager.reductions.invalidate();
+            startFixTimer(HOOK_POSTNVE_V, f);
             f->postNVE_V();
+            stopFixTimer(HOOK_POSTNVE_V, f);
         }
     }
 }
@@ -63,7 +94,10 @@ void IntegratorUtil::postNVE_X() {
     std::vector<Fix *> &fixes = state->fixes;
     for (Fix *f : fixes) {
         if (f->willFire(simTurn)) {
+            state->dataManager.reductions.invalidate();
+            startFixTimer(HOOK_POSTNVE_X, f);
             f->postNVE_X();
+            stopFixTimer(HOOK_POSTNVE_X, f);
         }
     }
 }
@@ -80,6 +114,8 @@ void IntegratorUtil::singlePointEng() {
 */
 
 void IntegratorUtil::forceSingle(int virialMode) {
+    // forces rewrite the virials, and some fixes change velocities here
+    state->dataManager.reductions.invalidate();
     for (Fix *f : state->fixes) {
         if (f->forceSingle and f->willFire(state->turn)) {
             f->compute(virialMode);
@@ -95,7 +131,7 @@ void IntegratorUtil::doDataComputation() {
     bool computedAny = false;
     bool requireIds = false;
     for (boost::shared_ptr<DataSetUser> ds : dm.dataSets) {
-        if (ds->nextCompute == turn and ds->computer->computeMode == "vector") {
+        if (ds->nextCompute == turn and ds->computer->requiresIds) {
             requireIds = true;
         }
     }
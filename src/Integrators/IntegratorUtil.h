@@ -3,13 +3,51 @@
 #define INTEGRATOR_UTIL_H
 //so this class exists because integrators are not members of the class, but sometimes the state needs to internally call some things have to do with integration, like calculating energies.  
 //The state has one of these classes.  Its methods are agnostic to integrator
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "PhaseTimers.h"
+#include "Fix.h"
 class State;
 
+//! Fix hooks which are timed per fix
+enum FIXHOOK {HOOK_STEPINIT, HOOK_POSTNVE_V, HOOK_POSTNVE_X, HOOK_FORCE, HOOK_STEPFINAL, HOOK_COUNT};
+
 class IntegratorUtil {
 public:
     IntegratorUtil(State *);
-    IntegratorUtil(){};
+    IntegratorUtil() : timers(new PhaseTimers()), hookPhases{-1, -1, -1, -1, -1}, timerGeneration(-1) {};
     State *state;
+
+    boost::shared_ptr<PhaseTimers> timers; //!< Timing of the phases of the run loop
+    int hookPhases[HOOK_COUNT]; //!< Phase each hook's fix phases are nested under
+    int timerGeneration; //!< Stamp fixes' cached timerPhases are checked against
+
+    //! Register a phase for every fix under the phase of each hook
+    /*!
+     * \param hookPhases_ Phase id for each FIXHOOK
+     */
+    void prepareFixTimers(const int hookPhases_[HOOK_COUNT]);
+
+    //! Register f's phases and cache their ids in the fix
+    /*!
+     * Called from prepareFixTimers, and for fixes activated mid-run by python
+     * operations or cached by another integrator
+     */
+    void registerFixTimers(Fix *f);
+
+    inline void startFixTimer(FIXHOOK hook, Fix *f) {
+        if (timers->enabled()) {
+            if (f->timerGeneration != timerGeneration) {
+                registerFixTimers(f);
+            }
+            timers->start(f->timerPhases[hook]);
+        }
+    }
+    inline void stopFixTimer(FIXHOOK hook, Fix *f) {
+        if (timers->enabled()) {
+            timers->stop(f->timerPhases[hook]);
+        }
+    }
     //! Calculate force for all fixes
     /*!
      * \param computeVirials Compute virials for all forces if True
@@ -594,7 +594,32 @@ double IntegratorVerlet::run(int numTurns)
 
     verifyPrepared();
 
-    int periodicInterval = state->periodicInterval;
+    SkinController &skin = state->skinController;
+    skin.prepare(state);
+
+    PhaseTimers &t = *timers;
+    int tNlist = t.phase("neighborList");
+    int tStepInit = t.phase("stepInit");
+    int tIntegrate = t.phase("integrate");
+    int tNVE_V = t.phase("nve_v");
+    int tNVE_X = t.phase("nve_x");
+    int tPostNVE_V = t.phase("postNVE_V");
+    int tPostNVE_X = t.phase("postNVE_X");
+    int tBoundsChange = t.phase("boundsChange");
+    int tTune = t.phase("tune");
+    int tForce = t.phase("force");
+    int tPostForce = t.phase("postForce");
+    int tStepFinal = t.phase("stepFinal");
+    int tDataComputation = t.phase("dataComputation");
+    int tDataAppending = t.phase("dataAppending");
+    int tHostOperations = t.phase("hostOperations");
+    int hookPhases[HOOK_COUNT];
+    hookPhases[HOOK_STEPINIT] = tStepInit;
+    hookPhases[HOOK_POSTNVE_V] = tPostNVE_V;
+    hookPhases[HOOK_POSTNVE_X] = tPostNVE_X;
+    hookPhases[HOOK_FORCE] = tForce;
+    hookPhases[HOOK_STEPFINAL] = tStepFinal;
+    prepareTimers(hookPhases);
 	
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -604,52 +629,93 @@ double IntegratorVerlet::run(int numTurns)
     bool haveTunedWithData = false;
     double timeTune = 0;
     for (int i=0; i<numTurns; ++i) {
-
-        if (state->turn % periodicInterval == 0 or state->turn == state->nextForceBuild) {
-            state->gridGPU.periodicBoundaryConditions();
+        t.beginStep(i);
+
+        t.start(tNlist);
+        // the controller may change the padding, which needs a new list, or the interval
+        bool paddingChanged = skin.beginStep();
+        if (paddingChanged or state->turn % state->periodicInterval == 0 or state->turn == state->nextForceBuild) {
+            skin.beforeCheck();
+            state->gridGPU.periodicBoundaryConditions(-1, paddingChanged);
+            skin.afterCheck();
         }
+        t.stop(tNlist);
 
         int virialMode = dataManager.getVirialModeForTurn(state->turn);
 
+        t.start(tStepInit);
         stepInit(virialMode==1 or virialMode==2);
+        t.stop(tStepInit);
 
         // Perform first half of velocity-Verlet step
+        // each phase is entered at most once per step, so the fused and split
+        // half steps are timed separately
         if (state->requiresPostNVE_V) {
+            t.start(tNVE_V);
             nve_v();
+            t.stop(tNVE_V);
+            t.start(tPostNVE_V);
             postNVE_V();
+            t.stop(tPostNVE_V);
+            t.start(tNVE_X);
             nve_x();
+            t.stop(tNVE_X);
         } else {
+            t.start(tIntegrate);
             preForce();
+            t.stop(tIntegrate);
         }
+        t.start(tPostNVE_X);
         postNVE_X();
+        t.stop(tPostNVE_X);
         //printf("preForce IS COMMENTED OUT\n");
 
+        t.start(tBoundsChange);
         handleBoundsChange();
+        t.stop(tBoundsChange);
 
         if ((state->turn-state->runInit) % tuneEvery == 0 and state->turn > state->runInit) {
             //this goes here because forces are zero at this point.  I don't need to save any forces this way
+            t.start(tTune);
             timeTune += tune();
+            t.stop(tTune);
         } else if (not haveTunedWithData and state->turn-state->runInit < tuneEvery and state->nlistBuildCount > 20) {
+            t.start(tTune);
             timeTune += tune();
+            t.stop(tTune);
             haveTunedWithData = true;
         }
 
         // Recalculate forces
+        t.start(tForce);
+        skin.beforeForce();
         force(virialMode);
+        skin.afterForce();
+        t.stop(tForce);
 
         //quits if ctrl+c has been pressed
         checkQuit();
 
         // Perform second half of velocity-Verlet step
+        t.start(tPostForce);
         postForce();
+        t.stop(tPostForce);
 
+        t.start(tStepFinal);
         stepFinal();
+        t.stop(tStepFinal);
 
         //HEY - MAKE DATA APPENDING HAPPEN WHILE SOMETHING IS GOING ON THE GPU.  
+        t.start(tDataComputation);
         doDataComputation();
+        t.stop(tDataComputation);
+        t.start(tDataAppending);
         doDataAppending();
+        t.stop(tDataAppending);
         dataManager.clearVirialTurn(state->turn);
+        t.start(tHostOperations);
         asyncOperations();
+        t.stop(tHostOperations);
 
         //! \todo The following parts could also be moved into stepFinal
         state->turn++;
@@ -666,6 +732,14 @@ double IntegratorVerlet::run(int numTurns)
     double ptsps = state->atoms.size()*numTurns / (duration.count() - timeTune);
     mdMessage("runtime %f\n%e particle timesteps per second\n",
               duration.count(), ptsps);
+    if (state->hostOperationCount) {
+        mdMessage("host operations %d, waited for a free buffer %d times, stall time %f\n",
+                  state->hostOperationCount, state->hostOperationStalls,
+                  state->hostOperationStallTime);
+    }
+
+    finishTimers(numTurns, duration.count());
+    skin.finish();
 
     basicFinish();
     return ptsps;
@@ -1,8 +1,9 @@
 #include "Interpolator.h"
 #include "Logging.h"
-enum thermoType {interval, constant, pyFunc};
+#include <algorithm>
+enum thermoType {interval, constant, pyFunc, expression};
 namespace py = boost::python;
-Interpolator::Interpolator(py::list intervals_, py::list vals_) {
+Interpolator::Interpolator(py::list intervals_, py::list vals_) : sampleEvery(1) {
     mode = thermoType::interval;
     int len = boost::python::len(intervals_);
     for (int i=0; i<len; i++) {
@@ -20,18 +21,45 @@ Interpolator::Interpolator(py::list intervals_, py::list vals_) {
     finished = false;
     mdAssert(intervals[0] == 0 and intervals.back() == 1, "Invalid intervals given to interpolator");
 }
-Interpolator::Interpolator(double val_) {
+Interpolator::Interpolator(double val_) : sampleEvery(1) {
     mode = thermoType::constant;
     constVal = val_;
     //mdAssert(constVal > 0, "Invalid value given to interpolator");
 }
-Interpolator::Interpolator(py::object valFunc_) {
+Interpolator::Interpolator(py::object valFunc_) : sampleEvery(1) {
+    py::extract<std::string> sourcePy(valFunc_);
+    if (sourcePy.check()) {
+        mode = thermoType::expression;
+        expression = ScheduleExpression(sourcePy());
+        return;
+    }
     mode = thermoType::pyFunc;
     valFunc = valFunc_;
+    samplesTurnBegin = -1;
+    samplesTurnFinish = -1;
     mdAssert(PyCallable_Check(valFunc.ptr()), "Must give callable function to interpolator");
 
 }
 
+void Interpolator::sampleFunc() {
+    int64_t nTurns = turnFinishRun - turnBeginRun;
+    int64_t minStride = (nTurns + MAX_SCHEDULE_SAMPLES - 1) / MAX_SCHEDULE_SAMPLES;
+    int64_t stride = std::max((int64_t) 1, (minStride + sampleEvery - 1) / sampleEvery) * sampleEvery;
+    //the ends of the run and the multiples of stride between them
+    samplesTurns.clear();
+    samplesTurns.push_back(turnBeginRun);
+    for (int64_t turn=(turnBeginRun / stride + 1) * stride; turn<turnFinishRun; turn+=stride) {
+        samplesTurns.push_back(turn);
+    }
+    samplesTurns.push_back(turnFinishRun);
+    samples.resize(samplesTurns.size());
+    for (size_t i=0; i<samplesTurns.size(); i++) {
+        samples[i] = py::call<double>(valFunc.ptr(), turnBeginRun, turnFinishRun, samplesTurns[i]);
+    }
+    samplesTurnBegin = turnBeginRun;
+    samplesTurnFinish = turnFinishRun;
+}
+
 
 void Interpolator::computeCurrentVal(int64_t turn) {
     if (mode == thermoType::interval) {
@@ -52,7 +80,26 @@ void Interpolator::computeCurrentVal(int64_t turn) {
     } else if (mode == thermoType::constant) {
         currentVal = constVal;
     } else if (mode == thermoType::pyFunc) {
-        currentVal = py::call<double>(valFunc.ptr(), turnBeginRun, turnFinishRun, turn);
+        if (turn < turnBeginRun or turn > turnFinishRun or turnFinishRun == turnBeginRun) {
+            currentVal = py::call<double>(valFunc.ptr(), turnBeginRun, turnFinishRun, turn);
+            return;
+        }
+        if (turnBeginRun != samplesTurnBegin or turnFinishRun != samplesTurnFinish) {
+            sampleFunc();
+        }
+        int idx = std::upper_bound(samplesTurns.begin(), samplesTurns.end(), turn) - samplesTurns.begin() - 1;
+        int64_t turnA = samplesTurns[idx];
+        if (turnA == turn) {
+            currentVal = samples[idx];
+        } else {
+            //only between samples off the turns the fix reads on, or for runs longer than MAX_SCHEDULE_SAMPLES turns
+            int64_t turnB = samplesTurns[idx+1];
+            double fracThroughSample = (turn - turnA) / (double) (turnB - turnA);
+            currentVal = samples[idx+1]*fracThroughSample + samples[idx]*(1-fracThroughSample);
+        }
+    } else if (mode == thermoType::expression) {
+        double frac = turnFinishRun == turnBeginRun ? 0 : (turn-turnBeginRun) / (double) (turnFinishRun - turnBeginRun);
+        currentVal = expression.evaluate(frac, turn, turn - turnBeginRun);
     }
 }
 
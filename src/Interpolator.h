@@ -5,6 +5,11 @@
 #include <boost/python.hpp>
 #include "BoundsGPU.h"
 #include "cutils_math.h"
+#include "ScheduleExpression.h"
+
+//! Most points a Python set point function is sampled at per run
+#define MAX_SCHEDULE_SAMPLES (1<<20)
+
 class Interpolator {
 public:
     //ONE of these three groups will be used based on thermo type
@@ -12,6 +17,23 @@ public:
     std::vector<double> vals;
 
     boost::python::object valFunc;
+    //! Values of valFunc sampled once at the start of each run, so the
+    //! function is not called from Python every turn
+    std::vector<double> samples;
+    std::vector<int64_t> samplesTurns; //!< Turn of each sample
+    int64_t samplesTurnBegin;
+    int64_t samplesTurnFinish;
+    //! Turns between set point reads of the fix using the interpolator
+    /*!
+     * A fix applied every applyEvery turns sets this to applyEvery, and
+     * valFunc is then sampled only on the multiples of it, the turns the
+     * fix reads the set point on.
+     */
+    int64_t sampleEvery;
+    void sampleFunc();
+
+    //! Compiled set point, given as a string in place of valFunc
+    ScheduleExpression expression;
 
     double constVal;
     
@@ -28,7 +50,7 @@ public:
     Interpolator(boost::python::list intervalsPy, boost::python::list valsPy);
     Interpolator(boost::python::object valFunc_);
     Interpolator(double val_);
-    Interpolator(){};
+    Interpolator() : sampleEvery(1) {};
     void computeCurrentVal(int64_t turn);
     double getCurrentVal();
     void finishRun();
@@ -125,14 +125,14 @@ __global__ void Mod::scaleSystem_cu(float4 *xs, int nAtoms, float3 lo, float3 re
 // whichever is most convenient; since this doesnt change during a given run, it doesnt matter that we 
 // have two conventions by which this can proceed.
 template <bool RIGIDBODIES>
-__global__ void Mod::scaleSystemGroup_cu(float4 *xs, int nAtoms, float3 lo, float3 rectLen, float3 scaleBy, uint32_t groupTag, float4 *fs, int* idToIdxs, int* notRigidBody) {
+__global__ void Mod::scaleSystemGroup_cu(float4 *xs, int nAtoms, float3 lo, float3 rectLen, float3 scaleBy, GroupMask group, float4 *fs, int* idToIdxs, int* notRigidBody) {
     int idx = GETIDX();
     if (idx < nAtoms) {
         if (RIGIDBODIES) {
             // we need to check that it is not a rigid body, and that it is in the group being scaled
             int newIdx = idToIdxs[idx];
             uint32_t tag = * (uint32_t *) &(fs[newIdx].w);
-            if (tag & groupTag) {
+            if (group.contains(tag, newIdx)) {
                 // idx --> id; newIdx --> idx
                 if (notRigidBody[idx]) {
             
@@ -150,7 +150,7 @@ __global__ void Mod::scaleSystemGroup_cu(float4 *xs, int nAtoms, float3 lo, floa
         } else {
             // keep it aligned by idx, and check the tag
             uint32_t tag = * (uint32_t *) &(fs[idx].w);
-            if (tag & groupTag) {
+            if (group.contains(tag, idx)) {
                 float4 posWhole = xs[idx];
                 float3 pos = make_float3(posWhole);
                 float3 center = lo + rectLen * 0.5f;
@@ -182,13 +182,13 @@ void Mod::scaleSystem(State *state, float3 scaleBy, uint32_t groupTag) {
         }
     } else if (groupTag) {
         if (state->rigidBodies) {
-            scaleSystemGroup_cu<true><<<NBLOCK(state->atoms.size()), PERBLOCK>>>(gpd.xs.getDevData(), state->atoms.size(), state->boundsGPU.lo, state->boundsGPU.rectComponents, scaleBy, groupTag, gpd.fs.getDevData(),gpd.idToIdxs.d_data.data(), state->rigidBodiesMask.d_data.data());
+            scaleSystemGroup_cu<true><<<NBLOCK(state->atoms.size()), PERBLOCK>>>(gpd.xs.getDevData(), state->atoms.size(), state->boundsGPU.lo, state->boundsGPU.rectComponents, scaleBy, state->groupMask(groupTag), gpd.fs.getDevData(),gpd.idToIdxs.d_data.data(), state->rigidBodiesMask.d_data.data());
             for (Fix *f: state->fixes)  {
                 f->scaleRigidBodies(scaleBy,groupTag); 
             }
 
         } else {
-            scaleSystemGroup_cu<false><<<NBLOCK(state->atoms.size()), PERBLOCK>>>(gpd.xs.getDevData(), state->atoms.size(), state->boundsGPU.lo, state->boundsGPU.rectComponents, scaleBy, groupTag, gpd.fs.getDevData(),gpd.idToIdxs.d_data.data(), state->rigidBodiesMask.d_data.data());
+            scaleSystemGroup_cu<false><<<NBLOCK(state->atoms.size()), PERBLOCK>>>(gpd.xs.getDevData(), state->atoms.size(), state->boundsGPU.lo, state->boundsGPU.rectComponents, scaleBy, state->groupMask(groupTag), gpd.fs.getDevData(),gpd.idToIdxs.d_data.data(), state->rigidBodiesMask.d_data.data());
         }
     }
 }
@@ -11,6 +11,7 @@ Molecule::Molecule(State *state_, std::vector<int> &ids_) {
 }
 
 void Molecule::translate(Vector &v) {
+    state->markAtomsDirty();
     for (int id : ids) {
         Atom &a = state->idToAtom(id);
         a.pos += v;
@@ -23,6 +24,7 @@ void Molecule::rotate(Vector axis, double theta) {
     rot = ax;
     Vector com = COM();
     Eigen::Vector3d comEig= {com[0], com[1], com[2]};
+    state->markAtomsDirty();
     for (int id : ids) {
         Atom &a = state->idToAtom(id);
         Eigen::Vector3d posEig = {a.pos[0], a.pos[1], a.pos[2]};
@@ -70,6 +72,7 @@ void Molecule::unwrap() {
     double sumMass = 0;
     Vector firstPos = state->idToAtom(ids[0]).pos;
     Bounds bounds = state->bounds;
+    state->markAtomsDirty();
     for (int id : ids) {
 		int idx = state->idToIdx[id];
 		Atom &a = state->atoms[idx];
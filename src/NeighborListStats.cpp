@@ -0,0 +1,143 @@
+#include "NeighborListStats.h"
+
+#include <cstdio>
+
+#include <boost/python.hpp>
+
+namespace py = boost::python;
+
+NeighborListStats::NeighborListStats() : sampleInterval(10) {
+    clear();
+}
+
+void NeighborListStats::reset() {
+    clear();
+    //allocated here rather than in the constructor, once the device is chosen
+    if (not sums.d_data.size()) {
+        sums = GPUArrayGlobal<unsigned long long>(4);
+        histogram = GPUArrayGlobal<uint32_t>(nBins + 1);
+    }
+    sums.d_data.memset(0);
+    histogram.d_data.memset(0);
+}
+
+void NeighborListStats::clear() {
+    checks = 0;
+    builds = 0;
+    forcedBuilds = 0;
+    dangerousBuilds = 0;
+    sampledBuilds = 0;
+    listSlots = 0;
+    listCapacity = 0;
+    buildIntervals.clear();
+    lastBuildTurn = -1;
+    countsCurrent = false;
+}
+
+void NeighborListStats::recordCheck() {
+    checks++;
+}
+
+bool NeighborListStats::recordBuild(int64_t turn, bool forced, bool dangerous) {
+    if (not forced and lastBuildTurn >= 0) {
+        buildIntervals[(int) (turn - lastBuildTurn)]++;
+    }
+    lastBuildTurn = turn;
+    forcedBuilds += forced;
+    dangerousBuilds += dangerous;
+    bool sample = sampleInterval > 0 and builds % sampleInterval == 0;
+    builds++;
+    if (sample) {
+        sampledBuilds++;
+        countsCurrent = false;
+    }
+    return sample;
+}
+
+void NeighborListStats::recordLayout(int slots, int capacity) {
+    listSlots += slots;
+    listCapacity += capacity;
+}
+
+void NeighborListStats::countsToHost() {
+    if (not sums.d_data.size()) {
+        //no run yet
+        sums.h_data = std::vector<unsigned long long>(4, 0);
+        histogram.h_data = std::vector<uint32_t>(nBins + 1, 0);
+    } else if (not countsCurrent) {
+        sums.dataToHost();
+        histogram.dataToHost();
+        cudaDeviceSynchronize();
+        countsCurrent = true;
+    }
+}
+
+py::dict NeighborListStats::asDict() {
+    countsToHost();
+    unsigned long long neighbors = sums.h_data[0];
+    unsigned long long inCutoff = sums.h_data[1];
+    unsigned long long atoms = sums.h_data[2];
+    py::dict d;
+    d["checks"] = checks;
+    d["builds"] = builds;
+    d["forcedBuilds"] = forcedBuilds;
+    d["dangerousBuilds"] = dangerousBuilds;
+    d["sampledBuilds"] = sampledBuilds;
+    d["meanNeighbors"] = atoms ? (double) neighbors / atoms : 0.0;
+    d["maxNeighbors"] = histogram.h_data[nBins];
+    //fraction of listed pairs inside the cutoff; the rest are in the padding
+    d["cutoffFraction"] = neighbors ? (double) inCutoff / neighbors : 0.0;
+    //fraction of laid-out list entries which hold a neighbor, and of the allocation laid out
+    d["slotOccupancy"] = listSlots ? neighbors / listSlots : 0.0;
+    d["capacityOccupancy"] = listCapacity ? listSlots / listCapacity : 0.0;
+    py::list hist;
+    for (int i=0; i<nBins; i++) {
+        hist.append(histogram.h_data[i]);
+    }
+    d["neighborHistogram"] = hist;
+    d["histogramBinWidth"] = (int) binWidth;
+    py::dict intervals;
+    int64_t nIntervals = 0;
+    double intervalSum = 0;
+    for (auto &entry : buildIntervals) {
+        intervals[entry.first] = entry.second;
+        nIntervals += entry.second;
+        intervalSum += (double) entry.first * entry.second;
+    }
+    d["buildIntervals"] = intervals;
+    d["meanBuildInterval"] = nIntervals ? intervalSum / nIntervals : 0.0;
+    return d;
+}
+
+std::string NeighborListStats::summary() {
+    countsToHost();
+    unsigned long long neighbors = sums.h_data[0];
+    unsigned long long atoms = sums.h_data[2];
+    int64_t nIntervals = 0;
+    double intervalSum = 0;
+    for (auto &entry : buildIntervals) {
+        nIntervals += entry.second;
+        intervalSum += (double) entry.first * entry.second;
+    }
+    char line[256];
+    snprintf(line, sizeof(line),
+             "Neighbor list: %lld builds (%lld dangerous) in %lld checks, %.1f turns between builds, "
+             "%.1f neighbors per atom (max %u), %.0f%% inside the cutoff",
+             (long long) builds, (long long) dangerousBuilds, (long long) checks,
+             nIntervals ? intervalSum / nIntervals : 0.0,
+             atoms ? (double) neighbors / atoms : 0.0, histogram.h_data[nBins],
+             neighbors ? 100.0 * sums.h_data[1] / neighbors : 0.0);
+    return std::string(line);
+}
+
+void export_NeighborListStats() {
+    py::class_<NeighborListStats, boost::noncopyable>("NeighborListStats", py::no_init)
+        .def_readwrite("sampleInterval", &NeighborListStats::sampleInterval)
+        .def_readonly("checks", &NeighborListStats::checks)
+        .def_readonly("builds", &NeighborListStats::builds)
+        .def_readonly("forcedBuilds", &NeighborListStats::forcedBuilds)
+        .def_readonly("dangerousBuilds", &NeighborListStats::dangerousBuilds)
+        .def("asDict", &NeighborListStats::asDict)
+        .def("summary", &NeighborListStats::summary)
+        ;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef NEIGHBORLISTSTATS_H
+#define NEIGHBORLISTSTATS_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python/dict.hpp>
+
+#include "GPUArrayGlobal.h"
+
+void export_NeighborListStats();
+
+//! Health of the neighbor list over a run
+/*!
+ * The grid reports every displacement check and rebuild here.  Rebuild
+ * intervals and dangerous builds are counted on every build.  Neighbor counts
+ * are sampled on every sampleInterval-th build by a kernel which accumulates
+ * into device arrays, so nothing is copied back until the statistics are read.
+ *
+ * A build is dangerous if some atom had already moved more than half the
+ * padding a step before the check that caught it, estimated from its current
+ * displacement and velocity.  Pairs may have been missed on such steps; if
+ * they are common, check more often (State::periodicInterval) or increase
+ * State::padding.
+ */
+class NeighborListStats {
+public:
+    static const int nBins = 128;   //!< Bins of the neighbors-per-atom histogram
+    static const int binWidth = 4;  //!< Neighbors per bin.  The last bin holds all the rest
+
+    int sampleInterval; //!< Sample neighbor counts every this many builds.  Zero disables
+
+    int64_t checks;          //!< Displacement checks, including those which built
+    int64_t builds;          //!< Builds, including forced ones
+    int64_t forcedBuilds;    //!< Builds requested without a displacement check
+    int64_t dangerousBuilds; //!< See class description
+    int64_t sampledBuilds;   //!< Builds whose neighbor counts were sampled
+    double listSlots;        //!< Sum over sampled builds of neighbor list entries laid out
+    double listCapacity;     //!< Sum over sampled builds of allocated neighbor list size
+    std::map<int, int64_t> buildIntervals; //!< Turns between builds -> number of times
+
+    //! Sums over sampled builds of neighbors, neighbors inside the cutoff
+    //! and atoms
+    GPUArrayGlobal<unsigned long long> sums;
+    //! Neighbors per atom over sampled builds, followed by the largest count
+    GPUArrayGlobal<uint32_t> histogram;
+
+    NeighborListStats();
+
+    //! Zero everything for a new run
+    void reset();
+
+    void recordCheck();
+
+    //! Record a build at turn
+    /*!
+     * \return True if this build should be sampled
+     */
+    bool recordBuild(int64_t turn, bool forced, bool dangerous);
+
+    //! Record the list layout of a sampled build
+    void recordLayout(int slots, int capacity);
+
+    //! Statistics of the run so far, as a python dict
+    boost::python::dict asDict();
+
+    //! One-line summary of the run so far
+    std::string summary();
+
+private:
+    int64_t lastBuildTurn;
+    bool countsCurrent; //!< Host copies of sums and histogram are up to date
+    void clear();
+    void countsToHost();
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "PhaseTimers.h"
+
+namespace py = boost::python;
+
+PhaseTimers::~PhaseTimers() {
+    for (Phase &p : phases) {
+        if (p.startEvent) {
+            cudaEventDestroy(p.startEvent);
+            cudaEventDestroy(p.stopEvent);
+        }
+    }
+}
+
+int PhaseTimers::phase(const std::string &name, int parent) {
+    for (int i=0; i<phases.size(); i++) {
+        if (phases[i].parent == parent and phases[i].name == name) {
+            return i;
+        }
+    }
+    phases.push_back(Phase(name, parent));
+    if (interval) {
+        CUCHECK(cudaEventCreate(&phases.back().startEvent));
+        CUCHECK(cudaEventCreate(&phases.back().stopEvent));
+    }
+    return phases.size() - 1;
+}
+
+void PhaseTimers::reset(int interval_, TraceRecorder *tracer_) {
+    interval = interval_ > 0 ? interval_ : 0;
+    tracer = tracer_;
+    sampling = false;
+    for (Phase &p : phases) {
+        p.calls = 0;
+        p.hostSamples = 0;
+        p.deviceSamples = 0;
+        p.hostTime = 0;
+        p.deviceTime = 0;
+        p.pending = false;
+        p.sampled = false;
+        if (interval and not p.startEvent) {
+            CUCHECK(cudaEventCreate(&p.startEvent));
+            CUCHECK(cudaEventCreate(&p.stopEvent));
+        }
+    }
+}
+
+void PhaseTimers::beginStep(int64_t step) {
+    if (not interval) {
+        return;
+    }
+    sampling = step % interval == 0;
+    if (sampling) {
+        readEvents();
+    }
+}
+
+void PhaseTimers::finish() {
+    if (interval) {
+        readEvents();
+    }
+    sampling = false;
+    tracer = nullptr;
+}
+
+void PhaseTimers::readEvents() {
+    for (Phase &p : phases) {
+        if (p.pending) {
+            //recorded a full interval ago, so this almost never waits
+            CUCHECK(cudaEventSynchronize(p.stopEvent));
+            float ms;
+            CUCHECK(cudaEventElapsedTime(&ms, p.startEvent, p.stopEvent));
+            p.deviceTime += ms * 1e-3;
+            p.deviceSamples++;
+            p.pending = false;
+        }
+    }
+}
+
+py::dict PhaseTimers::childrenAsDict(int parent) {
+    py::dict children;
+    for (int i=0; i<phases.size(); i++) {
+        Phase &p = phases[i];
+        if (p.parent != parent or not p.calls) {
+            continue;
+        }
+        py::dict entry;
+        entry["calls"] = p.calls;
+        entry["hostTime"] = p.hostSamples ? p.hostTime / p.hostSamples * p.calls : 0.0;
+        entry["deviceTime"] = p.deviceSamples ? p.deviceTime / p.deviceSamples * p.calls : 0.0;
+        py::dict grandchildren = childrenAsDict(i);
+        if (py::len(grandchildren)) {
+            entry["phases"] = grandchildren;
+        }
+        children[p.name] = entry;
+    }
+    return children;
+}
+
+py::dict PhaseTimers::asDict() {
+    return childrenAsDict(-1);
+}
+
+void PhaseTimers::childrenAsJSON(int parent, std::ostringstream &out) {
+    out << "{";
+    bool first = true;
+    for (int i=0; i<phases.size(); i++) {
+        Phase &p = phases[i];
+        if (p.parent != parent or not p.calls) {
+            continue;
+        }
+        //phase names are fix handles and fixed labels, but escape quotes regardless
+        std::string name;
+        for (char c : p.name) {
+            if (c == '"' or c == '\\') {
+                name += '\\';
+            }
+            name += c;
+        }
+        out << (first ? "" : ", ") << "\"" << name << "\": {"
+            << "\"calls\": " << p.calls
+            << ", \"hostTime\": " << (p.hostSamples ? p.hostTime / p.hostSamples * p.calls : 0.0)
+            << ", \"deviceTime\": " << (p.deviceSamples ? p.deviceTime / p.deviceSamples * p.calls : 0.0);
+        bool hasChildren = false;
+        for (Phase &c : phases) {
+            if (&c != &p and c.parent == i and c.calls) {
+                hasChildren = true;
+                break;
+            }
+        }
+        if (hasChildren) {
+            out << ", \"phases\": ";
+            childrenAsJSON(i, out);
+        }
+        out << "}";
+        first = false;
+    }
+    out << "}";
+}
+
+std::string PhaseTimers::asJSON() {
+    std::ostringstream out;
+    out.precision(6);
+    childrenAsJSON(-1, out);
+    return out.str();
+}
@@ -0,0 +1,137 @@
+#pragma once
+#ifndef PHASETIMERS_H
+#define PHASETIMERS_H
+
+#include <stdint.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python/dict.hpp>
+
+#include "globalDefs.h"
+#include "TraceRecorder.h"
+
+//! Hierarchical timers for the phases of the integration loop
+/*!
+ * Phases are registered once per run and then started and stopped by id,
+ * so the loop never does a string lookup.  Every call is counted, but only
+ * every interval-th step is timed.  Timed steps record both host wall time
+ * and device time, the latter with a pair of CUDA events per phase which
+ * are read back when the next timed step begins, long after they have
+ * completed.  Totals are estimated as the mean time of the sampled calls
+ * times the number of calls.
+ *
+ * If given a TraceRecorder, every call is also recorded as a trace event,
+ * whether or not timing is on.
+ */
+class PhaseTimers {
+public:
+    //! A timed region, nested under its parent
+    class Phase {
+    public:
+        std::string name;
+        int parent;          //!< Index of the enclosing phase, -1 at the top
+        int64_t calls;       //!< Calls during the run
+        int64_t hostSamples; //!< Calls whose host time was measured
+        int64_t deviceSamples; //!< Calls whose device time was measured
+        double hostTime;     //!< Sum of measured host times, seconds
+        double deviceTime;   //!< Sum of measured device times, seconds
+        bool pending;        //!< Events recorded but not yet read
+        bool sampled;        //!< Current call is being timed
+        cudaEvent_t startEvent;
+        cudaEvent_t stopEvent;
+        std::chrono::high_resolution_clock::time_point hostStart;
+        Phase(std::string name_, int parent_)
+            : name(name_), parent(parent_), calls(0), hostSamples(0), deviceSamples(0),
+              hostTime(0), deviceTime(0), pending(false), sampled(false),
+              startEvent(nullptr), stopEvent(nullptr) {}
+    };
+
+    PhaseTimers() : interval(0), sampling(false), tracer(nullptr) {}
+    ~PhaseTimers();
+
+    //! Find or create the phase called name under parent
+    /*!
+     * \return Id to pass to start() and stop()
+     */
+    int phase(const std::string &name, int parent=-1);
+
+    //! Zero all counts and set the sampling interval for a new run
+    /*!
+     * \param interval_ Time every interval_-th step.  Zero disables timing
+     * \param tracer_ Recorder for trace events, or null
+     */
+    void reset(int interval_, TraceRecorder *tracer_=nullptr);
+
+    //! Start a new step, deciding whether it is timed
+    void beginStep(int64_t step);
+
+    //! Read back any outstanding device times
+    void finish();
+
+    //! True if phases are being timed or traced
+    bool enabled() const {
+        return interval > 0 or tracer;
+    }
+
+    inline void start(int id) {
+        if (not interval and not tracer) {
+            return;
+        }
+        Phase &p = phases[id];
+        if (tracer) {
+            tracer->begin(p.name);
+        }
+        p.calls++;
+        p.sampled = sampling;
+        if (sampling) {
+            if (not p.pending) {
+                cudaEventRecord(p.startEvent, 0);
+            }
+            p.hostStart = std::chrono::high_resolution_clock::now();
+        }
+    }
+
+    inline void stop(int id) {
+        if (not interval and not tracer) {
+            return;
+        }
+        Phase &p = phases[id];
+        if (tracer) {
+            tracer->end(p.name);
+        }
+        if (p.sampled) {
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - p.hostStart;
+            p.hostTime += elapsed.count();
+            p.hostSamples++;
+            //a phase entered twice in one timed step only gets device time for the first call
+            if (not p.pending) {
+                cudaEventRecord(p.stopEvent, 0);
+                p.pending = true;
+            }
+            p.sampled = false;
+        }
+    }
+
+    //! Estimated totals as nested python dicts keyed by phase name
+    boost::python::dict asDict();
+
+    //! Estimated totals as a JSON object
+    std::string asJSON();
+
+    std::vector<Phase> phases;
+
+private:
+    int interval;
+    bool sampling;
+    TraceRecorder *tracer;
+    void readEvents();
+    boost::python::dict childrenAsDict(int parent);
+    void childrenAsJSON(int parent, std::ostringstream &out);
+};
+
+#endif
@@ -132,6 +132,16 @@ void loadGroupInfo(pugi::xml_node &config, State *state) {
         mdAssert(bits.size()==handles.size(), "bad group tag restart data");
         for (int i=0; i<bits.size(); i++) {
             state->groupTags[handles[i]] = bits[i];
+            state->groups[bits[i]] = Group(state, handles[i]);
+        }
+        for (auto members_xml = grp_xml.child("groupMembers"); members_xml; members_xml = members_xml.next_sibling("groupMembers")) {
+            uint32_t tag = members_xml.attribute("tag").as_uint();
+            mdAssert(state->groups.find(tag) != state->groups.end(), "bad group member restart data");
+            std::istringstream ss_ids(members_xml.first_child().value());
+            uint id;
+            while (ss_ids >> id) {
+                state->groups[tag].addMember(id);
+            }
         }
     } else {
         cout << "Failed to load groups from file " << endl;
@@ -0,0 +1,217 @@
+#include "ScheduleExpression.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+enum SCHEDULEOP {PUSH, FRAC, TURN, STEP, ADD, SUB, MUL, DIV, POW, NEG, LT, LE, GT, GE, EQ, NE,
+                 EXP, LOG, SQRT, ABS, FLOOR, SIN, COS, MIN, MAX, IF};
+
+//name to op and number of arguments
+static const std::map<std::string, std::pair<int, int> > scheduleFunctions = {
+    {"exp", {EXP, 1}}, {"log", {LOG, 1}}, {"sqrt", {SQRT, 1}}, {"abs", {ABS, 1}}, {"floor", {FLOOR, 1}},
+    {"sin", {SIN, 1}}, {"cos", {COS, 1}}, {"min", {MIN, 2}}, {"max", {MAX, 2}}, {"pow", {POW, 2}}, {"if", {IF, 3}}
+};
+
+static const std::map<std::string, int> scheduleComparisons = {
+    {"<", LT}, {"<=", LE}, {">", GT}, {">=", GE}, {"==", EQ}, {"!=", NE}
+};
+
+ScheduleExpression::ScheduleExpression(std::string source_) : source(source_), pos(0), depth(0), maxDepth(0) {
+    tokenize();
+    mdAssert(tokens.size(), "Empty schedule expression");
+    parseComparison();
+    if (pos != tokens.size()) {
+        mdError("Unexpected '%s' in schedule expression '%s'", tokens[pos].c_str(), source.c_str());
+    }
+    mdAssert(maxDepth <= SCHEDULE_STACK_SIZE, "Schedule expression '%s' is nested too deeply", source.c_str());
+    tokens.clear();
+}
+
+void ScheduleExpression::tokenize() {
+    int i = 0;
+    int n = source.size();
+    while (i < n) {
+        char c = source[i];
+        if (isspace(c)) {
+            i++;
+        } else if (isdigit(c) or c == '.') {
+            int start = i;
+            while (i < n and (isdigit(source[i]) or source[i] == '.')) {
+                i++;
+            }
+            if (i < n and (source[i] == 'e' or source[i] == 'E')) {
+                i++;
+                if (i < n and (source[i] == '+' or source[i] == '-')) {
+                    i++;
+                }
+                while (i < n and isdigit(source[i])) {
+                    i++;
+                }
+            }
+            tokens.push_back(source.substr(start, i - start));
+        } else if (isalpha(c) or c == '_') {
+            int start = i;
+            while (i < n and (isalnum(source[i]) or source[i] == '_')) {
+                i++;
+            }
+            tokens.push_back(source.substr(start, i - start));
+        } else if (i+1 < n and source[i+1] == '=' and (c == '<' or c == '>' or c == '=' or c == '!')) {
+            tokens.push_back(source.substr(i, 2));
+            i += 2;
+        } else if (std::string("+-*/^(),<>").find(c) != std::string::npos) {
+            tokens.push_back(std::string(1, c));
+            i++;
+        } else {
+            mdError("Invalid character '%c' in schedule expression '%s'", c, source.c_str());
+        }
+    }
+}
+
+void ScheduleExpression::emit(int op, double val, int depthChange) {
+    program.push_back(Instruction{op, val});
+    depth += depthChange;
+    maxDepth = std::max(maxDepth, depth);
+}
+
+std::string ScheduleExpression::peek() {
+    return pos < tokens.size() ? tokens[pos] : "";
+}
+
+void ScheduleExpression::expect(std::string token) {
+    if (peek() != token) {
+        mdError("Expected '%s' in schedule expression '%s'", token.c_str(), source.c_str());
+    }
+    pos++;
+}
+
+void ScheduleExpression::parseComparison() {
+    parseSum();
+    auto it = scheduleComparisons.find(peek());
+    if (it != scheduleComparisons.end()) {
+        pos++;
+        parseSum();
+        emit(it->second, 0, -1);
+    }
+}
+
+void ScheduleExpression::parseSum() {
+    parseProduct();
+    while (peek() == "+" or peek() == "-") {
+        int op = tokens[pos++] == "+" ? ADD : SUB;
+        parseProduct();
+        emit(op, 0, -1);
+    }
+}
+
+void ScheduleExpression::parseProduct() {
+    parseUnary();
+    while (peek() == "*" or peek() == "/") {
+        int op = tokens[pos++] == "*" ? MUL : DIV;
+        parseUnary();
+        emit(op, 0, -1);
+    }
+}
+
+void ScheduleExpression::parseUnary() {
+    if (peek() == "-") {
+        pos++;
+        parseUnary();
+        emit(NEG, 0, 0);
+    } else if (peek() == "+") {
+        pos++;
+        parseUnary();
+    } else {
+        parsePower();
+    }
+}
+
+void ScheduleExpression::parsePower() {
+    parsePrimary();
+    if (peek() == "^") {
+        pos++;
+        //right associative, and binds tighter than a unary minus on its left
+        parseUnary();
+        emit(POW, 0, -1);
+    }
+}
+
+void ScheduleExpression::parsePrimary() {
+    std::string token = peek();
+    if (token == "") {
+        mdError("Schedule expression '%s' ends unexpectedly", source.c_str());
+    }
+    pos++;
+    if (isdigit(token[0]) or token[0] == '.') {
+        char *end;
+        double val = strtod(token.c_str(), &end);
+        if (*end != '\0') {
+            mdError("Invalid number '%s' in schedule expression '%s'", token.c_str(), source.c_str());
+        }
+        emit(PUSH, val, 1);
+    } else if (token == "(") {
+        parseComparison();
+        expect(")");
+    } else if (token == "frac") {
+        emit(FRAC, 0, 1);
+    } else if (token == "turn") {
+        emit(TURN, 0, 1);
+    } else if (token == "step") {
+        emit(STEP, 0, 1);
+    } else if (token == "pi") {
+        emit(PUSH, M_PI, 1);
+    } else if (scheduleFunctions.find(token) != scheduleFunctions.end()) {
+        std::pair<int, int> function = scheduleFunctions.at(token);
+        expect("(");
+        for (int i=0; i<function.second; i++) {
+            if (i) {
+                expect(",");
+            }
+            parseComparison();
+        }
+        expect(")");
+        emit(function.first, 0, 1 - function.second);
+    } else {
+        mdError("Unknown name '%s' in schedule expression '%s'", token.c_str(), source.c_str());
+    }
+}
+
+double ScheduleExpression::evaluate(double frac, double turn, double step) const {
+    double stack[SCHEDULE_STACK_SIZE];
+    int top = -1;
+    for (const Instruction &ins : program) {
+        switch (ins.op) {
+            case PUSH: stack[++top] = ins.val; break;
+            case FRAC: stack[++top] = frac; break;
+            case TURN: stack[++top] = turn; break;
+            case STEP: stack[++top] = step; break;
+            case ADD: top--; stack[top] += stack[top+1]; break;
+            case SUB: top--; stack[top] -= stack[top+1]; break;
+            case MUL: top--; stack[top] *= stack[top+1]; break;
+            case DIV: top--; stack[top] /= stack[top+1]; break;
+            case POW: top--; stack[top] = pow(stack[top], stack[top+1]); break;
+            case NEG: stack[top] = -stack[top]; break;
+            case LT: top--; stack[top] = stack[top] < stack[top+1]; break;
+            case LE: top--; stack[top] = stack[top] <= stack[top+1]; break;
+            case GT: top--; stack[top] = stack[top] > stack[top+1]; break;
+            case GE: top--; stack[top] = stack[top] >= stack[top+1]; break;
+            case EQ: top--; stack[top] = stack[top] == stack[top+1]; break;
+            case NE: top--; stack[top] = stack[top] != stack[top+1]; break;
+            case EXP: stack[top] = exp(stack[top]); break;
+            case LOG: stack[top] = log(stack[top]); break;
+            case SQRT: stack[top] = sqrt(stack[top]); break;
+            case ABS: stack[top] = fabs(stack[top]); break;
+            case FLOOR: stack[top] = floor(stack[top]); break;
+            case SIN: stack[top] = sin(stack[top]); break;
+            case COS: stack[top] = cos(stack[top]); break;
+            case MIN: top--; stack[top] = std::min(stack[top], stack[top+1]); break;
+            case MAX: top--; stack[top] = std::max(stack[top], stack[top+1]); break;
+            case IF: top -= 2; stack[top] = stack[top] != 0 ? stack[top+1] : stack[top+2]; break;
+        }
+    }
+    return stack[0];
+}
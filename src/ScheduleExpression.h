@@ -0,0 +1,64 @@
+#pragma once
+#ifndef SCHEDULEEXPRESSION_H
+#define SCHEDULEEXPRESSION_H
+
+#include <string>
+#include <vector>
+
+//! Deepest stack a compiled schedule may need
+#define SCHEDULE_STACK_SIZE 64
+
+//! Set point schedule compiled from a small expression language, so it can be evaluated every turn without Python
+/*!
+ * Expressions are built from numbers, the variables
+ *  - frac: fraction of the current run completed, from 0 to 1
+ *  - turn: current turn
+ *  - step: turns since the start of the current run
+ *
+ * the constant pi, the operators + - * / ^ and < <= > >= == != (which give 1
+ * or 0), parentheses, and the functions exp, log, sqrt, abs, floor, sin, cos,
+ * min, max, pow and if(condition, a, b).  For example, a ramp from 300 to 400
+ * over the first half of a run followed by an oscillation is
+ *
+ *     if(frac < 0.5, 300 + 200*frac, 400 + 10*sin(2*pi*step/1000))
+ *
+ * The expression is compiled once to postfix instructions for a small stack
+ * machine.
+ */
+class ScheduleExpression {
+public:
+    ScheduleExpression() {};
+    //! Compile an expression.  Syntax errors are reported with mdError
+    explicit ScheduleExpression(std::string source_);
+
+    //! Value of the schedule at a point of a run
+    double evaluate(double frac, double turn, double step) const;
+
+    std::string source; //!< Expression as given
+
+private:
+    struct Instruction {
+        int op;
+        double val;
+    };
+    std::vector<Instruction> program;
+
+    //parsing state, only used while compiling
+    std::vector<std::string> tokens;
+    size_t pos;
+    int depth;
+    int maxDepth;
+
+    void tokenize();
+    void emit(int op, double val, int depthChange);
+    std::string peek();
+    void expect(std::string token);
+    void parseComparison();
+    void parseSum();
+    void parseProduct();
+    void parseUnary();
+    void parsePower();
+    void parsePrimary();
+};
+
+#endif
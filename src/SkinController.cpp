@@ -0,0 +1,296 @@
+#include "SkinController.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <boost/python.hpp>
+
+#include "State.h"
+#include "Fix.h"
+#include "Logging.h"
+
+namespace py = boost::python;
+
+namespace {
+    float intBitsToFloat(int bits) {
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+}
+
+SkinController::SkinController()
+    : enabled(false), minPadding(0), maxPadding(0), maxInterval(20), adjustEvery(1000),
+      safety(2), minGain(0.02), adjustments(0), dangerousBuilds(0), chosenPadding(0), chosenInterval(0),
+      state(nullptr), backoff(1),
+      forceStart(nullptr), forceStop(nullptr), forceSampling(false), forcePending(false) {}
+
+SkinController::~SkinController() {
+    if (forceStart) {
+        cudaEventDestroy(forceStart);
+        cudaEventDestroy(forceStop);
+    }
+    destroyPairEvents();
+}
+
+void SkinController::destroyPairEvents() {
+    for (cudaEvent_t e : pairEvents) {
+        cudaEventDestroy(e);
+    }
+    pairEvents.clear();
+}
+
+void SkinController::prepare(State *state_) {
+    state = state_;
+    GridGPU &grid = state->gridGPU;
+    grid.trackMotion = enabled;
+    grid.checkMargin = 0;
+    if (not enabled) {
+        return;
+    }
+    mdAssert(maxInterval >= 1 and adjustEvery >= 1, "skinController needs maxInterval and adjustEvery of at least 1");
+    if (not forceStart) {
+        CUCHECK(cudaEventCreate(&forceStart));
+        CUCHECK(cudaEventCreate(&forceStop));
+    }
+    //only fixes with a cutoff walk the neighbor list and slow down as it grows
+    destroyPairEvents();
+    pairFixes.clear();
+    for (Fix *f : state->fixes) {
+        if (f->getRCuts().size()) {
+            pairFixes.push_back(f);
+            for (int i=0; i<2; i++) {
+                cudaEvent_t e;
+                CUCHECK(cudaEventCreate(&e));
+                pairEvents.push_back(e);
+            }
+        }
+    }
+    pairRecorded.assign(pairFixes.size(), false);
+    startPadding = state->padding;
+    startInterval = state->periodicInterval;
+    dangerInWindow = false;
+    adjustments = 0;
+    dangerousBuilds = 0;
+    backoff = 1;
+    //the first adjustment comes early, so that the run does not spend long on a poor guess
+    nextAdjust = state->turn + std::min(adjustEvery, 100);
+    lastBuildTurn = state->turn;
+    checkTime = 0;
+    checkSamples = 0;
+    buildTime = 0;
+    buildSamples = 0;
+    forceTime = 0;
+    forceSamples = 0;
+    pairForceTime = 0;
+    displacementRate = 0;
+    rateSamples = 0;
+    maxStepDisplacement = 0;
+    lastStepDisplacement = 0;
+    forceSampling = false;
+    forcePending = false;
+}
+
+bool SkinController::beginStep() {
+    if (not enabled or state->turn < nextAdjust) {
+        return false;
+    }
+    double padding = state->padding;
+    adjust();
+    return state->padding != padding;
+}
+
+void SkinController::finish() {
+    if (not enabled) {
+        return;
+    }
+    chosenPadding = state->padding;
+    chosenInterval = state->periodicInterval;
+    state->periodicInterval = startInterval;
+    if (state->padding != startPadding) {
+        state->padding = startPadding;
+        //the grid was resized during the run, so the next run builds a new one
+        state->gridChecksum = 0;
+    }
+}
+
+void SkinController::beforeCheck() {
+    if (not enabled) {
+        return;
+    }
+    buildCountBeforeCheck = state->nlistBuildCount;
+    checkStart = std::chrono::high_resolution_clock::now();
+}
+
+void SkinController::afterCheck() {
+    if (not enabled) {
+        return;
+    }
+    //the check waits for its flag, so host time covers the device work
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - checkStart;
+    GridGPU &grid = state->gridGPU;
+    bool built = state->nlistBuildCount != buildCountBeforeCheck;
+    if (built) {
+        buildTime += elapsed.count();
+        buildSamples++;
+        int64_t turns = state->turn - lastBuildTurn;
+        if (turns > 0) {
+            displacementRate += sqrt(intBitsToFloat(grid.buildFlag.h_data[2])) / turns;
+            rateSamples++;
+        }
+        lastBuildTurn = state->turn;
+        if (grid.buildFlag.h_data[1]) {
+            //an atom outran the margin, so pairs may have been missed.  Check
+            //every turn and widen the margin from now on
+            dangerousBuilds++;
+            dangerInWindow = true;
+            backoff *= 2;
+            state->periodicInterval = 1;
+            grid.checkMargin = margin(1);
+            if (state->verbose) {
+                mdMessage("Dangerous neighbor list build at turn %lld, checking every turn\n", (long long) state->turn);
+            }
+        }
+    } else {
+        checkTime += elapsed.count();
+        checkSamples++;
+    }
+    double stepDisplacement = sqrt(intBitsToFloat(grid.buildFlag.h_data[3])) * state->dt;
+    if (stepDisplacement > maxStepDisplacement) {
+        maxStepDisplacement = stepDisplacement;
+        grid.checkMargin = margin(state->periodicInterval);
+    }
+}
+
+void SkinController::beforeForce() {
+    //time one force evaluation in every 16, reading it back at the next
+    forceSampling = enabled and state->turn % 16 == 7;
+    if (forceSampling) {
+        readForceEvents();
+        CUCHECK(cudaEventRecord(forceStart));
+    }
+}
+
+void SkinController::afterForce() {
+    if (forceSampling) {
+        CUCHECK(cudaEventRecord(forceStop));
+        forcePending = true;
+        forceSampling = false;
+    }
+}
+
+void SkinController::recordFix(Fix *f, int stop) {
+    for (int i=0; i<pairFixes.size(); i++) {
+        if (pairFixes[i] == f) {
+            CUCHECK(cudaEventRecord(pairEvents[2*i + stop]));
+            pairRecorded[i] = true;
+            return;
+        }
+    }
+}
+
+void SkinController::readForceEvents() {
+    if (forcePending) {
+        CUCHECK(cudaEventSynchronize(forceStop));
+        float ms;
+        CUCHECK(cudaEventElapsedTime(&ms, forceStart, forceStop));
+        forceTime += ms * 1e-3;
+        forceSamples++;
+        for (int i=0; i<pairFixes.size(); i++) {
+            if (pairRecorded[i]) {
+                CUCHECK(cudaEventElapsedTime(&ms, pairEvents[2*i], pairEvents[2*i + 1]));
+                pairForceTime += ms * 1e-3;
+                pairRecorded[i] = false;
+            }
+        }
+        forcePending = false;
+    }
+}
+
+double SkinController::margin(int interval) {
+    return interval * std::max(maxStepDisplacement, lastStepDisplacement) * safety * backoff;
+}
+
+SkinModel SkinController::model() {
+    SkinModel m;
+    GridGPU &grid = state->gridGPU;
+    m.rCut = grid.neighCutoffMax - grid.padding;
+    m.padding = state->padding;
+    double force = forceTime / forceSamples;
+    m.pairForce = std::min(pairForceTime / forceSamples, force);
+    m.otherForce = force - m.pairForce;
+    m.build = buildTime / buildSamples;
+    m.check = checkSamples ? checkTime / checkSamples : 0;
+    m.rate = displacementRate / rateSamples;
+    m.stepDisplacement = std::max(maxStepDisplacement, lastStepDisplacement);
+    m.safety = safety * backoff;
+    return m;
+}
+
+void SkinController::adjust() {
+    readForceEvents();
+    nextAdjust = state->turn + adjustEvery;
+    GridGPU &grid = state->gridGPU;
+    if (dangerInWindow) {
+        //keep checking every turn until a whole window passes without a dangerous build
+        dangerInWindow = false;
+    } else if (not buildSamples or not forceSamples or not rateSamples) {
+        return;
+    } else {
+        double s0 = state->padding;
+        int k0 = state->periodicInterval;
+        SkinModel m = model();
+        double rCut = m.rCut;
+
+        double lo = minPadding > 0 ? minPadding : 0.25 * startPadding;
+        double hi = maxPadding > 0 ? maxPadding : 4 * startPadding;
+        //the grid needs at least three cells across the box
+        Vector sides = state->boundsGPU.rectComponents;
+        double shortest = state->is2d ? std::min(sides[0], sides[1]) : std::min(sides[0], std::min(sides[1], sides[2]));
+        hi = std::min(hi, shortest / 3 - rCut);
+
+        SkinChoice choice = m.choose(k0, lo, hi, maxInterval, minGain);
+        if (choice.change) {
+            if (state->verbose) {
+                mdMessage("Neighbor list padding %f -> %f, check interval %d -> %d (modeled %e -> %e s per turn)\n",
+                          s0, choice.padding, k0, choice.interval, choice.currentCost, choice.cost);
+            }
+            state->periodicInterval = choice.interval;
+            if (choice.padding != s0) {
+                state->padding = choice.padding;
+                grid.setPadding(choice.padding);
+                //times measured at the old padding no longer apply
+                buildTime = 0;
+                buildSamples = 0;
+                forceTime = 0;
+                forceSamples = 0;
+                pairForceTime = 0;
+            }
+            adjustments++;
+        }
+    }
+    grid.checkMargin = margin(state->periodicInterval);
+    //the displacement rate and step size follow the current temperature
+    displacementRate = 0;
+    rateSamples = 0;
+    lastStepDisplacement = maxStepDisplacement;
+    maxStepDisplacement = 0;
+    checkTime = 0;
+    checkSamples = 0;
+}
+
+void export_SkinController() {
+    py::class_<SkinController, boost::noncopyable>("SkinController", py::no_init)
+        .def_readwrite("enabled", &SkinController::enabled)
+        .def_readwrite("minPadding", &SkinController::minPadding)
+        .def_readwrite("maxPadding", &SkinController::maxPadding)
+        .def_readwrite("maxInterval", &SkinController::maxInterval)
+        .def_readwrite("adjustEvery", &SkinController::adjustEvery)
+        .def_readwrite("safety", &SkinController::safety)
+        .def_readwrite("minGain", &SkinController::minGain)
+        .def_readonly("adjustments", &SkinController::adjustments)
+        .def_readonly("dangerousBuilds", &SkinController::dangerousBuilds)
+        .def_readonly("chosenPadding", &SkinController::chosenPadding)
+        .def_readonly("chosenInterval", &SkinController::chosenInterval)
+        ;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef SKINCONTROLLER_H
+#define SKINCONTROLLER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+#include "SkinModel.h"
+
+class State;
+class Fix;
+
+void export_SkinController();
+
+//! Adjusts the neighbor list padding and check interval during a run
+/*!
+ * Opt-in.  While enabled, the controller measures the host time of
+ * displacement checks and of neighbor list builds, samples the device time
+ * of force evaluations, separating fixes which use the neighbor list from
+ * the rest, and tracks how far atoms move between builds and the largest
+ * distance any atom moves in one step.
+ *
+ * Every adjustEvery turns it fills in a SkinModel from these measurements
+ * and switches to the padding and check interval the model predicts to be
+ * at least minGain faster.  Changing the padding resizes the grid and
+ * rebuilds the list.
+ *
+ * To make dangerous builds unlikely, the list is rebuilt once any atom is
+ * within checkMargin of half the padding, where checkMargin is k times the
+ * largest per-step displacement seen, times safety.  This is a heuristic: an
+ * atom moving faster than any seen so far can still cross half the padding
+ * between checks.  When a build finds that one did, the controller counts
+ * it in dangerousBuilds, drops to checking every turn until a whole
+ * adjustment window passes without another, and doubles the margin for the
+ * rest of the run.
+ *
+ * The padding and check interval the run started with are restored when it
+ * finishes, and the last values chosen are kept in chosenPadding and
+ * chosenInterval.
+ */
+class SkinController {
+public:
+    bool enabled;       //!< False (default) leaves padding and periodicInterval alone
+    double minPadding;  //!< Smallest padding considered.  Zero is a quarter of the padding the run starts with
+    double maxPadding;  //!< Largest padding considered.  Zero is four times the padding the run starts with
+    int maxInterval;    //!< Longest check interval considered
+    int adjustEvery;    //!< Turns between adjustments
+    double safety;      //!< Multiplies the largest per-step displacement in checkMargin
+    double minGain;     //!< Fractional predicted saving needed to change settings
+    int adjustments;    //!< Number of changes made during the last run
+    int dangerousBuilds; //!< Builds during the last run which found an atom past half the padding
+    double chosenPadding; //!< Padding in use at the end of the last run
+    int chosenInterval;   //!< Check interval in use at the end of the last run
+
+    SkinController();
+    ~SkinController();
+
+    //! Start of a run, after the grid is prepared
+    void prepare(State *state);
+
+    //! Called at the start of each turn
+    /*!
+     * \return True if the padding changed and the list must be rebuilt now
+     */
+    bool beginStep();
+
+    //! End of a run.  Restores the padding and check interval it started with
+    void finish();
+
+    void beforeCheck();
+    void afterCheck();
+    void beforeForce();
+    void afterForce();
+
+    //! Called around each fix's compute, to time those using the neighbor list
+    void beforeFix(Fix *f) {
+        if (forceSampling) {
+            recordFix(f, 0);
+        }
+    }
+    void afterFix(Fix *f) {
+        if (forceSampling) {
+            recordFix(f, 1);
+        }
+    }
+
+private:
+    State *state;
+    double startPadding;
+    int startInterval;
+    bool dangerInWindow; //!< A dangerous build happened since the last adjustment
+    int64_t nextAdjust;
+    int64_t lastBuildTurn;
+    int buildCountBeforeCheck;
+    std::chrono::high_resolution_clock::time_point checkStart;
+
+    double checkTime;
+    int64_t checkSamples;
+    double buildTime;
+    int64_t buildSamples;
+    double forceTime;
+    int64_t forceSamples;
+    double pairForceTime; //!< Part of forceTime spent in pairFixes
+    double displacementRate; //!< Sum over builds of max displacement per turn since the previous build
+    int64_t rateSamples;
+    double maxStepDisplacement;     //!< Largest |v| dt at checks since the last adjustment
+    double lastStepDisplacement;    //!< The same, over the window before that
+    double backoff;                 //!< Extra factor on the margin, doubled by each dangerous build
+
+    cudaEvent_t forceStart;
+    cudaEvent_t forceStop;
+    bool forceSampling;
+    bool forcePending;
+    std::vector<Fix *> pairFixes;       //!< Active fixes which walk the neighbor list
+    std::vector<cudaEvent_t> pairEvents; //!< Start and stop event of each of pairFixes
+    std::vector<bool> pairRecorded;     //!< Which pairFixes ran in the sampled evaluation
+
+    void recordFix(Fix *f, int stop);
+    void readForceEvents();
+    void destroyPairEvents();
+    SkinModel model();
+    double margin(int interval);
+    void adjust();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "SkinModel.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+double SkinModel::margin(int interval) const {
+    return interval * stepDisplacement * safety;
+}
+
+double SkinModel::cost(double s, int k) const {
+    double trigger = 0.5 * s - margin(k);
+    if (trigger <= 0) {
+        return DBL_MAX;
+    }
+    double turnsBetweenBuilds = rate > 0 ? std::max(1.0, ceil(trigger / rate / k)) * k : 1e9;
+    double scale = pow((rCut + s) / (rCut + padding), 3);
+    return pairForce * scale + otherForce + build * scale / turnsBetweenBuilds + check / k;
+}
+
+SkinChoice SkinModel::choose(int currentInterval, double lo, double hi, int maxInterval, double minGain) const {
+    SkinChoice best;
+    best.padding = padding;
+    best.interval = currentInterval;
+    best.currentCost = cost(padding, currentInterval);
+    best.cost = best.currentCost;
+    const int nSteps = 32;
+    for (int i=0; i<=nSteps and hi > lo; i++) {
+        double s = lo + (hi - lo) * i / nSteps;
+        for (int k=1; k<=maxInterval; k++) {
+            double c = cost(s, k);
+            if (c < best.cost) {
+                best.cost = c;
+                best.padding = s;
+                best.interval = k;
+            }
+        }
+    }
+    best.change = best.cost < DBL_MAX
+                  and (best.currentCost == DBL_MAX or best.cost < best.currentCost * (1 - minGain));
+    if (not best.change) {
+        best.padding = padding;
+        best.interval = currentInterval;
+        best.cost = best.currentCost;
+    }
+    return best;
+}
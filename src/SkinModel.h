@@ -0,0 +1,55 @@
+#pragma once
+#ifndef SKINMODEL_H
+#define SKINMODEL_H
+
+//! Padding and check interval picked by SkinModel::choose
+class SkinChoice {
+public:
+    double padding;
+    int interval;
+    double cost;        //!< Modeled seconds per turn at padding and interval
+    double currentCost; //!< Modeled seconds per turn at the current settings
+    bool change;        //!< True if padding and interval differ from the current settings
+};
+
+//! Model of time per turn as a function of neighbor list padding s and check interval k
+/*!
+ *     pairForce * scale(s) + otherForce + build * scale(s) / turnsBetweenBuilds(s, k) + check / k
+ *
+ * where scale(s) = ((rCut + s) / (rCut + padding))^3 is the change in volume
+ * of the neighbor sphere.  Only fixes which walk the neighbor list slow down
+ * as it grows, so bonded and other fixes are kept in otherForce.
+ *
+ * A setting is unusable, with infinite cost, if atoms moving stepDisplacement
+ * per turn could cross half the padding between two checks.
+ */
+class SkinModel {
+public:
+    double rCut;             //!< Largest cutoff, without padding
+    double padding;          //!< Padding the times were measured at
+    double pairForce;        //!< Seconds per turn in fixes using the neighbor list
+    double otherForce;       //!< Seconds per turn in every other fix
+    double build;            //!< Seconds per neighbor list build
+    double check;            //!< Seconds per displacement check
+    double rate;             //!< Typical largest displacement per turn between builds
+    double stepDisplacement; //!< Largest distance an atom was seen to move in one turn
+    double safety;           //!< Multiplies stepDisplacement in margin()
+
+    SkinModel() : rCut(0), padding(0), pairForce(0), otherForce(0), build(0), check(0),
+                  rate(0), stepDisplacement(0), safety(1) {}
+
+    //! Distance short of half the padding at which a rebuild is triggered
+    double margin(int interval) const;
+
+    //! Modeled seconds per turn, or DBL_MAX if unusable
+    double cost(double s, int k) const;
+
+    //! Cheapest setting on a grid of paddings in [lo, hi] and intervals up to maxInterval
+    /*!
+     * The current settings, padding and currentInterval, are kept unless the
+     * cheapest is at least minGain faster or the current settings are unusable.
+     */
+    SkinChoice choose(int currentInterval, double lo, double hi, int maxInterval, double minGain) const;
+};
+
+#endif
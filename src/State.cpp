@@ -21,6 +21,10 @@
  */
 
 #include "State.h"
+#include "helpers.h"
+#include "AllocationRegistry.h"
+
+#include <chrono>
 
 using std::cout;
 using std::endl;
@@ -33,6 +37,7 @@ State::State() : units(&dt) {
     is2d = false;
     rCut = RCUT_INIT;
     padding = PADDING_INIT;
+    typePairCutoffs = false;
     turn = 0;
     maxIdExisting = -1;
     maxExclusions = 0;
@@ -64,7 +69,27 @@ State::State() : units(&dt) {
     nThreadPerBlock = 256;
 
     tuneEvery = 1000000;
+    tuneCacheFile = "";
+    tuneCacheTolerance = 0.25;
+    traceFile = "";
     nextForceBuild = 0;
+    hostOperationBuffers = 2;
+    hostOperationStallTime = 0;
+    hostOperationStalls = 0;
+    hostOperationCount = 0;
+    hostOperations = SHARED(HostOperationRing) (new HostOperationRing());
+    groupTagChecksum = 0;
+    incrementalPrepare = true;
+    deviceDataCurrent = false;
+    gridCurrent = false;
+    atomsDirty = true;
+    atomsExposed = false;
+    atomChecksum = 0;
+    atomIdChecksum = 0;
+    topologyChecksum = 0;
+    gridChecksum = 0;
+    gridTopologyChecksum = 0;
+    fullPrepareCount = 0;
     rigidBodies = false;
 
 }
@@ -80,9 +105,23 @@ uint State::groupTagFromHandle(std::string handle) {
 
 bool State::atomInGroup(Atom &a, std::string handle) {
     uint tag = groupTagFromHandle(handle);
+    return atomInGroup(a, tag);
+}
+
+bool State::atomInGroup(Atom &a, uint32_t tag) {
+    if (tag & GROUP_TAG_EXTENDED) {
+        return groups[tag].hasMember(a.id);
+    }
     return a.groupTag & tag;
 }
 
+GroupMask State::groupMask(uint32_t tag) {
+    if (tag & GROUP_TAG_EXTENDED) {
+        return groups[tag].mask();
+    }
+    return GroupMask(tag, nullptr, nullptr);
+}
+
 int State::addAtom(std::string handle, Vector pos, double q) {
     std::vector<std::string> &handles = atomParams.handles;
     auto it = find(handles.begin(), handles.end(), handle);
@@ -144,6 +183,8 @@ bool State::addAtomDirect(Atom a) {
     }
 
     atoms.push_back(a);
+    markGroupsDirty();
+    markAtomsDirty();
     //std::cout << "adding atom id " << a.id << " of type " << a.type << " with mass " << a.mass << std::endl;
     return true;
 }
@@ -158,6 +199,11 @@ Atom &State::idToAtom(int id) {
     return atoms[idToIdx[id]];
 }
 
+std::vector<Atom> &State::getAtomsPy() {
+    atomsExposed = true;
+    return atoms;
+}
+
 int State::idToIdxPy(int id) {
     return idToIdx[id];
 }
@@ -202,8 +248,15 @@ bool State::deleteAtom(Atom *a) {
         idBuffer.push_back(id);
         sort(idBuffer.begin(), idBuffer.end());
     }
+    for (auto it = groups.begin(); it != groups.end(); it++) {
+        if (it->second.isExtended()) {
+            it->second.removeMember(id);
+        }
+    }
     int idx = a - &atoms[0];
     atoms.erase(atoms.begin()+idx, atoms.begin()+idx+1);
+    markGroupsDirty();
+    markAtomsDirty();
     refreshIdToIdx(); //hey, if deleting multiple atoms, this doesn't need to be done for every one
     return true;
 }
@@ -251,6 +304,27 @@ py::object State::createMoleculePy(py::list idsPy) {
 
 
 
+py::dict State::memoryUsage() {
+    py::dict byOwner;
+    for (auto &entry : AllocationRegistry::instance().usage()) {
+        const AllocationRegistry::Usage &u = entry.second;
+        py::dict d;
+        d["hostBytes"] = u.hostBytes;
+        d["deviceBytes"] = u.deviceBytes;
+        d["peakHostBytes"] = u.peakHostBytes;
+        d["peakDeviceBytes"] = u.peakDeviceBytes;
+        d["allocations"] = u.allocations;
+        d["frees"] = u.frees;
+        d["allocatedBytes"] = u.allocatedBytes;
+        byOwner[entry.first] = d;
+    }
+    return byOwner;
+}
+
+std::string State::memorySummary() {
+    return AllocationRegistry::instance().summary();
+}
+
 py::object State::duplicateMolecule(Molecule &molec, int n) {
     int molecsOrig = py::len(molecules);
     std::vector<int> oldIds;
@@ -285,7 +359,7 @@ py::object State::duplicateMolecule(Molecule &molec, int n) {
 
 }
 
-void unwrapMolec(State *state, int id, std::vector<int> &molecIds, std::unordered_map<int, std::vector<int> > &bondMap) {
+void unwrapMolec(State *state, Bounds &bounds, int id, std::vector<int> &molecIds, std::unordered_map<int, std::vector<int> > &bondMap) {
     Vector myPos = state->idToAtom(id).pos;
     if (bondMap.find(id) != bondMap.end()) {
         std::vector<int> &myConnections = bondMap[id];
@@ -296,10 +370,10 @@ void unwrapMolec(State *state, int id, std::vector<int> &molecIds, std::unordere
                 molecIds.erase(it);
                 Atom &other = state->idToAtom(otherId);
                 //unwrap
-                other.pos = myPos + state->bounds.minImage(other.pos - myPos);
+                other.pos = myPos + bounds.minImage(other.pos - myPos);
 
                 //and recurse
-                unwrapMolec(state, otherId, molecIds, bondMap);
+                unwrapMolec(state, bounds, otherId, molecIds, bondMap);
 
 
 
@@ -310,6 +384,11 @@ void unwrapMolec(State *state, int id, std::vector<int> &molecIds, std::unordere
 }
 
 void State::unwrapMolecules() {
+    markAtomsDirty();
+    unwrapMolecules(bounds);
+}
+
+void State::unwrapMolecules(Bounds &bounds) {
     std::vector<int> allMolecIds;
     std::vector<Molecule *> molecs;
     int nMolec = py::len(molecules);
@@ -344,7 +423,7 @@ void State::unwrapMolecules() {
         std::vector<int> ids = molec->ids;
         int idBegin = ids.back();
         ids.pop_back();
-        unwrapMolec(this, idBegin, ids, bondMap);
+        unwrapMolec(this, bounds, idBegin, ids, bondMap);
         Vector com = molec->COM();
         Vector comNew = bounds.wrap(com);
         Vector diff = comNew - com;
@@ -469,9 +548,12 @@ bool State::activateFix(SHARED(Fix) other) {
                   << ", but fix was initialized with a different State" << std::endl;
     }
     assert(other->state == this);
+    // which fixes are active can change what has to be on the device
+    markAtomsDirty();
     return addGeneric<Fix>(fixesShr, &fixes, other);
 }
 bool State::deactivateFix(SHARED(Fix) other) {
+    markAtomsDirty();
     return removeGeneric<Fix>(fixesShr, &fixes, other);
 }
 
@@ -486,14 +568,61 @@ float State::getMaxRCut() {
     return maxRCut;
 }
 
+std::vector<float> State::getRCutsByType() {
+    int numTypes = atomParams.numTypes;
+    std::vector<float> cuts(numTypes*numTypes, 0);
+    for (Fix *f : fixes) {
+        std::vector<float> byType = f->getRCutsByType();
+        if (byType.size() == cuts.size()) {
+            for (int i=0; i<cuts.size(); i++) {
+                cuts[i] = fmax(cuts[i], byType[i]);
+            }
+        } else {
+            for (float x : f->getRCuts()) {
+                for (float &cut : cuts) {
+                    cut = fmax(cut, x);
+                }
+            }
+        }
+    }
+    return cuts;
+}
+
 
 
 void State::initializeGrid() {
     double maxRCut = getMaxRCut();// ALSO PADDING PLS
     double gridDim = maxRCut + padding;
 
+    uint64_t checksum = hashBytes(HASH_SEED, &gridDim, sizeof(gridDim));
+    checksum = hashBytes(checksum, &padding, sizeof(padding));
+    checksum = hashBytes(checksum, &nPerRingPoly, sizeof(nPerRingPoly));
+    checksum = hashBytes(checksum, &nThreadPerBlock, sizeof(nThreadPerBlock));
+    checksum = hashBytes(checksum, &nThreadPerAtom, sizeof(nThreadPerAtom));
+    checksum = hashBytes(checksum, &boundsGPU.lo, sizeof(boundsGPU.lo));
+    checksum = hashBytes(checksum, &boundsGPU.rectComponents, sizeof(boundsGPU.rectComponents));
+    checksum = hashBytes(checksum, &boundsGPU.periodic, sizeof(boundsGPU.periodic));
+    std::vector<float> typeCutoffs;
+    if (typePairCutoffs and nPerRingPoly == 1) {
+        typeCutoffs = getRCutsByType();
+        checksum = hashBytes(checksum, typeCutoffs.data(), typeCutoffs.size() * sizeof(float));
+    }
+    bool exclusionsCurrent = incrementalPrepare and topologyChecksum == gridTopologyChecksum;
+    gridCurrent = deviceDataCurrent and exclusionsCurrent and checksum == gridChecksum;
+    if (gridCurrent) {
+        return;
+    }
+
     // copy value of nPerRingPoly to make it local to gpd instance
-    gridGPU = GridGPU(this, gridDim, gridDim, gridDim, gridDim, exclusionMode, this->padding, &gpd,nPerRingPoly);
+    GridGPU grid(this, gridDim, gridDim, gridDim, gridDim, exclusionMode, this->padding, &gpd, nPerRingPoly, not exclusionsCurrent);
+    if (exclusionsCurrent) {
+        grid.takeExclusions(gridGPU);
+    }
+    grid.setTypeCutoffs(typeCutoffs, atomParams.numTypes);
+    gridGPU = grid;
+    gridGPU.stats = &nlistStats;
+    gridChecksum = checksum;
+    gridTopologyChecksum = topologyChecksum;
     //testing
     //nThreadPerBlock = 64;
     //nThreadPerAtom = 4;
@@ -536,23 +665,22 @@ void State::copyAtomDataToGPU(std::vector<int> &idToIdx) {
     gpd.qs.dataToDevice();
 }
 
-bool State::prepareForRun() {
-    // so, Fixes are /not/ prepared at the time that this is called;
-    // but, they /are/ instantiated, and we know which ones are active (our list of fixes is up-to-date)
-    // so, this is ok.
-    
-    requiresCharges = false;
-    std::vector<bool> requireCharges = LISTMAP(Fix *, bool, fix, fixes, fix->requiresCharges);
-    if (!requireCharges.empty()) {
-        requiresCharges = *std::max_element(requireCharges.begin(), requireCharges.end());
-    }
-    
-    requiresPostNVE_V = false;
-    std::vector<bool> requirePostNVE_V = LISTMAP(Fix *, bool, fix, fixes, fix->requiresPostNVE_V);
-    if (!requirePostNVE_V.empty()) {
-        requiresPostNVE_V = *std::max_element(requirePostNVE_V.begin(), requirePostNVE_V.end());
-    }
+uint64_t State::checksumAtoms() {
+    uint64_t sum = HASH_SEED;
+    for (const Atom &a : atoms) {
+        sum = hashBytes(sum, &a.pos[0], 3*sizeof(a.pos[0]));
+        sum = hashBytes(sum, &a.vel[0], 3*sizeof(a.vel[0]));
+        sum = hashBytes(sum, &a.force[0], 3*sizeof(a.force[0]));
+        sum = hashBytes(sum, &a.mass, sizeof(a.mass));
+        sum = hashBytes(sum, &a.q, sizeof(a.q));
+        sum = hashBytes(sum, &a.type, sizeof(a.type));
+        sum = hashBytes(sum, &a.id, sizeof(a.id));
+        sum = hashBytes(sum, &a.groupTag, sizeof(a.groupTag));
+    }
+    return sum;
+}
 
+void State::packAtoms() {
     std::vector<float4> xs_vec, vs_vec, fs_vec;
     std::vector<uint> ids;
     std::vector<float> qs;
@@ -564,7 +692,11 @@ bool State::prepareForRun() {
     ids.reserve(nAtoms);
     qs.reserve(nAtoms);
    
+    uint64_t idSum = HASH_SEED;
+    uint64_t tagSum = HASH_SEED;
     for (const auto &a : atoms) {
+        idSum = hashBytes(idSum, &a.id, sizeof(a.id));
+        tagSum = hashBytes(tagSum, &a.groupTag, sizeof(a.groupTag));
         xs_vec.push_back(make_float4(a.pos[0], a.pos[1], a.pos[2],
                                      *(float *)&a.type));
         if (a.mass == 0.0) {
@@ -591,7 +723,6 @@ bool State::prepareForRun() {
     gpd.ids.set(ids);
     gpd.qs.set(qs);
 
-
     std::vector<Virial> virials(atoms.size(), Virial(0, 0, 0, 0, 0, 0));
     gpd.virials = GPUArrayGlobal<Virial>(nAtoms);
     gpd.virials.set(virials);
@@ -610,15 +741,81 @@ bool State::prepareForRun() {
 
     gpd.idToIdxsOnCopy = idToIdxs_vec;
     gpd.idToIdxs.set(idToIdxs_vec);
+
+    atomIdChecksum = idSum;
+    // tags can be assigned directly from python, so check for changes
+    if (tagSum != groupTagChecksum) {
+        markGroupsDirty();
+        groupTagChecksum = tagSum;
+    }
+}
+
+bool State::prepareForRun() {
+    // so, Fixes are /not/ prepared at the time that this is called;
+    // but, they /are/ instantiated, and we know which ones are active (our list of fixes is up-to-date)
+    // so, this is ok.
+    
+    requiresCharges = false;
+    std::vector<bool> requireCharges = LISTMAP(Fix *, bool, fix, fixes, fix->requiresCharges);
+    if (!requireCharges.empty()) {
+        requiresCharges = *std::max_element(requireCharges.begin(), requireCharges.end());
+    }
+    
+    requiresPostNVE_V = false;
+    std::vector<bool> requirePostNVE_V = LISTMAP(Fix *, bool, fix, fixes, fix->requiresPostNVE_V);
+    if (!requirePostNVE_V.empty()) {
+        requiresPostNVE_V = *std::max_element(requirePostNVE_V.begin(), requirePostNVE_V.end());
+    }
+
+    // the device holds what the last run left there unless something
+    // touched the host atoms or the fix list since.  Atoms python holds
+    // can only be checked by hashing them
+    int nAtoms = atoms.size();
+    deviceDataCurrent = incrementalPrepare and not atomsDirty
+                        and nAtoms and gpd.xs.size() == nAtoms
+                        and (not atomsExposed or checksumAtoms() == atomChecksum);
+    if (not deviceDataCurrent) {
+        packAtoms();
+        atomsDirty = false;
+        if (atomsExposed) {
+            atomChecksum = checksumAtoms();
+        }
+        fullPrepareCount++;
+    }
+
+    // ids and bonds determine exclusions
+    uint64_t topologySum = hashBytes(atomIdChecksum, &exclusionMode, sizeof(exclusionMode));
+    for (Fix *f : fixes) {
+        std::vector<BondVariant> *fixBonds = f->getBonds();
+        if (fixBonds != nullptr) {
+            for (BondVariant &bv : *fixBonds) {
+                const Bond &b = boost::apply_visitor(bondDowncast(bv), bv);
+                topologySum = hashBytes(topologySum, b.ids.data(), sizeof(b.ids));
+            }
+        }
+    }
+    topologyChecksum = topologySum;
+    // member lists go to the device before fixes are prepared or forces computed
+    for (auto it = groups.begin(); it != groups.end(); it++) {
+        it->second.prepareForRun();
+    }
+
     bounds.handle2d();
     boundsGPU = bounds.makeGPU();
-    float maxRCut = getMaxRCut();
-    initializeGrid();
+    {
+        AllocationScope scope("grid");
+        initializeGrid();
+    }
 
-    gpd.xsBuffer = GPUArrayGlobal<float4>(nAtoms);
-    gpd.vsBuffer = GPUArrayGlobal<float4>(nAtoms);
-    gpd.fsBuffer = GPUArrayGlobal<float4>(nAtoms);
-    gpd.idsBuffer = GPUArrayGlobal<uint>(nAtoms);
+    hostOperations->allocate(hostOperationBuffers, nAtoms);
+    if (traceFile.empty()) {
+        tracer.reset();
+    } else if (not tracer) {
+        tracer = SHARED(TraceRecorder) (new TraceRecorder());
+    }
+    hostOperationStallTime = 0;
+    hostOperationStalls = 0;
+    hostOperationCount = 0;
 
     return true;
 }
@@ -635,19 +832,23 @@ void State::handleChargeOffloading() {
         }
     }
 }
-void copyAsyncWithInstruc(State *state, std::function<void (int64_t )> cb, int64_t turn) {
+void copyAsyncWithInstruc(State *state, std::function<void (int64_t, Bounds &)> cb, HostOperationRing::Slot *slot) {
+    TraceScope scope(state->tracer.get(), "hostOperation", std::to_string(slot->turn));
     cudaStream_t stream;
     CUCHECK(cudaStreamCreate(&stream));
-    state->gpd.xsBuffer.dataToHostAsync(stream);
-    state->gpd.vsBuffer.dataToHostAsync(stream);
-    state->gpd.fsBuffer.dataToHostAsync(stream);
-    state->gpd.idsBuffer.dataToHostAsync(stream);
+    CUCHECK(cudaStreamWaitEvent(stream, slot->copied, 0));
+    slot->xs.dataToHostAsync(stream);
+    slot->vs.dataToHostAsync(stream);
+    slot->fs.dataToHostAsync(stream);
+    slot->ids.dataToHostAsync(stream);
     CUCHECK(cudaStreamSynchronize(stream));
-    std::vector<int> idToIdxsOnCopy = state->gpd.idToIdxsOnCopy;
-    std::vector<float4> &xs = state->gpd.xsBuffer.h_data;
-    std::vector<float4> &vs = state->gpd.vsBuffer.h_data;
-    std::vector<float4> &fs = state->gpd.fsBuffer.h_data;
-    std::vector<uint> &ids = state->gpd.idsBuffer.h_data;
+    //earlier snapshots must be unpacked and consumed before this one
+    state->hostOperations->waitForTurn(slot);
+    std::vector<int> &idToIdxsOnCopy = state->gpd.idToIdxsOnCopy;
+    std::vector<float4> &xs = slot->xs.h_data;
+    std::vector<float4> &vs = slot->vs.h_data;
+    std::vector<float4> &fs = slot->fs.h_data;
+    std::vector<uint> &ids = slot->ids.h_data;
     std::vector<Atom> &atoms = state->atoms;
 
     for (int i=0, ii=state->atoms.size(); i<ii; i++) {
@@ -657,11 +858,15 @@ void copyAsyncWithInstruc(State *state, std::function<void (int64_t )> cb, int64
         atoms[idxWriteTo].vel = vs[i];
         atoms[idxWriteTo].force = fs[i];
     }
-    cb(turn);
+    //python reads state.bounds, so it is set to the snapshot's box.  Slots
+    //are consumed one at a time in turn order, and the integrator does not
+    //read state->bounds while running
+    state->bounds.set(slot->bounds);
+    cb(slot->turn, state->bounds);
     CUCHECK(cudaStreamDestroy(stream));
 }
 
-void copySyncWithInstruc(State *state, std::function<void (int64_t )> cb, int64_t turn) {
+void copySyncWithInstruc(State *state, std::function<void (int64_t, Bounds &)> cb, int64_t turn) {
     state->gpd.xs.dataToHost();
     state->gpd.vs.dataToHost();
     state->gpd.fs.dataToHost();
@@ -682,40 +887,45 @@ void copySyncWithInstruc(State *state, std::function<void (int64_t )> cb, int64_
         atoms[idxWriteTo].vel = vs[i];
         atoms[idxWriteTo].force = fs[i];
     }
-    cb(turn);
+    cb(turn, state->bounds);
     //now copy back
     state->copyAtomDataToGPU(state->gpd.idToIdxs.h_data);
 }
 
-bool State::runtimeHostOperation(std::function<void (int64_t )> cb, bool async) {
-    // buffers should already be allocated in prepareForRun, and num atoms
+bool State::runtimeHostOperation(std::function<void (int64_t, Bounds &)> cb, bool async) {
+    // slots should already be allocated in prepareForRun, and num atoms
     // shouldn't have changed.
+    hostOperationCount++;
+    TraceScope scope(tracer.get(), async ? "issueHostOperation" : "syncHostOperation");
     if (async) {
-        gpd.xs.copyToDeviceArray((void *) gpd.xsBuffer.getDevData());
-        gpd.vs.copyToDeviceArray((void *) gpd.vsBuffer.getDevData());
-        gpd.fs.copyToDeviceArray((void *) gpd.fsBuffer.getDevData());
-        gpd.ids.copyToDeviceArray((void *) gpd.idsBuffer.getDevData());
-    }
-    bounds.set(boundsGPU);
-    if (asyncData and asyncData->joinable()) {
-        asyncData->join();
-    }
-    cudaDeviceSynchronize();
-    //cout << "ASYNC IS NOT ASYNC" << endl;
-    //copyAsyncWithInstruc(this, cb, turn);
-    if (async) {
-        asyncData = SHARED(std::thread) ( new std::thread(copyAsyncWithInstruc, this, cb, turn));
+        double stall;
+        HostOperationRing::Slot *slot = hostOperations->acquire(stall);
+        if (stall > 0) {
+            hostOperationStalls++;
+            hostOperationStallTime += stall;
+        }
+        gpd.xs.copyToDeviceArray((void *) slot->xs.getDevData());
+        gpd.vs.copyToDeviceArray((void *) slot->vs.getDevData());
+        gpd.fs.copyToDeviceArray((void *) slot->fs.getDevData());
+        gpd.ids.copyToDeviceArray((void *) slot->ids.getDevData());
+        slot->bounds = boundsGPU;
+        slot->turn = turn;
+        CUCHECK(cudaEventRecord(slot->copied, 0));
+        hostOperations->launch(slot, std::bind(copyAsyncWithInstruc, this, cb, std::placeholders::_1));
     } else {
+        auto start = std::chrono::high_resolution_clock::now();
+        finishHostOperations();
+        std::chrono::duration<double> waited = std::chrono::high_resolution_clock::now() - start;
+        hostOperationStallTime += waited.count();
+        bounds.set(boundsGPU);
+        cudaDeviceSynchronize();
         copySyncWithInstruc(this, cb, turn);
     }
-    // okay, now launch a thread to start async copying, then wait for it to
-    // finish, and set the cb on state (and maybe a flag if you can't set the
-    // function lambda equal to null
-    //if thread exists, wait for it to finish
-    //okay, now I have all of these buffers filled with data.  now let's just
-    //launch a thread which does the writing.  At the end of each just (in main
-    //iteration code, just have a join statement before any of the downloading
-    //happens
+    return true;
+}
+
+void State::finishHostOperations() {
+    hostOperations->drain();
 }
 
 // this function is called by barostatting methods 
@@ -784,6 +994,9 @@ bool State::downloadFromRun() {
         atoms[idxWriteTo].vel = vs[i];
         atoms[idxWriteTo].force = fs[i];
     }
+    if (atomsExposed) {
+        atomChecksum = checksumAtoms();
+    }
     bounds.set(boundsGPU);
     return true;
 }
@@ -805,8 +1018,14 @@ bool State::addToGroupPy(std::string handle, py::list toAdd) {//list of atom ids
         int idx = idToIdx[id];
         mdAssert(idx >= 0 and idx < atoms.size(), "Invalid atom found when trying to add to group");
         Atom *a = &atoms[idx];
-        a->groupTag |= tagBit;
+        if (tagBit & GROUP_TAG_EXTENDED) {
+            groups[tagBit].addMember(a->id);
+        } else {
+            a->groupTag |= tagBit;
+        }
     }
+    groups[tagBit].markDirty();
+    markAtomsDirty();
     return true;
 
 }
@@ -815,9 +1034,15 @@ bool State::addToGroup(std::string handle, std::function<bool (Atom *)> testF) {
     int tagBit = addGroupTag(handle);
     for (Atom &a : atoms) {
         if (testF(&a)) {
-            a.groupTag |= tagBit;
+            if (tagBit & GROUP_TAG_EXTENDED) {
+                groups[tagBit].addMember(a.id);
+            } else {
+                a.groupTag |= tagBit;
+            }
         }
     }
+    groups[tagBit].markDirty();
+    markAtomsDirty();
     return true;
 }
 
@@ -831,12 +1056,34 @@ void State::populateGroupMap() {
 
 }
 
+void State::markGroupsDirty() {
+    for (auto it = groups.begin(); it != groups.end(); it++) {
+        it->second.markDirty();
+    }
+}
+
+std::vector<int> &State::groupMembers(uint32_t groupTag) {
+    auto it = groups.find(groupTag);
+    mdAssert(it != groups.end(), "Group with tag %u does not exist", groupTag);
+    it->second.refreshMembers();
+    return it->second.atomIdxs;
+}
+
+std::vector<int> &State::preparedGroupMembers(uint32_t groupTag) {
+    auto it = groups.find(groupTag);
+    mdAssert(it != groups.end(), "Group with tag %u does not exist", groupTag);
+    return it->second.atomIdxs;
+}
+
 
 bool State::deleteGroup(std::string handle) {
     uint tagBit = groupTagFromHandle(handle);
     assert(handle != "all");
-    for (Atom &a : atoms) {
-        a.groupTag &= ~tagBit;
+    if (not (tagBit & GROUP_TAG_EXTENDED)) {
+        for (Atom &a : atoms) {
+            a.groupTag &= ~tagBit;
+        }
+        markAtomsDirty();
     }
     removeGroupTag(handle);
     return true;
@@ -861,13 +1108,7 @@ int State::countNumInGroup(std::string handle) {
 }
 
 int State::countNumInGroup(uint32_t tag) {
-    int count = 0;
-    for (Atom &a : atoms) {
-        if (a.groupTag & tag) {
-            count++;
-        }
-    }
-    return count;
+    return groupMembers(tag).size();
 }
 
 uint State::addGroupTag(std::string handle) {
@@ -876,13 +1117,15 @@ uint State::addGroupTag(std::string handle) {
     assert(groupTags.find(handle) == groupTags.end());
     // fill the bitmask with current occupied bits
     for (auto it=groupTags.begin(); it!=groupTags.end(); it++) {
-        working |= it->second;
+        if (not (it->second & GROUP_TAG_EXTENDED)) {
+            working |= it->second;
+        }
     }
     // shift until we find a bit that is not occupado; then return exactly that bit flipped, all others zero
     // -- start off shifted once, because groupTag 'all' is always present
     //    so, as long as we preclude redundancy in the groupTags map, we will 
     //    avoid that issue with the groups map as well.
-    for (int i=0; i<32; i++) {
+    for (int i=0; i<GROUP_TAG_NBITS; i++) {
         uint potentialTag = 1 << i;
         if (! (working & potentialTag)) {
             groupTags[handle] = potentialTag;
@@ -890,6 +1133,16 @@ uint State::addGroupTag(std::string handle) {
             return potentialTag;
         }
     }
+    // per-atom bits are used up, so membership of this one is kept as an id
+    // list on the group.  Find the lowest unused extended tag
+    for (uint i=0; i<GROUP_TAG_EXTENDED; i++) {
+        uint potentialTag = GROUP_TAG_EXTENDED | i;
+        if (groups.find(potentialTag) == groups.end()) {
+            groupTags[handle] = potentialTag;
+            groups[potentialTag] = Group(this,handle);
+            return potentialTag;
+        }
+    }
     return 0;
 }
 
@@ -903,8 +1156,14 @@ bool State::removeGroupTag(std::string handle) {
 }
 
 std::vector<Atom *> State::selectGroup(std::string handle) {
-    int tagBit = groupTagFromHandle(handle);
-    return LISTMAPREFTEST(Atom, Atom *, a, atoms, &a, a.groupTag & tagBit);
+    uint32_t tagBit = groupTagFromHandle(handle);
+    std::vector<Atom *> selected;
+    // python can edit the atoms through these pointers
+    atomsExposed = true;
+    for (int idx : groupMembers(tagBit)) {
+        selected.push_back(&atoms[idx]);
+    }
+    return selected;
 }
 
 std::vector<Atom> State::copyAtoms() {
@@ -924,6 +1183,13 @@ bool State::validAtom(Atom *a) {
 
 void State::deleteAtoms() {
     atoms.erase(atoms.begin(), atoms.end());
+    for (auto it = groups.begin(); it != groups.end(); it++) {
+        if (it->second.isExtended()) {
+            it->second.clearMembers();
+        }
+    }
+    markGroupsDirty();
+    markAtomsDirty();
     idBuffer.erase(idBuffer.begin(), idBuffer.end());
     maxIdExisting = -1;
     idToIdx.erase(idToIdx.begin(), idToIdx.end());
@@ -932,6 +1198,7 @@ void State::deleteAtoms() {
 
 
 void State::zeroVelocities() {
+    markAtomsDirty();
     for (Atom &a : atoms) {
         a.vel.zero();
     }
@@ -1097,7 +1364,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(State_seedRNG_overloads,State::seedRNG,0,
                          py::arg("pos"),
                          py::arg("q")=0)
                     )
-                .def_readonly("atoms", &State::atoms)
+                .add_property("atoms", py::make_function(&State::getAtomsPy, py::return_internal_reference<>()))
                 .def_readonly("molecules", &State::molecules)
                 .def("setPeriodic", &State::setPeriodic)
                 .def("getPeriodic", &State::getPeriodic) //boost is grumpy about readwriting static arrays.  can readonly, but that's weird to only allow one w/ wrapper func for other.  doing wrapper funcs for both
@@ -1111,7 +1378,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(State_seedRNG_overloads,State::seedRNG,0,
                         (py::arg("handle"),
                          py::arg("atoms") = py::list())
                     )
-				.def("atomInGroup", &State::atomInGroup)
+				.def("atomInGroup", (bool (State::*)(Atom &, std::string)) &State::atomInGroup)
                 .def("createMolecule", &State::createMoleculePy, (py::arg("ids")))
                 .def("duplicateMolecule", &State::duplicateMolecule, (py::arg("molecule"), py::arg("n")=1))
                 .def("selectGroup", &State::selectGroup)
@@ -1129,20 +1396,37 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(State_seedRNG_overloads,State::seedRNG,0,
                 .def("destroy", &State::destroy)
                 .def("seedRNG", &State::seedRNG, State_seedRNG_overloads())
                 .def("preparePIMD", &State::preparePIMD)
+                .def("memoryUsage", &State::memoryUsage)
+                .def("memorySummary", &State::memorySummary)
                 .def_readwrite("is2d", &State::is2d)
                 .def_readwrite("turn", &State::turn)
                 .def_readwrite("nThreadPerAtom", &State::nThreadPerAtom)
                 .def_readwrite("nThreadPerBlock", &State::nThreadPerBlock)
                 .def_readwrite("tuneEvery", &State::tuneEvery)
+                .def_readwrite("tuneCacheFile", &State::tuneCacheFile)
+                .def_readwrite("tuneCacheTolerance", &State::tuneCacheTolerance)
+                .def_readwrite("traceFile", &State::traceFile)
+                .def_readwrite("hostOperationBuffers", &State::hostOperationBuffers)
+                .def_readonly("hostOperationStallTime", &State::hostOperationStallTime)
+                .def_readonly("hostOperationStalls", &State::hostOperationStalls)
+                .def_readonly("hostOperationCount", &State::hostOperationCount)
+                .def_readwrite("incrementalPrepare", &State::incrementalPrepare)
+                .def_readonly("deviceDataCurrent", &State::deviceDataCurrent)
+                .def_readonly("gridCurrent", &State::gridCurrent)
+                .def_readonly("fullPrepareCount", &State::fullPrepareCount)
                 .def_readwrite("periodicInterval", &State::periodicInterval)
                 .def_readwrite("rCut", &State::rCut)
                 .def_readwrite("nPerRingPoly", &State::nPerRingPoly)
                 .def_readwrite("nlistBuildTurns", &State::nlistBuildTurns)
                 .def_readwrite("dt", &State::dt)
                 .def_readwrite("padding", &State::padding)
+                .def_readwrite("typePairCutoffs", &State::typePairCutoffs)
                 .def_readwrite("nextForceBuild", &State::nextForceBuild)
                 .def_readonly("groupTags", &State::groupTags)
                 .def_readonly("dataManager", &State::dataManager)
+                .def_readonly("nlistStats", &State::nlistStats)
+                .def_readonly("skinController", &State::skinController)
+                .def_readonly("dangerousRebuilds", &State::dangerousRebuilds)
                 //shared ptrs
                 .def_readwrite("bounds", &State::bounds)
                 .def_readwrite("fixes", &State::fixesShr)
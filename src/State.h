@@ -39,6 +39,9 @@
 #include "Bounds.h"
 #include "DataManager.h"
 #include "Group.h"
+#include "HostOperationRing.h"
+#include "TraceRecorder.h"
+#include "SkinController.h"
 
 #include "boost_for_export.h"
 #include "DeviceManager.h"
@@ -82,19 +85,28 @@ private:
      */
     uint addGroupTag(std::string handle);
 
+    //! Get the cutoff of each pair of atom types, the largest over all fixes
+    /*!
+     * \return numTypes^2 cutoffs.  Fixes without per-pair cutoffs contribute
+     *         their largest cutoff to every pair
+     */
+    std::vector<float> getRCutsByType();
+
+public:
     //! Get the maximum cutoff value from all fixes
     /*!
      * \return Maximum cutoff value
      *
-     * To be called from within prepare for run __after__ fixed have prepared
-     * (because that removes any DEFAULT_FILL values)
+     * Cutoffs still at DEFAULT_FILL, before fixes are prepared, count as
+     * rCut, which is what preparing them sets them to
      */
     float getMaxRCut();
 
-public:
     std::vector<Atom> atoms; //!< List of all atoms in the simulation
     boost::python::list molecules; //!< List of all molecules in the simulation.  Molecules are just groups of atom ids with some tools for managing them.  Using python list because users should to be able to 'hold on' to molecules without worrying about segfaults
     GridGPU gridGPU; //!< The Grid on the GPU
+    NeighborListStats nlistStats; //!< Neighbor list health over the last run
+    SkinController skinController; //!< Adapts padding and periodicInterval during runs, if enabled
     BoundsGPU boundsGPU; //!< Bounds on the GPU
     GPUData gpd; //!< All GPU data
     DeviceManager devManager; //!< GPU device manager
@@ -111,6 +123,32 @@ public:
                                                //!< bitmasks
     std::map<uint32_t,Group> groups; //!< Map of group handles to a given group
     void populateGroupMap(); //!< Populates the data of our Group instances contained in the above map 'groups'
+    void markGroupsDirty(); //!< Flag all groups' member lists for rebuild after atoms or membership change
+    //! Flag host atom data as edited, so the next run repacks and uploads it
+    void markAtomsDirty() {
+        atomsDirty = true;
+    }
+    //! Atoms as seen from python.  Python can keep these and edit them in
+    //! place at any later time, so this flags them exposed
+    std::vector<Atom> &getAtomsPy();
+
+    //! Indices into atoms of the members of a group, ascending
+    /*!
+     * \param groupTag Bitmask of the group
+     * \return Reference to the group's compact member list
+     *
+     * The list is rebuilt first if membership has changed since it was last
+     * built.
+     */
+    std::vector<int> &groupMembers(uint32_t groupTag);
+
+    //! Compact member list of a group as built by prepareForRun
+    /*!
+     * Never rebuilds the list, so it is safe to call from host operation
+     * worker threads during a run.
+     */
+    std::vector<int> &preparedGroupMembers(uint32_t groupTag);
+    uint64_t groupTagChecksum; //!< Hash of per-atom group tags at the last pack, to catch tags edited directly
 
     bool is2d; //!< True for 2d simulations, else False
     bool periodic[3]; //!< If True, simulation is periodic in given dimension
@@ -124,7 +162,9 @@ public:
     std::vector<int> nlistBuildTurns; //!< turns at which we built the neighborlist
     int64_t runInit; //!< Timestep at which the current run started
     int64_t nextForceBuild; //!< Timestep neighborlists will definitely be build.  Fixes might need to request this
-    int dangerousRebuilds; //!< Unused
+    int dangerousRebuilds; //!< Builds in the last run where an atom had moved
+                           //!< more than half the padding before the check.
+                           //!< See NeighborListStats
     int periodicInterval; //!< Periodicity to wrap atoms and rebuild neighbor
                           //!< list
     bool requiresCharges; //!< Charges will be stored 
@@ -139,6 +179,10 @@ public:
      */
     double rCut;
     double padding; //!< Added to rCut for cutoff distance of neighbor building
+    bool typePairCutoffs; //!< If true, the neighbor list only holds pairs within
+                          //!< their own type pair cutoff + padding.  False by
+                          //!< default, since fixes and data computers which
+                          //!< assume rCut read the same list
     int exclusionMode; //!< Mode for handling bond list exclusions.  See comments for exclusions in GridGPU
     void setExclusionMode(std::string);
 
@@ -329,6 +373,8 @@ public:
     void createMolecule(std::vector<int> &ids);
     boost::python::object createMoleculePy(boost::python::list ids);
     void unwrapMolecules();
+    //! Unwrap molecules using the given bounds rather than the State's
+    void unwrapMolecules(Bounds &bounds);
 
     boost::python::object duplicateMolecule(Molecule &, int n);
     Atom &duplicateAtom(Atom);
@@ -337,7 +383,62 @@ public:
     int nThreadPerAtom; //!< number of threads per atom for pair computations and nlist building
     int nThreadPerBlock; //!< number of threads per block for pair computations and nlist building
     int tuneEvery;
-    
+    std::string tuneCacheFile; //!< File remembering tuned thread counts per
+                               //!< system between jobs.  Empty (default)
+                               //!< disables the cache
+    double tuneCacheTolerance; //!< Fractional slowdown of cached parameters
+                               //!< at which they are re-tuned
+    std::string traceFile; //!< If set, a Chrome trace of all runs so far is
+                           //!< written here at the end of each run
+    SHARED(TraceRecorder) tracer; //!< Null unless traceFile is set
+
+    //! Host and device memory by owner, from the AllocationRegistry
+    /*!
+     * Returns a dict of owner (fix handle, "atoms", "grid", "data",
+     * "unattributed" or "total") to a dict of current bytes, high-water marks
+     * and allocation counts since the start of the last run.
+     */
+    boost::python::dict memoryUsage();
+    //! memoryUsage() as a table
+    std::string memorySummary();
+
+    int hostOperationBuffers; //!< Number of snapshot buffers asynchronous
+                              //!< writes and python operations rotate
+                              //!< through.  Integrator only waits when all
+                              //!< are in use
+    double hostOperationStallTime; //!< Seconds spent waiting for a free
+                                   //!< snapshot buffer during the last run
+    int hostOperationStalls; //!< Number of host operations in the last run
+                             //!< which had to wait for a free buffer
+    int hostOperationCount; //!< Number of host operations in the last run
+
+    bool incrementalPrepare; //!< If True (default), runs resume from the
+                             //!< device data left by the previous run when
+                             //!< nothing on the host has changed
+    bool deviceDataCurrent; //!< Set by prepareForRun: device atom data from
+                            //!< the last run was kept rather than re-uploaded
+    bool gridCurrent; //!< Set by prepareForRun: grid and neighbor list from
+                      //!< the last run were kept
+    bool atomsDirty; //!< Host atoms or the active fixes were changed since
+                     //!< atom data was last packed.  Set by the State and
+                     //!< Molecule functions which edit atoms
+    bool atomsExposed; //!< Python has been handed references to atoms,
+                       //!< through State.atoms or selectGroup, and may edit
+                       //!< them without the State knowing.  From then on
+                       //!< atomChecksum is compared before skipping a pack
+    uint64_t atomChecksum; //!< checksumAtoms() as of the last pack or
+                           //!< download, kept while atomsExposed
+    uint64_t atomIdChecksum; //!< Hash of atom ids in host order as of the
+                             //!< last pack.  Bonded fixes pack by host index
+                             //!< and key off this
+    uint64_t topologyChecksum; //!< Hash of atom ids and all bonds, which
+                               //!< together determine the exclusions
+    uint64_t gridChecksum; //!< Hash of the parameters the grid was built with
+    uint64_t gridTopologyChecksum; //!< topologyChecksum the grid's exclusions
+                                   //!< were built from
+    int fullPrepareCount; //!< Number of runs which had to repack and upload
+                          //!< atom data
+
     bool verbose; //!< Verbose output
     int shoutEvery; //!< Report state of simulation every this many timesteps
     AtomParams atomParams; //!< Generic properties of the Atoms, e.g. masses,
@@ -382,20 +483,34 @@ public:
      */
     bool atomInGroup(Atom &a, std::string handle);
 
+    //! Check whether a given Atom is in the group with a given tag
+    /*!
+     * Works for both per-atom bit groups and extended groups (see GroupMask.h)
+     */
+    bool atomInGroup(Atom &a, uint32_t tag);
+
+    //! Device-side membership view of the group with a given tag
+    GroupMask groupMask(uint32_t tag);
+
     //! Perform asynchronous Host operations
     /*!
      * \param cb Function pointer for asynchronous calculation
      * \return Undefined
      *
-     * This function copies all data to its respective buffer and opens a new
-     * thread for an asynchronous operation. Typically this function is used
-     * to write data to file and process Python operations.
-     *
-     * \todo Function does return neither True nor False
+     * This function copies all data into the next free slot of the snapshot
+     * ring and hands it to that slot's worker thread for an asynchronous
+     * operation.  Operations complete in the order they were issued.
+     * Synchronous operations first drain the ring.  The callback receives the
+     * turn and the bounds at that turn.  Asynchronous operations are given a
+     * copy of the bounds and State::bounds is left alone.  Typically this
+     * function is used to write data to file and process Python operations.
      */
-    bool runtimeHostOperation(std::function<void (int64_t )> cb, bool async);
+    bool runtimeHostOperation(std::function<void (int64_t, Bounds &)> cb, bool async);
+
+    //! Wait for all outstanding asynchronous host operations to finish
+    void finishHostOperations();
 
-    boost::shared_ptr<std::thread> asyncData; //!< Shared pointer to a thread
+    boost::shared_ptr<HostOperationRing> hostOperations; //!< Snapshot buffers and worker threads for asynchronous host operations
     boost::shared_ptr<ReadConfig> readConfig; //!< Shared pointer to configuration reader
 
     //! Default constructor
@@ -458,10 +573,18 @@ public:
     /*!
      * \return True always
      *
-     * This function copies atom data to the gpu
+     * This function copies atom data to the gpu.  If neither the atoms nor
+     * the active fixes have been touched since the last run finished (see
+     * atomsDirty and atomsExposed), the device arrays from that run are still valid and
+     * packing is skipped; see deviceDataCurrent.
      *
      */
     bool prepareForRun();
+    //! Hash of every host atom field packed to the device
+    uint64_t checksumAtoms();
+    //! Pack atoms into gpd host arrays, ready for upload.  Also updates
+    //! atomIdChecksum and flags groups dirty if any group tags changed
+    void packAtoms();
     void copyAtomDataToGPU(std::vector<int> &idToIdx);
     //! Prepares GridGPU member of state.  called after fix prepare run, because 
     /*!
@@ -508,6 +631,11 @@ public:
      */
     int maxIdExisting;
     //! set gridGPU member.  used when preparing for run
+    /*!
+     * The grid from the last run is kept when device data, bounds, cutoffs,
+     * and topology are all unchanged.  Exclusions are kept whenever the
+     * topology is unchanged.
+     */
     void initializeGrid();
     std::vector<int> idBuffer; //!< Buffer of unused Atom Ids
 
@@ -0,0 +1,193 @@
+#include "TabulatedSpline.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include <boost/python.hpp>
+
+#include "Logging.h"
+#include "xml_func.h"
+
+namespace py = boost::python;
+
+namespace TabulatedSpline {
+
+namespace {
+    std::vector<double> toDoubles(py::object seq) {
+        std::vector<double> res;
+        int n = py::len(seq);
+        for (int i=0; i<n; i++) {
+            py::extract<double> x(seq[i]);
+            mdAssert(x.check(), "Table entries must be numbers");
+            res.push_back(x);
+        }
+        return res;
+    }
+}
+
+std::vector<float4> Table::coefficients() const {
+    return TabulatedSpline::coefficients(values, derivs, dx, periodic);
+}
+
+std::pair<double, double> Table::evaluate(double x) const {
+    std::vector<float4> coefs = coefficients();
+    float2 ed = TabulatedSpline::evaluate(coefs.data(), coefs.size(), x0, 1 / dx, x);
+    return std::make_pair((double) ed.x, (double) -ed.y);
+}
+
+std::string Table::restartChunk(std::string attributes) const {
+    std::stringstream ss;
+    ss.precision(17);
+    ss << "<table " << attributes << " x0='" << x0 << "' dx='" << dx
+       << "' n='" << values.size() << "' derivs='" << (derivs.size() ? 1 : 0) << "'>\n";
+    for (double v : values) {
+        ss << v << "\n";
+    }
+    for (double d : derivs) {
+        ss << d << "\n";
+    }
+    ss << "</table>\n";
+    return ss.str();
+}
+
+Table tableFromPython(double x0, double xMax, py::object energies, py::object forces) {
+    Table table;
+    table.values = toDoubles(energies);
+    for (double f : toDoubles(forces)) {
+        table.derivs.push_back(-f);
+    }
+    mdAssert(table.values.size() >= 2, "A table needs at least two points");
+    mdAssert(xMax > x0, "A table must end after it starts");
+    mdAssert(table.derivs.empty() or table.derivs.size() == table.values.size(),
+             "A table needs as many forces as energies");
+    table.x0 = x0;
+    table.dx = (xMax - x0) / (table.values.size() - 1);
+    return table;
+}
+
+Table tableFromFile(std::string fn) {
+    std::ifstream file(fn.c_str());
+    mdAssert(file.good(), "Could not open table file %s", fn.c_str());
+    std::vector<double> xs;
+    std::vector<double> forces;
+    Table table;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos or line[start] == '#') {
+            continue;
+        }
+        std::istringstream ss(line);
+        double x, e, f;
+        mdAssert((bool) (ss >> x >> e), "Bad line in table file %s: %s", fn.c_str(), line.c_str());
+        xs.push_back(x);
+        table.values.push_back(e);
+        if (ss >> f) {
+            forces.push_back(f);
+        }
+    }
+    mdAssert(xs.size() >= 2, "Table file %s needs at least two points", fn.c_str());
+    mdAssert(forces.empty() or forces.size() == xs.size(),
+             "Table file %s gives forces for only some points", fn.c_str());
+    table.x0 = xs[0];
+    table.dx = (xs.back() - xs[0]) / (xs.size() - 1);
+    mdAssert(table.dx > 0, "Table file %s must be in increasing order", fn.c_str());
+    for (int i=1; i<xs.size(); i++) {
+        mdAssert(fabs(xs[i] - (table.x0 + i * table.dx)) < 1e-4 * table.dx,
+                 "Points in table file %s must be uniformly spaced", fn.c_str());
+    }
+    for (double f : forces) {
+        table.derivs.push_back(-f);
+    }
+    return table;
+}
+
+Table tableFromRestart(pugi::xml_node &node) {
+    Table table;
+    table.x0 = atof(node.attribute("x0").value());
+    table.dx = atof(node.attribute("dx").value());
+    int n = atoi(node.attribute("n").value());
+    bool hasDerivs = atoi(node.attribute("derivs").value());
+    std::vector<double> nums = xml_readNums<double>(node);
+    mdAssert(nums.size() == (hasDerivs ? 2 : 1) * n, "Invalid table in restart file");
+    table.values = std::vector<double>(nums.begin(), nums.begin() + n);
+    if (hasDerivs) {
+        table.derivs = std::vector<double>(nums.begin() + n, nums.end());
+    }
+    return table;
+}
+
+std::vector<double> naturalDerivatives(const std::vector<double> &values, double dx) {
+    int n = values.size();
+    mdAssert(n >= 2, "A table needs at least two points");
+    if (n == 2) {
+        return std::vector<double>(2, (values[1] - values[0]) / dx);
+    }
+    //second derivatives, zero at the ends, from the tridiagonal system
+    //M_{i-1} + 4 M_i + M_{i+1} = 6 (f_{i-1} - 2 f_i + f_{i+1}) / dx^2
+    std::vector<double> secondDerivs(n, 0);
+    std::vector<double> diag(n, 4);
+    std::vector<double> rhs(n, 0);
+    for (int i=1; i<n-1; i++) {
+        rhs[i] = 6 * (values[i-1] - 2 * values[i] + values[i+1]) / (dx * dx);
+    }
+    for (int i=2; i<n-1; i++) {
+        double w = 1 / diag[i-1];
+        diag[i] -= w;
+        rhs[i] -= w * rhs[i-1];
+    }
+    for (int i=n-2; i>0; i--) {
+        secondDerivs[i] = (rhs[i] - secondDerivs[i+1]) / diag[i];
+    }
+    std::vector<double> derivs(n);
+    for (int i=0; i<n-1; i++) {
+        derivs[i] = (values[i+1] - values[i]) / dx - dx * (2 * secondDerivs[i] + secondDerivs[i+1]) / 6;
+    }
+    derivs[n-1] = (values[n-1] - values[n-2]) / dx + dx * (secondDerivs[n-2] + 2 * secondDerivs[n-1]) / 6;
+    return derivs;
+}
+
+std::vector<double> periodicDerivatives(const std::vector<double> &values, double dx) {
+    int n = values.size();
+    mdAssert(n >= 2, "A table needs at least two points");
+    double scale = fmax(fabs(values[0]), fabs(values[n-1]));
+    mdAssert(fabs(values[n-1] - values[0]) <= 1e-6 * fmax(scale, 1.0),
+             "The last point of a periodic table must equal the first");
+    int period = n - 1;
+    //enough periods on each side for at least 16 padding samples
+    int padPeriods = (16 + period - 1) / period;
+    std::vector<double> repeated;
+    for (int p=0; p<2*padPeriods+1; p++) {
+        repeated.insert(repeated.end(), values.begin(), values.end() - 1);
+    }
+    repeated.push_back(values[0]);
+    std::vector<double> repeatedDerivs = naturalDerivatives(repeated, dx);
+    std::vector<double> derivs(repeatedDerivs.begin() + padPeriods * period,
+                               repeatedDerivs.begin() + padPeriods * period + n);
+    derivs[n-1] = derivs[0];
+    return derivs;
+}
+
+std::vector<float4> coefficients(const std::vector<double> &values,
+                                 const std::vector<double> &derivs_, double dx, bool periodic) {
+    mdAssert(values.size() >= 2, "A table needs at least two points");
+    mdAssert(derivs_.empty() or derivs_.size() == values.size(),
+             "A table needs as many derivatives as values");
+    mdAssert(dx > 0, "Table spacing must be positive");
+    std::vector<double> derivs = derivs_;
+    if (derivs.empty()) {
+        derivs = periodic ? periodicDerivatives(values, dx) : naturalDerivatives(values, dx);
+    }
+    std::vector<float4> coefs(values.size() - 1);
+    for (int i=0; i<coefs.size(); i++) {
+        double y0 = values[i];
+        double y1 = values[i+1];
+        double m0 = derivs[i] * dx;
+        double m1 = derivs[i+1] * dx;
+        coefs[i] = make_float4(y0, m0, 3 * (y1 - y0) - 2 * m0 - m1, 2 * (y0 - y1) + m0 + m1);
+    }
+    return coefs;
+}
+
+}
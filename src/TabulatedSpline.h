@@ -0,0 +1,131 @@
+#pragma once
+#ifndef TABULATEDSPLINE_H
+#define TABULATEDSPLINE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#undef _XOPEN_SOURCE
+#undef _POSIX_C_SOURCE
+#include <boost/python/object.hpp>
+
+#include "cutils_math.h"
+
+namespace pugi {
+    class xml_node;
+}
+
+//! Cubic splines through uniformly spaced samples, for tabulated potentials
+/*!
+ * A table of n samples f_0..f_{n-1} at x_0 + i dx is stored as n-1 segments
+ * of one float4 each.  With t = (x - x_i) / dx in segment i,
+ *
+ *     f(x)  = c.x + t (c.y + t (c.z + t c.w))
+ *     f'(x) = (c.y + t (2 c.z + 3 t c.w)) / dx
+ *
+ * so one 16-byte load gives both the value and its derivative, and force and
+ * energy are always consistent.  Segments are cubic Hermite polynomials
+ * through the samples and their derivatives.  If no derivatives are given,
+ * those of the natural cubic spline are used.
+ */
+namespace TabulatedSpline {
+
+    //! Energies sampled at uniformly spaced points, as given by the user
+    class Table {
+    public:
+        double x0;                  //!< First sample point
+        double dx;                  //!< Sample spacing
+        std::vector<double> values; //!< Energies at the samples
+        std::vector<double> derivs; //!< dE/dx at the samples, or empty
+        bool periodic = false;      //!< Last sample repeats the first, as for angles of rotation
+
+        double xMax() const {
+            return x0 + dx * (values.size() - 1);
+        }
+        //! Segment coefficients, see coefficients()
+        std::vector<float4> coefficients() const;
+        //! Energy and -dE/dx at x, evaluated on the host as on the device
+        std::pair<double, double> evaluate(double x) const;
+        //! Samples as a <table> xml element with extra attributes
+        std::string restartChunk(std::string attributes) const;
+    };
+
+    //! Table from python sequences of energies and, optionally, forces
+    /*!
+     * \param x0 First sample point
+     * \param xMax Last sample point
+     * \param energies Energies at uniformly spaced points from x0 to xMax
+     * \param forces -dE/dx at the same points, or an empty sequence
+     */
+    Table tableFromPython(double x0, double xMax, boost::python::object energies,
+                          boost::python::object forces);
+
+    //! Table from a text file of lines "x energy [force]"
+    /*!
+     * Blank lines and lines starting with # are skipped.  Points must be
+     * uniformly spaced, and force is -dE/dx.  If the force column is missing
+     * the natural spline through the energies is used.
+     */
+    Table tableFromFile(std::string fn);
+
+    //! Table from an element written by Table::restartChunk
+    Table tableFromRestart(pugi::xml_node &node);
+
+    //! Derivatives at the samples of the natural cubic spline through them
+    std::vector<double> naturalDerivatives(const std::vector<double> &values, double dx);
+
+    //! Derivatives at the samples of the periodic cubic spline through them
+    /*!
+     * The last sample must equal the first.  The natural spline through the
+     * samples repeated over several periods is used; end effects decay by a
+     * factor of about four per sample, so the middle period is periodic to
+     * well within float precision.
+     */
+    std::vector<double> periodicDerivatives(const std::vector<double> &values, double dx);
+
+    //! Segment coefficients for samples and their derivatives
+    /*!
+     * \param values Samples, at least two
+     * \param derivs df/dx at the samples, or empty for the natural spline
+     * \param dx Sample spacing
+     * \param periodic Use the periodic rather than the natural spline if no
+     *                 derivatives are given
+     */
+    std::vector<float4> coefficients(const std::vector<double> &values,
+                                     const std::vector<double> &derivs, double dx,
+                                     bool periodic=false);
+
+    //! Value and derivative of a table at x
+    /*!
+     * \param coefs Segments of the table
+     * \param nSegments Number of segments
+     * \param x0 Position of the first sample
+     * \param invDx Inverse sample spacing
+     *
+     * \return (f(x), df/dx).  Outside the table f continues linearly from
+     *         the nearest end
+     */
+    inline __host__ __device__ float2 evaluate(const float4 *coefs, int nSegments,
+                                               float x0, float invDx, float x) {
+        float u = (x - x0) * invDx;
+        int i = (int) floorf(u);
+        i = i < 0 ? 0 : (i >= nSegments ? nSegments - 1 : i);
+        float t = u - i;
+        float4 c = coefs[i];
+        float value, deriv;
+        if (t < 0) {
+            deriv = c.y;
+            value = c.x + t * deriv;
+        } else if (t > 1) {
+            deriv = c.y + 2 * c.z + 3 * c.w;
+            value = c.x + c.y + c.z + c.w + (t - 1) * deriv;
+        } else {
+            value = c.x + t * (c.y + t * (c.z + t * c.w));
+            deriv = c.y + t * (2 * c.z + 3 * t * c.w);
+        }
+        return make_float2(value, deriv * invDx);
+    }
+}
+
+#endif
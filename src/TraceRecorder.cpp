@@ -0,0 +1,71 @@
+#include "TraceRecorder.h"
+
+#include <fstream>
+
+#include "Logging.h"
+
+namespace {
+    std::atomic<uint64_t> nextRecorderId(1);
+    thread_local uint64_t cachedRecorderId = 0;
+    thread_local void *cachedBuffer = nullptr;
+
+    std::string escape(const std::string &s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' or c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out;
+    }
+}
+
+TraceRecorder::TraceRecorder() {
+    id = nextRecorderId++;
+    t0 = std::chrono::steady_clock::now();
+}
+
+TraceRecorder::Buffer *TraceRecorder::threadBuffer() {
+    if (cachedRecorderId == id) {
+        return (Buffer *) cachedBuffer;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    boost::shared_ptr<Buffer> buffer = boost::shared_ptr<Buffer>(new Buffer());
+    buffer->tid = buffers.size();
+    buffers.push_back(buffer);
+    cachedRecorderId = id;
+    cachedBuffer = buffer.get();
+    return buffer.get();
+}
+
+void TraceRecorder::write(const std::string &fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool append = fn == written;
+    std::ofstream f(fn.c_str(), append ? std::ios::app : std::ios::trunc);
+    if (not f) {
+        mdWarning("Could not open trace file %s\n", fn.c_str());
+        buffers.clear();
+        id = nextRecorderId++;
+        return;
+    }
+    if (not append) {
+        //every later entry, in this write or the next, follows a comma
+        f << "[\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"DASH\"}}";
+    }
+    for (boost::shared_ptr<Buffer> &buffer : buffers) {
+        //the first thread to record is the one running the integrator
+        f << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << buffer->tid
+          << ", \"args\": {\"name\": \"" << (buffer->tid ? "host operation " + std::to_string(buffer->tid) : std::string("integrator")) << "\"}}";
+        for (Event &e : buffer->events) {
+            f << ",\n{\"name\": \"" << escape(e.name) << "\", \"ph\": \"" << e.ph << "\", \"ts\": " << e.ts
+              << ", \"pid\": 0, \"tid\": " << buffer->tid << "}";
+        }
+    }
+    f.flush();
+    written = fn;
+    //threads' cached pointers are for the old id, so each registers a new
+    //buffer the next time it records
+    buffers.clear();
+    id = nextRecorderId++;
+}
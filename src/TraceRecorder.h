@@ -0,0 +1,98 @@
+#pragma once
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+//! Records begin/end events for Chrome/Perfetto's trace viewer
+/*!
+ * Each thread appends to its own buffer, found through a thread_local
+ * pointer, so recording takes no lock.  A mutex is only taken the first time
+ * a thread records into a given recorder after each write.  Buffers are
+ * read by write(), which must only be called once the threads recording
+ * into them are idle (the integrator calls it from basicFinish, after host
+ * operations are drained).  write() appends the buffered events to the
+ * file and then releases every buffer, so memory does not grow over runs
+ * and buffers of host operation threads which have since exited are freed.
+ *
+ * The file uses the JSON array form of the trace-event format, whose
+ * closing bracket is optional, so later writes can simply append.
+ *
+ * Times are host times.  Kernel launches are asynchronous, so device work
+ * shows up wherever the host next waits for it.
+ */
+class TraceRecorder {
+public:
+    class Event {
+    public:
+        std::string name;
+        int64_t ts;   //!< Microseconds since the recorder was created
+        char ph;      //!< 'B' begin or 'E' end
+        Event(const std::string &name_, int64_t ts_, char ph_) : name(name_), ts(ts_), ph(ph_) {}
+    };
+
+    TraceRecorder();
+
+    void begin(const std::string &name) {
+        record(name, 'B');
+    }
+    void end(const std::string &name) {
+        record(name, 'E');
+    }
+
+    //! Append everything recorded since the last write to fn
+    /*!
+     * The file is started over by the first write, and whenever fn changes
+     */
+    void write(const std::string &fn);
+
+private:
+    class Buffer {
+    public:
+        int tid;
+        std::vector<Event> events;
+    };
+    uint64_t id; //!< Distinguishes recorders, and buffer generations of a
+                 //!< recorder, in threads' cached buffer pointers
+    std::chrono::steady_clock::time_point t0;
+    std::string written; //!< File the last write went to
+    std::mutex mutex;
+    std::vector<boost::shared_ptr<Buffer> > buffers;
+
+    Buffer *threadBuffer();
+    void record(const std::string &name, char ph) {
+        int64_t ts = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+        threadBuffer()->events.push_back(Event(name, ts, ph));
+    }
+};
+
+//! Records a begin event on construction and the matching end on destruction
+/*!
+ * Does nothing if tracer is null, without building the event name.
+ */
+class TraceScope {
+public:
+    TraceScope(TraceRecorder *tracer_, const char *name_, const std::string &detail="") : tracer(tracer_) {
+        if (tracer) {
+            name = detail.size() ? std::string(name_) + " " + detail : std::string(name_);
+            tracer->begin(name);
+        }
+    }
+    ~TraceScope() {
+        if (tracer) {
+            tracer->end(name);
+        }
+    }
+private:
+    TraceRecorder *tracer;
+    std::string name;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "TuneCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "Logging.h"
+
+std::string TuneCache::signature(int nAtoms, double density, double cutoff, int nPerRingPoly, std::string device,
+                                 int major, int minor, std::vector<std::string> fixTypes) {
+    //log2 below, so an empty state gets the same signature as one atom
+    nAtoms = std::max(nAtoms, 1);
+    std::sort(fixTypes.begin(), fixTypes.end());
+    std::ostringstream sig;
+    sig << "n" << lround(4 * log2(nAtoms))
+        << "|rho" << lround(8 * log2(density))
+        << "|cut" << lround(10 * cutoff)
+        << "|rp" << nPerRingPoly
+        << "|" << device << "_sm" << major << minor << "|";
+    for (size_t i=0; i<fixTypes.size(); i++) {
+        sig << (i ? "," : "") << fixTypes[i];
+    }
+    //file is whitespace-separated
+    std::string res = sig.str();
+    std::replace(res.begin(), res.end(), ' ', '_');
+    return res;
+}
+
+void TuneCache::load() {
+    entries.clear();
+    std::ifstream f(fn.c_str());
+    std::string line;
+    while (std::getline(f, line)) {
+        std::istringstream ss(line);
+        std::string signature;
+        Entry entry;
+        if (ss >> signature >> entry.nThreadPerBlock >> entry.nThreadPerAtom >> entry.timePerAtomEval) {
+            entries[signature] = entry;
+        }
+    }
+}
+
+void TuneCache::save() {
+    //write beside the cache and rename so concurrent readers never see a partial file
+    std::ostringstream tmpName;
+    tmpName << fn << ".tmp" << getpid();
+    std::string tmp = tmpName.str();
+    {
+        std::ofstream f(tmp.c_str());
+        if (not f) {
+            mdWarning("Could not write tuning cache %s\n", tmp.c_str());
+            return;
+        }
+        f.precision(8);
+        for (auto it = entries.begin(); it != entries.end(); it++) {
+            f << it->first << " " << it->second.nThreadPerBlock << " "
+              << it->second.nThreadPerAtom << " " << it->second.timePerAtomEval << "\n";
+        }
+    }
+    if (std::rename(tmp.c_str(), fn.c_str())) {
+        mdWarning("Could not replace tuning cache %s\n", fn.c_str());
+        std::remove(tmp.c_str());
+    }
+}
+
+bool TuneCache::lookup(const std::string &signature, Entry &entry) {
+    if (not enabled()) {
+        return false;
+    }
+    load();
+    auto it = entries.find(signature);
+    if (it == entries.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+void TuneCache::store(const std::string &signature, const Entry &entry) {
+    if (not enabled()) {
+        return;
+    }
+    load();
+    entries[signature] = entry;
+    save();
+}
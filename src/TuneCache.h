@@ -0,0 +1,64 @@
+#pragma once
+#ifndef TUNECACHE_H
+#define TUNECACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+//! On-disk record of runtime parameters chosen by Integrator::tune
+/*!
+ * Each line of the file holds a system signature (see signature())
+ * followed by the parameters the tuner settled on
+ * and the time per atom per force evaluation measured with them.  Loading is
+ * tolerant of missing or malformed files, which simply give an empty cache.
+ * Stores re-read the file first so that jobs sharing a cache do not discard
+ * each other's entries, and replace it atomically.
+ */
+class TuneCache {
+public:
+    //! Tuned parameters for one system signature
+    class Entry {
+    public:
+        int nThreadPerBlock;
+        int nThreadPerAtom;
+        double timePerAtomEval; //!< Seconds per atom per force evaluation
+        Entry() : nThreadPerBlock(0), nThreadPerAtom(0), timePerAtomEval(0) {}
+        Entry(int nThreadPerBlock_, int nThreadPerAtom_, double timePerAtomEval_)
+            : nThreadPerBlock(nThreadPerBlock_), nThreadPerAtom(nThreadPerAtom_),
+              timePerAtomEval(timePerAtomEval_) {}
+    };
+
+    //! \param fn_ Cache file.  An empty name disables the cache
+    TuneCache(std::string fn_) : fn(fn_) {}
+
+    bool enabled() const {
+        return not fn.empty();
+    }
+
+    //! Key identifying a system
+    /*!
+     * The atom count and density go in logarithmic buckets, so jobs on
+     * slightly different systems share an entry.  cutoff is the largest
+     * neighbor list cutoff plus padding, and fixTypes may come in any order.
+     */
+    static std::string signature(int nAtoms, double density, double cutoff, int nPerRingPoly, std::string device,
+                                 int major, int minor, std::vector<std::string> fixTypes);
+
+    //! Look up signature, reading the file
+    /*!
+     * \return True if an entry was found
+     */
+    bool lookup(const std::string &signature, Entry &entry);
+
+    //! Record entry for signature and write the file
+    void store(const std::string &signature, const Entry &entry);
+
+private:
+    std::string fn;
+    std::map<std::string, Entry> entries;
+    void load();
+    void save();
+};
+
+#endif
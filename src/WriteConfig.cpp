@@ -67,6 +67,17 @@ void outputGroups(ofstream &outFile, State *state) {
         outFile << it->second<< "\n";
     }
     outFile << "</groupBits>\n";
+    //extended groups aren't in the per-atom tags, so store their members' ids
+    for (auto it = state->groups.begin(); it != state->groups.end(); it++) {
+        Group &group = it->second;
+        if (group.isExtended()) {
+            outFile << "<groupMembers tag=\"" << group.groupTag << "\">\n";
+            for (uint id : group.atomIds) {
+                outFile << id << " ";
+            }
+            outFile << "</groupMembers>\n";
+        }
+    }
     outFile << "</groupInfo>\n";
 }
 
@@ -89,10 +100,10 @@ void outputMolecules(ofstream &outFile, State *state) {
 
 }
 
-void writeXMLfileBase64(State *state, string fnFinal, int64_t turn, bool oneFilePerWrite, uint groupBit) {
+void writeXMLfileBase64(State *state, Bounds &bounds, string fnFinal, int64_t turn, bool oneFilePerWrite, uint groupBit) {
     vector<Atom> &atoms = state->atoms;
     ofstream outFile;
-    Bounds b = state->bounds;
+    Bounds &b = bounds;
     if (oneFilePerWrite) {
         outFile.open(fnFinal.c_str(), ofstream::out);
         outFile << "<data>" << endl;
@@ -163,7 +174,7 @@ void writeXMLfileBase64(State *state, string fnFinal, int64_t turn, bool oneFile
 }
 
 
-void writeLAMMPSTRJFile(State *state, string fn, int64_t turn, bool oneFilePerWrite, uint groupBit) {
+void writeLAMMPSTRJFile(State *state, Bounds &bounds, string fn, int64_t turn, bool oneFilePerWrite, uint groupBit) {
     vector<Atom> &atoms = state->atoms;
     AtomParams &params = state->atomParams;
     int count = 0;
@@ -174,36 +185,41 @@ void writeLAMMPSTRJFile(State *state, string fn, int64_t turn, bool oneFilePerWr
     } else {
         outFile.open(fn.c_str(), ofstream::app);
     }
+	std::vector<int> *members = nullptr;
 	if (groupBit == 1) {
         count = atoms.size();
 	} else {
-		for (Atom &a : atoms) {
-			if (a.groupTag & groupBit) {
-				count ++;
-			}
-		}
+		members = &state->preparedGroupMembers(groupBit);
+		count = members->size();
 	}
 
     // WRITE THE HEADER INFORMATION
     outFile << "ITEM: TIMESTEP" << endl << turn << endl;    // TIMESTEP
     outFile << "ITEM: NUMBER OF ATOMS" << endl << count << endl;   // NUMBER OF ATOMS
     outFile << "ITEM: BOX BOUNDS pp pp pp" << endl;
-    outFile << state->bounds.lo[0] << " " << state->bounds.lo[0] + state->bounds.rectComponents[0] << endl;
-    outFile << state->bounds.lo[1] << " " << state->bounds.lo[1] + state->bounds.rectComponents[1] << endl;
-    outFile << state->bounds.lo[2] << " " << state->bounds.lo[2] + state->bounds.rectComponents[2] << endl;       // BOX DIMENSION
+    outFile << bounds.lo[0] << " " << bounds.lo[0] + bounds.rectComponents[0] << endl;
+    outFile << bounds.lo[1] << " " << bounds.lo[1] + bounds.rectComponents[1] << endl;
+    outFile << bounds.lo[2] << " " << bounds.lo[2] + bounds.rectComponents[2] << endl;       // BOX DIMENSION
 
     // WRITE THE ATOM rectINFORMATION
     outFile << "ITEM: ATOMS id type x y z" << endl;         // ATOM HEADER
-    for (Atom &a : atoms) {
-        if (a.groupTag & groupBit) {
-            outFile << a.id << " " << a.type << " " << a.pos[0] << " " << a.pos[1] << " " << a.pos[2] << endl;
+    auto writeAtom = [&] (Atom &a) {
+        outFile << a.id << " " << a.type << " " << a.pos[0] << " " << a.pos[1] << " " << a.pos[2] << endl;
+    };
+    if (members) {
+        for (int idx : *members) {
+            writeAtom(atoms[idx]);
+        }
+    } else {
+        for (Atom &a : atoms) {
+            writeAtom(a);
         }
     }
 
     outFile.close();
 }
 
-void writeXYZFile(State *state, string fn, int64_t turn, bool oneFilePerWrite, uint groupBit) {
+void writeXYZFile(State *state, Bounds &bounds, string fn, int64_t turn, bool oneFilePerWrite, uint groupBit) {
     vector<Atom> &atoms = state->atoms;
     AtomParams &params = state->atomParams;
     bool useAtomicNums = true;
@@ -218,36 +234,39 @@ void writeXYZFile(State *state, string fn, int64_t turn, bool oneFilePerWrite, u
     } else {
         outFile.open(fn.c_str(), ofstream::app);
     }
+	std::vector<int> *members = nullptr;
 	if (groupBit == 1) {
-		outFile << atoms.size() <<  endl << "bounds lo " << state->bounds.lo << " hi " << (state->bounds.lo + state->bounds.rectComponents);
+		outFile << atoms.size() <<  endl << "bounds lo " << bounds.lo << " hi " << (bounds.lo + bounds.rectComponents);
 	} else {
-		int count = 0;
-		for (Atom &a : atoms) {
-			if (a.groupTag & groupBit) {
-				count ++;
-			}
-		}
-		outFile << count <<  endl << "bounds lo " << state->bounds.lo << " hi " << (state->bounds.lo + state->bounds.rectComponents);
+		members = &state->preparedGroupMembers(groupBit);
+		outFile << members->size() <<  endl << "bounds lo " << bounds.lo << " hi " << (bounds.lo + bounds.rectComponents);
 	}
-    for (Atom &a : atoms) {
-		if (a.groupTag & groupBit) {
-			int atomicNum;
-			if (useAtomicNums) {
-				atomicNum = params.atomicNums[a.type];
-			} else {
-				atomicNum = a.type;
-			}
-			outFile << endl << atomicNum << " " << a.pos[0] << " " << a.pos[1] << " " << a.pos[2];
-		}
+    auto writeAtom = [&] (Atom &a) {
+        int atomicNum;
+        if (useAtomicNums) {
+            atomicNum = params.atomicNums[a.type];
+        } else {
+            atomicNum = a.type;
+        }
+        outFile << endl << atomicNum << " " << a.pos[0] << " " << a.pos[1] << " " << a.pos[2];
+    };
+    if (members) {
+        for (int idx : *members) {
+            writeAtom(atoms[idx]);
+        }
+    } else {
+        for (Atom &a : atoms) {
+            writeAtom(a);
+        }
     }
     outFile << endl;
     outFile.close();
 }
 
-void writeXMLfile(State *state, string fnFinal, int64_t turn, bool oneFilePerWrite, uint groupBit) {
+void writeXMLfile(State *state, Bounds &bounds, string fnFinal, int64_t turn, bool oneFilePerWrite, uint groupBit) {
     vector<Atom> &atoms = state->atoms;
     ofstream outFile;
-    Bounds b = state->bounds;
+    Bounds &b = bounds;
     if (oneFilePerWrite) {
         outFile.open(fnFinal.c_str(), ofstream::out);
         outFile << "<data>" << endl;
@@ -415,18 +434,23 @@ void WriteConfig::finish() {
 }
 
 
-void WriteConfig::write(int64_t turn) {
+void WriteConfig::write(int64_t turn, Bounds &bounds) {
+    TraceScope scope(state->tracer.get(), "write", handle);
     if (unwrapMolecules) {
-        state->unwrapMolecules();
+        state->unwrapMolecules(bounds);
     }
-    writeFormat(state, getCurrentFn(turn), turn, oneFilePerWrite, groupBit);
+    writeFormat(state, bounds, getCurrentFn(turn), turn, oneFilePerWrite, groupBit);
 }
 void WriteConfig::writePy() {
     state->atomParams.guessAtomicNumbers();
+    if (groupBit != 1) {
+        //writers only read member lists built in prepareForRun, so bring them up to date here
+        state->groupMembers(groupBit);
+    }
     if (unwrapMolecules) {
         state->unwrapMolecules();
     }
-    writeFormat(state, getCurrentFn(state->turn), state->turn, oneFilePerWrite, groupBit);
+    writeFormat(state, state->bounds, getCurrentFn(state->turn), state->turn, oneFilePerWrite, groupBit);
 }
 
 
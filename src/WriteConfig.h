@@ -16,7 +16,7 @@ void export_WriteConfig();
 class WriteConfig {
 
 private:
-    void (*writeFormat)(State *, std::string, int64_t, bool, uint);    
+    void (*writeFormat)(State *, Bounds &, std::string, int64_t, bool, uint);    
 
 public:
     State *state;
@@ -44,7 +44,7 @@ public:
     void unwrap();
     void finish();
 
-    void write(int64_t turn);
+    void write(int64_t turn, Bounds &bounds);
     void writePy();
     std::string getCurrentFn(int64_t turn);
 
@@ -6,6 +6,7 @@
 #include "cutils_math.h"
 #include "Virial.h"
 #include "SharedMem.h"
+#include "GroupMask.h"
 #define N_DATA_PER_THREAD 4 //must be power of 2, 4 found to be fastest for a floats and float4s
 //tests show that N_DATA_PER_THREAD = 4 is fastest
 
@@ -161,13 +162,16 @@ public:\
     inline __host__ __device__ TO zero() {\
         return ( ZERO );\
     }\
+    inline __host__ __device__ bool willProcess(FROM *src, int idx) {\
+        return true;\
+    }\
 };\
 \
 class NAME ## If {\
 public:\
     float4 *fs;\
-    uint32_t groupTag;\
-    NAME ## If (float4 *fs_, uint32_t groupTag_) : fs(fs_), groupTag(groupTag_) {}\
+    GroupMask group;\
+    NAME ## If (float4 *fs_, GroupMask group_) : fs(fs_), group(group_) {}\
     inline __host__ __device__ TO process (FROM & VARNAME_PROC ) {\
         return ( PROC );\
     }\
@@ -176,7 +180,7 @@ public:\
     }\
     inline __host__ __device__ bool willProcess(FROM *src, int idx) {\
         uint32_t atomGroupTag = * (uint32_t *) &(fs[idx].w);\
-        return atomGroupTag & groupTag;\
+        return group.contains(atomGroupTag, idx);\
     }\
 };
 
@@ -250,9 +254,30 @@ __global__ void accumulate_gpu(K *dest, T *src, int n, int warpSize, C instance)
     }
 }
 
+//index sources for accumulate_gpu_if.  Thread element i of n reduces src[index(i)]
+
+//every element of src
+class IndexAll {
+public:
+    inline __host__ __device__ int operator()(int i) {
+        return i;
+    }
+};
+
+//members of a group only, gathered through the group's id list
+class IndexGroupMembers {
+public:
+    uint *groupIds;
+    int *idToIdxs;
+    IndexGroupMembers(uint *groupIds_, int *idToIdxs_) : groupIds(groupIds_), idToIdxs(idToIdxs_) {}
+    inline __host__ __device__ int operator()(int i) {
+        return idToIdxs[groupIds[i]];
+    }
+};
+
 //dealing with the common case of summing based on group tags
-template <class K, class T, class C, int NPERTHREAD>
-__global__ void accumulate_gpu_if(K *dest, T *src, int n, int warpSize, C instance) {
+template <class K, class T, class C, int NPERTHREAD, class I>
+__global__ void accumulate_gpu_if(K *dest, T *src, int n, int warpSize, C instance, I index) {
     SharedMemory<K> sharedMem;
     K *tmp = sharedMem.getPointer();
 
@@ -262,7 +287,7 @@ __global__ void accumulate_gpu_if(K *dest, T *src, int n, int warpSize, C instan
     for (int i=0; i<NPERTHREAD; i++) {
         int step = i * copyIncrement;
         if (copyBaseIdx + step < n) {
-            int curIdx = copyBaseIdx + step;
+            int curIdx = index(copyBaseIdx + step);
             if (instance.willProcess(src, curIdx)) { //can deal with bounds here
                 numAdded ++;
                 tmp[threadIdx.x + step] = instance.process(src[curIdx]);
@@ -22,6 +22,21 @@ void cumulativeSum(T *data, K n) {
     }
     data[n-1] = currentVal; //okay, so now nth place has grid's starting Idx, n+1th place has ending
 }
+
+#define HASH_SEED 14695981039346656037ULL
+
+//! FNV-1a hash of n bytes, continuing from h (start from HASH_SEED)
+/*!
+ * Used to tell whether host-side data has changed between runs so that
+ * unchanged data does not have to be packed and uploaded again.
+ */
+inline uint64_t hashBytes(uint64_t h, const void *data, size_t n) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i=0; i<n; i++) {
+        h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+    return h;
+}
 /*
             vals[0] = xx;
             vals[1] = yy;
@@ -39,6 +54,15 @@ inline __device__ void computeVirial(Virial &v, float3 force, float3 dr) {
     v[5] += force.y * dr.z;
 }
 
+//! computeVirial for a virial other threads may be adding to
+inline __device__ void atomicAddVirial(Virial &v, float3 force, float3 dr) {
+    Virial virial(0, 0, 0, 0, 0, 0);
+    computeVirial(virial, force, dr);
+    for (int i=0; i<6; i++) {
+        atomicAdd(&(v[i]), virial[i]);
+    }
+}
+
 template <class SRCVar, class SRCBase, class SRCFull, class DEST, class TYPEHOLDER, int N>
 int copyMultiAtomToGPU(int nAtoms, std::vector<SRCVar> &src, std::vector<int> &idToIdx, GPUArrayDeviceGlobal<DEST> *dest, GPUArrayDeviceGlobal<int> *destIdxs, std::unordered_map<int, TYPEHOLDER> *forcerTypes, GPUArrayDeviceGlobal<TYPEHOLDER> *parameters, int maxExistingType) {
     std::vector<int> idxs(nAtoms+1, 0); //started out being used as counts
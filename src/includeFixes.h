@@ -3,17 +3,22 @@
 #include "FixBondHarmonic.h"
 #include "FixBondQuartic.h"
 #include "FixBondFENE.h"
+#include "FixBondTabulated.h"
 #include "FixAngleHarmonic.h"
 #include "FixAngleCHARMM.h"
 #include "FixAngleCosineDelta.h"
+#include "FixAngleTabulated.h"
 #include "FixImproperHarmonic.h"
 #include "FixImproperCVFF.h"
 #include "FixDihedralOPLS.h"
 #include "FixDihedralCHARMM.h"
+#include "FixDihedralTabulated.h"
 #include "FixLJCut.h"
 #include "FixLJCutFS.h"
 #include "FixLJCHARMM.h"
+#include "FixLJCutSoftCore.h"
 #include "FixTICG.h"
+#include "FixPairTabulated.h"
 #include "Fix2d.h"
 #include "Fix.h"
 #include "FixNoseHoover.h"
@@ -35,4 +40,6 @@
 #include "FixExternalQuartic.h"
 #include "FixRingPolyPot.h"
 #include "FixDeform.h"
+#include "FixCVHarmonic.h"
+#include "FixCVMetadynamics.h"
 
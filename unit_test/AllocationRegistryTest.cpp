@@ -0,0 +1,150 @@
+#include "AllocationRegistry.h"
+#include "GPUArray.h"
+
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+//host half of a GPUArray, tracking the way GPUArrayGlobal does
+class HostOnlyArray : public GPUArray {
+public:
+    HostOnlyArray() {}
+    explicit HostOnlyArray(int n) : h_data(n) {
+        trackHost(h_data.capacity() * sizeof(int));
+    }
+    void dataToDevice() {
+        trackHost(h_data.capacity() * sizeof(int));
+    }
+    void dataToHost() {
+        trackHost(h_data.capacity() * sizeof(int));
+    }
+    size_t size() const {
+        return h_data.size();
+    }
+    std::vector<int> h_data;
+};
+
+//the registry is process-wide, so each test uses its own owner names and keys
+class AllocationRegistryTest : public ::testing::Test {
+protected:
+    AllocationRegistry::Usage usageOf(std::string owner) {
+        return AllocationRegistry::instance().usage()[owner];
+    }
+    char keys[4];
+};
+
+TEST_F(AllocationRegistryTest, ScopeAttributionTest) {
+    EXPECT_EQ("", AllocationScope::current());
+    {
+        AllocationScope outer("scopeOuter");
+        EXPECT_EQ("scopeOuter", AllocationScope::current());
+        {
+            AllocationScope inner("scopeInner");
+            EXPECT_EQ("scopeInner", AllocationScope::current());
+            AllocationRegistry::instance().hostResized(&keys[0], 100);
+        }
+        AllocationRegistry::instance().hostResized(&keys[1], 50);
+    }
+    EXPECT_EQ("", AllocationScope::current());
+    EXPECT_EQ(100, usageOf("scopeInner").hostBytes);
+    EXPECT_EQ(50, usageOf("scopeOuter").hostBytes);
+    AllocationRegistry::instance().hostFreed(&keys[0]);
+    AllocationRegistry::instance().hostFreed(&keys[1]);
+    EXPECT_EQ(0, usageOf("scopeInner").hostBytes);
+    EXPECT_EQ(0, usageOf("scopeOuter").hostBytes);
+}
+
+TEST_F(AllocationRegistryTest, HostResizeTest) {
+    AllocationRegistry &reg = AllocationRegistry::instance();
+    {
+        AllocationScope scope("hostOwner");
+        reg.hostResized(&keys[0], 400);
+        reg.hostResized(&keys[0], 1000);
+    }
+    //outside a scope a resize stays with the original owner
+    reg.hostResized(&keys[0], 200);
+    AllocationRegistry::Usage u = usageOf("hostOwner");
+    EXPECT_EQ(200, u.hostBytes);
+    EXPECT_EQ(1000, u.peakHostBytes);
+    EXPECT_EQ(0, usageOf("unattributed").hostBytes);
+
+    reg.beginRun();
+    u = usageOf("hostOwner");
+    EXPECT_EQ(200, u.peakHostBytes);
+    EXPECT_EQ(0, u.allocations);
+    EXPECT_EQ(0, u.frees);
+    reg.hostFreed(&keys[0]);
+    u = usageOf("hostOwner");
+    EXPECT_EQ(0, u.hostBytes);
+    EXPECT_EQ(1, u.frees);
+}
+
+TEST_F(AllocationRegistryTest, DeviceChurnTest) {
+    AllocationRegistry &reg = AllocationRegistry::instance();
+    reg.beginRun();
+    size_t totalBefore = usageOf("total").deviceBytes;
+    {
+        AllocationScope scope("deviceOwner");
+        reg.deviceAllocated(&keys[0], 4096);
+        reg.deviceAllocated(&keys[1], 1024);
+    }
+    reg.deviceFreed(&keys[0]);
+    reg.deviceAllocated(&keys[2], 0); //ignored
+    reg.deviceFreed(&keys[3]);        //never allocated, ignored
+
+    AllocationRegistry::Usage u = usageOf("deviceOwner");
+    EXPECT_EQ(1024, u.deviceBytes);
+    EXPECT_EQ(5120, u.peakDeviceBytes);
+    EXPECT_EQ(2, u.allocations);
+    EXPECT_EQ(1, u.frees);
+    EXPECT_EQ(5120, u.allocatedBytes);
+    EXPECT_EQ(totalBefore + 1024, usageOf("total").deviceBytes);
+
+    reg.deviceFreed(&keys[1]);
+    EXPECT_EQ(0, usageOf("deviceOwner").deviceBytes);
+    EXPECT_NE(std::string::npos, reg.summary().find("deviceOwner"));
+}
+
+TEST_F(AllocationRegistryTest, ArrayTransferTest) {
+    AllocationRegistry &reg = AllocationRegistry::instance();
+    AllocationScope scope("transferOwner");
+    HostOnlyArray arr(100);
+    EXPECT_EQ(400, usageOf("transferOwner").hostBytes);
+    reg.beginRun();
+    //transfers at an unchanged size do not touch the registry
+    for (int i=0; i<10; i++) {
+        arr.dataToDevice();
+        arr.dataToHost();
+    }
+    EXPECT_EQ(0, usageOf("transferOwner").allocations);
+    arr.h_data.resize(300);
+    arr.dataToHost();
+    EXPECT_EQ(arr.h_data.capacity() * sizeof(int), usageOf("transferOwner").hostBytes);
+    EXPECT_EQ(1, usageOf("transferOwner").allocations);
+}
+
+TEST_F(AllocationRegistryTest, ArrayCopyMoveTest) {
+    {
+        AllocationScope scope("copyOwner");
+        HostOnlyArray arr(100);
+        HostOnlyArray copy(arr);
+        EXPECT_EQ(400, copy.hostBytesTracked());
+        EXPECT_EQ(800, usageOf("copyOwner").hostBytes);
+
+        HostOnlyArray assigned;
+        assigned = arr;
+        EXPECT_EQ(1200, usageOf("copyOwner").hostBytes);
+
+        //a move hands the footprint over rather than counting it twice
+        HostOnlyArray moved(std::move(copy));
+        EXPECT_EQ(0, copy.hostBytesTracked());
+        EXPECT_EQ(400, moved.hostBytesTracked());
+        EXPECT_EQ(1200, usageOf("copyOwner").hostBytes);
+
+        HostOnlyArray moveAssigned;
+        moveAssigned = std::move(assigned);
+        EXPECT_EQ(0, assigned.hostBytesTracked());
+        EXPECT_EQ(1200, usageOf("copyOwner").hostBytes);
+    }
+    EXPECT_EQ(0, usageOf("copyOwner").hostBytes);
+}
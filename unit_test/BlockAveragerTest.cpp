@@ -0,0 +1,53 @@
+#include "BlockAverager.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace MD_ENGINE;
+
+TEST(BlockAveragerTest, MeanAndVarianceTest) {
+    BlockAverager averager;
+    std::vector<double> xs = {1.5, -2.0, 3.25, 0.0, 7.0, 2.5, -1.0};
+    double sum = 0;
+    for (double x : xs) {
+        averager.push(x);
+        sum += x;
+    }
+    double mean = sum / xs.size();
+    double sumSqr = 0;
+    for (double x : xs) {
+        sumSqr += (x - mean) * (x - mean);
+    }
+    EXPECT_EQ(xs.size(), averager.count());
+    EXPECT_DOUBLE_EQ(mean, averager.mean());
+    EXPECT_DOUBLE_EQ(sumSqr / (xs.size() - 1), averager.variance());
+    //blocks of 1, 2 and 4 samples
+    EXPECT_EQ(3, averager.levels.size());
+    EXPECT_EQ(1, averager.levels[2].n);
+}
+
+//for x_t = phi x_t-1 + noise the integrated autocorrelation time is (1 + phi) / (1 - phi) / 2
+TEST(BlockAveragerTest, CorrelatedSeriesTest) {
+    std::mt19937 gen(1234);
+    std::normal_distribution<double> noise(0, 1);
+    double phi = 0.9;
+    BlockAverager uncorrelated;
+    BlockAverager correlated;
+    double x = 0;
+    int nSamples = 1 << 20;
+    for (int i=0; i<nSamples; i++) {
+        uncorrelated.push(noise(gen));
+        x = phi * x + noise(gen);
+        correlated.push(x);
+    }
+    EXPECT_EQ(21, correlated.levels.size());
+    EXPECT_TRUE(uncorrelated.converged());
+    EXPECT_TRUE(correlated.converged());
+    EXPECT_NEAR(1.0 / std::sqrt(nSamples), uncorrelated.error(), 0.1 / std::sqrt(nSamples));
+    EXPECT_NEAR(0.5, uncorrelated.correlationTime(), 0.1);
+    double tau = 0.5 * (1 + phi) / (1 - phi);
+    EXPECT_NEAR(tau, correlated.correlationTime(), 0.2 * tau);
+    EXPECT_NEAR(0, correlated.mean(), 4 * correlated.error());
+}
@@ -0,0 +1,76 @@
+#include "CollectiveVariableMath.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+TEST(CollectiveVariableMathTest, AngleGradientTest) {
+    float3 u = make_float3(1.2, 0.3, -0.4);
+    float3 v = make_float3(-0.2, 1.1, 0.5);
+    float3 gradU, gradV, unused;
+    float h = 1e-3;
+    cvAngle(u, v, gradU, gradV);
+    float3 dx = make_float3(h, 0, 0);
+    float3 dz = make_float3(0, 0, h);
+    float dAngleDUx = (cvAngle(u + dx, v, unused, unused) - cvAngle(u - dx, v, unused, unused)) / (2*h);
+    float dAngleDVz = (cvAngle(u, v + dz, unused, unused) - cvAngle(u, v - dz, unused, unused)) / (2*h);
+    EXPECT_NEAR(gradU.x, dAngleDUx, 1e-3);
+    EXPECT_NEAR(gradV.z, dAngleDVz, 1e-3);
+    float3 perpendicular = make_float3(0, 2, 0);
+    EXPECT_NEAR(cvAngle(make_float3(1, 0, 0), perpendicular, gradU, gradV), M_PI / 2, 1e-6);
+}
+
+TEST(CollectiveVariableMathTest, SwitchingTest) {
+    float r0 = 3;
+    float h = 1e-3;
+    for (float r : {1.5f, 2.9f, 3.0f, 3.9f, 6.0f}) {
+        float dfdr, unused;
+        float f = cvSwitching(r, r0, 6, 12, dfdr);
+        //with n = 6 and m = 12 the function is 1 / (1 + (r/r0)^6)
+        EXPECT_NEAR(f, 1 / (1 + pow(r/r0, 6)), 1e-5) << "r " << r;
+        float fd = (cvSwitching(r+h, r0, 6, 12, unused) - cvSwitching(r-h, r0, 6, 12, unused)) / (2*h);
+        EXPECT_NEAR(dfdr, fd, 1e-2 * fabs(dfdr) + 1e-4) << "r " << r;
+    }
+}
+
+TEST(CollectiveVariableMathTest, RMSDFitTest) {
+    //rotate reference positions by a known rotation, then fit them back
+    double axis[3] = {0.3, -0.5, 0.8};
+    double len = sqrt(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+    double c = cos(0.7);
+    double s = sin(0.7);
+    double cross[3][3] = {{0, -axis[2]/len, axis[1]/len}, {axis[2]/len, 0, -axis[0]/len}, {-axis[1]/len, axis[0]/len, 0}};
+    double rotation[3][3];
+    for (int a=0; a<3; a++) {
+        for (int b=0; b<3; b++) {
+            rotation[a][b] = (a == b) * c + (1 - c) * axis[a] * axis[b] / (len*len) + s * cross[a][b];
+        }
+    }
+    std::vector<std::vector<double> > ys = {{1, 0, 0}, {-1, 0.5, 0}, {0, -0.5, 1.5}, {0, 0, -1.5}};
+    double S[3][3] = {{0}};
+    double sumSq = 0;
+    for (std::vector<double> &y : ys) {
+        double x[3];
+        for (int a=0; a<3; a++) {
+            x[a] = 0;
+            for (int b=0; b<3; b++) {
+                x[a] += rotation[a][b] * y[b];
+            }
+        }
+        for (int a=0; a<3; a++) {
+            sumSq += x[a]*x[a] + y[a]*y[a];
+            for (int b=0; b<3; b++) {
+                S[a][b] += y[a] * x[b];
+            }
+        }
+    }
+    double rot[3][3];
+    double msd = cvRMSDFit(S, sumSq, ys.size(), rot);
+    EXPECT_NEAR(msd, 0, 1e-8);
+    for (int a=0; a<3; a++) {
+        for (int b=0; b<3; b++) {
+            EXPECT_NEAR(rot[a][b], rotation[a][b], 1e-6);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "State.h"
+
+#include <string>
+#include <gtest/gtest.h>
+
+//more groups than there are per-atom tag bits, so the later ones are kept as id lists
+class ExtendedGroupTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        mState.atomParams.addSpecies("A", 1);
+        for (int i=0; i<nAtoms; i++) {
+            mState.addAtom("A", Vector(i, 0, 0), 0);
+        }
+        //group i holds the atoms whose id is a multiple of i+1
+        for (int i=0; i<nGroups; i++) {
+            mState.addToGroup(handle(i), [i] (Atom *a) {
+                return a->id % (i+1) == 0;
+            });
+        }
+    }
+
+    std::string handle(int i) {
+        return "group" + std::to_string(i);
+    }
+
+    State mState;
+    int nAtoms = 100;
+    int nGroups = 40;
+};
+
+TEST_F(ExtendedGroupTest, MembershipTest) {
+    int nExtended = 0;
+    for (int i=0; i<nGroups; i++) {
+        uint32_t tag = mState.groupTagFromHandle(handle(i));
+        nExtended += (tag & GROUP_TAG_EXTENDED) != 0;
+        for (Atom &a : mState.atoms) {
+            bool expected = a.id % (i+1) == 0;
+            EXPECT_EQ(expected, mState.atomInGroup(a, handle(i))) << "group " << i << " atom " << a.id;
+            if (tag & GROUP_TAG_EXTENDED) {
+                //extended groups leave the per-atom tag alone
+                EXPECT_EQ(0u, a.groupTag & tag);
+            }
+        }
+        EXPECT_EQ((nAtoms + i) / (i+1), mState.countNumInGroup(tag)) << "group " << i;
+    }
+    //all takes the first bit, so 30 of the 40 groups get one
+    EXPECT_EQ(nGroups - (GROUP_TAG_NBITS - 1), nExtended);
+}
+
+TEST_F(ExtendedGroupTest, DeleteGroupTest) {
+    std::string last = handle(nGroups-1);
+    uint32_t tag = mState.groupTagFromHandle(last);
+    ASSERT_TRUE(tag & GROUP_TAG_EXTENDED);
+    mState.deleteGroup(last);
+    //the extended slot is reused by the next group created
+    mState.addToGroup("again", [] (Atom *a) {
+        return a->id < 3;
+    });
+    EXPECT_EQ(tag, mState.groupTagFromHandle("again"));
+    EXPECT_EQ(3, mState.countNumInGroup(tag));
+    EXPECT_TRUE(mState.atomInGroup(mState.atoms[0], "again"));
+    EXPECT_FALSE(mState.atomInGroup(mState.atoms[5], "again"));
+}
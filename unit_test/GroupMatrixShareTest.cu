@@ -0,0 +1,56 @@
+#include "GPUArrayDeviceGlobal.h"
+#include "GroupMatrixShare.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+//thread i adds member i's share of an n-atom interaction of energy eng
+__global__ void addShares(GroupMatrix groupMatrix, int *ids, int n, float eng) {
+    int idx = GETIDX();
+    if (idx < n) {
+        addGroupMatrixShare(groupMatrix, ids, n, idx, eng / n);
+    }
+}
+
+class GroupMatrixShareTest : public ::testing::Test {
+protected:
+    //groups of atom ids 0 to 7: 2 and 5 in group 0, 1 and 7 in group 1, the rest in none
+    virtual void SetUp() {
+        std::vector<int> slots = {-1, 1, 0, -1, -1, 0, -1, 1};
+        slotsDevice = GPUArrayDeviceGlobal<int>(slots.size());
+        slotsDevice.set(slots.data());
+    }
+
+    std::vector<float> matrixFor(std::vector<int> ids, float eng) {
+        GPUArrayDeviceGlobal<int> idsDevice(ids.size());
+        idsDevice.set(ids.data());
+        GPUArrayDeviceGlobal<float> matrix(4);
+        matrix.memset(0);
+        int n = ids.size();
+        addShares<<<1, n>>>(GroupMatrix(matrix.data(), slotsDevice.data(), 2), idsDevice.data(), n, eng);
+        std::vector<float> res(4);
+        matrix.get(res.data());
+        return res;
+    }
+
+    GPUArrayDeviceGlobal<int> slotsDevice;
+};
+
+TEST_F(GroupMatrixShareTest, BondTest) {
+    //a bond between the groups is all off the diagonal, half in each direction
+    std::vector<float> matrix = matrixFor({5, 1}, 4);
+    EXPECT_FLOAT_EQ(0, matrix[0]);
+    EXPECT_FLOAT_EQ(2, matrix[1]);
+    EXPECT_FLOAT_EQ(2, matrix[2]);
+    EXPECT_FLOAT_EQ(0, matrix[3]);
+}
+
+TEST_F(GroupMatrixShareTest, DihedralTest) {
+    //each of the 12 ordered pairs of members carries 1, and pairs with atom 3 are dropped
+    std::vector<float> matrix = matrixFor({5, 2, 7, 3}, 12);
+    EXPECT_FLOAT_EQ(2, matrix[0]);
+    EXPECT_FLOAT_EQ(2, matrix[1]);
+    EXPECT_FLOAT_EQ(2, matrix[2]);
+    EXPECT_FLOAT_EQ(0, matrix[3]);
+}
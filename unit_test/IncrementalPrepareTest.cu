@@ -0,0 +1,51 @@
+#include "State.h"
+#include "IntegratorVerlet.h"
+
+#include <gtest/gtest.h>
+
+//two resting atoms with no fixes, so runs leave them where they are
+class IncrementalPrepareTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        //State keeps python lists
+        Py_Initialize();
+        state = boost::shared_ptr<State>(new State());
+        state->bounds = Bounds(state.get(), Vector(0, 0, 0), Vector(20, 20, 20));
+        state->atomParams.addSpecies("type1", 1);
+        state->addAtom("type1", Vector(5, 5, 5), 0);
+        state->addAtom("type1", Vector(10, 10, 10), 0);
+    }
+
+    boost::shared_ptr<State> state;
+};
+
+TEST_F(IncrementalPrepareTest, HeldAtomEditTest) {
+    IntegratorVerlet integrator(state.get());
+    //as a script holding state.atoms[0] across runs
+    Atom &held = state->getAtomsPy()[0];
+    integrator.run(1);
+    int fullPrepares = state->fullPrepareCount;
+
+    held.pos = Vector(7, 7, 7);
+    integrator.run(1);
+    EXPECT_EQ(fullPrepares + 1, state->fullPrepareCount);
+    EXPECT_EQ(Vector(7, 7, 7), state->atoms[0].pos);
+
+    //in place, as a.pos[0] = 8 does
+    held.pos[0] = 8;
+    integrator.run(1);
+    EXPECT_EQ(fullPrepares + 2, state->fullPrepareCount);
+    EXPECT_EQ(Vector(8, 7, 7), state->atoms[0].pos);
+}
+
+TEST_F(IncrementalPrepareTest, ReadOnlyAccessTest) {
+    IntegratorVerlet integrator(state.get());
+    integrator.run(1);
+    int fullPrepares = state->fullPrepareCount;
+
+    //reading atoms from python does not force a repack
+    Vector pos = state->getAtomsPy()[1].pos;
+    integrator.run(1);
+    EXPECT_EQ(fullPrepares, state->fullPrepareCount);
+    EXPECT_EQ(pos, state->atoms[1].pos);
+}
@@ -0,0 +1,58 @@
+#include "MultipleTauSchedule.h"
+
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace MD_ENGINE;
+
+//level 0 correlates every pair of samples up to nPoints-1 apart
+TEST(MultipleTauScheduleTest, FirstLevelCountsTest) {
+    MultipleTauSchedule schedule(8, 2);
+    int nSamples = 100;
+    for (int i=0; i<nSamples; i++) {
+        schedule.advance(schedule.levelsForNextSample());
+    }
+    for (int lag=0; lag<8; lag++) {
+        EXPECT_EQ(nSamples - lag, schedule.nCorrelated[lag]);
+    }
+    EXPECT_EQ(nSamples, schedule.nPushed[0]);
+    EXPECT_EQ(nSamples / 2, schedule.nPushed[1]);
+    EXPECT_EQ(nSamples / 4, schedule.nPushed[2]);
+    //levels only appear once they are needed
+    EXPECT_EQ(7, schedule.nLevels());
+}
+
+//positions moving one unit per sample have a squared displacement of the lag squared at every level
+TEST(MultipleTauScheduleTest, BallisticDisplacementTest) {
+    int nPoints = 8;
+    MultipleTauSchedule schedule(nPoints, 2);
+    std::vector<std::vector<double> > history;
+    std::vector<double> sums;
+    for (int t=0; t<500; t++) {
+        double x = t;
+        int nLevels = schedule.levelsForNextSample();
+        if (history.size() < nLevels) {
+            history.resize(nLevels, std::vector<double>(nPoints, 0));
+            sums.resize(nLevels * nPoints, 0);
+        }
+        for (int level=0; level<nLevels; level++) {
+            int64_t pushed = level < schedule.nLevels() ? schedule.nPushed[level] : 0;
+            int slot = pushed % nPoints;
+            history[level][slot] = x;
+            for (int lag=schedule.firstLag(level); lag<schedule.nLagsOnPush(level); lag++) {
+                double dx = x - history[level][(slot - lag + nPoints) % nPoints];
+                sums[level*nPoints + lag] += dx * dx;
+            }
+        }
+        schedule.advance(nLevels);
+    }
+    for (int level=0; level<schedule.nLevels(); level++) {
+        for (int lag=schedule.firstLag(level); lag<nPoints; lag++) {
+            double n = schedule.nCorrelated[level*nPoints + lag];
+            if (n > 0) {
+                double tau = schedule.lagSamples(level, lag);
+                EXPECT_DOUBLE_EQ(tau * tau, sums[level*nPoints + lag] / n);
+            }
+        }
+    }
+}
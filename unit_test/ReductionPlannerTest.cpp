@@ -0,0 +1,93 @@
+#include "ReductionPlanner.h"
+
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace MD_ENGINE;
+
+namespace {
+    std::vector<float4> testVelocities() {
+        //inverse masses in w
+        return {make_float4(1, 0, 0, 1), make_float4(0, 2, -1, 0.5), make_float4(-1, 1, 3, 0.25)};
+    }
+    std::vector<Virial> testVirials() {
+        return {Virial(1, 2, 3, 4, 5, 6), Virial(-1, 0, 1, 0, 0, 0), Virial(0.5, 0.5, 0.5, 1, 1, 1)};
+    }
+}
+
+//one sweep gives the same sums as computing each observable on its own
+TEST(ReductionPlannerTest, FusedSumsTest) {
+    std::vector<float4> vs = testVelocities();
+    std::vector<Virial> virials = testVirials();
+    int all = REDUCE_KE_SCALAR | REDUCE_KE_TENSOR | REDUCE_VIRIAL_TENSOR | REDUCE_MOMENTUM;
+    double sums[N_REDUCTION_SLOTS];
+    reduceHost(sums, vs.data(), virials.data(), nullptr, vs.size(), all);
+    ReductionResult res(sums);
+
+    EXPECT_DOUBLE_EQ(1 + 2*5 + 4*11, res.mvv());
+    Virial mvvTensor = res.mvvTensor();
+    EXPECT_DOUBLE_EQ(1 + 0 + 4, mvvTensor[0]);
+    EXPECT_DOUBLE_EQ(0 + 8 + 4, mvvTensor[1]);
+    EXPECT_DOUBLE_EQ(0 + 2 + 36, mvvTensor[2]);
+    EXPECT_DOUBLE_EQ(0 + 0 - 4, mvvTensor[3]);
+    EXPECT_DOUBLE_EQ(0 + 0 - 12, mvvTensor[4]);
+    EXPECT_DOUBLE_EQ(0 - 4 + 12, mvvTensor[5]);
+    EXPECT_DOUBLE_EQ(res.mvv(), mvvTensor[0] + mvvTensor[1] + mvvTensor[2]);
+
+    Virial virial = res.virialTensor();
+    double expected[6] = {0.5, 2.5, 4.5, 5, 6, 7};
+    for (int i=0; i<6; i++) {
+        EXPECT_DOUBLE_EQ(expected[i], virial[i]);
+    }
+    EXPECT_DOUBLE_EQ(7.5, res.virialScalar());
+
+    float4 momentum = res.momentum();
+    EXPECT_FLOAT_EQ(1 + 0 - 4, momentum.x);
+    EXPECT_FLOAT_EQ(0 + 4 + 4, momentum.y);
+    EXPECT_FLOAT_EQ(0 - 2 + 12, momentum.z);
+    EXPECT_FLOAT_EQ(1 + 2 + 4, momentum.w);
+}
+
+//slots of observables which were not asked for are left at zero, and virials are not read
+TEST(ReductionPlannerTest, UnusedSlotsTest) {
+    std::vector<float4> vs = testVelocities();
+    double sums[N_REDUCTION_SLOTS];
+    reduceHost(sums, vs.data(), nullptr, nullptr, vs.size(), REDUCE_KE_SCALAR);
+    for (int slot=0; slot<N_REDUCTION_SLOTS; slot++) {
+        EXPECT_EQ(slot == SLOT_MVV, reductionSlotUsed(slot, REDUCE_KE_SCALAR));
+        if (slot != SLOT_MVV) {
+            EXPECT_EQ(0, sums[slot]);
+        }
+    }
+    //the scalar virial only needs the diagonal
+    for (int slot=SLOT_VIRIAL; slot<SLOT_MOMENTUM; slot++) {
+        EXPECT_EQ(slot < SLOT_VIRIAL + 3, reductionSlotUsed(slot, REDUCE_VIRIAL_SCALAR));
+        EXPECT_TRUE(reductionSlotUsed(slot, REDUCE_VIRIAL_TENSOR));
+    }
+}
+
+//groups are summed through their member indices
+TEST(ReductionPlannerTest, GatherTest) {
+    std::vector<float4> vs = testVelocities();
+    std::vector<int> idxs = {2, 0};
+    double sums[N_REDUCTION_SLOTS];
+    reduceHost(sums, vs.data(), nullptr, idxs.data(), idxs.size(), REDUCE_KE_SCALAR | REDUCE_MOMENTUM);
+    ReductionResult res(sums);
+    EXPECT_DOUBLE_EQ(1 + 4*11, res.mvv());
+    EXPECT_FLOAT_EQ(5, res.momentum().w);
+}
+
+//a consumer wanting other observables later in the turn leaves the first consumer's sums intact
+TEST(ReductionPlannerTest, SecondConsumerTest) {
+    std::vector<float4> vs = testVelocities();
+    std::vector<Virial> virials = testVirials();
+    double sums[N_REDUCTION_SLOTS];
+    reduceHost(sums, vs.data(), virials.data(), nullptr, vs.size(), REDUCE_KE_SCALAR | REDUCE_VIRIAL_SCALAR);
+    reduceHost(sums, vs.data(), virials.data(), nullptr, vs.size(), REDUCE_KE_TENSOR | REDUCE_VIRIAL_TENSOR,
+               REDUCE_KE_SCALAR | REDUCE_VIRIAL_SCALAR);
+    ReductionResult res(sums);
+    EXPECT_DOUBLE_EQ(1 + 2*5 + 4*11, res.mvv());
+    EXPECT_DOUBLE_EQ(7.5, res.virialScalar());
+    EXPECT_DOUBLE_EQ(1 + 0 + 4, res.mvvTensor()[0]);
+    EXPECT_DOUBLE_EQ(7, res.virialTensor()[5]);
+}
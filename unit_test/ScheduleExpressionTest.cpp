@@ -0,0 +1,25 @@
+#include "ScheduleExpression.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+TEST(ScheduleExpressionTest, PrecedenceTest) {
+    EXPECT_DOUBLE_EQ(7, ScheduleExpression("1 + 2*3").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(-4, ScheduleExpression("-2^2").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(512, ScheduleExpression("2^3^2").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(0.5, ScheduleExpression("2^-1").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(1, ScheduleExpression("8/4/2").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(1, ScheduleExpression("1 + 2 < 4").evaluate(0, 0, 0));
+    EXPECT_DOUBLE_EQ(250, ScheduleExpression("2.5e2").evaluate(0, 0, 0));
+}
+
+TEST(ScheduleExpressionTest, ScheduleTest) {
+    ScheduleExpression ramp("300 + 100*frac");
+    EXPECT_DOUBLE_EQ(325, ramp.evaluate(0.25, 1250, 250));
+    ScheduleExpression piecewise("if(frac < 0.5, 300 + 200*frac, 400 + 10*sin(2*pi*step/1000))");
+    EXPECT_DOUBLE_EQ(350, piecewise.evaluate(0.25, 10, 10));
+    EXPECT_NEAR(410, piecewise.evaluate(0.75, 1250, 250), 1e-9);
+    ScheduleExpression decay("max(1, 100*exp(-turn/1000))");
+    EXPECT_DOUBLE_EQ(100*exp(-0.5), decay.evaluate(0, 500, 0));
+    EXPECT_DOUBLE_EQ(1, decay.evaluate(0, 1e5, 0));
+}
@@ -0,0 +1,63 @@
+#include "SkinModel.h"
+
+#include <cfloat>
+#include <gtest/gtest.h>
+
+//times measured at padding 1 with a cutoff of 2.5
+class SkinModelTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        model.rCut = 2.5;
+        model.padding = 1;
+        model.pairForce = 1e-3;
+        model.otherForce = 1e-3;
+        model.build = 2e-3;
+        model.check = 1e-4;
+        model.rate = 0.01;
+        model.stepDisplacement = 0.02;
+        model.safety = 2;
+    }
+
+    SkinModel model;
+};
+
+TEST_F(SkinModelTest, ForceScalingTest) {
+    //with no builds or checks, only the pair time changes with the padding
+    model.build = 0;
+    model.check = 0;
+    double scale = (2.5 + 2) * (2.5 + 2) * (2.5 + 2) / (3.5 * 3.5 * 3.5);
+    EXPECT_DOUBLE_EQ(model.pairForce * scale + model.otherForce, model.cost(2, 1));
+
+    //bonded and other fixes cost the same at any padding
+    model.pairForce = 0;
+    EXPECT_DOUBLE_EQ(model.otherForce, model.cost(0.5, 1));
+    EXPECT_DOUBLE_EQ(model.otherForce, model.cost(2, 1));
+}
+
+TEST_F(SkinModelTest, UnsafeTest) {
+    //margin(k) = 0.04k, so padding 0.5 can only be checked up to every 6 turns
+    EXPECT_LT(model.cost(0.5, 6), DBL_MAX);
+    EXPECT_EQ(DBL_MAX, model.cost(0.5, 7));
+
+    //an unusable current setting is always replaced by a usable one
+    model.padding = 0.5;
+    SkinChoice choice = model.choose(10, 0.25, 2, 20, 0.5);
+    EXPECT_TRUE(choice.change);
+    EXPECT_EQ(DBL_MAX, choice.currentCost);
+    EXPECT_LT(choice.cost, DBL_MAX);
+    EXPECT_GT(0.5 * choice.padding, model.margin(choice.interval));
+}
+
+TEST_F(SkinModelTest, MinGainTest) {
+    SkinChoice choice = model.choose(5, 0.25, 4, 20, 0);
+    ASSERT_TRUE(choice.change);
+    ASSERT_LT(choice.cost, choice.currentCost);
+
+    //a saving smaller than minGain keeps the current settings
+    double gain = 1 - choice.cost / choice.currentCost;
+    SkinChoice kept = model.choose(5, 0.25, 4, 20, gain * 1.01);
+    EXPECT_FALSE(kept.change);
+    EXPECT_DOUBLE_EQ(model.padding, kept.padding);
+    EXPECT_EQ(5, kept.interval);
+    EXPECT_DOUBLE_EQ(kept.currentCost, kept.cost);
+}
@@ -0,0 +1,98 @@
+#include "GPUArrayDeviceGlobal.h"
+#include "PairEvaluatorLJ.h"
+#include "PairEvaluatorLJSoftCore.h"
+#include "ChargeEvaluatorDSFSoftCore.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+//per (r, lambda): LJ dU/dlambda, its central difference, force, its central difference in r, then the same for DSF
+#define N_OUT 8
+
+__global__ void evaluateSoftCore(int n, float *rs, float *lambdas, float *params, EvaluatorLJSoftCore lj,
+                                 ChargeEvaluatorDSFSoftCore dsf, float qi, float qj, float *out) {
+    int idx = GETIDX();
+    if (idx < n) {
+        float r = rs[idx];
+        float lambda = lambdas[idx];
+        float h = 1e-3;
+        float lenSqr = r*r;
+        float lenSqrUp = (r+h)*(r+h);
+        float lenSqrDown = (r-h)*(r-h);
+        float *res = out + idx*N_OUT;
+        //energies are half-counted, forces are not
+        res[0] = lj.dEnergyDLambda(params, lenSqr, 1, lambda);
+        res[1] = (lj.energy(params, lenSqr, 1, lambda+h) - lj.energy(params, lenSqr, 1, lambda-h)) / (2*h);
+        res[2] = lj.force(make_float3(r, 0, 0), params, lenSqr, 1, lambda).x;
+        res[3] = -(lj.energy(params, lenSqrUp, 1, lambda) - lj.energy(params, lenSqrDown, 1, lambda)) / h;
+        res[4] = dsf.dEnergyDLambda(lenSqr, qi, qj, 1, lambda);
+        res[5] = (dsf.energy(lenSqr, qi, qj, 1, lambda+h) - dsf.energy(lenSqr, qi, qj, 1, lambda-h)) / (2*h);
+        res[6] = dsf.force(make_float3(r, 0, 0), lenSqr, qi, qj, 1, lambda).x;
+        res[7] = -(dsf.energy(lenSqrUp, qi, qj, 1, lambda) - dsf.energy(lenSqrDown, qi, qj, 1, lambda)) / h;
+    }
+}
+
+__global__ void evaluateLJ(float r, float *params, EvaluatorLJ lj, EvaluatorLJSoftCore ljSoftCore, float *out) {
+    out[0] = lj.energy(params, r*r, 1);
+    out[1] = ljSoftCore.energy(params, r*r, 1, 1);
+    out[2] = ljSoftCore.energy(params, 0, 1, 0.5);
+}
+
+class SoftCoreEvaluatorTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        float eps = 0.7;
+        float sig = 3.1;
+        float rCut = 9;
+        params = {rCut*rCut, 24*eps, (float) pow(sig, 6)};
+        paramsDevice = GPUArrayDeviceGlobal<float>(3);
+        paramsDevice.set(params.data());
+        float alpha = 0.25;
+        float A = 2.0/sqrt(M_PI)*alpha;
+        float shift = std::erfc(alpha*rCut)/(rCut*rCut) + A*exp(-alpha*alpha*rCut*rCut)/rCut;
+        dsf = ChargeEvaluatorDSFSoftCore(alpha, A, shift, 332.06371, rCut, 1.0);
+    }
+
+    std::vector<float> params;
+    GPUArrayDeviceGlobal<float> paramsDevice;
+    ChargeEvaluatorDSFSoftCore dsf = ChargeEvaluatorDSFSoftCore(0, 0, 0, 0, 1, 0);
+};
+
+TEST_F(SoftCoreEvaluatorTest, DerivativesTest) {
+    std::vector<float> rs;
+    std::vector<float> lambdas;
+    for (float lambda : {0.2f, 0.5f, 0.9f}) {
+        for (float r : {0.5f, 2.5f, 3.5f, 6.0f}) {
+            rs.push_back(r);
+            lambdas.push_back(lambda);
+        }
+    }
+    int n = rs.size();
+    GPUArrayDeviceGlobal<float> rsDevice(n);
+    GPUArrayDeviceGlobal<float> lambdasDevice(n);
+    GPUArrayDeviceGlobal<float> outDevice(n*N_OUT);
+    rsDevice.set(rs.data());
+    lambdasDevice.set(lambdas.data());
+    evaluateSoftCore<<<1, n>>>(n, rsDevice.data(), lambdasDevice.data(), paramsDevice.data(), EvaluatorLJSoftCore(0.5),
+                               dsf, 0.4, -0.8, outDevice.data());
+    std::vector<float> out(n*N_OUT);
+    outDevice.get(out.data());
+    for (int i=0; i<n; i++) {
+        float *res = out.data() + i*N_OUT;
+        for (int j=0; j<N_OUT; j+=2) {
+            EXPECT_NEAR(res[j], res[j+1], 1e-2 * fabs(res[j]) + 1e-4) << "r " << rs[i] << " lambda " << lambdas[i] << " value " << j;
+        }
+    }
+}
+
+TEST_F(SoftCoreEvaluatorTest, EndStatesTest) {
+    GPUArrayDeviceGlobal<float> outDevice(3);
+    evaluateLJ<<<1, 1>>>(3.5, paramsDevice.data(), EvaluatorLJ(), EvaluatorLJSoftCore(0.5), outDevice.data());
+    std::vector<float> out(3);
+    outDevice.get(out.data());
+    //lambda = 1 is plain LJ, and the soft core keeps overlapping atoms finite
+    EXPECT_NEAR(out[0], out[1], 1e-5 * fabs(out[0]));
+    EXPECT_TRUE(std::isfinite(out[2]));
+}
@@ -0,0 +1,154 @@
+#include "GPUArrayDeviceGlobal.h"
+#include "BondEvaluatorTabulated.h"
+#include "AngleEvaluatorTabulated.h"
+#include "TabulatedSpline.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+//per bond length: energy, force
+#define N_OUT_BOND 2
+//per angle: energy, x force on the first atom, its central difference
+#define N_OUT_ANGLE 3
+
+__global__ void evaluateBonds(int n, float *rs, BondTabulatedType bondType, BondEvaluatorTabulated eval, float *out) {
+    int idx = GETIDX();
+    if (idx < n) {
+        float r = rs[idx];
+        float *res = out + idx*N_OUT_BOND;
+        //bond energies are split between the two atoms
+        res[0] = 2 * eval.energy(make_float3(r, 0, 0), r*r, bondType);
+        res[1] = eval.force(make_float3(r, 0, 0), r*r, bondType).x;
+    }
+}
+
+//angle theta at the origin between atoms at distances 1 and 1.3, as in compute_force_angle
+__device__ float angleFrom(float3 posA, float3 posC, float3 directors[2], float distSqrs[2], float *c, float *invDistProd) {
+    directors[0] = posA;
+    directors[1] = posC;
+    for (int i=0; i<2; i++) {
+        distSqrs[i] = lengthSqr(directors[i]);
+    }
+    *invDistProd = 1.0f / sqrtf(distSqrs[0] * distSqrs[1]);
+    *c = dot(directors[0], directors[1]) * *invDistProd;
+    return acosf(*c);
+}
+
+__global__ void evaluateAngles(int n, float *thetas, AngleTabulatedType angleType, AngleEvaluatorTabulated eval, float *out) {
+    int idx = GETIDX();
+    if (idx < n) {
+        float theta = thetas[idx];
+        float3 posA = make_float3(1, 0, 0);
+        float3 posC = make_float3(1.3f*cosf(theta), 1.3f*sinf(theta), 0);
+        float3 directors[2];
+        float distSqrs[2];
+        float c, invDistProd;
+        float thetaMeasured = angleFrom(posA, posC, directors, distSqrs, &c, &invDistProd);
+        float s = 1.0f / sqrtf(1-c*c);
+        float3 forces[3];
+        eval.forcesAll(angleType, thetaMeasured, s, c, distSqrs, directors, invDistProd, forces);
+        float *res = out + idx*N_OUT_ANGLE;
+        //angle energies are split between the three atoms
+        res[0] = 3 * eval.energy(angleType, thetaMeasured, directors);
+        res[1] = forces[0].x;
+        float h = 1e-3;
+        float thetaUp = angleFrom(posA + make_float3(h, 0, 0), posC, directors, distSqrs, &c, &invDistProd);
+        float thetaDown = angleFrom(posA - make_float3(h, 0, 0), posC, directors, distSqrs, &c, &invDistProd);
+        res[2] = -3 * (eval.energy(angleType, thetaUp, directors) - eval.energy(angleType, thetaDown, directors)) / (2*h);
+    }
+}
+
+//non-periodic tables of harmonic wells, given with their forces so the splines are exact inside
+class TabulatedBondedTest : public ::testing::Test {
+protected:
+    GPUArrayDeviceGlobal<float4> tableFor(double x0, double xMax, double k, double center, int n, int *nSegments) {
+        double dx = (xMax - x0) / (n - 1);
+        std::vector<double> values, derivs;
+        for (int i=0; i<n; i++) {
+            double x = x0 + i*dx;
+            values.push_back(k * (x - center) * (x - center));
+            derivs.push_back(2 * k * (x - center));
+        }
+        std::vector<float4> coefs = TabulatedSpline::coefficients(values, derivs, dx);
+        *nSegments = coefs.size();
+        GPUArrayDeviceGlobal<float4> coefsDevice(coefs.size());
+        coefsDevice.set(coefs.data());
+        return coefsDevice;
+    }
+};
+
+TEST_F(TabulatedBondedTest, BondBoundaryTest) {
+    //E = 50 (r - 1)^2 on [0.8, 1.2], so E = 2 and |dE/dr| = 20 at both ends
+    BondTabulatedType bondType;
+    GPUArrayDeviceGlobal<float4> coefs = tableFor(0.8, 1.2, 50, 1, 41, &bondType.nSegments);
+    bondType.x0 = 0.8;
+    bondType.invDx = 100;
+    bondType.offset = 0;
+    bondType.table = 0;
+    BondEvaluatorTabulated eval;
+    eval.coefs = coefs.data();
+
+    std::vector<float> rs = {0.7, 0.8 - 1e-4, 0.8 + 1e-4, 0.93, 1.05, 1.2 - 1e-4, 1.2 + 1e-4, 1.3};
+    int n = rs.size();
+    GPUArrayDeviceGlobal<float> rsDevice(n);
+    GPUArrayDeviceGlobal<float> outDevice(n*N_OUT_BOND);
+    rsDevice.set(rs.data());
+    evaluateBonds<<<1, n>>>(n, rsDevice.data(), bondType, eval, outDevice.data());
+    std::vector<float> out(n*N_OUT_BOND);
+    outDevice.get(out.data());
+    for (int i=0; i<n; i++) {
+        float r = rs[i];
+        float energy, force;
+        if (r < 0.8) {
+            //linear below the table, with the force at its first point
+            energy = 2 + 20 * (0.8 - r);
+            force = 20;
+        } else if (r > 1.2) {
+            energy = 2 + 20 * (r - 1.2);
+            force = -20;
+        } else {
+            energy = 50 * (r - 1) * (r - 1);
+            force = -100 * (r - 1);
+        }
+        EXPECT_NEAR(energy, out[i*N_OUT_BOND], 1e-3) << "r " << r;
+        EXPECT_NEAR(force, out[i*N_OUT_BOND + 1], 1e-2) << "r " << r;
+    }
+}
+
+TEST_F(TabulatedBondedTest, AngleBoundaryTest) {
+    //E = 30 (theta - 2)^2 on [1.5, 2.5], so E = 7.5 and |dE/dtheta| = 30 at both ends
+    AngleTabulatedType angleType;
+    GPUArrayDeviceGlobal<float4> coefs = tableFor(1.5, 2.5, 30, 2, 21, &angleType.nSegments);
+    angleType.x0 = 1.5;
+    angleType.invDx = 20;
+    angleType.offset = 0;
+    angleType.table = 0;
+    AngleEvaluatorTabulated eval;
+    eval.coefs = coefs.data();
+
+    std::vector<float> thetas = {1.2, 1.5 - 1e-3, 1.5 + 1e-3, 1.8, 2.2, 2.5 - 1e-3, 2.5 + 1e-3, 2.9};
+    int n = thetas.size();
+    GPUArrayDeviceGlobal<float> thetasDevice(n);
+    GPUArrayDeviceGlobal<float> outDevice(n*N_OUT_ANGLE);
+    thetasDevice.set(thetas.data());
+    evaluateAngles<<<1, n>>>(n, thetasDevice.data(), angleType, eval, outDevice.data());
+    std::vector<float> out(n*N_OUT_ANGLE);
+    outDevice.get(out.data());
+    for (int i=0; i<n; i++) {
+        float theta = thetas[i];
+        float energy;
+        if (theta < 1.5) {
+            energy = 7.5 + 30 * (1.5 - theta);
+        } else if (theta > 2.5) {
+            energy = 7.5 + 30 * (theta - 2.5);
+        } else {
+            energy = 30 * (theta - 2) * (theta - 2);
+        }
+        float *res = out.data() + i*N_OUT_ANGLE;
+        EXPECT_NEAR(energy, res[0], 1e-2) << "theta " << theta;
+        //forces are the gradient of the energy inside and outside the table
+        EXPECT_NEAR(res[2], res[1], 1e-2 * fabs(res[2]) + 1e-2) << "theta " << theta;
+    }
+}
@@ -0,0 +1,75 @@
+#include "TabulatedSpline.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+//cubic Hermite segments reproduce a cubic given its derivatives
+TEST(TabulatedSplineTest, CubicWithDerivativesTest) {
+    auto f = [] (double x) { return 1 - 2*x + 0.5*x*x*x; };
+    auto df = [] (double x) { return -2 + 1.5*x*x; };
+    double x0 = 0.5, dx = 0.25;
+    std::vector<double> values, derivs;
+    for (int i=0; i<9; i++) {
+        values.push_back(f(x0 + i*dx));
+        derivs.push_back(df(x0 + i*dx));
+    }
+    std::vector<float4> coefs = TabulatedSpline::coefficients(values, derivs, dx);
+    ASSERT_EQ(8, coefs.size());
+    for (double x=0.5; x<=2.5; x+=0.0625) {
+        float2 ed = TabulatedSpline::evaluate(coefs.data(), coefs.size(), x0, 1/dx, x);
+        EXPECT_NEAR(f(x), ed.x, 1e-5);
+        EXPECT_NEAR(df(x), ed.y, 1e-4);
+    }
+}
+
+TEST(TabulatedSplineTest, NaturalSplineTest) {
+    //linear data has zero second derivative, so the natural spline is exact
+    std::vector<double> line = {3, 2, 1, 0, -1};
+    std::vector<double> derivs = TabulatedSpline::naturalDerivatives(line, 0.5);
+    for (double d : derivs) {
+        EXPECT_NEAR(-2, d, 1e-12);
+    }
+    //a smooth function is close to its spline between points
+    std::vector<double> values;
+    for (int i=0; i<201; i++) {
+        values.push_back(sin(i*0.01));
+    }
+    std::vector<float4> coefs = TabulatedSpline::coefficients(values, std::vector<double>(), 0.01);
+    for (double x=0.1; x<1.9; x+=0.0137) {
+        float2 ed = TabulatedSpline::evaluate(coefs.data(), coefs.size(), 0, 100, x);
+        EXPECT_NEAR(sin(x), ed.x, 1e-6);
+        EXPECT_NEAR(cos(x), ed.y, 1e-4);
+    }
+}
+
+TEST(TabulatedSplineTest, ExtrapolationTest) {
+    std::vector<double> values = {4, 1, 0};
+    std::vector<double> derivs = {-4, -2, 0};
+    std::vector<float4> coefs = TabulatedSpline::coefficients(values, derivs, 1);
+    //linear below the first point, with the slope there
+    float2 ed = TabulatedSpline::evaluate(coefs.data(), coefs.size(), 1, 1, 0.5);
+    EXPECT_FLOAT_EQ(6, ed.x);
+    EXPECT_FLOAT_EQ(-4, ed.y);
+    ed = TabulatedSpline::evaluate(coefs.data(), coefs.size(), 1, 1, 3);
+    EXPECT_FLOAT_EQ(0, ed.x);
+    EXPECT_FLOAT_EQ(0, ed.y);
+}
+
+TEST(TabulatedSplineTest, PeriodicSplineTest) {
+    //one period of a smooth periodic function, as for a dihedral table
+    int n = 37;
+    double dx = 2 * M_PI / (n - 1);
+    std::vector<double> values;
+    for (int i=0; i<n; i++) {
+        values.push_back(cos(-M_PI + i*dx) + 0.5 * cos(3 * (-M_PI + i*dx)));
+    }
+    std::vector<double> derivs = TabulatedSpline::periodicDerivatives(values, dx);
+    EXPECT_DOUBLE_EQ(derivs[0], derivs[n-1]);
+    for (int i=0; i<n; i++) {
+        double x = -M_PI + i*dx;
+        EXPECT_NEAR(-sin(x) - 1.5 * sin(3*x), derivs[i], 1e-2);
+    }
+    //the natural spline has zero curvature at the ends, so its slope there is worse
+    std::vector<double> natural = TabulatedSpline::naturalDerivatives(values, dx);
+    EXPECT_GT(fabs(natural[0] - derivs[0]), 1e-3);
+}
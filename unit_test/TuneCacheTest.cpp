@@ -0,0 +1,57 @@
+#include "TuneCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace {
+    std::string signatureFor(int nAtoms, double cutoff, std::vector<std::string> fixTypes) {
+        return TuneCache::signature(nAtoms, 0.8, cutoff, 1, "Tesla K80", 3, 7, fixTypes);
+    }
+}
+
+TEST(TuneCacheTest, SignatureTest) {
+    std::string sig = signatureFor(10000, 3, {"LJ", "bond"});
+    //the same system in another job, with fixes activated in another order
+    EXPECT_EQ(sig, signatureFor(10000, 3, {"bond", "LJ"}));
+    //close atom counts share a bucket
+    EXPECT_EQ(sig, signatureFor(10100, 3, {"LJ", "bond"}));
+    EXPECT_NE(sig, signatureFor(20000, 3, {"LJ", "bond"}));
+    //systems whose largest cutoffs differ do not share tuning
+    EXPECT_NE(sig, signatureFor(10000, 3.5, {"LJ", "bond"}));
+    EXPECT_NE(sig, signatureFor(10000, 3, {"LJ"}));
+    //the file is whitespace-separated
+    EXPECT_EQ(std::string::npos, sig.find(' '));
+    EXPECT_EQ(signatureFor(1, 3, {}), signatureFor(0, 3, {}));
+}
+
+TEST(TuneCacheTest, RoundTripTest) {
+    std::string fn = "TuneCacheTest" + std::to_string(getpid()) + ".txt";
+    std::string sigA = signatureFor(10000, 3, {"LJ"});
+    std::string sigB = signatureFor(50000, 3, {"LJ"});
+    TuneCache::Entry entry;
+    EXPECT_FALSE(TuneCache(fn).lookup(sigA, entry));
+
+    TuneCache(fn).store(sigA, TuneCache::Entry(256, 4, 1.25e-9));
+    //a second job adds its entry without discarding the first
+    TuneCache(fn).store(sigB, TuneCache::Entry(128, 8, 3e-9));
+    {
+        std::ofstream f(fn.c_str(), std::ios::app);
+        f << "malformed line\n";
+    }
+    TuneCache cache(fn);
+    ASSERT_TRUE(cache.lookup(sigA, entry));
+    EXPECT_EQ(256, entry.nThreadPerBlock);
+    EXPECT_EQ(4, entry.nThreadPerAtom);
+    EXPECT_DOUBLE_EQ(1.25e-9, entry.timePerAtomEval);
+    ASSERT_TRUE(cache.lookup(sigB, entry));
+    EXPECT_EQ(128, entry.nThreadPerBlock);
+    EXPECT_EQ(8, entry.nThreadPerAtom);
+    std::remove(fn.c_str());
+
+    //an empty name disables the cache
+    TuneCache disabled("");
+    disabled.store(sigA, TuneCache::Entry(256, 4, 1.25e-9));
+    EXPECT_FALSE(disabled.lookup(sigA, entry));
+}